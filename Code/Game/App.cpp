@@ -16,13 +16,24 @@
 #include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 //Game Systems
+#include "Game/BinaryLog.hpp"
+#include "Game/FrameAllocator.hpp"
 #include "Game/Game.hpp"
+#include "Game/JobScheduler.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderRecorder.hpp"
+#include "Game/VirtualFileSystem.hpp"
 #include "Engine/Commons/Profiler/ProfileLogScope.hpp"
 //Setting up the PVector and PVectorBase to test
 #include "Engine/ProdigyTemplateLibrary/PVectorBase.hpp"
 
 
 App* g_theApp = nullptr;
+bool g_isHeadless = false;
+
+const char* BINARY_LOG_PATH_PREFIX = "Data/Logs/ExecutionLog";
+//Built by Tools/Packer, a tree without one runs off the loose Data folder
+const char* DATA_PACK_PATH = "Data.pak";
 
 App::App()
 {	
@@ -46,7 +57,10 @@ void App::LoadGameBlackBoard()
 
 	const char* xmlDocPath = "Data/Gameplay/GameConfig.xml";
 	tinyxml2::XMLDocument gameconfig;
-	gameconfig.LoadFile(xmlDocPath);
+	std::string xmlText;
+	//A missing file leaves the text empty, which tinyxml reports as XML_ERROR_EMPTY_DOCUMENT below
+	g_virtualFileSystem->ReadTextFile(xmlDocPath, xmlText);
+	gameconfig.Parse(xmlText.c_str(), xmlText.size());
 	
 	if(gameconfig.ErrorID() != tinyxml2::XML_SUCCESS)
 	{
@@ -67,6 +81,8 @@ void App::LoadGameBlackBoard()
 
 void App::StartUp()
 {
+	g_virtualFileSystem = new VirtualFileSystem();
+	g_virtualFileSystem->MountPack(DATA_PACK_PATH);
 
 	LoadGameBlackBoard();
 
@@ -75,6 +91,10 @@ void App::StartUp()
 	g_devConsole = new DevConsole();
 	g_devConsole->Startup();
 
+	//The game's log in every configuration. The engine's text log is only kept for the engine's own messages
+	g_binaryLog = new BinaryLog(BinaryLog::MakeTimestampedLogPath(BINARY_LOG_PATH_PREFIX));
+	g_binaryLog->Startup();
+
 #if defined(_DEBUG)
 	{
 		g_LogSystem = new LogSystem(LOG_PATH);
@@ -85,23 +105,42 @@ void App::StartUp()
 #endif
 
 	gJobSystem = JobSystem::CreateInstance();
+
+	g_jobScheduler = new JobScheduler();
+	g_jobScheduler->Startup();
+
+	g_frameAllocator = new FrameAllocator();
 	
 	g_inputSystem = new InputSystem();
 
-	g_audio = new AudioSystem();
-
 	//create the networking system
 	//g_networkSystem = new NetworkSystem();
 
-	g_debugRenderer = new DebugRender();
-	g_debugRenderer->Startup(g_renderContext);
+	if (g_isHeadless)
+	{
+		//No window, GPU or sound device. Draws and uploads are only recorded
+		g_renderRecorder = new RenderRecorder();
+		g_renderBackend = new RecordingRenderBackend(g_renderRecorder);
+	}
+	else
+	{
+		g_renderBackend = new EngineRenderBackend(g_renderContext);
+
+		g_audio = new AudioSystem();
 
-	g_ImGUI = new ImGUISystem(g_renderContext);
+		g_debugRenderer = new DebugRender();
+		g_debugRenderer->Startup(g_renderContext);
+
+		g_ImGUI = new ImGUISystem(g_renderContext);
+	}
 
 	g_RNG = new RandomNumberGenerator();
 
+#if defined(_DEBUG)
+	//The engine's text log only exists in debug
 	g_LogSystem->LogHook(&LogHookForDevConsole);
-	g_LogSystem->Logf("Game", "Starting Game");
+#endif
+	g_binaryLog->Logf("Game", "Starting Game");
 
 	m_game = new Game();
 	m_game->StartUp();
@@ -114,9 +153,15 @@ void App::StartUp()
 
 void App::ShutDown()
 {
+	//First, the game's meshes and textures have to go while the device they were made on is still there
+	m_game->Shutdown();
+
 	delete g_ImGUI;
 	g_ImGUI = nullptr;
 
+	delete g_renderBackend;
+	g_renderBackend = nullptr;
+
 	delete g_renderContext;
 	g_renderContext = nullptr;
 
@@ -138,6 +183,9 @@ void App::ShutDown()
 	delete g_RNG;
 	g_RNG = nullptr;
 
+	delete g_renderRecorder;
+	g_renderRecorder = nullptr;
+
 	//JobSystem::DestroyInstance();
 
 #if defined(_DEBUG)
@@ -149,8 +197,24 @@ void App::ShutDown()
 		gProfiler->ProfilerShutdown();
 	}
 #endif
-	
-	m_game->Shutdown();
+
+	//After the game, which waits on its own jobs
+	g_jobScheduler->Shutdown();
+	delete g_jobScheduler;
+	g_jobScheduler = nullptr;
+
+	//No thread is left to hold frame memory
+	delete g_frameAllocator;
+	g_frameAllocator = nullptr;
+
+	//Spans it handed out may be held right up to here
+	delete g_virtualFileSystem;
+	g_virtualFileSystem = nullptr;
+
+	//Last, the game and its jobs log right up to their shutdown
+	g_binaryLog->Shutdown();
+	delete g_binaryLog;
+	g_binaryLog = nullptr;
 }
 
 void App::RunFrame()
@@ -177,15 +241,37 @@ void App::BeginFrame()
 		//PROFILE_LOG_SCOPE("Jobs");
 		jobSystem->ProcessCategoryForTimeInMS(JOB_MAIN, 1);
 		jobSystem->ProcessCategoryForTimeInMS(JOB_RENDER, 1);
+
+		//Generic scheduler jobs run on the worker pool, only the thread bound ones wait for us
+		g_jobScheduler->ProcessAffinityForTimeInMS(JOB_AFFINITY_MAIN, 1.0);
+		g_jobScheduler->ProcessAffinityForTimeInMS(JOB_AFFINITY_RENDER, 1.0);
+	}
+
+	if (g_renderRecorder != nullptr)
+	{
+		g_renderRecorder->BeginFrame();
+	}
+
+	if (!g_isHeadless)
+	{
+		g_renderContext->BeginFrame();
 	}
 
-	g_renderContext->BeginFrame();
 	g_inputSystem->BeginFrame();
-	g_audio->BeginFrame();
+
+	if (!g_isHeadless)
+	{
+		g_audio->BeginFrame();
+	}
+
 	g_devConsole->BeginFrame();
 	g_eventSystem->BeginFrame();
-	g_debugRenderer->BeginFrame();
-	g_ImGUI->BeginFrame();
+
+	if (!g_isHeadless)
+	{
+		g_debugRenderer->BeginFrame();
+		g_ImGUI->BeginFrame();
+	}
 
 	m_game->BeginFrame();
 }
@@ -196,13 +282,37 @@ void App::EndFrame()
 	//jobSystem->ProcessFinishJobsForCategory(JOB_MAIN);
 	//jobSystem->ProcessFinishJobsForCategory(JOB_RENDER);
 
-	g_renderContext->EndFrame();
+	m_game->EndFrame();
+
+	if (!g_isHeadless)
+	{
+		g_renderContext->EndFrame();
+	}
+
 	g_inputSystem->EndFrame();
-	g_audio->EndFrame();
+
+	if (!g_isHeadless)
+	{
+		g_audio->EndFrame();
+	}
+
 	g_devConsole->EndFrame();
 	g_eventSystem->EndFrame();
-	g_debugRenderer->EndFrame();
-	g_ImGUI->EndFrame();
+
+	if (!g_isHeadless)
+	{
+		g_debugRenderer->EndFrame();
+		g_ImGUI->EndFrame();
+	}
+
+	if (g_renderRecorder != nullptr)
+	{
+		g_renderRecorder->EndFrame();
+	}
+
+	//Last, every system is done with this frame's scratch memory
+	g_frameAllocator->EndFrame();
+
 	gProfiler->ProfilerEndFrame();
 }
 
@@ -220,7 +330,10 @@ void App::Update()
 
 	m_game->Update(deltaTime);
 
-	g_debugRenderer->Update(deltaTime);
+	if (!g_isHeadless)
+	{
+		g_debugRenderer->Update(deltaTime);
+	}
 }
 
 void App::Render() const
@@ -0,0 +1,2017 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/Game.hpp"
+//Engine Systems
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Renderer/TextureView.hpp"
+//Game Systems
+#include "Game/BinaryLog.hpp"
+#include "Game/BinaryLogFormat.hpp"
+#include "Game/CallstackTable.hpp"
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/DirtyRectTracker.hpp"
+#include "Game/DynamicTextureUploader.hpp"
+#include "Game/EntityCommandBuffer.hpp"
+#include "Game/EntitySimulation.hpp"
+#include "Game/EntityStore.hpp"
+#include "Game/FontAtlas.hpp"
+#include "Game/FrameAllocator.hpp"
+#include "Game/FrameArena.hpp"
+#include "Game/HandlePool.hpp"
+#include "Game/JobScheduler.hpp"
+#include "Game/LightClusterGrid.hpp"
+#include "Game/MandelbrotGenerator.hpp"
+#include "Game/MappedFile.hpp"
+#include "Game/MeshCache.hpp"
+#include "Game/MeshOptimizer.hpp"
+#include "Game/PackFile.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderRecorder.hpp"
+#include "Game/ShaderCache.hpp"
+#include "Game/SpatialHashGrid.hpp"
+#include "Game/SpriteBatch.hpp"
+#include "Game/TextRunCache.hpp"
+#include "Game/TextureStreamer.hpp"
+#include "Game/VirtualFileSystem.hpp"
+//Third Party
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The console benchmarks and the unit tests for the game's systems. Every benchmark line goes through here, to the dev
+// console and the debugger output
+//------------------------------------------------------------------------------------------------------------------------------
+static void PrintBenchmarkResult( const char* format, ... )
+{
+	char result[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(result, sizeof(result), format, args);
+	va_end(args);
+
+	g_devConsole->PrintString(Rgba::WHITE, result);
+	DebuggerPrintf("\n %s", result);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void LogBenchmarkThread( uint messageCount )
+{
+	std::thread::id this_id = std::this_thread::get_id();
+	size_t hash_id = std::hash<std::thread::id>{}(this_id);
+	char const* format = "Thread[%llu]: Printing Message %u";
+
+	for (uint i = 0; i < messageCount; ++i)
+	{
+		g_binaryLog->Logf("benchmark", format, hash_id, i);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Same messages as LogThreadTest without the RNG and DebuggerPrintf, so only the log call is timed. Runs 1, 2, 4...
+// producer threads up to one per spare core and reports throughput for each.
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::LogThreadBenchmark(EventArgs& args)
+{
+	uint messageCount = (uint)args.GetValue("messages", 16384);
+	uint maxThreads = JobScheduler::GetDefaultWorkerCount();
+
+	std::vector<uint> threadCounts;
+	for (uint threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+	threadCounts.push_back(maxThreads);
+
+	for (uint threadCount : threadCounts)
+	{
+		//Start each run with empty buffers
+		g_binaryLog->LogFlush();
+		uint64_t droppedBefore = g_binaryLog->GetDroppedCount();
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+
+		double startTime = GetCurrentTimeSeconds();
+		for (uint i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back(LogBenchmarkThread, messageCount);
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		double totalMessages = (double)threadCount * (double)messageCount;
+		double messagesPerSecond = totalMessages / elapsedSeconds;
+		double nsPerCall = elapsedSeconds * 1e9 * (double)threadCount / totalMessages;
+		uint64_t dropped = g_binaryLog->GetDroppedCount() - droppedBefore;
+
+		PrintBenchmarkResult("Log benchmark: %u threads | %.2f M msg/s | %.1f ns/call | %llu dropped", threadCount, messagesPerSecond * 1e-6, nsPerCall, (unsigned long long)dropped);
+	}
+
+	g_binaryLog->LogFlush();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Fine grained ParallelFor (a few hundred nanoseconds per job) on throwaway schedulers with 1, 2, 4... workers up to one per
+// spare core. Reports jobs/sec and the speed up over a single worker.
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::JobSchedulerBenchmark(EventArgs& args)
+{
+	uint itemCount = (uint)args.GetValue("items", 1 << 22);
+	uint grainSize = (uint)args.GetValue("grain", 256);
+
+	uint maxWorkers = JobScheduler::GetDefaultWorkerCount();
+
+	std::vector<uint> workerCounts;
+	for (uint workerCount = 1; workerCount < maxWorkers; workerCount *= 2)
+	{
+		workerCounts.push_back(workerCount);
+	}
+	workerCounts.push_back(maxWorkers);
+
+	std::vector<float> values(itemCount, 1.f);
+	double singleWorkerSeconds = 0.0;
+
+	for (uint workerCount : workerCounts)
+	{
+		JobScheduler scheduler(workerCount);
+		scheduler.Startup();
+
+		double startTime = GetCurrentTimeSeconds();
+		scheduler.ParallelFor(0, itemCount, grainSize, [&](uint begin, uint end)
+		{
+			for (uint index = begin; index < end; ++index)
+			{
+				values[index] = sqrtf(values[index] * 1.0001f + 0.5f);
+			}
+		});
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		uint64_t jobCount = scheduler.GetExecutedCount();
+		uint64_t stealCount = scheduler.GetStealCount();
+		scheduler.Shutdown();
+
+		if (workerCount == 1)
+		{
+			singleWorkerSeconds = elapsedSeconds;
+		}
+
+		PrintBenchmarkResult("Job benchmark: %u workers | %.2f ms | %.2f M jobs/s | %.2fx | %llu steals", workerCount, elapsedSeconds * 1000.0,
+			(double)jobCount / elapsedSeconds * 1e-6, singleWorkerSeconds / elapsedSeconds, (unsigned long long)stealCount);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Full resolution render of the default view with every kernel the CPU supports, on g_jobScheduler
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::MandelbrotBenchmark(EventArgs& args)
+{
+	uint size = (uint)args.GetValue("size", 1024);
+	MandelbrotViewT view;
+	view.maxIterations = (uint)args.GetValue("iterations", (int)view.maxIterations);
+
+	MandelbrotGenerator generator(size, size);
+	for (int kernelIndex = 0; kernelIndex < NUM_MANDELBROT_KERNELS; ++kernelIndex)
+	{
+		eMandelbrotKernel kernel = (eMandelbrotKernel)kernelIndex;
+		if (!MandelbrotGenerator::IsKernelSupported(kernel))
+		{
+			continue;
+		}
+
+		MandelbrotStatsT stats = generator.RunBenchmark(*g_jobScheduler, view, kernel);
+
+		PrintBenchmarkResult("Mandelbrot benchmark: %s | %.2f ms | %.2f Mpix/s | %.2f Giter/s", MandelbrotGenerator::GetKernelName(kernel),
+			stats.seconds * 1000.0, stats.GetMegaPixelsPerSecond(), stats.GetGigaIterationsPerSecond());
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Chunked entity update, serial and on g_jobScheduler, reports the per entity cost and whether both runs ended up identical
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::EntityBenchmark(EventArgs& args)
+{
+	uint entityCount = (uint)args.GetValue("count", 100000);
+	uint frameCount = (uint)args.GetValue("frames", 100);
+
+	EntityStore serialEntities(entityCount);
+	EntityStore parallelEntities(entityCount);
+	uint32_t serialSeed = 12345U;
+	uint32_t parallelSeed = 12345U;
+	SpawnSeededEntities(serialEntities, entityCount, serialSeed);
+	SpawnSeededEntities(parallelEntities, entityCount, parallelSeed);
+
+	//Its own frame memory, so the benchmark's frames end like real ones without ending the game's
+	FrameAllocator frameAllocator;
+	EntitySimulation simulation(4096U, &frameAllocator);
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		EntityStore& entities = (runIndex == 0) ? serialEntities : parallelEntities;
+		JobScheduler* scheduler = (runIndex == 0) ? nullptr : g_jobScheduler;
+
+		double startTime = GetCurrentTimeSeconds();
+		for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+		{
+			simulation.Update(entities, 1.f / 60.f, scheduler, DespawnOffScreenEntities);
+			frameAllocator.EndFrame();
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		double nsPerEntity = elapsedSeconds * 1e9 / ((double)entityCount * (double)frameCount);
+		PrintBenchmarkResult("Entity benchmark: %s | %u entities at start | %.3f ms/frame | %.2f ns/entity | %u left", (scheduler == nullptr) ? "serial" : "jobs",
+			entityCount, elapsedSeconds * 1000.0 / (double)frameCount, nsPerEntity, entities.GetCount());
+	}
+
+	uint count = serialEntities.GetCount();
+	bool isIdentical = count == parallelEntities.GetCount()
+		&& memcmp(serialEntities.GetPositionsX(), parallelEntities.GetPositionsX(), count * sizeof(float)) == 0
+		&& memcmp(serialEntities.GetPositionsY(), parallelEntities.GetPositionsY(), count * sizeof(float)) == 0;
+	g_devConsole->PrintString(isIdentical ? Rgba::GREEN : Rgba::RED, isIdentical ? "Entity benchmark: serial and job runs are bit identical" : "Entity benchmark: serial and job runs DIFFER");
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Projectile style churn: every frame spawns a wave and despawns the wave from a few frames back. After the warm up frames
+// the store should not grow (no allocations) and the reclaim cost should only depend on the wave size
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::EntityChurnBenchmark(EventArgs& args)
+{
+	uint waveSize = (uint)args.GetValue("spawn", 5000);
+	uint frameCount = (uint)args.GetValue("frames", 200);
+	uint residentCount = (uint)args.GetValue("resident", 100000);
+	constexpr uint WAVE_LIFETIME = 4U;
+	constexpr uint WARM_UP_FRAMES = WAVE_LIFETIME + 1U;
+
+	EntityStore entities;
+	EntityDescT desc;
+	for (uint entityIndex = 0; entityIndex < residentCount; ++entityIndex)
+	{
+		entities.Spawn(desc);
+	}
+
+	std::vector<EntityHandle> waves[WAVE_LIFETIME];
+	for (std::vector<EntityHandle>& wave : waves)
+	{
+		wave.reserve(waveSize);
+	}
+
+	uint warmCapacity = 0U;
+	double spawnSeconds = 0.0;
+	double reclaimSeconds = 0.0;
+	for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		std::vector<EntityHandle>& wave = waves[frameIndex % WAVE_LIFETIME];
+
+		double startTime = GetCurrentTimeSeconds();
+		for (const EntityHandle& handle : wave)
+		{
+			entities.MarkGarbage(handle);
+		}
+		entities.RemoveGarbage();
+		double reclaimedTime = GetCurrentTimeSeconds();
+
+		wave.clear();
+		for (uint spawnIndex = 0; spawnIndex < waveSize; ++spawnIndex)
+		{
+			desc.velocity = Vec2(50.f, (float)spawnIndex);
+			wave.push_back(entities.Spawn(desc));
+		}
+		double endTime = GetCurrentTimeSeconds();
+
+		if (frameIndex == WARM_UP_FRAMES)
+		{
+			warmCapacity = entities.GetCapacity();
+		}
+		if (frameIndex >= WARM_UP_FRAMES)
+		{
+			reclaimSeconds += reclaimedTime - startTime;
+			spawnSeconds += endTime - reclaimedTime;
+		}
+	}
+
+	uint measuredFrames = (frameCount > WARM_UP_FRAMES) ? frameCount - WARM_UP_FRAMES : 1U;
+	PrintBenchmarkResult("Entity churn: %u resident + %u/frame | spawn %.1f ns | reclaim %.1f ns | grew after warm up: %s", residentCount, waveSize,
+		spawnSeconds * 1e9 / ((double)measuredFrames * waveSize), reclaimSeconds * 1e9 / ((double)measuredFrames * waveSize),
+		(entities.GetCapacity() != warmCapacity) ? "yes" : "no");
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Broadphase + narrowphase over moving discs, timed single threaded and on g_jobScheduler
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::CollisionBenchmark(EventArgs& args)
+{
+	uint entityCount = (uint)args.GetValue("count", 50000);
+	uint frameCount = (uint)args.GetValue("frames", 60);
+	float radius = args.GetValue("radius", 0.25f);
+
+	EntityStore entities(entityCount);
+	uint32_t seed = 777U;
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		EntityDescT desc;
+		seed = seed * 1664525U + 1013904223U;
+		desc.position = Vec2((float)(seed >> 8) / 16777216.f * WORLD_WIDTH, (float)(seed & 0xFFFF) / 65536.f * WORLD_HEIGHT);
+		seed = seed * 1664525U + 1013904223U;
+		desc.velocity = Vec2((float)(seed >> 8) / 16777216.f * 20.f - 10.f, (float)(seed & 0xFFFF) / 65536.f * 20.f - 10.f);
+		desc.physicsRadius = radius;
+		entities.Spawn(desc);
+	}
+
+	SpatialHashGrid grid(Vec2(0.f, 0.f), Vec2(WORLD_WIDTH, WORLD_HEIGHT), radius * 2.f);
+	std::vector<CollisionPairT> pairs;
+
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		JobScheduler* scheduler = (runIndex == 0) ? nullptr : g_jobScheduler;
+		uint64_t contactCount = 0U;
+		double collisionSeconds = 0.0;
+
+		for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+		{
+			entities.Update(1.f / 60.f);
+
+			double startTime = GetCurrentTimeSeconds();
+			grid.Rebuild(entities.GetPositionsX(), entities.GetPositionsY(), entities.GetPhysicsRadii(), entities.GetCount());
+			pairs.clear();
+			grid.FindCandidatePairs(pairs, scheduler);
+			contactCount += SpatialHashGrid::FilterOverlappingPairs(entities.GetPositionsX(), entities.GetPositionsY(), entities.GetPhysicsRadii(), pairs);
+			collisionSeconds += GetCurrentTimeSeconds() - startTime;
+		}
+
+		PrintBenchmarkResult("Collision benchmark: %u entities | %s | %.3f ms/frame | %.1f contacts/frame", entityCount,
+			(scheduler == nullptr) ? "1 thread" : "job scheduler", collisionSeconds * 1000.0 / (double)frameCount, (double)contactCount / (double)frameCount);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Bins the scene's point lights and a field of random ones in front of a 60 degree camera into the default froxel grid, single
+// threaded and on g_jobScheduler, and reports how many lights a pixel would still walk. Only built here: no lit draw in the
+// frame binds the clusters yet, so the game does not build them per frame
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::LightClusterBenchmark(EventArgs& args)
+{
+	uint lightCount = (uint)args.GetValue("count", 4096);
+	uint frameCount = (uint)args.GetValue("frames", 60);
+	float radius = args.GetValue("radius", 2.f);
+
+	std::vector<Vec3> positions;
+	std::vector<float> radii;
+	g_lightManager->GatherPointLights(positions, radii);
+	size_t sceneLightCount = positions.size();
+	positions.resize(sceneLightCount + lightCount);
+	radii.resize(sceneLightCount + lightCount, radius);
+	lightCount = (uint)positions.size();
+
+	uint32_t seed = 4242U;
+	for (size_t lightIndex = sceneLightCount; lightIndex < positions.size(); ++lightIndex)
+	{
+		Vec3& position = positions[lightIndex];
+		seed = seed * 1664525U + 1013904223U;
+		position.x = (float)(seed >> 8) / 16777216.f * 100.f - 50.f;
+		seed = seed * 1664525U + 1013904223U;
+		position.y = (float)(seed >> 8) / 16777216.f * 20.f - 10.f;
+		seed = seed * 1664525U + 1013904223U;
+		position.z = (float)(seed >> 8) / 16777216.f * MAIN_CAMERA_FAR_Z;
+	}
+
+	LightClusterViewT view;
+	view.aspect = SCREEN_ASPECT;
+	view.nearZ = MAIN_CAMERA_NEAR_Z;
+	view.farZ = MAIN_CAMERA_FAR_Z;
+
+	LightClusterGrid grid;
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		JobScheduler* scheduler = (runIndex == 0) ? nullptr : g_jobScheduler;
+
+		double startTime = GetCurrentTimeSeconds();
+		for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+		{
+			grid.Build(view, positions.data(), radii.data(), lightCount, scheduler);
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		uint occupiedCount = 0U;
+		uint maxLights = 0U;
+		for (const LightClusterT& cluster : grid.GetClusters())
+		{
+			occupiedCount += (cluster.count > 0U) ? 1U : 0U;
+			maxLights = (cluster.count > maxLights) ? cluster.count : maxLights;
+		}
+
+		PrintBenchmarkResult("Light cluster benchmark: %u lights (%u visible) | %s | %.3f ms/frame | %.1f lights per lit cluster, %u at most | %zu KB",
+			lightCount, grid.GetVisibleLightCount(), (scheduler == nullptr) ? "1 thread" : "job scheduler", elapsedSeconds * 1000.0 / (double)frameCount,
+			(occupiedCount > 0U) ? (double)grid.GetLightIndices().size() / (double)occupiedCount : 0.0, maxLights, grid.GetUploadBytes() / 1024U);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::FrameAllocatorStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	PrintBenchmarkResult("Frame allocator: %zu bytes last frame | %zu bytes high water | %u threads | %u spills last frame",
+		g_frameAllocator->GetLastFrameBytes(), g_frameAllocator->GetHighWaterBytes(), g_frameAllocator->GetThreadCount(), g_frameAllocator->GetLastFrameSpillCount());
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Keeps count debug objects alive, points, lines, boxes and quads in every depth mode, and reports the cost of merging them
+// into the frame's vertex array and how many draws that leaves
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::DebugDrawBenchmark(EventArgs& args)
+{
+	uint objectCount = (uint)args.GetValue("count", 100000);
+	uint frameCount = (uint)args.GetValue("frames", 30);
+
+	DebugDrawBatch batch;
+	DebugRenderOptionsT options;
+	options.space = DEBUG_RENDER_WORLD;
+
+	uint32_t seed = 777U;
+	for (uint objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		Vec3 position = Vec3((float)(seed & 0xFFU) - 128.f, (float)((seed >> 8) & 0xFFU) - 128.f, (float)((seed >> 16) & 0xFFU));
+		uint modeIndex = objectIndex % 3U;
+		options.mode = (modeIndex == 0U) ? DEBUG_RENDER_USE_DEPTH : ((modeIndex == 1U) ? DEBUG_RENDER_XRAY : DEBUG_RENDER_ALWAYS);
+		options.beginColor = Rgba::GREEN;
+		options.endColor = Rgba::RED;
+
+		switch ((seed >> 24) % 4U)
+		{
+		case 0U:
+			batch.AddPoint(options, position, 1000.f);
+			break;
+		case 1U:
+			batch.AddLine(options, position, position + Vec3(1.f, 1.f, 0.f), 1000.f);
+			break;
+		case 2U:
+			batch.AddBox(options, position, Vec3(0.5f, 0.5f, 0.5f), 1000.f);
+			break;
+		default:
+			batch.AddQuad(options, position, Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f), 1000.f);
+			break;
+		}
+	}
+
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		JobScheduler* scheduler = (runIndex == 0) ? nullptr : g_jobScheduler;
+
+		double startTime = GetCurrentTimeSeconds();
+		for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+		{
+			batch.BeginFrame(0.f);
+			batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), scheduler);
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		PrintBenchmarkResult("Debug draw benchmark: %u objects | %s | %.3f ms/frame | %zu verts in %zu draws", batch.GetObjectCount(),
+			(scheduler == nullptr) ? "1 thread" : "job scheduler", elapsedSeconds * 1000.0 / (double)frameCount, batch.GetVerts().size(), batch.GetDraws().size());
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Fills a SpriteBatch with laborer and warrior sized sprites spread over a few sheets, reports the cost of building the batch
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::SpriteBatchBenchmark(EventArgs& args)
+{
+	uint spriteCount = (uint)args.GetValue("count", 100000);
+	uint frameCount = (uint)args.GetValue("frames", 30);
+
+	//Sheets are only compared, never bound, so stand ins are enough
+	int sheetKeys[4] = {};
+	SpriteFrameT frame;
+	frame.pivot = Vec2(0.5f, 0.25f);
+
+	SpriteBatch batch;
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		JobScheduler* scheduler = (runIndex == 0) ? nullptr : g_jobScheduler;
+
+		double startTime = GetCurrentTimeSeconds();
+		for (uint frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+		{
+			batch.Begin(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+			for (uint spriteIndex = 0; spriteIndex < spriteCount; ++spriteIndex)
+			{
+				TextureView* sheet = reinterpret_cast<TextureView*>(&sheetKeys[(spriteIndex >> 6) & 3U]);
+				Vec3 position((float)(spriteIndex & 511U) * 0.5f, 0.f, (float)(spriteIndex >> 9) * 0.5f);
+				batch.AddSprite(sheet, frame, position, Vec2(1.f, 1.f));
+			}
+			batch.Finish(scheduler);
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		PrintBenchmarkResult("Sprite batch benchmark: %u sprites | %s | %.3f ms/frame | %u draws", spriteCount,
+			(scheduler == nullptr) ? "1 thread" : "job scheduler", elapsedSeconds * 1000.0 / (double)frameCount, (uint)batch.GetDraws().size());
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Same layout CPUMeshAddUVSphere emits: rows of wedges + 1 vertices (the seam column is doubled for UVs), quads row by row
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddOptimizerTestSphere( std::vector<Vertex_PCU>& vertices, std::vector<uint>& indices, uint wedges, uint slices )
+{
+	for (uint slice = 0; slice <= slices; ++slice)
+	{
+		float latitude = -90.f + 180.f * (float)slice / (float)slices;
+		for (uint wedge = 0; wedge <= wedges; ++wedge)
+		{
+			float longitude = 360.f * (float)wedge / (float)wedges;
+			Vec3 position(CosDegrees(latitude) * CosDegrees(longitude), SinDegrees(latitude), CosDegrees(latitude) * SinDegrees(longitude));
+			vertices.push_back(Vertex_PCU(position, Rgba::WHITE, Vec2((float)wedge / (float)wedges, (float)slice / (float)slices)));
+		}
+	}
+
+	for (uint slice = 0; slice < slices; ++slice)
+	{
+		for (uint wedge = 0; wedge < wedges; ++wedge)
+		{
+			uint bottomLeft = slice * (wedges + 1U) + wedge;
+			uint topLeft = bottomLeft + wedges + 1U;
+			uint quad[6] = { bottomLeft, bottomLeft + 1U, topLeft + 1U, bottomLeft, topLeft + 1U, topLeft };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Optimizes a generator ordered UV sphere, reports the vertex cache ACMR before and after, then builds and times a LOD chain
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::MeshOptimizerBenchmark(EventArgs& args)
+{
+	uint wedges = (uint)args.GetValue("wedges", 64);
+	uint slices = (uint)args.GetValue("slices", 32);
+
+	std::vector<Vertex_PCU> vertices;
+	std::vector<uint> indices;
+	AddOptimizerTestSphere(vertices, indices, wedges, slices);
+
+	double startTime = GetCurrentTimeSeconds();
+	uint vertexCount = (uint)vertices.size();
+	MeshOptimizeStatsT stats = OptimizeMesh(vertices.data(), sizeof(Vertex_PCU), vertexCount, indices.data(), (uint)indices.size(), offsetof(Vertex_PCU, m_position));
+	double optimizeSeconds = GetCurrentTimeSeconds() - startTime;
+	vertices.resize(vertexCount);
+
+	PrintBenchmarkResult("Mesh optimizer benchmark: %u tris | ACMR %.3f -> %.3f (FIFO %u) | %u -> %u verts | %s indices | %.3f ms",
+		(uint)indices.size() / 3U, stats.acmrBefore, stats.acmrAfter, MESH_OPTIMIZER_FIFO_CACHE_SIZE, stats.vertexCountBefore, stats.vertexCountAfter,
+		CanUse16BitIndices(vertexCount) ? "16 bit" : "32 bit", optimizeSeconds * 1000.0);
+
+	std::vector<uint> lodIndices(indices.size());
+	for (uint lodIndex = 1; lodIndex < MESH_LOD_MAX_COUNT; ++lodIndex)
+	{
+		float lodError = 0.f;
+		startTime = GetCurrentTimeSeconds();
+		uint lodIndexCount = SimplifyMesh(lodIndices.data(), indices.data(), (uint)indices.size(), vertices.data(), sizeof(Vertex_PCU), vertexCount,
+			offsetof(Vertex_PCU, m_position), (uint)indices.size() / 6U * 3U, MESH_LOD_MAX_ERROR_FRACTION, &lodError);
+		double simplifySeconds = GetCurrentTimeSeconds() - startTime;
+
+		indices.assign(lodIndices.begin(), lodIndices.begin() + lodIndexCount);
+		stats = OptimizeMesh(vertices.data(), sizeof(Vertex_PCU), vertexCount, indices.data(), lodIndexCount, offsetof(Vertex_PCU, m_position));
+
+		PrintBenchmarkResult("  LOD%u: %u tris | %u verts | error %.4f | ACMR %.3f | %.3f ms", lodIndex, lodIndexCount / 3U, vertexCount, lodError,
+			stats.acmrAfter, simplifySeconds * 1000.0);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Runs every stage of the shaders GetandSetShaders loads through a ShaderCache twice. The first run compiles whatever is not
+// cached yet, the second has to be all hits. The engine still compiles these shaders from source, so this is what warm starts
+// would save once it takes bytecode
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::ShaderCacheBenchmark(EventArgs& args)
+{
+	UNUSED(args);
+#if defined(_WIN32)
+	//The paths GetandSetShaders loads, with each pass's source, defines and entry points read the way the engine reads them
+	const char* shaderPaths[3] = { "default_unlit.xml", "normal_shader.hlsl", "default_lit_PCUN.hlsl" };
+
+	std::vector<unsigned char> vertexCode;
+	std::vector<unsigned char> fragmentCode;
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		ShaderCache cache(CompileShaderWithD3D, D3D_SHADER_COMPILER_TAG);
+
+		double startTime = GetCurrentTimeSeconds();
+		for (int shaderIndex = 0; shaderIndex < 3; ++shaderIndex)
+		{
+			ShaderPassDescT pass;
+			if (ReadShaderPassDesc(shaderPaths[shaderIndex], pass))
+			{
+				cache.GetOrCompilePass(pass, vertexCode, fragmentCode);
+			}
+		}
+		double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+
+		PrintBenchmarkResult("Shader cache benchmark: run %d | %u compiled | %u from cache | %u failed | %.3f ms", runIndex + 1,
+			cache.GetCompileCount(), cache.GetHitCount(), cache.GetFailureCount(), elapsedSeconds * 1000.0);
+	}
+#else
+	g_devConsole->PrintString(Rgba::RED, "Shader cache benchmark needs the D3D shader compiler");
+#endif
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tests that start a scheduler, spawn threads or write files are priority 20, above the 10 StartUp runs. This runs every test
+// up to priority, 20 by default so those run too
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::RunUnitTests(EventArgs& args)
+{
+	uint priority = (uint)args.GetValue("priority", 20);
+	UnitTestRunAllCategories(priority);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string BinaryLogRoundTrip( const char* format, ... )
+{
+	eBinaryLogArg signature[MAX_BINARY_LOG_ARGS];
+	uint8_t argCount = 0U;
+	if (!BinaryLogParseFormat(format, signature, argCount))
+	{
+		return "";
+	}
+
+	unsigned char argBytes[MAX_BINARY_LOG_ARG_BYTES];
+	va_list args;
+	va_start(args, format);
+	uint32_t byteCount = BinaryLogEncodeArgs(signature, argCount, args, argBytes, MAX_BINARY_LOG_ARG_BYTES);
+	va_end(args);
+
+	return BinaryLogFormatArgs(format, signature, argCount, argBytes, byteCount);
+}
+
+UNITTEST("BinaryLogRoundTrip", "LoggingSystem", 0)
+{
+	std::string decoded = BinaryLogRoundTrip("Thread[%llu]: Printing Message %u %.2f %-*s|", 42ULL, 7U, 1.5, 5, "done");
+	CONFIRM(decoded == "Thread[42]: Printing Message 7 1.50 done |");
+	return true;
+}
+
+UNITTEST("BinaryLogRetiresThreadBuffers", "LoggingSystem", 20)
+{
+	BinaryLog log("Data/Cache/Tests/RetireThreadBuffers.binlog");
+	log.Startup();
+
+	//Each thread's ring is drained and handed on once it exits, the registry does not grow with the number of threads
+	const uint messageCount = 100U;
+	for (uint threadIndex = 0; threadIndex < 8U; ++threadIndex)
+	{
+		std::thread thread([&]()
+		{
+			for (uint messageIndex = 0; messageIndex < messageCount; ++messageIndex)
+			{
+				log.Logf("retire", "Thread %u message %u", threadIndex, messageIndex);
+			}
+		});
+		thread.join();
+
+		log.LogFlush();
+		CONFIRM(log.GetThreadBufferCount() == 0U);
+		CONFIRM(log.GetMessageCount() == (uint64_t)messageCount * (threadIndex + 1U));
+	}
+
+	log.Shutdown();
+	remove(log.GetLogFilePath().c_str());
+	return true;
+}
+
+UNITTEST("JobSchedulerSuccessors", "JobSystem", 20)
+{
+	JobScheduler scheduler(3);
+	scheduler.Startup();
+
+	std::atomic<uint64_t> sum(0);
+	scheduler.ParallelFor(0, 10000, 16, [&](uint begin, uint end)
+	{
+		uint64_t localSum = 0;
+		for (uint index = begin; index < end; ++index)
+		{
+			localSum += index;
+		}
+		sum += localSum;
+	});
+	CONFIRM(sum == 49995000);
+
+	//Generic job feeding a main thread successor, same shape as the Mandelbrot row + texture upload jobs
+	int value = 0;
+	int result = 0;
+	JobCounter counter;
+	FunctionJob* producer = new FunctionJob([&]() { value = 1; });
+	FunctionJob* consumer = new FunctionJob([&]() { result = (value == 1) ? 2 : -1; }, JOB_AFFINITY_MAIN);
+	producer->AddSuccessor(consumer);
+	producer->SetCounter(&counter);
+	consumer->SetCounter(&counter);
+	scheduler.Dispatch(producer);
+	scheduler.Dispatch(consumer);
+	scheduler.WaitForCounter(counter);
+	CONFIRM(result == 2);
+
+	scheduler.Shutdown();
+	return true;
+}
+
+UNITTEST("JobSchedulerShutdownCancels", "JobSystem", 20)
+{
+	//A MAIN job nobody processes, with a successor waiting on it, is cancelled by Shutdown along with its successor
+	std::shared_ptr<int> jobState = std::make_shared<int>(0);
+	JobCounter counter;
+	{
+		JobScheduler scheduler(1);
+		scheduler.Startup();
+
+		FunctionJob* pending = new FunctionJob([jobState]() { *jobState = 1; }, JOB_AFFINITY_MAIN);
+		FunctionJob* successor = new FunctionJob([jobState]() { *jobState = 2; });
+		pending->AddSuccessor(successor);
+		pending->SetCounter(&counter);
+		successor->SetCounter(&counter);
+		scheduler.Dispatch(pending);
+		scheduler.Dispatch(successor);
+
+		scheduler.Shutdown();
+		CONFIRM(scheduler.GetCancelledCount() == 2U);
+	}
+
+	CONFIRM(counter.IsDone());
+	CONFIRM(*jobState == 0);
+	CONFIRM(jobState.use_count() == 1);
+	return true;
+}
+
+UNITTEST("MandelbrotKernelsMatch", "JobSystem", 20)
+{
+	JobScheduler scheduler(2);
+	scheduler.Startup();
+
+	//Odd size so the SIMD paths hit their remainder lanes and partial tiles
+	MandelbrotViewT view;
+	view.maxIterations = 200;
+	MandelbrotGenerator reference(131, 67, 32);
+	MandelbrotGenerator generator(131, 67, 32);
+	reference.RunBenchmark(scheduler, view, MANDELBROT_KERNEL_SCALAR);
+
+	for (int kernelIndex = MANDELBROT_KERNEL_SSE; kernelIndex < NUM_MANDELBROT_KERNELS; ++kernelIndex)
+	{
+		if (MandelbrotGenerator::IsKernelSupported((eMandelbrotKernel)kernelIndex))
+		{
+			generator.RunBenchmark(scheduler, view, (eMandelbrotKernel)kernelIndex);
+			CONFIRM(memcmp(generator.GetPixels(), reference.GetPixels(), 131 * 67 * sizeof(uint32_t)) == 0);
+		}
+	}
+
+	//Progressive passes add up to the full render
+	generator.Start(view, true, MANDELBROT_KERNEL_SCALAR);
+	while (!generator.IsComplete())
+	{
+		generator.DispatchNextPass(scheduler);
+		generator.WaitForPass(scheduler);
+	}
+	CONFIRM(memcmp(generator.GetPixels(), reference.GetPixels(), 131 * 67 * sizeof(uint32_t)) == 0);
+
+	scheduler.Shutdown();
+	return true;
+}
+
+UNITTEST("DirtyRectUpload", "Renderer", 20)
+{
+	//A full grid of tiles coalesces into one update
+	DirtyRectTracker tracker(1024, 1024);
+	for (uint tileY = 0; tileY < 16; ++tileY)
+	{
+		for (uint tileX = 0; tileX < 16; ++tileX)
+		{
+			tracker.MarkDirty(ImageRegionT(tileX * 64, tileY * 64, tileX * 64 + 64, tileY * 64 + 64));
+		}
+	}
+	std::vector<ImageRegionT> regions;
+	tracker.ConsumeRegions(regions);
+	CONFIRM(regions.size() == 1 && regions[0].GetArea() == 1024 * 1024);
+
+	//Far apart regions stay separate, overlapping ones are not counted twice
+	tracker.MarkDirty(ImageRegionT(0, 0, 8, 8));
+	tracker.MarkDirty(ImageRegionT(512, 512, 520, 520));
+	tracker.MarkDirty(ImageRegionT(4, 4, 8, 8));
+	CONFIRM(tracker.GetDirtyTexelCount() == 128);
+	regions.clear();
+	tracker.ConsumeRegions(regions);
+	CONFIRM(regions.size() == 2 && !tracker.IsDirty());
+
+	//Staged bytes match the changed texels only
+	JobScheduler scheduler(2);
+	scheduler.Startup();
+
+	std::vector<uint32_t> source(64 * 64);
+	for (uint index = 0; index < 64 * 64; ++index)
+	{
+		source[index] = index;
+	}
+
+	DynamicTextureUploader uploader("DirtyRectUploadTest", 64, 64);
+	uploader.MarkDirty(ImageRegionT(8, 8, 24, 16));
+	CONFIRM(uploader.BeginStaging(scheduler, source.data(), 64));
+
+	bool texelsMatch = true;
+	size_t uploadBytes = uploader.Submit(scheduler, [&](const StagedRegionT& staged)
+	{
+		for (uint y = staged.region.minY; y < staged.region.maxY; ++y)
+		{
+			for (uint x = staged.region.minX; x < staged.region.maxX; ++x)
+			{
+				texelsMatch &= staged.texels[(y - staged.region.minY) * staged.region.GetWidth() + (x - staged.region.minX)] == source[y * 64 + x];
+			}
+		}
+	});
+	CONFIRM(texelsMatch && uploadBytes == 16 * 8 * sizeof(uint32_t) && uploader.GetLastRegionCount() == 1);
+
+	scheduler.Shutdown();
+	return true;
+}
+
+UNITTEST("EntityStoreUpdate", "Gameplay", 0)
+{
+	EntityStore entities;
+	entities.SetScreenBounds(Vec2(0.f, 0.f), Vec2(100.f, 100.f));
+
+	EntityDescT desc;
+	desc.position = Vec2(10.f, 10.f);
+	desc.velocity = Vec2(2.f, -4.f);
+	entities.Spawn(desc);
+	desc.position = Vec2(99.f, 50.f);
+	desc.velocity = Vec2(4.f, 0.f);
+	entities.Spawn(desc);
+	desc.position = Vec2(50.f, 50.f);
+	desc.velocity = Vec2(0.f, 0.f);
+	entities.Spawn(desc);
+
+	entities.Update(0.5f);
+	CONFIRM(entities.GetPosition(0).x == 11.f && entities.GetPosition(0).y == 8.f);
+	CONFIRM(!entities.IsOffScreen(0) && entities.IsOffScreen(1) && !entities.IsOffScreen(2));
+
+	//Swap remove moves the last entity into the hole
+	entities.MarkGarbage(entities.GetHandle(0));
+	CONFIRM(entities.RemoveGarbage() == 1 && entities.GetCount() == 2);
+	CONFIRM(entities.GetPosition(0).x == 50.f && entities.GetPosition(1).x == 101.f);
+
+	std::vector<Vertex_PCU> debugVerts;
+	entities.AddDebugVerts(debugVerts, true);
+	CONFIRM(debugVerts.size() == 2 * 48);
+	return true;
+}
+
+UNITTEST("SpatialHashPairs", "Gameplay", 0)
+{
+	//A small crowd checked against brute force, including discs outside the world that get clamped into border cells
+	const uint entityCount = 400;
+	std::vector<float> positionsX(entityCount);
+	std::vector<float> positionsY(entityCount);
+	std::vector<float> radii(entityCount);
+	uint32_t seed = 99U;
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		positionsX[entityIndex] = (float)(seed >> 8) / 16777216.f * 24.f - 2.f;
+		seed = seed * 1664525U + 1013904223U;
+		positionsY[entityIndex] = (float)(seed >> 8) / 16777216.f * 24.f - 2.f;
+		radii[entityIndex] = 0.2f + (float)(seed & 0xFF) / 255.f * 0.4f;
+	}
+
+	uint bruteForceCount = 0U;
+	for (uint entityA = 0; entityA < entityCount; ++entityA)
+	{
+		for (uint entityB = entityA + 1; entityB < entityCount; ++entityB)
+		{
+			float deltaX = positionsX[entityB] - positionsX[entityA];
+			float deltaY = positionsY[entityB] - positionsY[entityA];
+			float radiusSum = radii[entityA] + radii[entityB];
+			bruteForceCount += (deltaX * deltaX + deltaY * deltaY < radiusSum * radiusSum) ? 1U : 0U;
+		}
+	}
+
+	SpatialHashGrid grid(Vec2(0.f, 0.f), Vec2(20.f, 20.f), 0.5f);
+	grid.Rebuild(positionsX.data(), positionsY.data(), radii.data(), entityCount);
+	CONFIRM(grid.GetCellSize() >= 1.2f - 0.01f);
+
+	std::vector<CollisionPairT> pairs;
+	grid.FindCandidatePairs(pairs);
+	CONFIRM(SpatialHashGrid::FilterOverlappingPairs(positionsX.data(), positionsY.data(), radii.data(), pairs) == bruteForceCount);
+
+	//Nobody moved, so the second rebuild skips the sort
+	grid.Rebuild(positionsX.data(), positionsY.data(), radii.data(), entityCount);
+	CONFIRM(!grid.WasLastRebuildSorted() && grid.GetMovedCount() == 0);
+	return true;
+}
+
+UNITTEST("EntityHandles", "Gameplay", 0)
+{
+	EntityStore entities;
+	EntityDescT desc;
+	EntityHandle first = entities.Spawn(desc);
+	desc.position = Vec2(5.f, 5.f);
+	EntityHandle second = entities.Spawn(desc);
+
+	//Despawning the first moves the second into index 0, its handle follows it
+	CONFIRM(entities.MarkGarbage(first) && entities.MarkGarbage(first));
+	CONFIRM(entities.RemoveGarbage() == 1);
+	uint secondIndex = 99;
+	CONFIRM(entities.TryGetIndex(second, secondIndex) && secondIndex == 0 && entities.GetPosition(secondIndex).x == 5.f);
+
+	//The slot is reused with a new generation, the old handle stays dead
+	EntityHandle third = entities.Spawn(desc);
+	CONFIRM(third.slot == first.slot && !(third == first));
+	CONFIRM(!entities.IsValid(first) && !entities.MarkGarbage(first) && entities.IsValid(third));
+
+	//The pool hands back the most recently freed slot, and can be asked for a particular one
+	HandlePool pool;
+	uint32_t slots[4];
+	for (uint32_t& slot : slots)
+	{
+		slot = pool.AllocateSlot();
+	}
+	CONFIRM(pool.FreeSlot(slots[1]) && pool.FreeSlot(slots[3]) && !pool.FreeSlot(slots[3]));
+	CONFIRM(pool.AllocateSlot() == slots[3]);
+	CONFIRM(pool.ClaimSlot(6U) && !pool.ClaimSlot(6U) && pool.GetSlotCount() == 7U && pool.GetLiveCount() == 4U);
+	CONFIRM(pool.ClaimSlot(slots[1]) && pool.AllocateSlot() != slots[1]);
+	pool.FreeAllSlots();
+	CONFIRM(pool.GetLiveCount() == 0U && pool.AllocateSlot() == 0U && pool.GetGeneration(0U) == 1U);
+	return true;
+}
+
+UNITTEST("EntitySimulationDeterminism", "Gameplay", 20)
+{
+	//Small chunks so a few hundred entities still spread over every worker
+	EntityStore serialEntities;
+	EntityStore parallelEntities;
+	uint32_t serialSeed = 12345U;
+	uint32_t parallelSeed = 12345U;
+	SpawnSeededEntities(serialEntities, 700, serialSeed);
+	SpawnSeededEntities(parallelEntities, 700, parallelSeed);
+
+	//Every off screen entity despawns and spawns a replacement at the center, so handles and slots churn too
+	EntityChunkFunction respawnOffScreen = [](EntityStore& store, uint beginIndex, uint endIndex, EntityCommandBuffer& commands)
+	{
+		for (uint entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+		{
+			if (store.IsOffScreen(entityIndex))
+			{
+				EntityDescT desc;
+				desc.position = Vec2(WORLD_CENTER_X, WORLD_CENTER_Y);
+				desc.velocity = store.GetVelocity(entityIndex) * -1.f;
+				commands.Despawn(store.GetHandle(entityIndex));
+				commands.Spawn(desc);
+			}
+		}
+	};
+
+	JobScheduler scheduler(3);
+	scheduler.Startup();
+
+	FrameAllocator frameAllocator(1024U);
+	EntitySimulation serialSimulation(64, &frameAllocator);
+	EntitySimulation parallelSimulation(64, &frameAllocator);
+	for (uint frameIndex = 0; frameIndex < 300; ++frameIndex)
+	{
+		serialSimulation.Update(serialEntities, 1.f / 30.f, nullptr, respawnOffScreen);
+		parallelSimulation.Update(parallelEntities, 1.f / 30.f, &scheduler, respawnOffScreen);
+		frameAllocator.EndFrame();
+	}
+	scheduler.Shutdown();
+
+	uint count = serialEntities.GetCount();
+	CONFIRM(count == 700 && parallelEntities.GetCount() == count);
+	CONFIRM(memcmp(serialEntities.GetPositionsX(), parallelEntities.GetPositionsX(), count * sizeof(float)) == 0);
+	CONFIRM(memcmp(serialEntities.GetPositionsY(), parallelEntities.GetPositionsY(), count * sizeof(float)) == 0);
+	CONFIRM(memcmp(serialEntities.GetVelocitiesX(), parallelEntities.GetVelocitiesX(), count * sizeof(float)) == 0);
+	for (uint entityIndex = 0; entityIndex < count; ++entityIndex)
+	{
+		CONFIRM(serialEntities.GetHandle(entityIndex) == parallelEntities.GetHandle(entityIndex));
+	}
+	return true;
+}
+
+UNITTEST("TextRunCacheReuse", "Renderer", 0)
+{
+	//Fonts only exist with a render context; a null font still exercises the keying and eviction
+	BitmapFont* font = g_isHeadless ? nullptr : g_renderContext->CreateOrGetBitmapFontFromFile("SquirrelFixedFont");
+	TextRunCache cache(2U);
+
+	const std::vector<Vertex_PCU>& firstRun = cache.GetRun(font, Vec2(10.f, 10.f), 40.f, "Static HUD", Rgba::WHITE);
+	CONFIRM(font == nullptr || firstRun.size() == 6U * 10U);
+	CONFIRM(&cache.GetRun(font, Vec2(10.f, 10.f), 40.f, "Static HUD", Rgba::WHITE) == &firstRun);
+	CONFIRM(cache.GetHitCount() == 1U && cache.GetMissCount() == 1U);
+
+	//Any part of the key changing is a different run
+	cache.GetRun(font, Vec2(10.f, 10.f), 40.f, "Static HUD", Rgba::RED);
+	cache.GetRun(font, Vec2(10.f, 20.f), 40.f, "Static HUD", Rgba::WHITE);
+	cache.GetRun(font, Vec2(10.f, 10.f), 40.f, "Static HUD!", Rgba::WHITE);
+	CONFIRM(cache.GetRunCount() == 4U && cache.GetMissCount() == 4U);
+
+	//Only the run that is still drawn survives being idle
+	for (int frameIndex = 0; frameIndex < 4; ++frameIndex)
+	{
+		cache.GetRun(font, Vec2(10.f, 10.f), 40.f, "Static HUD", Rgba::WHITE);
+		cache.EndFrame();
+	}
+	CONFIRM(cache.GetRunCount() == 1U && cache.GetMissCount() == 4U);
+	return true;
+}
+
+UNITTEST("FontAtlasPacking", "Renderer", 0)
+{
+	//Fonts are only keys to the atlas, so two addresses stand in for real BitmapFonts
+	int fontKeys[2] = {};
+	const BitmapFont* fontA = reinterpret_cast<const BitmapFont*>(&fontKeys[0]);
+	const BitmapFont* fontB = reinterpret_cast<const BitmapFont*>(&fontKeys[1]);
+
+	FontAtlas atlas(128U, 2U);
+	uint pageA = atlas.AddPage("A.png", IntVec2(256, 256));
+	uint pageB = atlas.AddPage("B.png", IntVec2(64, 64));
+	for (int glyphIndex = 0; glyphIndex < 20; ++glyphIndex)
+	{
+		atlas.AddRect(fontA, pageA, IntVec2((glyphIndex % 8) * 32, (glyphIndex / 8) * 40), IntVec2(10 + glyphIndex, 40));
+	}
+	atlas.AddRect(fontB, pageB, IntVec2(0, 0), IntVec2(64, 64));
+	CONFIRM(atlas.Pack());
+
+	//Every rect plus its gutter inside the atlas and apart from the others
+	const std::vector<FontAtlasRectT>& rects = atlas.GetRects();
+	IntVec2 dimensions = atlas.GetDimensions();
+	for (size_t rectIndex = 0; rectIndex < rects.size(); ++rectIndex)
+	{
+		const FontAtlasRectT& rect = rects[rectIndex];
+		CONFIRM(rect.atlasMin.x >= 2 && rect.atlasMin.y >= 2);
+		CONFIRM(rect.atlasMin.x + rect.size.x + 2 <= dimensions.x && rect.atlasMin.y + rect.size.y + 2 <= dimensions.y);
+
+		for (size_t otherIndex = rectIndex + 1; otherIndex < rects.size(); ++otherIndex)
+		{
+			const FontAtlasRectT& other = rects[otherIndex];
+			bool isApart = rect.atlasMin.x + rect.size.x + 4 <= other.atlasMin.x || other.atlasMin.x + other.size.x + 4 <= rect.atlasMin.x
+				|| rect.atlasMin.y + rect.size.y + 4 <= other.atlasMin.y || other.atlasMin.y + other.size.y + 4 <= rect.atlasMin.y;
+			CONFIRM(isApart);
+		}
+	}
+
+	//A quad over glyph 9 of font A lands on the same texels in the atlas, a quad over empty page space is collapsed
+	const FontAtlasRectT& glyph = rects[9];
+	std::vector<Vertex_PCU> verts;
+	Vec2 cornersUV[6] = { Vec2(0.f, 0.f), Vec2(1.f, 0.f), Vec2(1.f, 1.f), Vec2(0.f, 0.f), Vec2(1.f, 1.f), Vec2(0.f, 1.f) };
+	for (const Vec2& corner : cornersUV)
+	{
+		Vec2 texel((float)glyph.sourceMin.x + corner.x * (float)glyph.size.x, (float)glyph.sourceMin.y + corner.y * (float)glyph.size.y);
+		verts.push_back(Vertex_PCU(Vec3(corner.x, corner.y, 0.f), Rgba::WHITE, Vec2(texel.x / 256.f, texel.y / 256.f)));
+	}
+	for (const Vec2& corner : cornersUV)
+	{
+		verts.push_back(Vertex_PCU(Vec3(corner.x, corner.y, 0.f), Rgba::WHITE, Vec2(0.99f + corner.x * 0.005f, 0.99f + corner.y * 0.005f)));
+	}
+
+	CONFIRM(atlas.RemapVerts(fontA, verts) == 1U);
+	for (int vertIndex = 0; vertIndex < 6; ++vertIndex)
+	{
+		float expectedX = (float)glyph.atlasMin.x + cornersUV[vertIndex].x * (float)glyph.size.x;
+		float expectedY = (float)glyph.atlasMin.y + cornersUV[vertIndex].y * (float)glyph.size.y;
+		CONFIRM(fabsf(verts[vertIndex].m_uvTexCoords.x * (float)dimensions.x - expectedX) < 0.01f);
+		CONFIRM(fabsf(verts[vertIndex].m_uvTexCoords.y * (float)dimensions.y - expectedY) < 0.01f);
+		CONFIRM(verts[6 + vertIndex].m_position.x == verts[6].m_position.x && verts[6 + vertIndex].m_position.y == verts[6].m_position.y);
+	}
+
+	CONFIRM(atlas.ContainsFont(fontB) && !atlas.ContainsFont(nullptr));
+	return true;
+}
+
+UNITTEST("SpriteBatchGrouping", "Renderer", 20)
+{
+	int sheetKeys[3] = {};
+	TextureView* sheets[3] = { reinterpret_cast<TextureView*>(&sheetKeys[0]), reinterpret_cast<TextureView*>(&sheetKeys[1]), reinterpret_cast<TextureView*>(&sheetKeys[2]) };
+
+	SpriteFrameT frame;
+	frame.uvMins = Vec2(0.25f, 0.5f);
+	frame.uvMaxs = Vec2(0.5f, 0.75f);
+	frame.pivot = Vec2(0.5f, 0.25f);
+
+	//Interleaved sheets, enough sprites that the scheduler splits the expansion
+	SpriteBatch serialBatch;
+	SpriteBatch parallelBatch;
+	JobScheduler scheduler(3);
+	scheduler.Startup();
+	for (int runIndex = 0; runIndex < 2; ++runIndex)
+	{
+		SpriteBatch& batch = (runIndex == 0) ? serialBatch : parallelBatch;
+		batch.Begin(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+		for (uint spriteIndex = 0; spriteIndex < 10000U; ++spriteIndex)
+		{
+			batch.AddSprite(sheets[spriteIndex % 3U], frame, Vec3((float)spriteIndex, 0.f, 0.f), Vec2(2.f, 4.f));
+		}
+		batch.Finish((runIndex == 0) ? nullptr : &scheduler);
+	}
+	scheduler.Shutdown();
+
+	//One draw per sheet in first use order, add order kept inside each draw
+	const std::vector<SpriteDrawT>& draws = serialBatch.GetDraws();
+	const std::vector<SpriteInstanceDataT>& instances = serialBatch.GetInstances();
+	CONFIRM(draws.size() == 3U && instances.size() == 10000U);
+	CONFIRM(draws[1].texture == sheets[1] && draws[1].firstInstance == 3334U && draws[1].instanceCount == 3333U);
+	CONFIRM(instances[draws[1].firstInstance + 1U].corner.x == 4.f - 1.f);
+
+	//Pivot on the position: a quarter of the way up, centered across
+	CONFIRM(instances[0].corner.x == -1.f && instances[0].corner.y == -1.f);
+	CONFIRM(instances[0].right.x == 2.f && instances[0].up.y == 4.f);
+	CONFIRM(instances[0].uvMins.x == 0.25f && instances[0].uvMaxs.y == 0.75f);
+
+	CONFIRM(memcmp(instances.data(), parallelBatch.GetInstances().data(), instances.size() * sizeof(SpriteInstanceDataT)) == 0);
+
+	//Iso sprites show the frame closest to their facing as the camera sees it. Looking down -z the camera's right is -x, so a
+	//sprite facing +x faces view left and one facing -z faces away
+	IsoSpriteFramesT isoFrames;
+	isoFrames.frames.resize(2U);
+	isoFrames.frames[1].uvMins = Vec2(0.5f, 0.f);
+	isoFrames.directions.push_back(Vec3(0.f, 0.f, 1.f));
+	isoFrames.directions.push_back(Vec3(-1.f, 0.f, 0.f));
+
+	SpriteBatch isoBatch;
+	isoBatch.Begin(Vec3(-1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, -1.f));
+	isoBatch.AddIsoSprite(sheets[0], isoFrames, Vec3(0.f, 0.f, 0.f), Vec3(1.f, 0.f, 0.f), Vec2(1.f, 1.f));
+	isoBatch.AddIsoSprite(sheets[0], isoFrames, Vec3(0.f, 0.f, 0.f), Vec3(0.f, 0.f, -1.f), Vec2(1.f, 1.f));
+	isoBatch.Finish();
+	CONFIRM(isoBatch.GetInstances()[0].uvMins.x == 0.5f && isoBatch.GetInstances()[1].uvMins.x == 0.f);
+	return true;
+}
+
+UNITTEST("CookedMeshRoundTrip", "Renderer", 20)
+{
+	std::vector<Vertex_PCU> vertices;
+	std::vector<uint> indices;
+	for (uint vertexIndex = 0; vertexIndex < 37U; ++vertexIndex)
+	{
+		vertices.push_back(Vertex_PCU(Vec3((float)vertexIndex, 1.f, 2.f), Rgba::WHITE, Vec2(0.5f, (float)vertexIndex)));
+		indices.push_back(36U - vertexIndex);
+	}
+
+	const char* cookedPath = "Data/Cache/Tests/RoundTrip.mesh";
+	uint64_t recipeHash = HashMeshRecipe("RoundTrip 37");
+	CONFIRM(WriteCookedMesh(cookedPath, recipeHash, COOKED_VERTEX_LAYOUT_PCU, vertices.data(), sizeof(Vertex_PCU), 37U, indices.data(), 37U));
+
+	MappedFile file;
+	CookedMeshViewT view;
+	CONFIRM(file.Open(cookedPath));
+	CONFIRM(ReadCookedMesh(file.GetData(), file.GetSize(), recipeHash, COOKED_VERTEX_LAYOUT_PCU, sizeof(Vertex_PCU), view));
+	CONFIRM(view.vertexCount == 37U && view.indexCount == 37U);
+	CONFIRM(((uintptr_t)view.vertices % COOKED_MESH_BLOB_ALIGNMENT) == 0U && ((uintptr_t)view.indices % COOKED_MESH_BLOB_ALIGNMENT) == 0U);
+	CONFIRM(memcmp(view.vertices, vertices.data(), 37U * sizeof(Vertex_PCU)) == 0 && memcmp(view.indices, indices.data(), 37U * sizeof(uint)) == 0);
+
+	//Anything that changed since cooking makes the file stale
+	CONFIRM(!ReadCookedMesh(file.GetData(), file.GetSize(), HashMeshRecipe("RoundTrip 38"), COOKED_VERTEX_LAYOUT_PCU, sizeof(Vertex_PCU), view));
+	CONFIRM(!ReadCookedMesh(file.GetData(), file.GetSize(), recipeHash, COOKED_VERTEX_LAYOUT_LIT, sizeof(Vertex_PCU), view));
+	CONFIRM(!ReadCookedMesh(file.GetData(), file.GetSize(), recipeHash, COOKED_VERTEX_LAYOUT_PCU, sizeof(Vertex_PCU) + 4U, view));
+	file.Close();
+
+	//A truncated file is rejected instead of read past its end
+	FILE* truncatedFile = fopen(cookedPath, "r+b");
+	CONFIRM(truncatedFile != nullptr);
+	fseek(truncatedFile, 0, SEEK_SET);
+	CookedMeshHeaderT header;
+	CONFIRM(fread(&header, sizeof(header), 1, truncatedFile) == 1);
+	header.indexCount = 1000000U;
+	fseek(truncatedFile, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, truncatedFile);
+	fclose(truncatedFile);
+
+	CONFIRM(file.Open(cookedPath));
+	CONFIRM(!ReadCookedMesh(file.GetData(), file.GetSize(), recipeHash, COOKED_VERTEX_LAYOUT_PCU, sizeof(Vertex_PCU), view));
+	file.Close();
+	remove(cookedPath);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("MeshOptimizerSphere", "Renderer", 0)
+{
+	std::vector<Vertex_PCU> vertices;
+	std::vector<uint> indices;
+	AddOptimizerTestSphere(vertices, indices, 32U, 16U);
+
+	//A duplicated vertex gets welded back into the original
+	vertices.push_back(vertices[indices[100]]);
+	indices[100] = (uint)vertices.size() - 1U;
+
+	uint vertexCount = (uint)vertices.size();
+	MeshOptimizeStatsT stats = OptimizeMesh(vertices.data(), sizeof(Vertex_PCU), vertexCount, indices.data(), (uint)indices.size(), offsetof(Vertex_PCU, m_position));
+	CONFIRM(vertexCount == (33U * 17U) && stats.vertexCountAfter == vertexCount);
+	CONFIRM(stats.acmrAfter < stats.acmrBefore && stats.acmrAfter < 0.8f);
+	CONFIRM(CanUse16BitIndices(vertexCount));
+
+	//Fetch order: the first use of every vertex comes in increasing order
+	uint nextNewVertex = 0U;
+	for (uint index : indices)
+	{
+		CONFIRM(index <= nextNewVertex);
+		nextNewVertex = std::max(nextNewVertex, index + 1U);
+	}
+
+	//Each LOD roughly halves the triangles, stays on the unit sphere and never grows the error past the limit
+	uint triangleCount = (uint)indices.size() / 3U;
+	std::vector<uint> lodIndices(indices.size());
+	float lodError = 0.f;
+	uint lodIndexCount = SimplifyMesh(lodIndices.data(), indices.data(), (uint)indices.size(), vertices.data(), sizeof(Vertex_PCU), vertexCount,
+		offsetof(Vertex_PCU, m_position), triangleCount / 2U * 3U, 0.05f, &lodError);
+	CONFIRM(lodIndexCount % 3U == 0U && lodIndexCount <= triangleCount / 2U * 3U + 6U && lodIndexCount >= triangleCount / 3U * 3U);
+	CONFIRM(lodError <= 0.05f);
+	for (uint index = 0; index < lodIndexCount; ++index)
+	{
+		CONFIRM(lodIndices[index] < vertexCount);
+	}
+
+	//Nothing collapses when no error is allowed on a curved surface
+	CONFIRM(SimplifyMesh(lodIndices.data(), indices.data(), (uint)indices.size(), vertices.data(), sizeof(Vertex_PCU), vertexCount,
+		offsetof(Vertex_PCU, m_position), 0U, 0.f) == (uint)indices.size());
+
+	CONFIRM(SelectMeshLod(MESH_LOD0_RADIUS_PIXELS * 2.f, 4U) == 0U);
+	CONFIRM(SelectMeshLod(MESH_LOD0_RADIUS_PIXELS * 0.5f, 4U) == 2U);
+	CONFIRM(SelectMeshLod(1.f, 4U) == 3U);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteShaderTestFile( const char* filePath, const char* text )
+{
+	CreateFoldersForFile(filePath);
+	FILE* file = fopen(filePath, "wb");
+	if (file != nullptr)
+	{
+		fputs(text, file);
+		fclose(file);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("ShaderCacheKeys", "Renderer", 20)
+{
+	const char* testFolder = "Data/Cache/Tests/Shaders/";
+	const char* whiteInclude = "#define COLOR float4(1,1,1,1)\n";
+	const char* redInclude = "#define COLOR float4(1,0,0,1)\n";
+	WriteShaderTestFile("Data/Cache/Tests/Shaders/test.hlsl", "#include \"test_include.hlsl\"\r\nfloat4 Main() { return COLOR; }\r\n");
+	WriteShaderTestFile("Data/Cache/Tests/Shaders/cycle.hlsl", "#include \"cycle.hlsl\"\n");
+
+	//Stands in for D3DCompile: the "bytecode" is everything it was given, and entry points named Broken fail
+	uint compilerCalls = 0U;
+	ShaderCompileFunction stubCompiler = [&compilerCalls](const std::string& source, const std::string& sourceName, const std::vector<ShaderDefineT>& defines,
+		const std::string& entryPoint, const std::string& target, std::vector<unsigned char>& outBytecode, std::string& outErrors)
+	{
+		compilerCalls++;
+		if (entryPoint == "Broken")
+		{
+			outErrors = sourceName + ": no entry point Broken";
+			return false;
+		}
+
+		std::string blob = source + target + entryPoint + std::to_string(defines.size());
+		outBytecode.assign(blob.begin(), blob.end());
+		return true;
+	};
+
+	std::vector<ShaderDefineT> defines = ParseShaderDefines(" DEFINE=VALUE; JUST_DEFINED ;;ETC");
+	CONFIRM(defines.size() == 3U && defines[0].name == "DEFINE" && defines[0].value == "VALUE" && defines[1].name == "JUST_DEFINED" && defines[1].value.empty());
+
+	std::string expanded;
+	ShaderCache cache(stubCompiler, "stub", testFolder);
+	ShaderCache otherCompiler(stubCompiler, "stub O0", testFolder);
+
+	//Whatever an earlier run cached would turn the cold compile below into a hit
+	const char* includeTexts[2] = { whiteInclude, redInclude };
+	for (const char* includeText : includeTexts)
+	{
+		WriteShaderTestFile("Data/Cache/Tests/Shaders/test_include.hlsl", includeText);
+		CONFIRM(cache.ExpandIncludes("Data/Cache/Tests/Shaders/test.hlsl", expanded));
+		remove(cache.GetCacheFilePath(cache.ComputeKey(expanded, ParseShaderDefines("A=1"), "Main", "ps_5_0")).c_str());
+		remove(cache.GetCacheFilePath(cache.ComputeKey(expanded, ParseShaderDefines("A=2"), "Main", "ps_5_0")).c_str());
+		remove(cache.GetCacheFilePath(cache.ComputeKey(expanded, ParseShaderDefines("A=1"), "Main", "vs_5_0")).c_str());
+		remove(otherCompiler.GetCacheFilePath(otherCompiler.ComputeKey(expanded, ParseShaderDefines("A=1"), "Main", "ps_5_0")).c_str());
+	}
+	WriteShaderTestFile("Data/Cache/Tests/Shaders/test_include.hlsl", whiteInclude);
+
+	CONFIRM(cache.ExpandIncludes("Data/Cache/Tests/Shaders/test.hlsl", expanded));
+	CONFIRM(expanded.find("#define COLOR") != std::string::npos && expanded.find("#line 2 \"Data/Cache/Tests/Shaders/test.hlsl\"") != std::string::npos);
+	CONFIRM(expanded.find('\r') == std::string::npos);
+	CONFIRM(!cache.ExpandIncludes("Data/Cache/Tests/Shaders/cycle.hlsl", expanded));
+
+	std::vector<unsigned char> coldBytecode;
+	std::vector<unsigned char> warmBytecode;
+	CONFIRM(cache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=1", "Main", "ps_5_0", coldBytecode));
+	CONFIRM(compilerCalls == 1U && cache.GetCompileCount() == 1U);
+
+	//A new cache over the same folder is a warm start: no compiler call, same bytes
+	ShaderCache warmCache(stubCompiler, "stub", testFolder);
+	CONFIRM(warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=1", "Main", "ps_5_0", warmBytecode));
+	CONFIRM(compilerCalls == 1U && warmCache.GetHitCount() == 1U && warmBytecode == coldBytecode);
+
+	//Every part of the key is a miss on its own
+	CONFIRM(warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=2", "Main", "ps_5_0", warmBytecode) && compilerCalls == 2U);
+	CONFIRM(warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=1", "Main", "vs_5_0", warmBytecode) && compilerCalls == 3U);
+	CONFIRM(otherCompiler.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=1", "Main", "ps_5_0", warmBytecode) && compilerCalls == 4U);
+
+	//Editing only the included file is a miss too
+	WriteShaderTestFile("Data/Cache/Tests/Shaders/test_include.hlsl", redInclude);
+	CONFIRM(warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "A=1", "Main", "ps_5_0", warmBytecode) && compilerCalls == 5U);
+	CONFIRM(warmBytecode != coldBytecode);
+
+	//Failures report the compiler's messages and are not cached
+	CONFIRM(!warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "", "Broken", "ps_5_0", warmBytecode));
+	CONFIRM(!warmCache.GetOrCompile("Data/Cache/Tests/Shaders/test.hlsl", "", "Broken", "ps_5_0", warmBytecode));
+	CONFIRM(compilerCalls == 7U && warmCache.GetFailureCount() == 2U && warmCache.GetLastErrors().find("Broken") != std::string::npos);
+	return true;
+}
+
+UNITTEST("CookedTextureRoundTrip", "Renderer", 20)
+{
+	//Odd sizes, so the chain has to drop a row or column on the way down
+	std::vector<unsigned char> texels(6U * 5U * 4U);
+	for (size_t texelIndex = 0; texelIndex < 6U * 5U; ++texelIndex)
+	{
+		texels[texelIndex * 4U + 0U] = (unsigned char)(texelIndex * 8U);
+		texels[texelIndex * 4U + 1U] = (unsigned char)(255U - texelIndex * 8U);
+		texels[texelIndex * 4U + 2U] = 128U;
+		texels[texelIndex * 4U + 3U] = (unsigned char)((texelIndex % 2U) * 255U);
+	}
+
+	std::vector<std::vector<unsigned char>> mips;
+	BuildTextureMipChain(texels.data(), 6U, 5U, true, mips);
+	CONFIRM(mips.size() == 3U && mips[1].size() == 3U * 2U * 4U && mips[2].size() == 4U);
+	//Flat color stays flat through the linear light average, alpha averages as stored
+	CONFIRM(mips[1][2] == 128U && mips[1][3] == 128U);
+
+	//Block compression stays close on a smooth gradient, and BC3 keeps the alpha BC1 drops
+	std::vector<unsigned char> gradient(8U * 8U * 4U);
+	for (uint texelIndex = 0; texelIndex < 64U; ++texelIndex)
+	{
+		gradient[texelIndex * 4U + 0U] = gradient[texelIndex * 4U + 1U] = gradient[texelIndex * 4U + 2U] = (unsigned char)(texelIndex * 4U);
+		gradient[texelIndex * 4U + 3U] = (unsigned char)(255U - texelIndex * 4U);
+	}
+	std::vector<unsigned char> blocks;
+	std::vector<unsigned char> decoded;
+	CompressTextureBC(COOKED_TEXTURE_FORMAT_BC3, gradient.data(), 8U, 8U, blocks);
+	DecompressTextureBC(COOKED_TEXTURE_FORMAT_BC3, blocks.data(), 8U, 8U, decoded);
+	CONFIRM(blocks.size() == 4U * 16U && decoded.size() == gradient.size());
+	int largestError = 0;
+	for (size_t byteIndex = 0; byteIndex < gradient.size(); ++byteIndex)
+	{
+		int error = abs((int)gradient[byteIndex] - (int)decoded[byteIndex]);
+		largestError = (error > largestError) ? error : largestError;
+	}
+	CONFIRM(largestError <= 12);
+	CompressTextureBC(COOKED_TEXTURE_FORMAT_BC1, gradient.data(), 8U, 8U, blocks);
+	CONFIRM(blocks.size() == 4U * 8U);
+
+	//Written, mapped and validated; a truncated copy is refused
+	const char* sourceBytes = "stands in for the png bytes";
+	uint64_t sourceHash = HashTextureSource(sourceBytes, strlen(sourceBytes));
+	CONFIRM(WriteCookedTexture("Data/Cache/Tests/Textures/Cooked/source.png.ctex", sourceHash, COOKED_TEXTURE_FORMAT_RGBA8, COOKED_TEXTURE_FLAG_ROWS_FLIPPED, mips, 6U, 5U));
+
+	MappedFile cookedFile;
+	CookedTextureViewT view;
+	uint64_t cookedHash = 0U;
+	CONFIRM(cookedFile.Open("Data/Cache/Tests/Textures/Cooked/source.png.ctex") && ReadCookedTexture(cookedFile.GetData(), cookedFile.GetSize(), view, &cookedHash));
+	CONFIRM(cookedHash == sourceHash && view.mipCount == 3U && view.mips[2].width == 1U && memcmp(view.mips[1].data, mips[1].data(), mips[1].size()) == 0);
+	CONFIRM(((uintptr_t)view.mips[1].data % COOKED_TEXTURE_BLOB_ALIGNMENT) == 0U);
+	CONFIRM(!ReadCookedTexture(cookedFile.GetData(), cookedFile.GetSize() - 1U, view));
+	cookedFile.Close();
+
+	//The streamer's default decode takes the cook when it matches the source bytes
+	FILE* sourceFile = fopen("Data/Cache/Tests/Textures/source.png", "wb");
+	CONFIRM(sourceFile != nullptr);
+	fwrite(sourceBytes, 1, strlen(sourceBytes), sourceFile);
+	fclose(sourceFile);
+
+	JobScheduler scheduler(1);
+	scheduler.Startup();
+	unsigned char firstTexel[4] = {};
+	CookedTextureViewT uploaded;
+	TextureStreamer::TextureUploadFunction uploadFunction = [&firstTexel, &uploaded](const std::string&, const CookedTextureViewT& uploadMips, Texture2D*&)
+	{
+		memcpy(firstTexel, uploadMips.mips[0].data + 4U, 4U);
+		uploaded = uploadMips;
+		return (TextureView*)(uintptr_t)0x100;
+	};
+	{
+		TextureStreamer streamer("Data/Cache/Tests/Textures/", 1024U, "Data/Cache/Tests/Textures/Cooked/");
+		streamer.SetUploadFunctions(uploadFunction, [](TextureView*, Texture2D*) {});
+
+		StreamedTexture* texture = streamer.RequestTexture(scheduler, "source.png");
+		streamer.WaitForDecodes();
+		CONFIRM(streamer.Update() == 1U && texture->IsResident() && texture->GetDimensions().x == 6 && texture->GetDimensions().y == 5);
+	}
+	CONFIRM(firstTexel[0] == 8U && firstTexel[1] == 247U && firstTexel[3] == 255U && uploaded.mipCount == 3U);
+
+	//A BC cook goes up as its blocks
+	std::vector<std::vector<unsigned char>> blockMips(1U, blocks);
+	CONFIRM(WriteCookedTexture("Data/Cache/Tests/Textures/Cooked/source.png.ctex", sourceHash, COOKED_TEXTURE_FORMAT_BC1, COOKED_TEXTURE_FLAG_ROWS_FLIPPED, blockMips, 8U, 8U));
+	{
+		TextureStreamer streamer("Data/Cache/Tests/Textures/", 1024U, "Data/Cache/Tests/Textures/Cooked/");
+		streamer.SetUploadFunctions(uploadFunction, [](TextureView*, Texture2D*) {});
+
+		streamer.RequestTexture(scheduler, "source.png");
+		streamer.WaitForDecodes();
+		CONFIRM(streamer.Update() == 1U && streamer.GetLastUploadBytes() == blocks.size());
+	}
+	scheduler.Shutdown();
+	CONFIRM(uploaded.format == COOKED_TEXTURE_FORMAT_BC1 && uploaded.mipCount == 1U && memcmp(firstTexel, blocks.data() + 4U, 4U) == 0);
+	return true;
+}
+
+UNITTEST("TextureStreamerPlaceholders", "Renderer", 20)
+{
+	JobScheduler scheduler(2);
+	scheduler.Startup();
+
+	//Stand ins for the engine: file names carry the image size, views are tagged pointers that are never dereferenced
+	TextureView* whiteView = (TextureView*)(uintptr_t)0x10;
+	TextureView* flatView = (TextureView*)(uintptr_t)0x20;
+	uint uploadCalls = 0U;
+	uint releaseCalls = 0U;
+
+	//One mip each, so a texture's bytes are its level 0
+	TextureStreamer::TextureDecodeFunction decodeFunction = [](const std::string& filePath, bool) -> DecodedTextureT*
+	{
+		uint size = 0U;
+		if (sscanf(filePath.c_str(), "Data/Images/%u.png", &size) != 1)
+		{
+			return nullptr;
+		}
+		std::vector<std::vector<unsigned char>> mipTexels(1U, std::vector<unsigned char>((size_t)size * size * 4U, 255U));
+		return CreateDecodedTexture(mipTexels, size, size);
+	};
+	TextureStreamer::TextureUploadFunction uploadFunction = [&uploadCalls](const std::string&, const CookedTextureViewT&, Texture2D*&)
+	{
+		uploadCalls++;
+		return (TextureView*)(uintptr_t)(0x100U * uploadCalls);
+	};
+	TextureStreamer::TextureReleaseFunction releaseFunction = [&releaseCalls](TextureView*, Texture2D*)
+	{
+		releaseCalls++;
+	};
+
+	{
+		TextureStreamer streamer("Data/Images/", 64U * 64U * 4U);
+		streamer.SetPlaceholder(TEXTURE_PLACEHOLDER_WHITE, whiteView);
+		streamer.SetPlaceholder(TEXTURE_PLACEHOLDER_FLAT, flatView);
+		streamer.SetDecodeFunction(decodeFunction);
+		streamer.SetUploadFunctions(uploadFunction, releaseFunction);
+
+		//Handles come back before any decode ran and sample the placeholder they asked for
+		StreamedTexture* color = streamer.RequestTexture(scheduler, "64.png");
+		StreamedTexture* normal = streamer.RequestTexture(scheduler, "32.png", TEXTURE_PLACEHOLDER_FLAT);
+		StreamedTexture* large = streamer.RequestTexture(scheduler, "128.png");
+		StreamedTexture* missing = streamer.RequestTexture(scheduler, "missing.png");
+		CONFIRM(streamer.RequestTexture(scheduler, "64.png") == color);
+		CONFIRM(color->GetView() == whiteView && normal->GetView() == flatView && !color->IsResident());
+
+		//Decoding alone uploads nothing, that waits for the frame
+		streamer.WaitForDecodes();
+		CONFIRM(uploadCalls == 0U && color->GetState() == STREAMED_TEXTURE_DECODED && missing->GetState() == STREAMED_TEXTURE_FAILED);
+
+		//The first texture fills the budget, the rest go out one frame each; a texture bigger than the budget still goes
+		CONFIRM(streamer.Update() == 1U && color->IsResident() && color->GetView() != whiteView && !normal->IsResident());
+		CONFIRM(streamer.GetLastUploadBytes() == 64U * 64U * 4U && streamer.GetPendingCount() == 2U);
+		CONFIRM(streamer.Update() == 1U && normal->IsResident() && !large->IsResident());
+		CONFIRM(streamer.Update() == 1U && large->IsResident() && large->GetDimensions().x == 128);
+		CONFIRM(streamer.Update() == 0U && streamer.GetPendingCount() == 0U);
+		CONFIRM(streamer.GetTotalUploadBytes() == (64U * 64U + 32U * 32U + 128U * 128U) * 4U);
+
+		//A file that never decodes keeps its placeholder
+		CONFIRM(missing->GetView() == whiteView && uploadCalls == 3U);
+	}
+
+	CONFIRM(releaseCalls == 3U);
+
+	//A loaded placeholder goes through the same decode and upload, is what new requests sample, and is released with the rest
+	{
+		TextureStreamer streamer("Data/Images/");
+		streamer.SetDecodeFunction(decodeFunction);
+		streamer.SetUploadFunctions(uploadFunction, releaseFunction);
+		TextureView* loadedView = streamer.LoadPlaceholder(TEXTURE_PLACEHOLDER_WHITE, "4.png");
+		CONFIRM(loadedView != nullptr && uploadCalls == 4U && streamer.RequestTexture(scheduler, "8.png")->GetView() == loadedView);
+		CONFIRM(streamer.LoadPlaceholder(TEXTURE_PLACEHOLDER_FLAT, "missing.png") == nullptr);
+		streamer.WaitForDecodes();
+	}
+	CONFIRM(releaseCalls == 4U);
+	scheduler.Shutdown();
+	return true;
+}
+
+UNITTEST("PackFileVirtualFileSystem", "Core", 20)
+{
+	//Text repeats and round trips; noise does not get smaller and is refused
+	std::string text;
+	for (uint lineIndex = 0; lineIndex < 64U; ++lineIndex)
+	{
+		text += "<Texture name=\"Data/Images/Test_StbiFlippedAndOpenGL.png\" index=\"" + std::to_string(lineIndex) + "\"/>\n";
+	}
+	std::vector<unsigned char> compressed;
+	std::vector<unsigned char> decompressed(text.size());
+	CONFIRM(CompressPackLZ((const unsigned char*)text.data(), text.size(), compressed) && compressed.size() < text.size() / 4U);
+	CONFIRM(DecompressPackLZ(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+	CONFIRM(memcmp(decompressed.data(), text.data(), text.size()) == 0);
+	CONFIRM(!DecompressPackLZ(compressed.data(), compressed.size() - 1U, decompressed.data(), decompressed.size()));
+
+	std::vector<unsigned char> noise(4096U);
+	uint noiseState = 0x12345678U;
+	for (unsigned char& noiseByte : noise)
+	{
+		noiseState = noiseState * 1664525U + 1013904223U;
+		noiseByte = (unsigned char)(noiseState >> 24U);
+	}
+	CONFIRM(!CompressPackLZ(noise.data(), noise.size(), compressed));
+
+	std::vector<PackSourceT> sources(3U);
+	sources[0].path = "Data/Gameplay/Packed.xml";
+	sources[0].bytes.assign(text.begin(), text.end());
+	sources[1].path = "Data/Images/Noise.png";
+	sources[1].bytes = noise;
+	sources[2].path = "Data/Gameplay/Empty.txt";
+	std::string error;
+	CONFIRM(WritePackFile("Data/Cache/Tests/Test.pak", sources, 0.125f, error));
+
+	//Any spelling of a packed path finds it; the stored entry is a span of the mapping itself
+	VirtualFileSystem fileSystem;
+	CONFIRM(fileSystem.MountPack("Data/Cache/Tests/Test.pak"));
+	FileSpanT span;
+	CONFIRM(fileSystem.ReadFile("./data\\IMAGES/noise.PNG", span) && span.size == noise.size() && memcmp(span.data, noise.data(), noise.size()) == 0);
+	CONFIRM(((uintptr_t)span.data % PACK_ENTRY_ALIGNMENT) == 0U);
+	CONFIRM(fileSystem.ReadFile("Data/Gameplay/Packed.xml", span) && span.size == text.size() && memcmp(span.data, text.data(), text.size()) == 0);
+	std::string packedText;
+	CONFIRM(fileSystem.ReadTextFile("Data/Gameplay/Packed.xml", packedText) && packedText == text);
+	CONFIRM(fileSystem.ReadTextFile("Data/Gameplay/Empty.txt", packedText) && packedText.empty());
+	CONFIRM(fileSystem.GetPackReadCount() == 4U && fileSystem.GetLooseReadCount() == 0U);
+
+	//Anything not packed comes off disk until the fallback is turned off. Spans of a loose file share one mapping, which goes
+	//with the last of them
+	CONFIRM(fileSystem.ReadFile("Data/Gameplay/GameConfig.xml", span) && span.size > 0U && fileSystem.GetLooseReadCount() == 1U);
+	FileSpanT sharedSpan;
+	CONFIRM(fileSystem.ReadFile("data/gameplay/gameconfig.xml", sharedSpan) && sharedSpan.data == span.data && fileSystem.GetMappedLooseFileCount() == 1U);
+	CONFIRM(fileSystem.ReadFile("Data/Gameplay/Packed.xml", span) && fileSystem.GetMappedLooseFileCount() == 1U);
+	sharedSpan = FileSpanT();
+	CONFIRM(fileSystem.GetMappedLooseFileCount() == 0U);
+	fileSystem.SetLooseFallback(false);
+	CONFIRM(!fileSystem.ReadTextFile("Data/Gameplay/GameConfig.xml", packedText));
+	CONFIRM(!fileSystem.ReadFile("Data/Gameplay/Missing.xml", span));
+	return true;
+}
+
+UNITTEST("LightClusterAssignment", "Renderer", 20)
+{
+	//Quadratic falloff reaches the cutoff at 16 units, linear at 255, constant never does
+	CONFIRM(fabsf(ComputeLightRadius(1.f, Vec3(0.f, 0.f, 1.f)) - 16.f) < 0.01f);
+	CONFIRM(fabsf(ComputeLightRadius(1.f, Vec3(1.f, 1.f, 0.f)) - 255.f) < 0.01f);
+	CONFIRM(ComputeLightRadius(1.f, Vec3(1.f, 0.f, 0.f)) == LIGHT_RADIUS_UNBOUNDED);
+	CONFIRM(ComputeLightRadius(0.f, Vec3(0.f, 0.f, 1.f)) == 0.f);
+
+	//Camera at (0,0,-10) looking down +Z, lights scattered around and behind it
+	LightClusterViewT view;
+	view.position = Vec3(0.f, 0.f, -10.f);
+	view.aspect = 16.f / 9.f;
+	view.farZ = 60.f;
+
+	const uint lightCount = 2000U;
+	std::vector<Vec3> positions(lightCount);
+	std::vector<float> radii(lightCount);
+	uint32_t seed = 99U;
+	for (uint lightIndex = 0; lightIndex < lightCount; ++lightIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		positions[lightIndex].x = (float)(seed >> 8) / 16777216.f * 80.f - 40.f;
+		seed = seed * 1664525U + 1013904223U;
+		positions[lightIndex].y = (float)(seed >> 8) / 16777216.f * 40.f - 20.f;
+		seed = seed * 1664525U + 1013904223U;
+		positions[lightIndex].z = (float)(seed >> 8) / 16777216.f * 80.f - 20.f;
+		radii[lightIndex] = (lightIndex % 100U == 0U) ? 0.f : 0.5f + (float)(lightIndex % 7U);
+	}
+
+	LightClusterGrid grid;
+	grid.Build(view, positions.data(), radii.data(), lightCount);
+	std::vector<LightClusterT> serialClusters = grid.GetClusters();
+	std::vector<uint32_t> serialIndices = grid.GetLightIndices();
+	CONFIRM(grid.GetVisibleLightCount() > 0U && grid.GetVisibleLightCount() < lightCount);
+
+	JobScheduler scheduler(3);
+	scheduler.Startup();
+	grid.Build(view, positions.data(), radii.data(), lightCount, &scheduler);
+	scheduler.Shutdown();
+	CONFIRM(grid.GetLightIndices() == serialIndices);
+	CONFIRM(memcmp(grid.GetClusters().data(), serialClusters.data(), serialClusters.size() * sizeof(LightClusterT)) == 0);
+
+	//Every light that reaches a point in the frustum is listed in that point's cluster
+	float tanHalfFovY = tanf(30.f * 3.14159265f / 180.f);
+	float tanHalfFovX = tanHalfFovY * view.aspect;
+	for (uint sampleIndex = 0; sampleIndex < 2000U; ++sampleIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		float ndcX = (float)(seed >> 8) / 16777216.f * 2.f - 1.f;
+		seed = seed * 1664525U + 1013904223U;
+		float ndcY = (float)(seed >> 8) / 16777216.f * 2.f - 1.f;
+		seed = seed * 1664525U + 1013904223U;
+		float depth = view.nearZ + (float)(seed >> 8) / 16777216.f * (view.farZ - view.nearZ);
+		Vec3 point(ndcX * tanHalfFovX * depth, ndcY * tanHalfFovY * depth, view.position.z + depth);
+
+		uint tileX = (uint)((ndcX + 1.f) * 0.5f * (float)grid.GetTileCountX());
+		uint tileY = (uint)((1.f - ndcY) * 0.5f * (float)grid.GetTileCountY());
+		tileX = (tileX >= grid.GetTileCountX()) ? grid.GetTileCountX() - 1U : tileX;
+		tileY = (tileY >= grid.GetTileCountY()) ? grid.GetTileCountY() - 1U : tileY;
+		const LightClusterT& cluster = grid.GetClusters()[grid.GetClusterIndex(tileX, tileY, (uint)grid.GetSliceForDepth(depth))];
+		const uint32_t* clusterLights = grid.GetLightIndices().data() + cluster.offset;
+
+		for (uint lightIndex = 0; lightIndex < lightCount; ++lightIndex)
+		{
+			Vec3 offset = positions[lightIndex] - point;
+			if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z < radii[lightIndex] * radii[lightIndex])
+			{
+				CONFIRM(std::find(clusterLights, clusterLights + cluster.count, lightIndex) != clusterLights + cluster.count);
+			}
+		}
+	}
+	return true;
+}
+
+UNITTEST("LightManagerDirtyRanges", "Renderer", 0)
+{
+	LightManager lights(8U);
+	std::vector<uint> rangeFirsts;
+	std::vector<uint> rangeCounts;
+	std::vector<LightDescT> buffer(8U);
+	LightManager::LightRangeUploadCallback upload = [&](uint firstSlot, uint slotCount, const LightDescT* submitted)
+	{
+		rangeFirsts.push_back(firstSlot);
+		rangeCounts.push_back(slotCount);
+		std::copy(submitted, submitted + slotCount, buffer.begin() + firstSlot);
+	};
+
+	LightDescT sun;
+	sun.isDirectional = true;
+	LightDescT point;
+	point.diffuseAttenuation = Vec3(0.f, 1.f, 0.f);
+	LightHandle sunHandle = lights.CreateLight(sun);
+	LightHandle pointHandles[4];
+	for (LightHandle& handle : pointHandles)
+	{
+		handle = lights.CreateLight(point);
+	}
+	CONFIRM(sunHandle.slot == 0U && pointHandles[3].slot == 4U);
+
+	//The first submit writes every slot, free ones as off. The buffer goes up whole whatever was written
+	CONFIRM(lights.Submit(upload) == LIGHT_BUFFER_HEADER_BYTES + 8U * LIGHT_BUFFER_BYTES_PER_LIGHT);
+	CONFIRM(rangeFirsts.size() == 1U && rangeCounts[0] == 8U);
+	CONFIRM(buffer[7].intensity == 0.f);
+
+	//Nothing changed, nothing sent, including a position set to what it already is
+	rangeFirsts.clear();
+	rangeCounts.clear();
+	CONFIRM(lights.SetPosition(pointHandles[0], point.position));
+	CONFIRM(lights.Submit(upload) == 0U && rangeFirsts.empty());
+
+	//Two runs: slots 1-2 and slot 4
+	lights.SetPosition(pointHandles[0], Vec3(1.f, 0.f, 0.f));
+	lights.SetPosition(pointHandles[1], Vec3(2.f, 0.f, 0.f));
+	lights.SetPosition(pointHandles[3], Vec3(4.f, 0.f, 0.f));
+	CONFIRM(lights.Submit(upload) == lights.GetLightBufferBytes() && lights.GetLastSlotCount() == 3U);
+	CONFIRM(rangeFirsts.size() == 2U && rangeFirsts[0] == 1U && rangeCounts[0] == 2U && rangeFirsts[1] == 4U && rangeCounts[1] == 1U);
+	CONFIRM(buffer[4].position.x == 4.f);
+
+	//Disabled and attenuated to nothing go out once as off, then moving them costs nothing
+	rangeFirsts.clear();
+	rangeCounts.clear();
+	lights.SetEnabled(pointHandles[0], false);
+	LightDescT faint = point;
+	faint.diffuseAttenuation = Vec3(1000.f, 0.f, 0.f);
+	faint.specularAttenuation = Vec3(1000.f, 0.f, 0.f);
+	lights.SetLight(pointHandles[2], faint);
+	lights.Submit(upload);
+	CONFIRM(buffer[1].intensity == 0.f && buffer[3].intensity == 0.f);
+	rangeFirsts.clear();
+	lights.SetPosition(pointHandles[0], Vec3(5.f, 0.f, 0.f));
+	lights.SetIntensity(pointHandles[2], 0.5f);
+	CONFIRM(lights.Submit(upload) == 0U && rangeFirsts.empty());
+
+	std::vector<Vec3> positions;
+	std::vector<float> radii;
+	lights.GatherPointLights(positions, radii);
+	CONFIRM(positions.size() == 2U);
+
+	//A destroyed light's handle is refused and the lowest free slot is reused with a new generation, even when a higher
+	//slot was freed after it
+	CONFIRM(lights.DestroyLight(pointHandles[1]) && lights.DestroyLight(pointHandles[3]));
+	CONFIRM(!lights.IsValid(pointHandles[1]) && !lights.SetPosition(pointHandles[1], Vec3::ZERO));
+	LightHandle reused = lights.CreateLight(point);
+	CONFIRM(reused.slot == pointHandles[1].slot && !(reused == pointHandles[1]));
+	CONFIRM(lights.GetLiveCount() == 4U);
+	return true;
+}
+
+UNITTEST("DebugDrawBatching", "Renderer", 0)
+{
+	FrameAllocator frameAllocator;
+	DebugDrawBatch batch(&frameAllocator);
+	DebugRenderOptionsT options;
+	options.beginColor = Rgba(1.f, 0.f, 0.f, 1.f);
+	options.endColor = Rgba(0.f, 0.f, 1.f, 1.f);
+
+	//Box placed by the CPU transform covers exactly its bounds
+	batch.AddBox(options, Vec3(1.f, 2.f, 3.f), Vec3(1.f, 0.5f, 2.f), 0.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	Vec3 mins = batch.GetVerts()[0].m_position;
+	Vec3 maxs = mins;
+	for (const Vertex_PCU& vert : batch.GetVerts())
+	{
+		mins = Vec3(std::min(mins.x, vert.m_position.x), std::min(mins.y, vert.m_position.y), std::min(mins.z, vert.m_position.z));
+		maxs = Vec3(std::max(maxs.x, vert.m_position.x), std::max(maxs.y, vert.m_position.y), std::max(maxs.z, vert.m_position.z));
+	}
+	CONFIRM(batch.GetVerts().size() == batch.GetShapeVertCount(DEBUG_SHAPE_BOX));
+	CONFIRM(mins.x == 0.f && mins.y == 1.5f && mins.z == 1.f && maxs.x == 2.f && maxs.y == 2.5f && maxs.z == 5.f);
+
+	//Zero duration lasts one frame, timed objects fade towards endColor
+	batch.EndFrame();
+	batch.BeginFrame(0.f);
+	CONFIRM(batch.GetObjectCount() == 0U);
+	batch.AddSphere(options, Vec3(0.f, 0.f, 0.f), 1.f, 2.f);
+	batch.BeginFrame(1.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	CONFIRM(batch.GetObjectCount() == 1U && batch.GetVerts()[0].m_color.r == 0.5f && batch.GetVerts()[0].m_color.b == 0.5f);
+	batch.BeginFrame(1.5f);
+	CONFIRM(batch.GetObjectCount() == 0U);
+
+	//Ten objects or ten thousand, the draw count only depends on the (space, pass, texture) mix
+	size_t drawCounts[2] = { 0U, 0U };
+	const uint objectCounts[2] = { 10U, 10000U };
+	TextureView* texture = (TextureView*)&batch;
+	for (uint runIndex = 0; runIndex < 2U; ++runIndex)
+	{
+		for (uint objectIndex = 0; objectIndex < objectCounts[runIndex]; ++objectIndex)
+		{
+			Vec3 position = Vec3((float)objectIndex, 0.f, 0.f);
+			options.mode = (objectIndex % 2U == 0U) ? DEBUG_RENDER_USE_DEPTH : DEBUG_RENDER_XRAY;
+			batch.AddPoint(options, position, 0.f, 0.1f, (objectIndex % 5U == 0U) ? texture : nullptr);
+			batch.AddLine(options, position, position + Vec3(0.f, 1.f, 0.f), 0.f);
+			batch.AddPoint2D(options, Vec2(position.x, 0.f), 0.f);
+		}
+		batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+		drawCounts[runIndex] = batch.GetDraws().size();
+		batch.EndFrame();
+		batch.BeginFrame(0.f);
+	}
+	CONFIRM(drawCounts[0] == drawCounts[1]);
+	//World: depth, xray hidden and xray visible, each with and without the texture. Screen: one
+	CONFIRM(drawCounts[1] == 7U);
+
+	//Ordered by space then pass, and the hidden xray copy is faded
+	batch.AddLine(options, Vec3(0.f, 0.f, 0.f), Vec3(1.f, 0.f, 0.f), 0.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	const std::vector<DebugDrawT>& draws = batch.GetDraws();
+	CONFIRM(draws.size() == 2U && draws[0].pass == DEBUG_DRAW_PASS_XRAY_HIDDEN && draws[1].pass == DEBUG_DRAW_PASS_XRAY_VISIBLE);
+	CONFIRM(batch.GetVerts()[draws[0].firstVert].m_color.a == DEBUG_DRAW_XRAY_HIDDEN_ALPHA);
+	batch.EndFrame();
+	batch.BeginFrame(0.f);
+
+	//Wire shapes and rings are line lists, kept out of the triangle draws they would otherwise share
+	options.mode = DEBUG_RENDER_USE_DEPTH;
+	batch.AddBox(options, Vec3(0.f, 0.f, 0.f), Vec3(1.f, 1.f, 1.f), 0.f);
+	batch.AddWireBox(options, Vec3(0.f, 0.f, 0.f), Vec3(1.f, 1.f, 1.f), 0.f);
+	batch.AddWireSphere(options, Vec3(0.f, 0.f, 0.f), 1.f, 0.f);
+	batch.AddRing2D(options, Vec2(0.f, 0.f), 10.f, 0.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	CONFIRM(batch.GetShapeVertCount(DEBUG_SHAPE_WIRE_BOX) == 24U && batch.GetShapeVertCount(DEBUG_SHAPE_WIRE_QUAD) == 8U);
+	CONFIRM(draws.size() == 3U && draws[0].topology == DEBUG_DRAW_TRIANGLES && draws[1].topology == DEBUG_DRAW_LINES && draws[2].topology == DEBUG_DRAW_LINES);
+	CONFIRM(draws[1].vertCount == batch.GetShapeVertCount(DEBUG_SHAPE_WIRE_BOX) + batch.GetShapeVertCount(DEBUG_SHAPE_WIRE_SPHERE));
+	CONFIRM(draws[2].space == DEBUG_DRAW_SCREEN && draws[2].vertCount == batch.GetShapeVertCount(DEBUG_SHAPE_RING));
+	batch.EndFrame();
+	batch.BeginFrame(0.f);
+
+	//An arrow is its shaft and a head that ends on the tip, drawn together
+	batch.AddArrow2D(options, Vec2(0.f, 0.f), Vec2(100.f, 0.f), 0.f, 5.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	float tipX = 0.f;
+	for (const Vertex_PCU& vert : batch.GetVerts())
+	{
+		tipX = std::max(tipX, vert.m_position.x);
+	}
+	CONFIRM(batch.GetObjectCount() == 2U && draws.size() == 1U && draws[0].topology == DEBUG_DRAW_TRIANGLES && tipX == 100.f);
+	batch.EndFrame();
+	batch.BeginFrame(0.f);
+
+	//Text is kept without a font but not drawn
+	batch.AddText2D(options, Vec2(0.f, 0.f), Vec2(0.5f, 0.5f), "No font", 16.f, 0.f);
+	batch.AddText(options, Vec3(0.f, 0.f, 0.f), Vec2(0.5f, 0.5f), "Timed", 0.1f, 1.f);
+	batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+	CONFIRM(batch.GetTextCount() == 2U && draws.empty());
+	batch.EndFrame();
+	CONFIRM(batch.GetTextCount() == 1U);
+	return true;
+}
+
+UNITTEST("DebugDrawFrameArena", "DebugRender", 0)
+{
+	//Aligned, and a frame that does not fit spills then grows the block for the next one
+	FrameArena arena(64U);
+	void* first = arena.Allocate(3U, 1U);
+	void* aligned = arena.Allocate(8U, 16U);
+	CONFIRM(first != nullptr && ((uintptr_t)aligned & 15U) == 0U);
+	arena.Allocate(200U);
+	CONFIRM(arena.GetSpillCount() == 1U);
+	arena.Reset();
+	CONFIRM(arena.GetUsedBytes() == 0U && arena.GetCapacityBytes() >= arena.GetHighWaterBytes());
+	uint length = 0U;
+	const char* text = arena.Format(length, "Light %d of %d", 3, 4);
+	CONFIRM(length == 12U && strcmp(text, "Light 3 of 4") == 0 && arena.GetSpillCount() == 0U);
+
+	//One frame objects and log lines go at EndFrame, timed ones stay until they expire
+	FrameAllocator frameAllocator(1024U);
+	DebugDrawBatch batch(&frameAllocator);
+	DebugRenderOptionsT options;
+	batch.AddPoint(options, Vec3::ZERO, 5.f);
+	batch.AddLogLine(Rgba::WHITE, 5.f, "Timed %s", "line");
+	for (uint frameIndex = 0; frameIndex < 8U; ++frameIndex)
+	{
+		batch.BeginFrame(0.1f);
+		for (uint pointIndex = 0; pointIndex < 200U; ++pointIndex)
+		{
+			batch.AddPoint(options, Vec3((float)pointIndex, 0.f, 0.f), 0.f);
+		}
+		batch.AddLogLine(Rgba::YELLOW, 0.f, "Current Time %f", (float)frameIndex);
+		batch.Finish(Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f));
+		CONFIRM(batch.GetObjectCount() == 201U && batch.GetFrameObjectCount() == 200U && batch.GetLogLineCount() == 2U);
+		CONFIRM(batch.GetVerts().size() == 201U * batch.GetShapeVertCount(DEBUG_SHAPE_QUAD));
+
+		batch.EndFrame();
+		frameAllocator.EndFrame();
+		CONFIRM(batch.GetObjectCount() == 1U && batch.GetLogLineCount() == 1U);
+
+		//The first frame on each of the two arenas grows it, after that the same frame fits without spilling
+		CONFIRM(frameAllocator.GetLastFrameBytes() > 0U);
+		CONFIRM(frameIndex < 2U || frameAllocator.GetLastFrameSpillCount() == 0U);
+	}
+	return true;
+}
+
+UNITTEST("FrameAllocatorThreads", "Memory", 20)
+{
+	FrameAllocator allocator(1024U);
+	JobScheduler scheduler(3U);
+	scheduler.Startup();
+
+	//Every worker fills its own arena, the main thread reads the results on the next frame
+	const uint itemCount = 64U;
+	std::vector<uint*> frameResults(itemCount, nullptr);
+	bool isLastFrameIntact = true;
+	for (uint frameIndex = 0; frameIndex < 6U; ++frameIndex)
+	{
+		std::vector<uint*> lastResults = frameResults;
+		scheduler.ParallelFor(0U, itemCount, 1U, [&](uint beginItem, uint endItem)
+		{
+			for (uint itemIndex = beginItem; itemIndex < endItem; ++itemIndex)
+			{
+				FrameVector<uint> values{ FrameStdAllocator<uint>(&allocator) };
+				for (uint valueIndex = 0; valueIndex < 100U; ++valueIndex)
+				{
+					values.push_back(frameIndex * 1000U + itemIndex);
+				}
+				uint* result = allocator.AllocateArray<uint>(1U);
+				*result = values.back();
+				frameResults[itemIndex] = result;
+			}
+		});
+
+		//Double buffered, last frame's data survives this frame's allocations
+		for (uint itemIndex = 0; frameIndex > 0U && itemIndex < itemCount; ++itemIndex)
+		{
+			isLastFrameIntact = isLastFrameIntact && *lastResults[itemIndex] == (frameIndex - 1U) * 1000U + itemIndex;
+		}
+		allocator.EndFrame();
+	}
+	scheduler.Shutdown();
+
+	CONFIRM(isLastFrameIntact);
+	CONFIRM(allocator.GetThreadCount() >= 1U && allocator.GetLastFrameBytes() > 0U);
+	CONFIRM(allocator.GetHighWaterBytes() >= allocator.GetLastFrameBytes());
+
+	//Once both of a thread's arenas have grown to fit, the same frame makes no heap allocations
+	FrameAllocator mainAllocator(1024U);
+	for (uint frameIndex = 0; frameIndex < 4U; ++frameIndex)
+	{
+		FrameString text{ FrameStdAllocator<char>(&mainAllocator) };
+		for (uint lineIndex = 0; lineIndex < 100U; ++lineIndex)
+		{
+			text += "Frame memory line ";
+		}
+		mainAllocator.AllocateArray<Vertex_PCU>(256U);
+		mainAllocator.EndFrame();
+	}
+	CONFIRM(mainAllocator.GetLastFrameSpillCount() == 0U && mainAllocator.GetHighWaterBytes() >= 100U * 18U);
+
+	//A thread that goes back and forth between allocators keeps one pair of arenas in each
+	FrameAllocator otherAllocator(1024U);
+	for (uint switchIndex = 0; switchIndex < 4U; ++switchIndex)
+	{
+		mainAllocator.Allocate(16U);
+		otherAllocator.Allocate(16U);
+	}
+	CONFIRM(mainAllocator.GetThreadCount() == 1U && otherAllocator.GetThreadCount() == 1U);
+
+	//Without an allocator the adaptor is a plain heap allocator
+	FrameVector<int> heapValues{ FrameStdAllocator<int>(nullptr) };
+	heapValues.assign(10U, 7);
+	CONFIRM(heapValues.size() == 10U && heapValues[9] == 7);
+	return true;
+}
+
+UNITTEST("RecordingRenderBackend", "Renderer", 0)
+{
+	RenderRecorder recorder;
+	RecordingRenderBackend backend(&recorder);
+	uint tagCount = recorder.GetTagCount();
+
+	Vertex_PCU verts[6];
+	recorder.BeginFrame();
+	backend.ClearColorTargets(Rgba::BLACK);
+	backend.DrawVertexArray("UIText", verts, 6U);
+	backend.DrawVertexArray("UIText", verts, 3U);
+	backend.DrawMesh("Meshes", nullptr);
+	recorder.EndFrame();
+
+	CONFIRM(recorder.GetFrameRecord("Clear").drawCalls == 1U);
+	CONFIRM(recorder.GetFrameRecord("UIText").drawCalls == 2U && recorder.GetFrameRecord("UIText").vertexCount == 9U);
+	CONFIRM(recorder.GetFrameTotals().drawCalls == 4U);
+
+	//The same tag text from another pointer is the same tag, one new tag per kind of draw
+	std::string uiTag = "UIText";
+	recorder.RecordDraw(uiTag.c_str(), 6U);
+	CONFIRM(recorder.GetTagCount() == tagCount + 2U);
+	CONFIRM(recorder.GetRunRecord("UIText").drawCalls == 3U);
+
+	recorder.ResetRunTotals();
+	CONFIRM(recorder.GetRunRecord("UIText").drawCalls == 0U && recorder.GetTagCount() == tagCount + 2U);
+
+	//A region update sends the region, not the texture it lands in
+	std::vector<uint32_t> texels(64 * 64, 0xFF000000U);
+	Texture2D* texture = nullptr;
+	recorder.BeginFrame();
+	CONFIRM(backend.CreateUpdatableTexture("RegionTexture", 64, 64, texels.data(), texture) == nullptr && texture == nullptr);
+	backend.UpdateTextureRegion("RegionTexture", texture, ImageRegionT(8, 8, 24, 16), texels.data());
+	recorder.EndFrame();
+	CONFIRM(recorder.GetFrameRecord("RegionTexture").uploadCount == 2U);
+	CONFIRM(recorder.GetFrameRecord("RegionTexture").uploadBytes == (64 * 64 + 16 * 8) * sizeof(uint32_t));
+	return true;
+}
+
+UNITTEST("CallstackTableDedupe", "LoggingSystem", 0)
+{
+	CallstackTable callstacks;
+
+	//Same call site every iteration, so only one callstack gets stored and nothing is symbolized yet
+	uint32_t firstID = INVALID_CALLSTACK_ID;
+	for (uint i = 0; i < 100; ++i)
+	{
+		uint32_t callstackID = callstacks.Capture();
+		if (firstID == INVALID_CALLSTACK_ID)
+		{
+			firstID = callstackID;
+		}
+		CONFIRM(callstackID == firstID);
+	}
+	CONFIRM(callstacks.GetCallstackCount() == 1);
+	CONFIRM(callstacks.GetResolvedAddressCount() == 0);
+
+	CONFIRM(!callstacks.ResolveToString(firstID).empty());
+	CONFIRM(callstacks.GetResolvedAddressCount() > 0);
+	return true;
+}
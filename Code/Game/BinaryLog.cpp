@@ -0,0 +1,711 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/BinaryLog.hpp"
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <algorithm>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+BinaryLog* g_binaryLog = nullptr;
+
+//Number of frames skipped so the callstack starts at the LogCallstackf caller (LogMessage, LogCallstackf)
+constexpr uint32_t BINARY_LOG_CALLSTACK_SKIP_FRAMES = 2U;
+//Writer thread wakes at least this often to push pending records to disk
+constexpr int BINARY_LOG_WRITE_INTERVAL_MS = 10;
+//Records younger than this stay staged so a slower thread can still slot older records in ahead of them
+constexpr uint64_t BINARY_LOG_MERGE_HOLDBACK_NS = 2000000U;
+//Direct mapped per thread caches of interned IDs (power of two)
+constexpr uint32_t BINARY_LOG_THREAD_CACHE_SIZE = 64U;
+//A producer checks if its ring is half full (and wakes the writer) once every this many messages
+constexpr uint32_t BINARY_LOG_WAKE_CHECK_INTERVAL = 64U;
+
+static std::atomic<uint64_t> s_nextLogGeneration(1U);
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BinaryLogThreadCacheT
+{
+	//Runs at thread exit. The ring stays alive through bufferOwner until the writer has drained it
+	~BinaryLogThreadCacheT()
+	{
+		if (buffer != nullptr)
+		{
+			buffer->Retire();
+		}
+	}
+
+	uint64_t							generation = 0U;
+	std::shared_ptr<LogThreadBuffer>	bufferOwner;
+	LogThreadBuffer*					buffer = nullptr;
+	uint32_t							messageCount = 0U;
+
+	const char*							filterKeys[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+	const BinaryLogFilterEntryT*		filters[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+	const char*							formatKeys[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+	const BinaryLogFormatEntryT*		formats[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+	uint64_t							callstackHashes[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+	uint32_t							callstackIDs[BINARY_LOG_THREAD_CACHE_SIZE] = {};
+};
+
+static thread_local BinaryLogThreadCacheT t_binaryLogCache;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint32_t GetCacheSlot( const void* key )
+{
+	uint64_t hash = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)(hash >> 58) & (BINARY_LOG_THREAD_CACHE_SIZE - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+BinaryLog::BinaryLog( const std::string& logFilePath )
+	: m_logFilePath(logFilePath),
+	m_isRunning(false),
+	m_bytesWritten(0U)
+{
+	m_startTime = std::chrono::steady_clock::now();
+
+	for (uint32_t filterIndex = 0; filterIndex < MAX_BINARY_LOG_FILTERS; ++filterIndex)
+	{
+		m_filterEnabled[filterIndex].store(true, std::memory_order_relaxed);
+	}
+}
+
+BinaryLog::~BinaryLog()
+{
+	Shutdown();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string BinaryLog::MakeTimestampedLogPath( const char* pathPrefix )
+{
+	time_t now = time(nullptr);
+	struct tm localTime;
+#if defined(_WIN32)
+	localtime_s(&localTime, &now);
+#else
+	localtime_r(&now, &localTime);
+#endif
+
+	char timeString[64];
+	strftime(timeString, sizeof(timeString), "_%d-%m-%Y_%H-%M-%S.blog", &localTime);
+	return std::string(pathPrefix) + timeString;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::Startup()
+{
+	if (m_isRunning)
+	{
+		return;
+	}
+
+	m_logFile = fopen(m_logFilePath.c_str(), "wb");
+	if (m_logFile == nullptr)
+	{
+		printf("\n >> Error opening binary log file %s ", m_logFilePath.c_str());
+		return;
+	}
+
+	BinaryLogFileHeaderT header;
+	header.startTimeSinceEpochMS = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	fwrite(&header, sizeof(header), 1, m_logFile);
+	m_bytesWritten += sizeof(header);
+
+	//Thread caches from an older log instance see a different generation and re-register
+	m_generation = s_nextLogGeneration++;
+
+	//Messages whose format cannot be stored raw are formatted at the call site and logged through "%s"
+	m_preformattedEntry = InternFormat("%s");
+
+	m_isRunning = true;
+	m_writerThread = std::thread(&BinaryLog::WriterThreadMain, this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_signalLock);
+		if (!m_isRunning)
+		{
+			return;
+		}
+		m_isRunning = false;
+	}
+
+	//The writer drains every ring one last time before it exits
+	m_writerSignal.notify_all();
+	m_writerThread.join();
+
+	uint64_t droppedCount = GetDroppedCount();
+	if (droppedCount > 0U)
+	{
+		printf("\n >> Binary log dropped %llu messages (thread buffers full) ", (unsigned long long)droppedCount);
+	}
+
+	fclose(m_logFile);
+	m_logFile = nullptr;
+
+	std::lock_guard<std::mutex> lock(m_internLock);
+	m_staging.clear();
+	m_threadBuffers.clear();
+	m_freeBuffers.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::Logf( const char* filter, const char* format, ... )
+{
+	va_list args;
+	va_start(args, format);
+	LogMessage(filter, false, format, args);
+	va_end(args);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogCallstackf( const char* filter, const char* format, ... )
+{
+	va_list args;
+	va_start(args, format);
+	LogMessage(filter, true, format, args);
+	va_end(args);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogMessage( const char* filter, bool captureCallstack, const char* format, va_list args )
+{
+	if (!m_isRunning.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	BinaryLogThreadCacheT& cache = GetThreadCache();
+
+	//Filter ID and enabled state
+	uint32_t filterSlot = GetCacheSlot(filter);
+	const BinaryLogFilterEntryT* filterEntry = cache.filters[filterSlot];
+	if (cache.filterKeys[filterSlot] != filter || strcmp(filterEntry->name.c_str(), filter) != 0)
+	{
+		filterEntry = InternFilter(filter);
+		cache.filterKeys[filterSlot] = filter;
+		cache.filters[filterSlot] = filterEntry;
+	}
+
+	if (!m_filterEnabled[filterEntry->id].load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	BinaryLogMessageT message;
+	message.timestampNS = GetTimestampNS();
+	message.threadID = cache.buffer->GetThreadID();
+	message.filterID = filterEntry->id;
+
+	//Format ID and raw arguments
+	uint32_t formatSlot = GetCacheSlot(format);
+	const BinaryLogFormatEntryT* formatEntry = cache.formats[formatSlot];
+	if (cache.formatKeys[formatSlot] != format || strcmp(formatEntry->text.c_str(), format) != 0)
+	{
+		formatEntry = InternFormat(format);
+		cache.formatKeys[formatSlot] = format;
+		cache.formats[formatSlot] = formatEntry;
+	}
+
+	unsigned char argBytes[MAX_BINARY_LOG_ARG_BYTES];
+	if (formatEntry->isEncodable)
+	{
+		message.argByteCount = (uint16_t)BinaryLogEncodeArgs(formatEntry->signature, formatEntry->argCount, args, argBytes, MAX_BINARY_LOG_ARG_BYTES);
+	}
+	else
+	{
+		//Fall back to formatting here and storing the text as a single string argument
+		char formatted[MAX_BINARY_LOG_STRING_ARG_LENGTH + 1U];
+		vsnprintf(formatted, sizeof(formatted), format, args);
+
+		uint16_t length = (uint16_t)strlen(formatted);
+		memcpy(argBytes, &length, sizeof(length));
+		memcpy(argBytes + sizeof(length), formatted, length);
+		message.argByteCount = (uint16_t)(sizeof(length) + length);
+		formatEntry = m_preformattedEntry;
+	}
+	message.formatID = formatEntry->id;
+
+	//Callstack ID
+	if (captureCallstack)
+	{
+		void* frames[MAX_BINARY_LOG_CALLSTACK_FRAMES];
+		uint32_t frameCount = CaptureRawCallstack(frames, MAX_BINARY_LOG_CALLSTACK_FRAMES, BINARY_LOG_CALLSTACK_SKIP_FRAMES);
+		if (frameCount > 0U)
+		{
+			uint64_t hash = HashCallstack(frames, frameCount);
+			uint32_t callstackSlot = (uint32_t)hash & (BINARY_LOG_THREAD_CACHE_SIZE - 1U);
+			if (cache.callstackHashes[callstackSlot] != hash)
+			{
+				cache.callstackHashes[callstackSlot] = hash;
+				cache.callstackIDs[callstackSlot] = InternCallstack(hash, frames, frameCount);
+			}
+			message.callstackID = cache.callstackIDs[callstackSlot];
+		}
+	}
+
+	unsigned char header[sizeof(eBinaryLogChunk) + sizeof(BinaryLogMessageT)];
+	header[0] = BINARY_LOG_CHUNK_MESSAGE;
+	memcpy(header + sizeof(eBinaryLogChunk), &message, sizeof(message));
+	cache.buffer->TryWrite(header, sizeof(header), argBytes, message.argByteCount);
+
+	if ((++cache.messageCount % BINARY_LOG_WAKE_CHECK_INTERVAL) == 0U && cache.buffer->GetUsedBytes() > cache.buffer->GetCapacity() / 2U)
+	{
+		m_writerSignal.notify_one();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+BinaryLogThreadCacheT& BinaryLog::GetThreadCache()
+{
+	BinaryLogThreadCacheT& cache = t_binaryLogCache;
+	if (cache.generation != m_generation)
+	{
+		//A ring from an older log instance is never written again
+		if (cache.buffer != nullptr)
+		{
+			cache.buffer->Retire();
+		}
+
+		cache = BinaryLogThreadCacheT();
+		cache.generation = m_generation;
+		cache.bufferOwner = RegisterThreadBuffer();
+		cache.buffer = cache.bufferOwner.get();
+	}
+
+	return cache;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogFlush()
+{
+	std::unique_lock<std::mutex> lock(m_signalLock);
+	if (!m_isRunning)
+	{
+		return;
+	}
+
+	uint64_t flushTarget = ++m_flushRequested;
+	m_writerSignal.notify_one();
+	m_flushSignal.wait(lock, [&]() { return m_flushCompleted >= flushTarget || !m_isRunning; });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogEnableAll()
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+	m_enableAll = true;
+	m_filterOverrides.clear();
+	RefreshFilterStates();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogDisableAll()
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+	m_enableAll = false;
+	m_filterOverrides.clear();
+	RefreshFilterStates();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogEnable( const char* filter )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	//With everything enabled the overrides are the disabled filters, otherwise they are the enabled ones
+	if (m_enableAll)
+	{
+		m_filterOverrides.erase(filter);
+	}
+	else
+	{
+		m_filterOverrides.insert(filter);
+	}
+	RefreshFilterStates();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::LogDisable( const char* filter )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	if (m_enableAll)
+	{
+		m_filterOverrides.insert(filter);
+	}
+	else
+	{
+		m_filterOverrides.erase(filter);
+	}
+	RefreshFilterStates();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t BinaryLog::GetMessageCount() const
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	uint64_t messageCount = m_reclaimedMessageCount;
+	for (const std::shared_ptr<LogThreadBuffer>& buffer : m_threadBuffers)
+	{
+		messageCount += buffer->GetWrittenCount();
+	}
+	return messageCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t BinaryLog::GetDroppedCount() const
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	uint64_t droppedCount = m_reclaimedDroppedCount;
+	for (const std::shared_ptr<LogThreadBuffer>& buffer : m_threadBuffers)
+	{
+		droppedCount += buffer->GetDroppedCount();
+	}
+	return droppedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t BinaryLog::GetThreadBufferCount() const
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+	return (uint32_t)m_threadBuffers.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool BinaryLog::IsFilterOverridden( const std::string& filter ) const
+{
+	return m_filterOverrides.find(filter) != m_filterOverrides.end();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::RefreshFilterStates()
+{
+	for (const std::unique_ptr<BinaryLogFilterEntryT>& filter : m_filters)
+	{
+		m_filterEnabled[filter->id].store(m_enableAll != IsFilterOverridden(filter->name), std::memory_order_relaxed);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::shared_ptr<LogThreadBuffer> BinaryLog::RegisterThreadBuffer()
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	std::shared_ptr<LogThreadBuffer> buffer;
+	if (m_freeBuffers.empty())
+	{
+		buffer = std::make_shared<LogThreadBuffer>(m_nextThreadID++, BINARY_LOG_THREAD_BUFFER_BYTES);
+	}
+	else
+	{
+		//Neither its old thread nor the writer look at a free ring any more
+		buffer = std::move(m_freeBuffers.back());
+		m_freeBuffers.pop_back();
+		buffer->Reset(m_nextThreadID++);
+	}
+
+	m_threadBuffers.push_back(buffer);
+	return buffer;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const BinaryLogFilterEntryT* BinaryLog::InternFilter( const char* filter )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	std::unordered_map<std::string, const BinaryLogFilterEntryT*>::iterator itr = m_filtersByName.find(filter);
+	if (itr != m_filtersByName.end())
+	{
+		return itr->second;
+	}
+
+	if (m_filters.size() >= MAX_BINARY_LOG_FILTERS)
+	{
+		//Out of filter slots, share the last one
+		return m_filters.back().get();
+	}
+
+	std::unique_ptr<BinaryLogFilterEntryT> entry(new BinaryLogFilterEntryT());
+	entry->id = (uint16_t)m_filters.size();
+	entry->name = filter;
+	m_filterEnabled[entry->id].store(m_enableAll != IsFilterOverridden(entry->name), std::memory_order_relaxed);
+
+	const BinaryLogFilterEntryT* filterEntry = entry.get();
+	m_filters.push_back(std::move(entry));
+	m_filtersByName[filter] = filterEntry;
+
+	uint32_t id = filterEntry->id;
+	uint16_t length = (uint16_t)filterEntry->name.size();
+	eBinaryLogChunk chunk = BINARY_LOG_CHUNK_FILTER;
+	AppendDefinitionBytes(&chunk, sizeof(chunk));
+	AppendDefinitionBytes(&id, sizeof(id));
+	AppendDefinitionBytes(&length, sizeof(length));
+	AppendDefinitionBytes(filterEntry->name.data(), length);
+
+	return filterEntry;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const BinaryLogFormatEntryT* BinaryLog::InternFormat( const char* format )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	std::unordered_map<std::string, const BinaryLogFormatEntryT*>::iterator itr = m_formatsByText.find(format);
+	if (itr != m_formatsByText.end())
+	{
+		return itr->second;
+	}
+
+	std::unique_ptr<BinaryLogFormatEntryT> entry(new BinaryLogFormatEntryT());
+	entry->id = (uint32_t)m_formats.size() + 1U;
+	entry->text = format;
+	entry->isEncodable = BinaryLogParseFormat(format, entry->signature, entry->argCount);
+
+	const BinaryLogFormatEntryT* formatEntry = entry.get();
+	m_formats.push_back(std::move(entry));
+	m_formatsByText[format] = formatEntry;
+
+	//Formats that can not be encoded are never referenced by a message, so only the usable ones go to disk
+	if (formatEntry->isEncodable)
+	{
+		uint32_t id = formatEntry->id;
+		uint16_t length = (uint16_t)formatEntry->text.size();
+		eBinaryLogChunk chunk = BINARY_LOG_CHUNK_FORMAT;
+		AppendDefinitionBytes(&chunk, sizeof(chunk));
+		AppendDefinitionBytes(&id, sizeof(id));
+		AppendDefinitionBytes(&length, sizeof(length));
+		AppendDefinitionBytes(formatEntry->text.data(), length);
+		AppendDefinitionBytes(&formatEntry->argCount, sizeof(formatEntry->argCount));
+		AppendDefinitionBytes(formatEntry->signature, formatEntry->argCount * sizeof(eBinaryLogArg));
+	}
+
+	return formatEntry;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t BinaryLog::InternCallstack( uint64_t hash, void* const* frames, uint32_t frameCount )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	bool isNew = false;
+	uint32_t callstackID = m_callstacks.Intern(hash, frames, frameCount, &isNew);
+	if (!isNew)
+	{
+		return callstackID;
+	}
+
+	//Only the raw addresses go out now, symbols follow on the next flush
+	uint16_t frameCount16 = (uint16_t)frameCount;
+	eBinaryLogChunk chunk = BINARY_LOG_CHUNK_CALLSTACK;
+	AppendDefinitionBytes(&chunk, sizeof(chunk));
+	AppendDefinitionBytes(&callstackID, sizeof(callstackID));
+	AppendDefinitionBytes(&frameCount16, sizeof(frameCount16));
+	for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		uint64_t address = (uint64_t)(uintptr_t)frames[frameIndex];
+		AppendDefinitionBytes(&address, sizeof(address));
+	}
+
+	return callstackID;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::AppendDefinitionBytes( const void* data, size_t byteCount )
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	m_definitionBytes.insert(m_definitionBytes.end(), bytes, bytes + byteCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::WriterThreadMain()
+{
+	while (true)
+	{
+		uint64_t flushTarget = 0U;
+		bool isRunning = true;
+		{
+			std::unique_lock<std::mutex> lock(m_signalLock);
+			m_writerSignal.wait_for(lock, std::chrono::milliseconds(BINARY_LOG_WRITE_INTERVAL_MS), [&]()
+			{
+				return !m_isRunning || m_flushRequested > m_flushCompleted;
+			});
+
+			flushTarget = m_flushRequested;
+			isRunning = m_isRunning;
+		}
+
+		bool drainEverything = !isRunning || flushTarget > m_flushCompleted;
+		DrainThreadBuffers(drainEverything);
+
+		//Symbol lookups are slow, so they wait for a flush and only cover addresses not resolved before
+		if (drainEverything)
+		{
+			AppendPendingSymbols();
+		}
+
+		if (!m_writeBytes.empty())
+		{
+			fwrite(m_writeBytes.data(), 1, m_writeBytes.size(), m_logFile);
+			m_bytesWritten += m_writeBytes.size();
+			m_writeBytes.clear();
+		}
+
+		if (drainEverything)
+		{
+			fflush(m_logFile);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_signalLock);
+			m_flushCompleted = flushTarget;
+		}
+		m_flushSignal.notify_all();
+
+		if (!isRunning)
+		{
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pulls every committed record out of the thread rings and appends them to m_writeBytes in timestamp order. Without
+// drainEverything, records inside the holdback window stay staged for the next pass.
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::DrainThreadBuffers( bool drainEverything )
+{
+	uint64_t now = GetTimestampNS();
+	uint64_t watermark = UINT64_MAX;
+	if (!drainEverything)
+	{
+		watermark = (now > BINARY_LOG_MERGE_HOLDBACK_NS) ? now - BINARY_LOG_MERGE_HOLDBACK_NS : 0U;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_internLock);
+		while (m_staging.size() < m_threadBuffers.size())
+		{
+			ThreadStagingT staging;
+			staging.buffer = m_threadBuffers[m_staging.size()].get();
+			m_staging.push_back(std::move(staging));
+		}
+	}
+
+	for (ThreadStagingT& staging : m_staging)
+	{
+		staging.wasRetired = staging.buffer->IsRetired();
+		staging.buffer->ReadAll(staging.bytes);
+	}
+
+	//Definitions are taken after the rings so every drained message already has its IDs defined
+	{
+		std::lock_guard<std::mutex> lock(m_internLock);
+		m_writeBytes.insert(m_writeBytes.end(), m_definitionBytes.begin(), m_definitionBytes.end());
+		m_definitionBytes.clear();
+	}
+
+	const size_t headerSize = sizeof(eBinaryLogChunk) + sizeof(BinaryLogMessageT);
+	const size_t timestampOffset = sizeof(eBinaryLogChunk) + offsetof(BinaryLogMessageT, timestampNS);
+	const size_t argByteCountOffset = sizeof(eBinaryLogChunk) + offsetof(BinaryLogMessageT, argByteCount);
+
+	//K-way merge; each ring is already in timestamp order
+	while (true)
+	{
+		ThreadStagingT* nextStaging = nullptr;
+		uint64_t nextTimestamp = 0U;
+
+		for (ThreadStagingT& staging : m_staging)
+		{
+			if (staging.readOffset + headerSize > staging.bytes.size())
+			{
+				continue;
+			}
+
+			uint64_t timestamp = 0U;
+			memcpy(&timestamp, staging.bytes.data() + staging.readOffset + timestampOffset, sizeof(timestamp));
+			if (timestamp <= watermark && (nextStaging == nullptr || timestamp < nextTimestamp))
+			{
+				nextStaging = &staging;
+				nextTimestamp = timestamp;
+			}
+		}
+
+		if (nextStaging == nullptr)
+		{
+			break;
+		}
+
+		uint16_t argByteCount = 0U;
+		memcpy(&argByteCount, nextStaging->bytes.data() + nextStaging->readOffset + argByteCountOffset, sizeof(argByteCount));
+
+		const unsigned char* record = nextStaging->bytes.data() + nextStaging->readOffset;
+		size_t recordSize = headerSize + argByteCount;
+		m_writeBytes.insert(m_writeBytes.end(), record, record + recordSize);
+		nextStaging->readOffset += recordSize;
+	}
+
+	for (ThreadStagingT& staging : m_staging)
+	{
+		staging.bytes.erase(staging.bytes.begin(), staging.bytes.begin() + staging.readOffset);
+		staging.readOffset = 0U;
+	}
+
+	//Exited threads whose records are all written give their ring back
+	for (size_t stagingIndex = m_staging.size(); stagingIndex > 0U; --stagingIndex)
+	{
+		const ThreadStagingT& staging = m_staging[stagingIndex - 1U];
+		if (staging.wasRetired && staging.bytes.empty())
+		{
+			ReclaimThreadBuffer(stagingIndex - 1U);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Writer thread only. m_staging and m_threadBuffers share indices: registration only appends and only the writer removes
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::ReclaimThreadBuffer( size_t bufferIndex )
+{
+	std::lock_guard<std::mutex> lock(m_internLock);
+
+	std::shared_ptr<LogThreadBuffer> buffer = std::move(m_threadBuffers[bufferIndex]);
+	m_threadBuffers.erase(m_threadBuffers.begin() + bufferIndex);
+	m_staging.erase(m_staging.begin() + bufferIndex);
+
+	m_reclaimedMessageCount += buffer->GetWrittenCount();
+	m_reclaimedDroppedCount += buffer->GetDroppedCount();
+
+	if (m_freeBuffers.size() < BINARY_LOG_FREE_THREAD_BUFFERS)
+	{
+		m_freeBuffers.push_back(std::move(buffer));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BinaryLog::AppendPendingSymbols()
+{
+	std::vector<std::pair<uint64_t, std::string>> symbols;
+	m_callstacks.ResolvePending(&symbols);
+
+	for (const std::pair<uint64_t, std::string>& symbol : symbols)
+	{
+		uint16_t length = (uint16_t)std::min<size_t>(symbol.second.size(), UINT16_MAX);
+		m_writeBytes.push_back(BINARY_LOG_CHUNK_SYMBOL);
+		m_writeBytes.insert(m_writeBytes.end(), (const unsigned char*)&symbol.first, (const unsigned char*)&symbol.first + sizeof(symbol.first));
+		m_writeBytes.insert(m_writeBytes.end(), (const unsigned char*)&length, (const unsigned char*)&length + sizeof(length));
+		m_writeBytes.insert(m_writeBytes.end(), symbol.second.begin(), symbol.second.begin() + length);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t BinaryLog::GetTimestampNS() const
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+}
@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Game Systems
+#include "Game/BinaryLogFormat.hpp"
+#include "Game/CallstackTable.hpp"
+#include "Game/LogThreadBuffer.hpp"
+//Third Party
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Binary replacement for the text ExecutionLog. Logf/LogCallstackf only intern the filter, format string and callstack into
+// IDs and copy the raw argument bytes; formatting happens offline in the LogDecoder tool (Code/Tools/LogDecoder).
+//
+// Every logging thread gets its own LogThreadBuffer, so the hot path takes no locks: IDs come from a thread local cache and
+// the record is copied into that thread's ring. The writer thread drains all rings and merges them by timestamp. Interning a
+// new filter/format/callstack takes m_internLock once per thread. Threads must stop logging before Shutdown.
+//
+// Callstacks are captured as raw return addresses and deduped through a CallstackTable. They are symbolized on the writer
+// thread when the log is flushed, never on the logging thread.
+//
+// A thread retires its ring when it exits. The writer drops the ring once it is drained and keeps a few for the next threads
+// that register, so short lived threads do not grow the registry or keep a buffer each.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t MAX_BINARY_LOG_FILTERS = 1024U;
+constexpr size_t BINARY_LOG_THREAD_BUFFER_BYTES = 1024U * 1024U;
+//Drained rings of exited threads kept for reuse, the rest are freed
+constexpr size_t BINARY_LOG_FREE_THREAD_BUFFERS = 4U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BinaryLogFormatEntryT
+{
+	uint32_t							id = BINARY_LOG_INVALID_ID;
+	std::string							text;
+	eBinaryLogArg						signature[MAX_BINARY_LOG_ARGS];
+	uint8_t								argCount = 0U;
+	bool								isEncodable = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BinaryLogFilterEntryT
+{
+	uint16_t							id = 0U;
+	std::string							name;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BinaryLogThreadCacheT;
+
+//------------------------------------------------------------------------------------------------------------------------------
+class BinaryLog
+{
+public:
+	explicit BinaryLog( const std::string& logFilePath );
+	~BinaryLog();
+
+	static std::string					MakeTimestampedLogPath( const char* pathPrefix );
+
+	void								Startup();
+	void								Shutdown();
+
+	void								Logf( const char* filter, const char* format, ... );
+	void								LogCallstackf( const char* filter, const char* format, ... );
+	void								LogFlush();
+
+	void								LogEnableAll();
+	void								LogDisableAll();
+	void								LogEnable( const char* filter );
+	void								LogDisable( const char* filter );
+
+	size_t								GetBytesWritten() const { return m_bytesWritten; }
+	uint64_t							GetMessageCount() const;
+	uint64_t							GetDroppedCount() const;
+	//Rings of threads that are logging or whose records are not written yet
+	uint32_t							GetThreadBufferCount() const;
+	const std::string&					GetLogFilePath() const { return m_logFilePath; }
+
+private:
+	void								LogMessage( const char* filter, bool captureCallstack, const char* format, va_list args );
+	BinaryLogThreadCacheT&				GetThreadCache();
+	bool								IsFilterOverridden( const std::string& filter ) const;
+	void								RefreshFilterStates();
+
+	//All of these take m_internLock; the hot path only calls them on a thread cache miss
+	std::shared_ptr<LogThreadBuffer>	RegisterThreadBuffer();
+	const BinaryLogFilterEntryT*		InternFilter( const char* filter );
+	const BinaryLogFormatEntryT*		InternFormat( const char* format );
+	uint32_t							InternCallstack( uint64_t hash, void* const* frames, uint32_t frameCount );
+	void								AppendDefinitionBytes( const void* data, size_t byteCount );
+
+	void								WriterThreadMain();
+	void								DrainThreadBuffers( bool drainEverything );
+	void								ReclaimThreadBuffer( size_t bufferIndex );
+	void								AppendPendingSymbols();
+
+	uint64_t							GetTimestampNS() const;
+
+private:
+	std::string							m_logFilePath;
+	FILE*								m_logFile = nullptr;
+	uint64_t							m_generation = 0U;
+
+	std::chrono::steady_clock::time_point	m_startTime;
+	std::atomic<bool>					m_isRunning;
+
+	//Interned data and thread registration, guarded by m_internLock. Logging threads share ownership of their ring
+	mutable std::mutex					m_internLock;
+	std::vector<std::shared_ptr<LogThreadBuffer>>	m_threadBuffers;
+	std::vector<std::shared_ptr<LogThreadBuffer>>	m_freeBuffers;
+	uint32_t							m_nextThreadID = 0U;
+	uint64_t							m_reclaimedMessageCount = 0U;
+	uint64_t							m_reclaimedDroppedCount = 0U;
+	std::vector<unsigned char>			m_definitionBytes;
+	std::vector<std::unique_ptr<BinaryLogFilterEntryT>>	m_filters;
+	std::unordered_map<std::string, const BinaryLogFilterEntryT*>	m_filtersByName;
+	std::vector<std::unique_ptr<BinaryLogFormatEntryT>>	m_formats;
+	std::unordered_map<std::string, const BinaryLogFormatEntryT*>	m_formatsByText;
+	CallstackTable						m_callstacks;
+	const BinaryLogFormatEntryT*		m_preformattedEntry = nullptr;
+
+	//Filter state. Producers only read m_filterEnabled
+	bool								m_enableAll = true;
+	std::unordered_set<std::string>		m_filterOverrides;
+	std::atomic<bool>					m_filterEnabled[MAX_BINARY_LOG_FILTERS];
+
+	//Writer thread state
+	std::thread							m_writerThread;
+	std::mutex							m_signalLock;
+	std::condition_variable				m_writerSignal;
+	std::condition_variable				m_flushSignal;
+	uint64_t							m_flushRequested = 0U;
+	uint64_t							m_flushCompleted = 0U;
+
+	//Only touched by the writer thread
+	struct ThreadStagingT
+	{
+		LogThreadBuffer*				buffer = nullptr;
+		std::vector<unsigned char>		bytes;
+		size_t							readOffset = 0U;
+		//Seen before the last ReadAll, so that read took everything the thread wrote
+		bool							wasRetired = false;
+	};
+	std::vector<ThreadStagingT>			m_staging;
+	std::vector<unsigned char>			m_writeBytes;
+
+	std::atomic<size_t>					m_bytesWritten;
+};
+
+extern BinaryLog* g_binaryLog;
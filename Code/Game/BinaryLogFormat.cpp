@@ -0,0 +1,518 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/BinaryLogFormat.hpp"
+//Third Party
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsFormatFlag( char character )
+{
+	return character == '-' || character == '+' || character == ' ' || character == '#' || character == '0' || character == '\'';
+}
+
+static bool IsDigit( char character )
+{
+	return character >= '0' && character <= '9';
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Skips the length modifier of a conversion spec and returns the size in bytes of the integer it describes
+static const char* SkipLengthModifier( const char* cursor, uint32_t& outIntegerSize, bool& outIsWide )
+{
+	outIntegerSize = sizeof(int);
+	outIsWide = false;
+
+	switch (*cursor)
+	{
+	case 'h':
+	{
+		cursor += (cursor[1] == 'h') ? 2 : 1;
+	}
+	break;
+	case 'l':
+	{
+		if (cursor[1] == 'l')
+		{
+			outIntegerSize = sizeof(long long);
+			cursor += 2;
+		}
+		else
+		{
+			outIntegerSize = sizeof(long);
+			outIsWide = true;
+			cursor += 1;
+		}
+	}
+	break;
+	case 'j':
+	{
+		outIntegerSize = sizeof(long long);
+		cursor += 1;
+	}
+	break;
+	case 'z':
+	{
+		outIntegerSize = sizeof(size_t);
+		cursor += 1;
+	}
+	break;
+	case 't':
+	{
+		outIntegerSize = sizeof(ptrdiff_t);
+		cursor += 1;
+	}
+	break;
+	case 'I':
+	{
+		//MSVC sized integers (%I64d, %I32d, %Iu)
+		if (cursor[1] == '6' && cursor[2] == '4')
+		{
+			outIntegerSize = 8U;
+			cursor += 3;
+		}
+		else if (cursor[1] == '3' && cursor[2] == '2')
+		{
+			outIntegerSize = 4U;
+			cursor += 3;
+		}
+		else
+		{
+			outIntegerSize = sizeof(size_t);
+			cursor += 1;
+		}
+	}
+	break;
+	default:
+	break;
+	}
+
+	return cursor;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool BinaryLogParseFormat( const char* format, eBinaryLogArg* outSignature, uint8_t& outArgCount )
+{
+	outArgCount = 0U;
+	const char* cursor = format;
+
+	while (*cursor != '\0')
+	{
+		if (*cursor != '%')
+		{
+			++cursor;
+			continue;
+		}
+
+		++cursor;
+		if (*cursor == '%')
+		{
+			++cursor;
+			continue;
+		}
+
+		while (IsFormatFlag(*cursor))
+		{
+			++cursor;
+		}
+
+		//Width
+		if (*cursor == '*')
+		{
+			if (outArgCount >= MAX_BINARY_LOG_ARGS)
+			{
+				return false;
+			}
+			outSignature[outArgCount++] = BINARY_LOG_ARG_INT32;
+			++cursor;
+		}
+		while (IsDigit(*cursor))
+		{
+			++cursor;
+		}
+
+		//Precision
+		if (*cursor == '.')
+		{
+			++cursor;
+			if (*cursor == '*')
+			{
+				if (outArgCount >= MAX_BINARY_LOG_ARGS)
+				{
+					return false;
+				}
+				outSignature[outArgCount++] = BINARY_LOG_ARG_INT32;
+				++cursor;
+			}
+			while (IsDigit(*cursor))
+			{
+				++cursor;
+			}
+		}
+
+		uint32_t integerSize = 0U;
+		bool isWide = false;
+		if (*cursor == 'L')
+		{
+			//long double is not stored
+			return false;
+		}
+		cursor = SkipLengthModifier(cursor, integerSize, isWide);
+
+		if (outArgCount >= MAX_BINARY_LOG_ARGS)
+		{
+			return false;
+		}
+
+		switch (*cursor)
+		{
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+		{
+			outSignature[outArgCount++] = (integerSize > 4U) ? BINARY_LOG_ARG_INT64 : BINARY_LOG_ARG_INT32;
+		}
+		break;
+		case 'c':
+		{
+			outSignature[outArgCount++] = BINARY_LOG_ARG_INT32;
+		}
+		break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			outSignature[outArgCount++] = BINARY_LOG_ARG_DOUBLE;
+		}
+		break;
+		case 's':
+		{
+			if (isWide)
+			{
+				return false;
+			}
+			outSignature[outArgCount++] = BINARY_LOG_ARG_STRING;
+		}
+		break;
+		case 'p':
+		{
+			outSignature[outArgCount++] = BINARY_LOG_ARG_POINTER;
+		}
+		break;
+		default:
+		{
+			//%n, wide strings or a malformed spec
+			return false;
+		}
+		}
+
+		++cursor;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t BinaryLogEncodeArgs( const eBinaryLogArg* signature, uint8_t argCount, va_list args, unsigned char* buffer, uint32_t bufferSize )
+{
+	uint32_t writeOffset = 0U;
+
+	for (uint8_t argIndex = 0; argIndex < argCount; ++argIndex)
+	{
+		switch (signature[argIndex])
+		{
+		case BINARY_LOG_ARG_INT32:
+		{
+			int32_t value = (int32_t)va_arg(args, int);
+			if (writeOffset + sizeof(value) > bufferSize)
+			{
+				return writeOffset;
+			}
+			memcpy(buffer + writeOffset, &value, sizeof(value));
+			writeOffset += sizeof(value);
+		}
+		break;
+		case BINARY_LOG_ARG_INT64:
+		{
+			int64_t value = (int64_t)va_arg(args, long long);
+			if (writeOffset + sizeof(value) > bufferSize)
+			{
+				return writeOffset;
+			}
+			memcpy(buffer + writeOffset, &value, sizeof(value));
+			writeOffset += sizeof(value);
+		}
+		break;
+		case BINARY_LOG_ARG_DOUBLE:
+		{
+			double value = va_arg(args, double);
+			if (writeOffset + sizeof(value) > bufferSize)
+			{
+				return writeOffset;
+			}
+			memcpy(buffer + writeOffset, &value, sizeof(value));
+			writeOffset += sizeof(value);
+		}
+		break;
+		case BINARY_LOG_ARG_POINTER:
+		{
+			uint64_t value = (uint64_t)(uintptr_t)va_arg(args, void*);
+			if (writeOffset + sizeof(value) > bufferSize)
+			{
+				return writeOffset;
+			}
+			memcpy(buffer + writeOffset, &value, sizeof(value));
+			writeOffset += sizeof(value);
+		}
+		break;
+		case BINARY_LOG_ARG_STRING:
+		{
+			const char* value = va_arg(args, const char*);
+			if (value == nullptr)
+			{
+				value = "(null)";
+			}
+
+			if (writeOffset + sizeof(uint16_t) > bufferSize)
+			{
+				return writeOffset;
+			}
+
+			//Clamp long strings to what is left in the record
+			size_t length = strlen(value);
+			size_t space = bufferSize - writeOffset - sizeof(uint16_t);
+			length = (length > MAX_BINARY_LOG_STRING_ARG_LENGTH) ? MAX_BINARY_LOG_STRING_ARG_LENGTH : length;
+			length = (length > space) ? space : length;
+
+			uint16_t length16 = (uint16_t)length;
+			memcpy(buffer + writeOffset, &length16, sizeof(length16));
+			writeOffset += sizeof(length16);
+			memcpy(buffer + writeOffset, value, length);
+			writeOffset += (uint32_t)length;
+		}
+		break;
+		default:
+		break;
+		}
+	}
+
+	return writeOffset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AppendFormatted( std::string& result, const char* spec, ... )
+{
+	char stackBuffer[256];
+
+	va_list args;
+	va_start(args, spec);
+	int length = vsnprintf(stackBuffer, sizeof(stackBuffer), spec, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		return;
+	}
+
+	if (length < (int)sizeof(stackBuffer))
+	{
+		result.append(stackBuffer, (size_t)length);
+		return;
+	}
+
+	std::vector<char> heapBuffer((size_t)length + 1U);
+	va_start(args, spec);
+	vsnprintf(heapBuffer.data(), heapBuffer.size(), spec, args);
+	va_end(args);
+	result.append(heapBuffer.data(), (size_t)length);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static bool ReadArg( const unsigned char* argBytes, uint32_t argByteCount, uint32_t& readOffset, T& outValue )
+{
+	if (readOffset + sizeof(T) > argByteCount)
+	{
+		return false;
+	}
+
+	memcpy(&outValue, argBytes + readOffset, sizeof(T));
+	readOffset += sizeof(T);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string BinaryLogFormatArgs( const char* format, const eBinaryLogArg* signature, uint8_t argCount, const unsigned char* argBytes, uint32_t argByteCount )
+{
+	std::string result;
+	result.reserve(strlen(format) + argByteCount);
+
+	const char* cursor = format;
+	uint8_t argIndex = 0U;
+	uint32_t readOffset = 0U;
+
+	while (*cursor != '\0')
+	{
+		if (*cursor != '%')
+		{
+			result.push_back(*cursor);
+			++cursor;
+			continue;
+		}
+
+		if (cursor[1] == '%')
+		{
+			result.push_back('%');
+			cursor += 2;
+			continue;
+		}
+
+		//Rebuild the spec with '*' replaced by the stored values and the length modifier matching the stored type
+		std::string spec = "%";
+		++cursor;
+
+		while (IsFormatFlag(*cursor))
+		{
+			spec.push_back(*cursor);
+			++cursor;
+		}
+
+		if (*cursor == '*')
+		{
+			int32_t width = 0;
+			if (argIndex >= argCount || !ReadArg(argBytes, argByteCount, readOffset, width))
+			{
+				result.append("<truncated>");
+				return result;
+			}
+			++argIndex;
+			spec.append(std::to_string(width));
+			++cursor;
+		}
+		while (IsDigit(*cursor))
+		{
+			spec.push_back(*cursor);
+			++cursor;
+		}
+
+		if (*cursor == '.')
+		{
+			spec.push_back('.');
+			++cursor;
+			if (*cursor == '*')
+			{
+				int32_t precision = 0;
+				if (argIndex >= argCount || !ReadArg(argBytes, argByteCount, readOffset, precision))
+				{
+					result.append("<truncated>");
+					return result;
+				}
+				++argIndex;
+				spec.append(std::to_string(precision));
+				++cursor;
+			}
+			while (IsDigit(*cursor))
+			{
+				spec.push_back(*cursor);
+				++cursor;
+			}
+		}
+
+		uint32_t integerSize = 0U;
+		bool isWide = false;
+		cursor = SkipLengthModifier(cursor, integerSize, isWide);
+
+		char conversion = *cursor;
+		if (conversion == '\0' || argIndex >= argCount)
+		{
+			result.append("<bad format>");
+			return result;
+		}
+		++cursor;
+
+		bool readSucceeded = true;
+		switch (signature[argIndex++])
+		{
+		case BINARY_LOG_ARG_INT32:
+		{
+			int32_t value = 0;
+			readSucceeded = ReadArg(argBytes, argByteCount, readOffset, value);
+			spec.push_back(conversion);
+			if (readSucceeded)
+			{
+				AppendFormatted(result, spec.c_str(), value);
+			}
+		}
+		break;
+		case BINARY_LOG_ARG_INT64:
+		{
+			int64_t value = 0;
+			readSucceeded = ReadArg(argBytes, argByteCount, readOffset, value);
+			spec.append("ll");
+			spec.push_back(conversion);
+			if (readSucceeded)
+			{
+				AppendFormatted(result, spec.c_str(), (long long)value);
+			}
+		}
+		break;
+		case BINARY_LOG_ARG_DOUBLE:
+		{
+			double value = 0.0;
+			readSucceeded = ReadArg(argBytes, argByteCount, readOffset, value);
+			spec.push_back(conversion);
+			if (readSucceeded)
+			{
+				AppendFormatted(result, spec.c_str(), value);
+			}
+		}
+		break;
+		case BINARY_LOG_ARG_POINTER:
+		{
+			uint64_t value = 0U;
+			readSucceeded = ReadArg(argBytes, argByteCount, readOffset, value);
+			spec.push_back('p');
+			if (readSucceeded)
+			{
+				AppendFormatted(result, spec.c_str(), (void*)(uintptr_t)value);
+			}
+		}
+		break;
+		case BINARY_LOG_ARG_STRING:
+		{
+			uint16_t length = 0U;
+			readSucceeded = ReadArg(argBytes, argByteCount, readOffset, length) && (readOffset + length <= argByteCount);
+			spec.push_back('s');
+			if (readSucceeded)
+			{
+				std::string value((const char*)argBytes + readOffset, length);
+				readOffset += length;
+				AppendFormatted(result, spec.c_str(), value.c_str());
+			}
+		}
+		break;
+		default:
+		{
+			readSucceeded = false;
+		}
+		break;
+		}
+
+		if (!readSucceeded)
+		{
+			result.append("<truncated>");
+			return result;
+		}
+	}
+
+	return result;
+}
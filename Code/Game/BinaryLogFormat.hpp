@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <stdarg.h>
+#include <stdint.h>
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Binary log file layout (shared by BinaryLog and the LogDecoder tool)
+//
+// File:	BinaryLogFileHeaderT followed by chunks. Every chunk starts with one eBinaryLogChunk byte.
+// Filter:	[u32 id][u16 length][length chars]
+// Format:	[u32 id][u16 length][length chars][u8 argCount][argCount eBinaryLogArg]
+// Callstack:	[u32 id][u16 frameCount][frameCount u64 return addresses]
+// Message:	[BinaryLogMessageT][argByteCount raw argument bytes]
+// Symbol:	[u64 return address][u16 length][length chars]
+//
+// Filters, format strings and callstacks are written once, the first time they are used. Messages only carry their IDs.
+// Argument bytes are stored in signature order: int32/int64/double/pointer as raw little endian values, strings as
+// [u16 length][chars]. Nothing is formatted until the file is decoded.
+// Symbol chunks are optional and come after the callstacks that use them (they are resolved on flush). Addresses without
+// one are printed raw and can still be symbolized offline against the matching build.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t BINARY_LOG_MAGIC = 0x474C4250U;	// "PBLG"
+constexpr uint16_t BINARY_LOG_VERSION = 2U;
+
+constexpr uint32_t BINARY_LOG_INVALID_ID = 0U;
+constexpr uint32_t MAX_BINARY_LOG_ARGS = 32U;
+constexpr uint32_t MAX_BINARY_LOG_ARG_BYTES = 1024U;
+constexpr uint32_t MAX_BINARY_LOG_STRING_ARG_LENGTH = 255U;
+constexpr uint32_t MAX_BINARY_LOG_CALLSTACK_FRAMES = 32U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eBinaryLogChunk : uint8_t
+{
+	BINARY_LOG_CHUNK_FILTER = 1,
+	BINARY_LOG_CHUNK_FORMAT,
+	BINARY_LOG_CHUNK_CALLSTACK,
+	BINARY_LOG_CHUNK_MESSAGE,
+	BINARY_LOG_CHUNK_SYMBOL
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eBinaryLogArg : uint8_t
+{
+	BINARY_LOG_ARG_INT32 = 0,
+	BINARY_LOG_ARG_INT64,
+	BINARY_LOG_ARG_DOUBLE,
+	BINARY_LOG_ARG_STRING,
+	BINARY_LOG_ARG_POINTER
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+struct BinaryLogFileHeaderT
+{
+	uint32_t							magic = BINARY_LOG_MAGIC;
+	uint16_t							version = BINARY_LOG_VERSION;
+	uint16_t							headerSize = sizeof(BinaryLogFileHeaderT);
+	uint64_t							startTimeSinceEpochMS = 0U;
+};
+
+struct BinaryLogMessageT
+{
+	uint64_t							timestampNS = 0U;
+	uint32_t							formatID = BINARY_LOG_INVALID_ID;
+	uint32_t							callstackID = BINARY_LOG_INVALID_ID;
+	uint32_t							threadID = 0U;
+	uint16_t							filterID = 0U;
+	uint16_t							argByteCount = 0U;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Parses a printf style format string into the types of the arguments it consumes (including '*' width/precision).
+// Returns false if the format uses something that cannot be stored (%n, or more than MAX_BINARY_LOG_ARGS arguments)
+bool		BinaryLogParseFormat( const char* format, eBinaryLogArg* outSignature, uint8_t& outArgCount );
+
+// Copies the arguments described by the signature out of the va_list. Returns the number of bytes written to buffer
+uint32_t	BinaryLogEncodeArgs( const eBinaryLogArg* signature, uint8_t argCount, va_list args, unsigned char* buffer, uint32_t bufferSize );
+
+// Rebuilds the formatted message from the format string and the encoded argument bytes
+std::string	BinaryLogFormatArgs( const char* format, const eBinaryLogArg* signature, uint8_t argCount, const unsigned char* argBytes, uint32_t argByteCount );
@@ -0,0 +1,316 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/CallstackTable.hpp"
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#else
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdlib.h>
+#endif
+
+//Skip counts assume the capture functions keep their own frames
+#if defined(_MSC_VER)
+#define CALLSTACK_NOINLINE __declspec(noinline)
+#else
+#define CALLSTACK_NOINLINE __attribute__((noinline))
+#endif
+
+//DbgHelp is single threaded, every symbol lookup goes through this lock
+static std::mutex s_symbolizeLock;
+
+//------------------------------------------------------------------------------------------------------------------------------
+CALLSTACK_NOINLINE uint32_t CaptureRawCallstack( void** outFrames, uint32_t maxFrames, uint32_t skipFrames )
+{
+	//Skip this function too
+	skipFrames++;
+
+#if defined(_WIN32)
+	return (uint32_t)RtlCaptureStackBackTrace((DWORD)skipFrames, (DWORD)maxFrames, outFrames, nullptr);
+#else
+	void* frames[MAX_CALLSTACK_TABLE_FRAMES * 2U];
+	uint32_t wantedFrames = maxFrames + skipFrames;
+	if (wantedFrames > MAX_CALLSTACK_TABLE_FRAMES * 2U)
+	{
+		wantedFrames = MAX_CALLSTACK_TABLE_FRAMES * 2U;
+	}
+
+	int captured = backtrace(frames, (int)wantedFrames);
+	if (captured <= (int)skipFrames)
+	{
+		return 0U;
+	}
+
+	uint32_t frameCount = (uint32_t)captured - skipFrames;
+	if (frameCount > maxFrames)
+	{
+		frameCount = maxFrames;
+	}
+	memcpy(outFrames, frames + skipFrames, frameCount * sizeof(void*));
+	return frameCount;
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t HashCallstack( void* const* frames, uint32_t frameCount )
+{
+	//Over the return addresses
+	uint64_t hash = HashFNV1a(frames, frameCount * sizeof(void*));
+	return (hash == 0U) ? 1U : hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+CallstackTable::CallstackTable()
+{
+}
+
+CallstackTable::~CallstackTable()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+CALLSTACK_NOINLINE uint32_t CallstackTable::Capture( uint32_t skipFrames )
+{
+	void* frames[MAX_CALLSTACK_TABLE_FRAMES];
+	uint32_t frameCount = CaptureRawCallstack(frames, MAX_CALLSTACK_TABLE_FRAMES, skipFrames + 1U);
+	if (frameCount == 0U)
+	{
+		return INVALID_CALLSTACK_ID;
+	}
+
+	return Intern(HashCallstack(frames, frameCount), frames, frameCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t CallstackTable::Intern( uint64_t hash, void* const* frames, uint32_t frameCount, bool* outIsNew )
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	//Probe until we hit the same frames or a free hash, so a 64 bit collision can not merge two callstacks
+	std::unordered_map<uint64_t, uint32_t>::iterator itr = m_idsByHash.find(hash);
+	while (itr != m_idsByHash.end())
+	{
+		const std::vector<uint64_t>& existing = m_callstacks[itr->second - 1U];
+		bool isSame = (existing.size() == frameCount);
+		for (uint32_t frameIndex = 0; isSame && frameIndex < frameCount; ++frameIndex)
+		{
+			isSame = (existing[frameIndex] == (uint64_t)(uintptr_t)frames[frameIndex]);
+		}
+
+		if (isSame)
+		{
+			if (outIsNew != nullptr)
+			{
+				*outIsNew = false;
+			}
+			return itr->second;
+		}
+
+		hash++;
+		itr = m_idsByHash.find(hash);
+	}
+
+	m_callstacks.emplace_back();
+	std::vector<uint64_t>& callstack = m_callstacks.back();
+	callstack.reserve(frameCount);
+
+	for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+	{
+		uint64_t address = (uint64_t)(uintptr_t)frames[frameIndex];
+		callstack.push_back(address);
+
+		//An empty entry marks an address that is queued but not symbolized yet
+		if (m_symbols.emplace(address, std::string()).second)
+		{
+			m_pendingAddresses.push_back(address);
+		}
+	}
+
+	uint32_t callstackID = (uint32_t)m_callstacks.size();
+	m_idsByHash[hash] = callstackID;
+
+	if (outIsNew != nullptr)
+	{
+		*outIsNew = true;
+	}
+	return callstackID;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool CallstackTable::GetFrames( uint32_t callstackID, std::vector<uint64_t>& outFrames ) const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	if (callstackID == INVALID_CALLSTACK_ID || callstackID > m_callstacks.size())
+	{
+		return false;
+	}
+
+	outFrames = m_callstacks[callstackID - 1U];
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t CallstackTable::GetCallstackCount() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_callstacks.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t CallstackTable::GetResolvedAddressCount() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	size_t resolvedCount = 0U;
+	for (const std::pair<const uint64_t, std::string>& symbol : m_symbols)
+	{
+		resolvedCount += symbol.second.empty() ? 0U : 1U;
+	}
+	return resolvedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string CallstackTable::ResolveAddress( uint64_t address )
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		std::unordered_map<uint64_t, std::string>::const_iterator itr = m_symbols.find(address);
+		if (itr != m_symbols.end() && !itr->second.empty())
+		{
+			return itr->second;
+		}
+	}
+
+	//Resolve without holding the table lock; at worst two threads resolve the same address
+	std::string symbol = SymbolizeAddress(address);
+
+	std::lock_guard<std::mutex> lock(m_lock);
+	std::string& cached = m_symbols[address];
+	if (cached.empty())
+	{
+		cached = symbol;
+	}
+	return cached;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string CallstackTable::ResolveToString( uint32_t callstackID )
+{
+	std::vector<uint64_t> frames;
+	if (!GetFrames(callstackID, frames))
+	{
+		return std::string();
+	}
+
+	std::string result;
+	for (uint64_t address : frames)
+	{
+		result += "\t";
+		result += ResolveAddress(address);
+		result += "\n";
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Symbolizes every address interned since the last call. Meant for a background thread; returns how many were resolved.
+//------------------------------------------------------------------------------------------------------------------------------
+size_t CallstackTable::ResolvePending( std::vector<std::pair<uint64_t, std::string>>* outResolved )
+{
+	std::vector<uint64_t> pending;
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		pending.swap(m_pendingAddresses);
+	}
+
+	for (uint64_t address : pending)
+	{
+		std::string symbol = ResolveAddress(address);
+		if (outResolved != nullptr)
+		{
+			outResolved->emplace_back(address, symbol);
+		}
+	}
+
+	return pending.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC std::string CallstackTable::SymbolizeAddress( uint64_t address )
+{
+	std::lock_guard<std::mutex> lock(s_symbolizeLock);
+	char text[1024];
+
+#if defined(_WIN32)
+	static bool s_symbolsInitialized = false;
+	HANDLE process = GetCurrentProcess();
+	if (!s_symbolsInitialized)
+	{
+		SymSetOptions(SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
+		SymInitialize(process, nullptr, TRUE);
+		s_symbolsInitialized = true;
+	}
+
+	unsigned char symbolBuffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+	SYMBOL_INFO* symbol = (SYMBOL_INFO*)symbolBuffer;
+	memset(symbol, 0, sizeof(SYMBOL_INFO));
+	symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+	symbol->MaxNameLen = MAX_SYM_NAME;
+
+	DWORD64 displacement = 0;
+	if (!SymFromAddr(process, (DWORD64)address, &displacement, symbol))
+	{
+		snprintf(text, sizeof(text), "0x%016llx", (unsigned long long)address);
+		return text;
+	}
+
+	IMAGEHLP_LINE64 line;
+	memset(&line, 0, sizeof(line));
+	line.SizeOfStruct = sizeof(line);
+	DWORD lineDisplacement = 0;
+	if (SymGetLineFromAddr64(process, (DWORD64)address, &lineDisplacement, &line))
+	{
+		snprintf(text, sizeof(text), "%s(%lu): %s", line.FileName, line.LineNumber, symbol->Name);
+	}
+	else
+	{
+		snprintf(text, sizeof(text), "%s+0x%llx", symbol->Name, (unsigned long long)displacement);
+	}
+#else
+	Dl_info info;
+	if (dladdr((void*)(uintptr_t)address, &info) == 0 || info.dli_fname == nullptr)
+	{
+		snprintf(text, sizeof(text), "0x%016llx", (unsigned long long)address);
+		return text;
+	}
+
+	const char* module = strrchr(info.dli_fname, '/');
+	module = (module != nullptr) ? module + 1 : info.dli_fname;
+
+	if (info.dli_sname != nullptr)
+	{
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+		snprintf(text, sizeof(text), "%s!%s+0x%llx", module, (status == 0 && demangled != nullptr) ? demangled : info.dli_sname,
+			(unsigned long long)(address - (uint64_t)(uintptr_t)info.dli_saddr));
+		free(demangled);
+	}
+	else
+	{
+		snprintf(text, sizeof(text), "%s+0x%llx", module, (unsigned long long)(address - (uint64_t)(uintptr_t)info.dli_fbase));
+	}
+#endif
+
+	return text;
+}
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Replacement for CallstackGet + GetCallstackToString on hot paths. Capture only walks the stack for raw return addresses;
+// the table hashes them and hands out one ID per unique callstack, so a callstack logged from a loop is stored once.
+//
+// Nothing is symbolized at capture time. Addresses are resolved (and cached per address) only when somebody asks: Resolve*
+// for an on-demand string, or ResolvePending from a background thread (BinaryLog does this on flush). The IDs and raw
+// frames are also enough to symbolize offline.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t MAX_CALLSTACK_TABLE_FRAMES = 32U;
+constexpr uint32_t INVALID_CALLSTACK_ID = 0U;
+
+//Captures up to maxFrames return addresses, skipping skipFrames plus this function itself
+uint32_t	CaptureRawCallstack( void** outFrames, uint32_t maxFrames, uint32_t skipFrames );
+//Never returns 0, so 0 can mark empty cache slots
+uint64_t	HashCallstack( void* const* frames, uint32_t frameCount );
+
+//------------------------------------------------------------------------------------------------------------------------------
+class CallstackTable
+{
+public:
+	CallstackTable();
+	~CallstackTable();
+
+	//All of these are thread safe
+	uint32_t							Capture( uint32_t skipFrames = 0U );
+	uint32_t							Intern( uint64_t hash, void* const* frames, uint32_t frameCount, bool* outIsNew = nullptr );
+
+	bool								GetFrames( uint32_t callstackID, std::vector<uint64_t>& outFrames ) const;
+	size_t								GetCallstackCount() const;
+	size_t								GetResolvedAddressCount() const;
+
+	//Symbolization. Slow the first time an address is seen, cached after that
+	std::string							ResolveAddress( uint64_t address );
+	std::string							ResolveToString( uint32_t callstackID );
+	size_t								ResolvePending( std::vector<std::pair<uint64_t, std::string>>* outResolved = nullptr );
+
+private:
+	static std::string					SymbolizeAddress( uint64_t address );
+
+private:
+	mutable std::mutex					m_lock;
+	std::unordered_map<uint64_t, uint32_t>	m_idsByHash;
+	std::vector<std::vector<uint64_t>>	m_callstacks;
+
+	//Addresses seen in interned callstacks that have not been symbolized yet
+	std::vector<uint64_t>				m_pendingAddresses;
+	std::unordered_map<uint64_t, std::string>	m_symbols;
+};
@@ -0,0 +1,497 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/CookedTextureFormat.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t BC_BLOCK_SIZE = 4U;
+constexpr size_t BC1_BLOCK_BYTES = 8U;
+constexpr size_t BC3_BLOCK_BYTES = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint32_t AlignCookedTextureOffset( uint32_t offset )
+{
+	return (offset + COOKED_TEXTURE_BLOB_ALIGNMENT - 1U) & ~(COOKED_TEXTURE_BLOB_ALIGNMENT - 1U);
+}
+
+static uint32_t GetBlockCount( uint32_t texelCount )
+{
+	return (texelCount + BC_BLOCK_SIZE - 1U) / BC_BLOCK_SIZE;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float SRGBToLinear( unsigned char value )
+{
+	float color = (float)value / 255.f;
+	return (color <= 0.04045f) ? color / 12.92f : powf((color + 0.055f) / 1.055f, 2.4f);
+}
+
+static unsigned char LinearToSRGB( float color )
+{
+	color = (color <= 0.0031308f) ? color * 12.92f : 1.055f * powf(color, 1.f / 2.4f) - 0.055f;
+	color = (color < 0.f) ? 0.f : ((color > 1.f) ? 1.f : color);
+	return (unsigned char)(color * 255.f + 0.5f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t HashTextureSource( const void* bytes, size_t byteCount )
+{
+	return HashFNV1a(bytes, byteCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t GetCookedMipByteCount( eCookedTextureFormat format, uint32_t width, uint32_t height )
+{
+	switch (format)
+	{
+	case COOKED_TEXTURE_FORMAT_RGBA8:
+		return (size_t)width * height * 4U;
+	case COOKED_TEXTURE_FORMAT_BC1:
+		return (size_t)GetBlockCount(width) * GetBlockCount(height) * BC1_BLOCK_BYTES;
+	case COOKED_TEXTURE_FORMAT_BC3:
+		return (size_t)GetBlockCount(width) * GetBlockCount(height) * BC3_BLOCK_BYTES;
+	default:
+		return 0U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t GetCookedTextureByteCount( const CookedTextureViewT& mips )
+{
+	size_t byteCount = 0U;
+	for (uint32_t mipIndex = 0; mipIndex < mips.mipCount; ++mipIndex)
+	{
+		byteCount += mips.mips[mipIndex].byteCount;
+	}
+	return byteCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BuildTextureMipChain( const unsigned char* texels, uint32_t width, uint32_t height, bool isSRGB, std::vector<std::vector<unsigned char>>& outMips )
+{
+	outMips.clear();
+	outMips.emplace_back(texels, texels + (size_t)width * height * 4U);
+
+	float toLinear[256];
+	for (int value = 0; value < 256; ++value)
+	{
+		toLinear[value] = isSRGB ? SRGBToLinear((unsigned char)value) : (float)value / 255.f;
+	}
+
+	while ((width > 1U || height > 1U) && outMips.size() < COOKED_TEXTURE_MAX_MIPS)
+	{
+		uint32_t mipWidth = (width > 1U) ? width / 2U : 1U;
+		uint32_t mipHeight = (height > 1U) ? height / 2U : 1U;
+		std::vector<unsigned char> mip((size_t)mipWidth * mipHeight * 4U);
+		const unsigned char* source = outMips.back().data();
+
+		for (uint32_t y = 0; y < mipHeight; ++y)
+		{
+			//An odd last row or column is dropped, so every texel stays a plain 2x2 average
+			uint32_t rows[2] = { 2U * y, (2U * y + 1U < height) ? 2U * y + 1U : 2U * y };
+			for (uint32_t x = 0; x < mipWidth; ++x)
+			{
+				uint32_t columns[2] = { 2U * x, (2U * x + 1U < width) ? 2U * x + 1U : 2U * x };
+				const unsigned char* corners[4] =
+				{
+					source + ((size_t)rows[0] * width + columns[0]) * 4U, source + ((size_t)rows[0] * width + columns[1]) * 4U,
+					source + ((size_t)rows[1] * width + columns[0]) * 4U, source + ((size_t)rows[1] * width + columns[1]) * 4U
+				};
+
+				unsigned char* destination = mip.data() + ((size_t)y * mipWidth + x) * 4U;
+				for (int channel = 0; channel < 3; ++channel)
+				{
+					float sum = toLinear[corners[0][channel]] + toLinear[corners[1][channel]] + toLinear[corners[2][channel]] + toLinear[corners[3][channel]];
+					destination[channel] = isSRGB ? LinearToSRGB(sum * 0.25f) : (unsigned char)(sum * 0.25f * 255.f + 0.5f);
+				}
+				destination[3] = (unsigned char)((corners[0][3] + corners[1][3] + corners[2][3] + corners[3][3] + 2) / 4);
+			}
+		}
+
+		outMips.push_back(std::move(mip));
+		width = mipWidth;
+		height = mipHeight;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// BC block encoding. Endpoints come from the block's bounding box, inset a little and flipped onto the diagonal that matches
+// how the channels move together; every texel then takes the nearest palette entry. Not as good as an exhaustive search, but
+// fast enough to cook a folder of 2k textures in seconds.
+//------------------------------------------------------------------------------------------------------------------------------
+static void GatherBlockTexels( const unsigned char* texels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, unsigned char* outBlock )
+{
+	for (uint32_t y = 0; y < BC_BLOCK_SIZE; ++y)
+	{
+		uint32_t sourceY = blockY * BC_BLOCK_SIZE + y;
+		sourceY = (sourceY < height) ? sourceY : height - 1U;
+		for (uint32_t x = 0; x < BC_BLOCK_SIZE; ++x)
+		{
+			uint32_t sourceX = blockX * BC_BLOCK_SIZE + x;
+			sourceX = (sourceX < width) ? sourceX : width - 1U;
+			memcpy(outBlock + (y * BC_BLOCK_SIZE + x) * 4U, texels + ((size_t)sourceY * width + sourceX) * 4U, 4U);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint16_t PackColor565( const int* color )
+{
+	return (uint16_t)((((color[0] * 31 + 127) / 255) << 11) | (((color[1] * 63 + 127) / 255) << 5) | ((color[2] * 31 + 127) / 255));
+}
+
+static void UnpackColor565( uint16_t packed, int* outColor )
+{
+	int red = (packed >> 11) & 31;
+	int green = (packed >> 5) & 63;
+	int blue = packed & 31;
+	outColor[0] = (red << 3) | (red >> 2);
+	outColor[1] = (green << 2) | (green >> 4);
+	outColor[2] = (blue << 3) | (blue >> 2);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildColorPalette( uint16_t color0, uint16_t color1, bool isFourColor, int palette[4][4] )
+{
+	UnpackColor565(color0, palette[0]);
+	UnpackColor565(color1, palette[1]);
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		if (isFourColor)
+		{
+			palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+			palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+		}
+		else
+		{
+			palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+			palette[3][channel] = 0;
+		}
+	}
+	palette[0][3] = palette[1][3] = palette[2][3] = 255;
+	palette[3][3] = isFourColor ? 255 : 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void EncodeColorBlock( const unsigned char* block, unsigned char* outBytes )
+{
+	int minColor[3] = { 255, 255, 255 };
+	int maxColor[3] = { 0, 0, 0 };
+	for (uint32_t texel = 0; texel < 16U; ++texel)
+	{
+		for (int channel = 0; channel < 3; ++channel)
+		{
+			minColor[channel] = (block[texel * 4U + channel] < minColor[channel]) ? block[texel * 4U + channel] : minColor[channel];
+			maxColor[channel] = (block[texel * 4U + channel] > maxColor[channel]) ? block[texel * 4U + channel] : maxColor[channel];
+		}
+	}
+
+	//Red and blue are flipped when they fall while green rises, so the endpoints sit on the block's real diagonal
+	int covariance[3] = { 0, 0, 0 };
+	for (uint32_t texel = 0; texel < 16U; ++texel)
+	{
+		int green = 2 * block[texel * 4U + 1U] - (minColor[1] + maxColor[1]);
+		covariance[0] += (2 * block[texel * 4U + 0U] - (minColor[0] + maxColor[0])) * green;
+		covariance[2] += (2 * block[texel * 4U + 2U] - (minColor[2] + maxColor[2])) * green;
+	}
+
+	int endpoints[2][3];
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		int inset = (maxColor[channel] - minColor[channel]) / 16;
+		endpoints[0][channel] = maxColor[channel] - inset;
+		endpoints[1][channel] = minColor[channel] + inset;
+		if (covariance[channel] < 0)
+		{
+			int swapped = endpoints[0][channel];
+			endpoints[0][channel] = endpoints[1][channel];
+			endpoints[1][channel] = swapped;
+		}
+	}
+
+	//color0 > color1 selects the four color mode, the only one that interpolates
+	uint16_t color0 = PackColor565(endpoints[0]);
+	uint16_t color1 = PackColor565(endpoints[1]);
+	if (color0 < color1)
+	{
+		uint16_t swapped = color0;
+		color0 = color1;
+		color1 = swapped;
+	}
+
+	int palette[4][4];
+	BuildColorPalette(color0, color1, true, palette);
+
+	uint32_t indices = 0U;
+	if (color0 != color1)
+	{
+		for (uint32_t texel = 0; texel < 16U; ++texel)
+		{
+			int bestDistance = 0x7FFFFFFF;
+			uint32_t bestIndex = 0U;
+			for (uint32_t paletteIndex = 0; paletteIndex < 4U; ++paletteIndex)
+			{
+				int distance = 0;
+				for (int channel = 0; channel < 3; ++channel)
+				{
+					int delta = block[texel * 4U + channel] - palette[paletteIndex][channel];
+					distance += delta * delta;
+				}
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = paletteIndex;
+				}
+			}
+			indices |= bestIndex << (texel * 2U);
+		}
+	}
+
+	memcpy(outBytes, &color0, 2U);
+	memcpy(outBytes + 2U, &color1, 2U);
+	memcpy(outBytes + 4U, &indices, 4U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildAlphaPalette( int alpha0, int alpha1, int* palette )
+{
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	for (int step = 1; step < 7; ++step)
+	{
+		palette[step + 1] = ((7 - step) * alpha0 + step * alpha1) / 7;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void EncodeAlphaBlock( const unsigned char* block, unsigned char* outBytes )
+{
+	int minAlpha = 255;
+	int maxAlpha = 0;
+	for (uint32_t texel = 0; texel < 16U; ++texel)
+	{
+		minAlpha = (block[texel * 4U + 3U] < minAlpha) ? block[texel * 4U + 3U] : minAlpha;
+		maxAlpha = (block[texel * 4U + 3U] > maxAlpha) ? block[texel * 4U + 3U] : maxAlpha;
+	}
+
+	//alpha0 > alpha1 selects eight interpolated values; a flat block keeps every index at 0
+	int palette[8];
+	BuildAlphaPalette(maxAlpha, minAlpha, palette);
+
+	uint64_t indices = 0U;
+	if (maxAlpha != minAlpha)
+	{
+		for (uint32_t texel = 0; texel < 16U; ++texel)
+		{
+			int bestDistance = 256;
+			uint64_t bestIndex = 0U;
+			for (uint32_t paletteIndex = 0; paletteIndex < 8U; ++paletteIndex)
+			{
+				int distance = abs(block[texel * 4U + 3U] - palette[paletteIndex]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = paletteIndex;
+				}
+			}
+			indices |= bestIndex << (texel * 3U);
+		}
+	}
+
+	outBytes[0] = (unsigned char)maxAlpha;
+	outBytes[1] = (unsigned char)minAlpha;
+	for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+	{
+		outBytes[2 + byteIndex] = (unsigned char)(indices >> (byteIndex * 8));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void CompressTextureBC( eCookedTextureFormat format, const unsigned char* texels, uint32_t width, uint32_t height, std::vector<unsigned char>& outBlocks )
+{
+	size_t blockBytes = (format == COOKED_TEXTURE_FORMAT_BC3) ? BC3_BLOCK_BYTES : BC1_BLOCK_BYTES;
+	outBlocks.resize(GetCookedMipByteCount(format, width, height));
+
+	unsigned char block[BC_BLOCK_SIZE * BC_BLOCK_SIZE * 4U];
+	unsigned char* output = outBlocks.data();
+	for (uint32_t blockY = 0; blockY < GetBlockCount(height); ++blockY)
+	{
+		for (uint32_t blockX = 0; blockX < GetBlockCount(width); ++blockX)
+		{
+			GatherBlockTexels(texels, width, height, blockX, blockY, block);
+			if (format == COOKED_TEXTURE_FORMAT_BC3)
+			{
+				EncodeAlphaBlock(block, output);
+				EncodeColorBlock(block, output + 8U);
+			}
+			else
+			{
+				EncodeColorBlock(block, output);
+			}
+			output += blockBytes;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DecompressTextureBC( eCookedTextureFormat format, const unsigned char* blocks, uint32_t width, uint32_t height, std::vector<unsigned char>& outTexels )
+{
+	size_t blockBytes = (format == COOKED_TEXTURE_FORMAT_BC3) ? BC3_BLOCK_BYTES : BC1_BLOCK_BYTES;
+	outTexels.resize((size_t)width * height * 4U);
+
+	for (uint32_t blockY = 0; blockY < GetBlockCount(height); ++blockY)
+	{
+		for (uint32_t blockX = 0; blockX < GetBlockCount(width); ++blockX)
+		{
+			const unsigned char* input = blocks + ((size_t)blockY * GetBlockCount(width) + blockX) * blockBytes;
+			const unsigned char* colorBlock = (format == COOKED_TEXTURE_FORMAT_BC3) ? input + 8U : input;
+
+			uint16_t color0;
+			uint16_t color1;
+			uint32_t colorIndices;
+			memcpy(&color0, colorBlock, 2U);
+			memcpy(&color1, colorBlock + 2U, 2U);
+			memcpy(&colorIndices, colorBlock + 4U, 4U);
+
+			//BC3 color is always four color, whatever the endpoint order
+			int palette[4][4];
+			BuildColorPalette(color0, color1, format == COOKED_TEXTURE_FORMAT_BC3 || color0 > color1, palette);
+
+			int alphaPalette[8];
+			uint64_t alphaIndices = 0U;
+			if (format == COOKED_TEXTURE_FORMAT_BC3)
+			{
+				BuildAlphaPalette(input[0], input[1], alphaPalette);
+				for (int byteIndex = 0; byteIndex < 6; ++byteIndex)
+				{
+					alphaIndices |= (uint64_t)input[2 + byteIndex] << (byteIndex * 8);
+				}
+			}
+
+			for (uint32_t texel = 0; texel < 16U; ++texel)
+			{
+				uint32_t x = blockX * BC_BLOCK_SIZE + texel % BC_BLOCK_SIZE;
+				uint32_t y = blockY * BC_BLOCK_SIZE + texel / BC_BLOCK_SIZE;
+				if (x >= width || y >= height)
+				{
+					continue;
+				}
+
+				const int* color = palette[(colorIndices >> (texel * 2U)) & 3U];
+				unsigned char* destination = outTexels.data() + ((size_t)y * width + x) * 4U;
+				destination[0] = (unsigned char)color[0];
+				destination[1] = (unsigned char)color[1];
+				destination[2] = (unsigned char)color[2];
+				destination[3] = (format == COOKED_TEXTURE_FORMAT_BC3) ? (unsigned char)alphaPalette[(alphaIndices >> (texel * 3U)) & 7U] : (unsigned char)color[3];
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool WriteCookedTexture( const std::string& filePath, uint64_t sourceHash, eCookedTextureFormat format, uint16_t flags,
+	const std::vector<std::vector<unsigned char>>& mips, uint32_t width, uint32_t height )
+{
+	if (mips.empty() || mips.size() > COOKED_TEXTURE_MAX_MIPS)
+	{
+		return false;
+	}
+
+	CookedTextureHeaderT header;
+	header.sourceHash = sourceHash;
+	header.format = (uint16_t)format;
+	header.flags = flags;
+	header.width = width;
+	header.height = height;
+	header.mipCount = (uint32_t)mips.size();
+
+	std::vector<CookedTextureMipT> mipTable(mips.size());
+	uint32_t offset = (uint32_t)(sizeof(CookedTextureHeaderT) + mipTable.size() * sizeof(CookedTextureMipT));
+	for (size_t mipIndex = 0; mipIndex < mips.size(); ++mipIndex)
+	{
+		CookedTextureMipT& mip = mipTable[mipIndex];
+		mip.width = (width >> mipIndex) > 0U ? (width >> mipIndex) : 1U;
+		mip.height = (height >> mipIndex) > 0U ? (height >> mipIndex) : 1U;
+		mip.byteCount = (uint32_t)mips[mipIndex].size();
+		mip.offset = AlignCookedTextureOffset(offset);
+		if (mip.byteCount != GetCookedMipByteCount(format, mip.width, mip.height))
+		{
+			return false;
+		}
+		offset = mip.offset + mip.byteCount;
+	}
+
+	return WriteFileAtomically(filePath, [&](FILE* file)
+	{
+		static const unsigned char s_padding[COOKED_TEXTURE_BLOB_ALIGNMENT] = {};
+		bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(mipTable.data(), sizeof(CookedTextureMipT), mipTable.size(), file) == mipTable.size();
+
+		uint32_t written = (uint32_t)(sizeof(CookedTextureHeaderT) + mipTable.size() * sizeof(CookedTextureMipT));
+		for (size_t mipIndex = 0; mipIndex < mips.size() && isWritten; ++mipIndex)
+		{
+			isWritten = fwrite(s_padding, 1, mipTable[mipIndex].offset - written, file) == mipTable[mipIndex].offset - written
+				&& fwrite(mips[mipIndex].data(), 1, mips[mipIndex].size(), file) == mips[mipIndex].size();
+			written = mipTable[mipIndex].offset + mipTable[mipIndex].byteCount;
+		}
+		return isWritten;
+	});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReadCookedTexture( const unsigned char* data, size_t byteCount, CookedTextureViewT& outView, uint64_t* outSourceHash )
+{
+	if (data == nullptr || byteCount < sizeof(CookedTextureHeaderT))
+	{
+		return false;
+	}
+
+	CookedTextureHeaderT header;
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != COOKED_TEXTURE_MAGIC || header.version != COOKED_TEXTURE_VERSION || header.headerSize != sizeof(CookedTextureHeaderT)
+		|| header.mipCount == 0U || header.mipCount > COOKED_TEXTURE_MAX_MIPS || header.width == 0U || header.height == 0U
+		|| GetCookedMipByteCount((eCookedTextureFormat)header.format, 1U, 1U) == 0U)
+	{
+		return false;
+	}
+
+	size_t tableEnd = sizeof(CookedTextureHeaderT) + header.mipCount * sizeof(CookedTextureMipT);
+	if (tableEnd > byteCount)
+	{
+		return false;
+	}
+
+	outView.format = (eCookedTextureFormat)header.format;
+	outView.flags = header.flags;
+	outView.mipCount = header.mipCount;
+	for (uint32_t mipIndex = 0; mipIndex < header.mipCount; ++mipIndex)
+	{
+		CookedTextureMipT mip;
+		memcpy(&mip, data + sizeof(CookedTextureHeaderT) + mipIndex * sizeof(CookedTextureMipT), sizeof(mip));
+
+		//64 bit math so a corrupt offset can not wrap past the size check
+		uint32_t expectedWidth = (header.width >> mipIndex) > 0U ? (header.width >> mipIndex) : 1U;
+		uint32_t expectedHeight = (header.height >> mipIndex) > 0U ? (header.height >> mipIndex) : 1U;
+		if (mip.width != expectedWidth || mip.height != expectedHeight || (mip.offset % COOKED_TEXTURE_BLOB_ALIGNMENT) != 0U || mip.offset < tableEnd
+			|| mip.byteCount != GetCookedMipByteCount(outView.format, mip.width, mip.height) || (uint64_t)mip.offset + mip.byteCount > (uint64_t)byteCount)
+		{
+			return false;
+		}
+
+		outView.mips[mipIndex].width = mip.width;
+		outView.mips[mipIndex].height = mip.height;
+		outView.mips[mipIndex].data = data + mip.offset;
+		outView.mips[mipIndex].byteCount = mip.byteCount;
+	}
+
+	if (outSourceHash != nullptr)
+	{
+		*outSourceHash = header.sourceHash;
+	}
+	return true;
+}
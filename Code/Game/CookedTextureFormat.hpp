@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Cooked texture file layout (shared by TextureStreamer and the TextureCooker tool)
+//
+// File:	CookedTextureHeaderT, then mipCount CookedTextureMipT, then the mip blobs largest first. Every blob starts on a 16
+// byte boundary so it can be uploaded straight out of a mapped file. RGBA8 blobs are tightly packed rows; BC blobs are rows
+// of 4x4 blocks, with the edge blocks of odd sized mips padded by repeating the last row and column.
+// sourceHash is FNV-1a over the bytes of the source image file, a mismatch means the source changed since the cook.
+// Rows are stored in the order the engine loads images (bottom row first) when COOKED_TEXTURE_FLAG_ROWS_FLIPPED is set.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t COOKED_TEXTURE_MAGIC = 0x58455443U;	// "CTEX"
+constexpr uint16_t COOKED_TEXTURE_VERSION = 1U;
+constexpr uint32_t COOKED_TEXTURE_BLOB_ALIGNMENT = 16U;
+//Enough for a 32k texture
+constexpr uint32_t COOKED_TEXTURE_MAX_MIPS = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eCookedTextureFormat : uint16_t
+{
+	COOKED_TEXTURE_FORMAT_RGBA8 = 1,
+	//Opaque, 4 bits per texel
+	COOKED_TEXTURE_FORMAT_BC1,
+	//Interpolated alpha, 8 bits per texel
+	COOKED_TEXTURE_FORMAT_BC3
+};
+
+enum eCookedTextureFlags : uint16_t
+{
+	COOKED_TEXTURE_FLAG_ROWS_FLIPPED = 1 << 0,
+	//Mips were averaged in linear light; cleared for data textures such as normal maps
+	COOKED_TEXTURE_FLAG_SRGB = 1 << 1
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+struct CookedTextureHeaderT
+{
+	uint32_t							magic = COOKED_TEXTURE_MAGIC;
+	uint16_t							version = COOKED_TEXTURE_VERSION;
+	uint16_t							headerSize = sizeof(CookedTextureHeaderT);
+	uint64_t							sourceHash = 0U;
+	uint16_t							format = COOKED_TEXTURE_FORMAT_RGBA8;
+	uint16_t							flags = 0U;
+	uint32_t							width = 0U;
+	uint32_t							height = 0U;
+	uint32_t							mipCount = 0U;
+};
+
+struct CookedTextureMipT
+{
+	uint32_t							offset = 0U;
+	uint32_t							byteCount = 0U;
+	uint32_t							width = 0U;
+	uint32_t							height = 0U;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One mip of a cooked texture, either in memory while cooking or pointing into a mapped file while loading
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedTextureMipDataT
+{
+	uint32_t							width = 0U;
+	uint32_t							height = 0U;
+	const unsigned char*				data = nullptr;
+	size_t								byteCount = 0U;
+};
+
+struct CookedTextureViewT
+{
+	eCookedTextureFormat				format = COOKED_TEXTURE_FORMAT_RGBA8;
+	uint16_t							flags = 0U;
+	uint32_t							mipCount = 0U;
+	CookedTextureMipDataT				mips[COOKED_TEXTURE_MAX_MIPS];
+};
+
+uint64_t	HashTextureSource( const void* bytes, size_t byteCount );
+size_t		GetCookedMipByteCount( eCookedTextureFormat format, uint32_t width, uint32_t height );
+//Every mip of the view, which is what creating the texture uploads
+size_t		GetCookedTextureByteCount( const CookedTextureViewT& mips );
+
+//Box filtered chain from the RGBA8 level 0 down to 1x1, level 0 included. With isSRGB the color channels are averaged in
+//linear light, which keeps bright detail from going dark in the small mips; alpha is always averaged as stored
+void		BuildTextureMipChain( const unsigned char* texels, uint32_t width, uint32_t height, bool isSRGB, std::vector<std::vector<unsigned char>>& outMips );
+
+//RGBA8 texels in, BC blocks out (GetCookedMipByteCount bytes). BC1 ignores alpha
+void		CompressTextureBC( eCookedTextureFormat format, const unsigned char* texels, uint32_t width, uint32_t height, std::vector<unsigned char>& outBlocks );
+//The inverse, for measuring what the compression cost
+void		DecompressTextureBC( eCookedTextureFormat format, const unsigned char* blocks, uint32_t width, uint32_t height, std::vector<unsigned char>& outTexels );
+
+bool		WriteCookedTexture( const std::string& filePath, uint64_t sourceHash, eCookedTextureFormat format, uint16_t flags,
+				const std::vector<std::vector<unsigned char>>& mips, uint32_t width, uint32_t height );
+//Points outView into data. Fails on anything inconsistent, including a truncated file
+bool		ReadCookedTexture( const unsigned char* data, size_t byteCount, CookedTextureViewT& outView, uint64_t* outSourceHash = nullptr );
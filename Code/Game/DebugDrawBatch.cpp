@@ -0,0 +1,1007 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/DebugDrawBatch.hpp"
+//Engine Systems
+#include "Engine/Renderer/BitmapFont.hpp"
+//Game Systems
+#include "Game/JobScheduler.hpp"
+//Third Party
+#include <algorithm>
+#include <math.h>
+#include <new>
+#include <stdarg.h>
+#include <stdio.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DEBUG_DRAW_HAS_SSE
+#include <xmmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint DEBUG_DRAW_WRITE_GRAIN = 256U;
+constexpr uint DEBUG_DRAW_MIN_FRAME_ARRAY = 16U;
+constexpr uint DEBUG_SPHERE_SLICES = 16U;
+constexpr uint DEBUG_SPHERE_STACKS = 8U;
+constexpr uint DEBUG_WIRE_SPHERE_SEGMENTS = 24U;
+constexpr uint DEBUG_DISC_SEGMENTS = 32U;
+constexpr uint DEBUG_RING_SEGMENTS = 48U;
+constexpr float DEBUG_DRAW_TWO_PI = 6.28318531f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Vec3 Cross( const Vec3& a, const Vec3& b )
+{
+	return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float Dot( const Vec3& a, const Vec3& b )
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Vec3 Normalized( const Vec3& a )
+{
+	float length = sqrtf(Dot(a, a));
+	return (length > 0.f) ? a * (1.f / length) : a;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapeVertex( DebugShapeT& shape, const Vec3& position, const Vec2& uv )
+{
+	shape.x.push_back(position.x);
+	shape.y.push_back(position.y);
+	shape.z.push_back(position.z);
+	shape.u.push_back(uv.x);
+	shape.v.push_back(uv.y);
+	shape.vertCount++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Wound like SpriteBatch's quads: counter clockwise as seen from the outward side, which has the cross product pointing away
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapeTriangle( DebugShapeT& shape, const Vec3& a, const Vec3& b, const Vec3& c, const Vec2& uvA, const Vec2& uvB, const Vec2& uvC, const Vec3& outward )
+{
+	AddShapeVertex(shape, a, uvA);
+	if (Dot(Cross(b - a, c - a), outward) > 0.f)
+	{
+		AddShapeVertex(shape, c, uvC);
+		AddShapeVertex(shape, b, uvB);
+	}
+	else
+	{
+		AddShapeVertex(shape, b, uvB);
+		AddShapeVertex(shape, c, uvC);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapeQuad( DebugShapeT& shape, const Vec3& p0, const Vec3& p1, const Vec3& p2, const Vec3& p3, const Vec3& outward,
+	const Vec2& uv0 = Vec2(0.f, 0.f), const Vec2& uv1 = Vec2(1.f, 0.f), const Vec2& uv2 = Vec2(1.f, 1.f), const Vec2& uv3 = Vec2(0.f, 1.f) )
+{
+	AddShapeTriangle(shape, p0, p1, p2, uv0, uv1, uv2, outward);
+	AddShapeTriangle(shape, p0, p2, p3, uv0, uv2, uv3, outward);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapeEdge( DebugShapeT& shape, const Vec3& start, const Vec3& end )
+{
+	AddShapeVertex(shape, start, Vec2(0.f, 0.f));
+	AddShapeVertex(shape, end, Vec2(1.f, 0.f));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Radius 1 around the origin in the plane of circleU and circleV
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapeCircle( DebugShapeT& shape, const Vec3& circleU, const Vec3& circleV, uint segmentCount )
+{
+	for (uint segment = 0; segment < segmentCount; ++segment)
+	{
+		float angle0 = DEBUG_DRAW_TWO_PI * (float)segment / (float)segmentCount;
+		float angle1 = DEBUG_DRAW_TWO_PI * (float)(segment + 1U) / (float)segmentCount;
+		AddShapeEdge(shape, circleU * cosf(angle0) + circleV * sinf(angle0), circleU * cosf(angle1) + circleV * sinf(angle1));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Square tube from start to end, no caps. sideA and sideB are unit and perpendicular to it
+//------------------------------------------------------------------------------------------------------------------------------
+static void AddShapePrism( DebugShapeT& shape, const Vec3& start, const Vec3& end, const Vec3& sideA, const Vec3& sideB, float halfWidth )
+{
+	Vec3 sides[4] = { sideA, sideB, sideA * -1.f, sideB * -1.f };
+	for (uint sideIndex = 0; sideIndex < 4U; ++sideIndex)
+	{
+		Vec3 normal = sides[sideIndex] * halfWidth;
+		Vec3 across = sides[(sideIndex + 1U) & 3U] * halfWidth;
+		AddShapeQuad(shape, start + normal - across, end + normal - across, end + normal + across, start + normal + across, sides[sideIndex]);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void PadShape( DebugShapeT& shape )
+{
+	uint paddedCount = (shape.vertCount + 3U) & ~3U;
+	shape.x.resize(paddedCount, 0.f);
+	shape.y.resize(paddedCount, 0.f);
+	shape.z.resize(paddedCount, 0.f);
+	shape.u.resize(paddedCount, 0.f);
+	shape.v.resize(paddedCount, 0.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// [-1, 1] on every axis
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildBox( DebugShapeT& shape )
+{
+	const Vec3 axes[3] = { Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 1.f) };
+	for (uint axis = 0; axis < 3U; ++axis)
+	{
+		const Vec3& tangentU = axes[(axis + 1U) % 3U];
+		const Vec3& tangentV = axes[(axis + 2U) % 3U];
+		for (float side = -1.f; side <= 1.f; side += 2.f)
+		{
+			Vec3 center = axes[axis] * side;
+			AddShapeQuad(shape, center - tangentU - tangentV, center + tangentU - tangentV, center + tangentU + tangentV, center - tangentU + tangentV, center);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildWireBox( DebugShapeT& shape )
+{
+	shape.topology = DEBUG_DRAW_LINES;
+	const Vec3 axes[3] = { Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 1.f) };
+	for (uint axis = 0; axis < 3U; ++axis)
+	{
+		const Vec3& sideA = axes[(axis + 1U) % 3U];
+		const Vec3& sideB = axes[(axis + 2U) % 3U];
+		for (float signA = -1.f; signA <= 1.f; signA += 2.f)
+		{
+			for (float signB = -1.f; signB <= 1.f; signB += 2.f)
+			{
+				Vec3 offset = sideA * signA + sideB * signB;
+				AddShapeEdge(shape, offset - axes[axis], offset + axes[axis]);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Radius 1, Z up, u around and v from bottom to top
+//------------------------------------------------------------------------------------------------------------------------------
+static Vec3 GetSpherePoint( uint slice, uint stack )
+{
+	float yaw = DEBUG_DRAW_TWO_PI * (float)slice / (float)DEBUG_SPHERE_SLICES;
+	float pitch = DEBUG_DRAW_TWO_PI * 0.5f * ((float)stack / (float)DEBUG_SPHERE_STACKS - 0.5f);
+	return Vec3(cosf(pitch) * cosf(yaw), cosf(pitch) * sinf(yaw), sinf(pitch));
+}
+
+static void BuildSphere( DebugShapeT& shape )
+{
+	for (uint stack = 0; stack < DEBUG_SPHERE_STACKS; ++stack)
+	{
+		for (uint slice = 0; slice < DEBUG_SPHERE_SLICES; ++slice)
+		{
+			Vec3 p0 = GetSpherePoint(slice, stack);
+			Vec3 p1 = GetSpherePoint(slice + 1U, stack);
+			Vec3 p2 = GetSpherePoint(slice + 1U, stack + 1U);
+			Vec3 p3 = GetSpherePoint(slice, stack + 1U);
+
+			float u0 = (float)slice / (float)DEBUG_SPHERE_SLICES;
+			float u1 = (float)(slice + 1U) / (float)DEBUG_SPHERE_SLICES;
+			float v0 = (float)stack / (float)DEBUG_SPHERE_STACKS;
+			float v1 = (float)(stack + 1U) / (float)DEBUG_SPHERE_STACKS;
+			AddShapeQuad(shape, p0, p1, p2, p3, Normalized(p0 + p1 + p2 + p3), Vec2(u0, v0), Vec2(u1, v0), Vec2(u1, v1), Vec2(u0, v1));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Three great circles, one around each axis
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildWireSphere( DebugShapeT& shape )
+{
+	shape.topology = DEBUG_DRAW_LINES;
+	const Vec3 axes[3] = { Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.f, 1.f) };
+	for (uint axis = 0; axis < 3U; ++axis)
+	{
+		AddShapeCircle(shape, axes[(axis + 1U) % 3U], axes[(axis + 2U) % 3U], DEBUG_WIRE_SPHERE_SEGMENTS);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Along Z from 0 to 1, one unit across
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildLine( DebugShapeT& shape )
+{
+	AddShapePrism(shape, Vec3(0.f, 0.f, 0.f), Vec3(0.f, 0.f, 1.f), Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), 0.5f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// [0, 1] in X and Y, facing a camera that looks down +Z
+//------------------------------------------------------------------------------------------------------------------------------
+static const Vec3 DEBUG_FLAT_OUTWARD = Vec3(0.f, 0.f, -1.f);
+
+static void BuildQuad( DebugShapeT& shape )
+{
+	AddShapeQuad(shape, Vec3(0.f, 0.f, 0.f), Vec3(1.f, 0.f, 0.f), Vec3(1.f, 1.f, 0.f), Vec3(0.f, 1.f, 0.f), DEBUG_FLAT_OUTWARD);
+}
+
+static void BuildWireQuad( DebugShapeT& shape )
+{
+	shape.topology = DEBUG_DRAW_LINES;
+	const Vec3 corners[4] = { Vec3(0.f, 0.f, 0.f), Vec3(1.f, 0.f, 0.f), Vec3(1.f, 1.f, 0.f), Vec3(0.f, 1.f, 0.f) };
+	for (uint corner = 0; corner < 4U; ++corner)
+	{
+		AddShapeEdge(shape, corners[corner], corners[(corner + 1U) & 3U]);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// From the middle of its base at the origin to the tip at (1, 0), one unit wide
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildArrowHead( DebugShapeT& shape )
+{
+	AddShapeTriangle(shape, Vec3(0.f, -0.5f, 0.f), Vec3(1.f, 0.f, 0.f), Vec3(0.f, 0.5f, 0.f), Vec2(0.f, 0.f), Vec2(1.f, 0.5f), Vec2(0.f, 1.f), DEBUG_FLAT_OUTWARD);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Radius 1 around the origin
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildDisc( DebugShapeT& shape )
+{
+	for (uint segment = 0; segment < DEBUG_DISC_SEGMENTS; ++segment)
+	{
+		float angle0 = DEBUG_DRAW_TWO_PI * (float)segment / (float)DEBUG_DISC_SEGMENTS;
+		float angle1 = DEBUG_DRAW_TWO_PI * (float)(segment + 1U) / (float)DEBUG_DISC_SEGMENTS;
+		Vec3 edge0 = Vec3(cosf(angle0), sinf(angle0), 0.f);
+		Vec3 edge1 = Vec3(cosf(angle1), sinf(angle1), 0.f);
+		AddShapeTriangle(shape, Vec3(0.f, 0.f, 0.f), edge0, edge1, Vec2(0.5f, 0.5f), Vec2(0.5f + edge0.x * 0.5f, 0.5f + edge0.y * 0.5f),
+			Vec2(0.5f + edge1.x * 0.5f, 0.5f + edge1.y * 0.5f), DEBUG_FLAT_OUTWARD);
+	}
+}
+
+static void BuildRing( DebugShapeT& shape )
+{
+	shape.topology = DEBUG_DRAW_LINES;
+	AddShapeCircle(shape, Vec3(1.f, 0.f, 0.f), Vec3(0.f, 1.f, 0.f), DEBUG_RING_SEGMENTS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Writes origin + x * axisI + y * axisJ + z * axisK for every vertex of the unit mesh
+//------------------------------------------------------------------------------------------------------------------------------
+static void TransformShape( const DebugShapeT& shape, const Vec3& origin, const Vec3& axisI, const Vec3& axisJ, const Vec3& axisK, const Rgba& color, Vertex_PCU* outVerts )
+{
+	const float* xs = shape.x.data();
+	const float* ys = shape.y.data();
+	const float* zs = shape.z.data();
+	const float* us = shape.u.data();
+	const float* vs = shape.v.data();
+	uint vertCount = shape.vertCount;
+
+#if defined(DEBUG_DRAW_HAS_SSE)
+	const __m128 originX = _mm_set1_ps(origin.x);
+	const __m128 originY = _mm_set1_ps(origin.y);
+	const __m128 originZ = _mm_set1_ps(origin.z);
+	const __m128 iX = _mm_set1_ps(axisI.x);
+	const __m128 iY = _mm_set1_ps(axisI.y);
+	const __m128 iZ = _mm_set1_ps(axisI.z);
+	const __m128 jX = _mm_set1_ps(axisJ.x);
+	const __m128 jY = _mm_set1_ps(axisJ.y);
+	const __m128 jZ = _mm_set1_ps(axisJ.z);
+	const __m128 kX = _mm_set1_ps(axisK.x);
+	const __m128 kY = _mm_set1_ps(axisK.y);
+	const __m128 kZ = _mm_set1_ps(axisK.z);
+
+	alignas(16) float outX[4];
+	alignas(16) float outY[4];
+	alignas(16) float outZ[4];
+	for (uint groupStart = 0; groupStart < vertCount; groupStart += 4U)
+	{
+		__m128 x = _mm_loadu_ps(xs + groupStart);
+		__m128 y = _mm_loadu_ps(ys + groupStart);
+		__m128 z = _mm_loadu_ps(zs + groupStart);
+
+		_mm_store_ps(outX, _mm_add_ps(_mm_add_ps(originX, _mm_mul_ps(x, iX)), _mm_add_ps(_mm_mul_ps(y, jX), _mm_mul_ps(z, kX))));
+		_mm_store_ps(outY, _mm_add_ps(_mm_add_ps(originY, _mm_mul_ps(x, iY)), _mm_add_ps(_mm_mul_ps(y, jY), _mm_mul_ps(z, kY))));
+		_mm_store_ps(outZ, _mm_add_ps(_mm_add_ps(originZ, _mm_mul_ps(x, iZ)), _mm_add_ps(_mm_mul_ps(y, jZ), _mm_mul_ps(z, kZ))));
+
+		//The padding past vertCount is computed but never written out
+		uint laneCount = std::min(4U, vertCount - groupStart);
+		for (uint lane = 0; lane < laneCount; ++lane)
+		{
+			uint vertIndex = groupStart + lane;
+			outVerts[vertIndex] = Vertex_PCU(Vec3(outX[lane], outY[lane], outZ[lane]), color, Vec2(us[vertIndex], vs[vertIndex]));
+		}
+	}
+#else
+	for (uint vertIndex = 0; vertIndex < vertCount; ++vertIndex)
+	{
+		Vec3 position = origin + axisI * xs[vertIndex] + axisJ * ys[vertIndex] + axisK * zs[vertIndex];
+		outVerts[vertIndex] = Vertex_PCU(position, color, Vec2(us[vertIndex], vs[vertIndex]));
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Rgba LerpColor( const Rgba& begin, const Rgba& end, float fraction )
+{
+	return Rgba(begin.r + (end.r - begin.r) * fraction, begin.g + (end.g - begin.g) * fraction, begin.b + (end.b - begin.b) * fraction,
+		begin.a + (end.a - begin.a) * fraction);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint8_t GetDrawPass( const DebugRenderOptionsT& options, eDebugDrawSpace space )
+{
+	//Screen space has no depth to test against
+	if (space == DEBUG_DRAW_SCREEN || options.mode == DEBUG_RENDER_ALWAYS)
+	{
+		return DEBUG_DRAW_PASS_ALWAYS;
+	}
+	if (options.mode == DEBUG_RENDER_XRAY)
+	{
+		return DEBUG_DRAW_PASS_XRAY_VISIBLE;
+	}
+	return DEBUG_DRAW_PASS_USE_DEPTH;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Makes room for one more item in an array that lives in frame memory. A full array is copied into one twice its size and the
+// old one is left for the allocator to take back. After EndFrame items is null but capacity still holds the last frame's size,
+// so a frame like the one before sets its array up once
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static T* ReserveFrameArray( FrameAllocator& frameAllocator, T* items, uint count, uint& capacity )
+{
+	if (items != nullptr && count < capacity)
+	{
+		return items;
+	}
+
+	uint newCapacity = (items == nullptr) ? std::max(capacity, DEBUG_DRAW_MIN_FRAME_ARRAY) : capacity * 2U;
+	T* grown = frameAllocator.AllocateArray<T>(newCapacity);
+	for (uint itemIndex = 0; itemIndex < count; ++itemIndex)
+	{
+		new (&grown[itemIndex]) T(items[itemIndex]);
+	}
+	capacity = newCapacity;
+	return grown;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+DebugDrawBatch::DebugDrawBatch( FrameAllocator* frameAllocator )
+	: m_frameAllocator(frameAllocator)
+{
+	BuildBox(m_shapes[DEBUG_SHAPE_BOX]);
+	BuildWireBox(m_shapes[DEBUG_SHAPE_WIRE_BOX]);
+	BuildSphere(m_shapes[DEBUG_SHAPE_SPHERE]);
+	BuildWireSphere(m_shapes[DEBUG_SHAPE_WIRE_SPHERE]);
+	BuildLine(m_shapes[DEBUG_SHAPE_LINE]);
+	BuildQuad(m_shapes[DEBUG_SHAPE_QUAD]);
+	BuildWireQuad(m_shapes[DEBUG_SHAPE_WIRE_QUAD]);
+	BuildDisc(m_shapes[DEBUG_SHAPE_DISC]);
+	BuildRing(m_shapes[DEBUG_SHAPE_RING]);
+	BuildArrowHead(m_shapes[DEBUG_SHAPE_ARROW_HEAD]);
+
+	for (DebugShapeT& shape : m_shapes)
+	{
+		PadShape(shape);
+	}
+}
+
+DebugDrawBatch::~DebugDrawBatch()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::BeginFrame( float deltaSeconds )
+{
+	//In place and in order, so add order within a bucket holds from frame to frame
+	size_t keptCount = 0U;
+	for (size_t objectIndex = 0; objectIndex < m_objects.size(); ++objectIndex)
+	{
+		DebugObjectT& object = m_objects[objectIndex];
+		object.age += deltaSeconds;
+		if (object.age > object.duration)
+		{
+			continue;
+		}
+
+		if (keptCount != objectIndex)
+		{
+			m_objects[keptCount] = object;
+		}
+		keptCount++;
+	}
+	m_objects.resize(keptCount);
+
+	keptCount = 0U;
+	for (size_t textIndex = 0; textIndex < m_texts.size(); ++textIndex)
+	{
+		DebugTextT& text = m_texts[textIndex];
+		text.placement.age += deltaSeconds;
+		if (text.placement.age > text.placement.duration)
+		{
+			continue;
+		}
+
+		if (keptCount != textIndex)
+		{
+			m_texts[keptCount] = text;
+		}
+		keptCount++;
+	}
+	m_texts.resize(keptCount);
+
+	keptCount = 0U;
+	for (size_t lineIndex = 0; lineIndex < m_logLines.size(); ++lineIndex)
+	{
+		DebugLogLineT& line = m_logLines[lineIndex];
+		line.age += deltaSeconds;
+		if (line.age > line.duration)
+		{
+			continue;
+		}
+
+		if (keptCount != lineIndex)
+		{
+			m_logLines[keptCount] = line;
+		}
+		keptCount++;
+	}
+	m_logLines.resize(keptCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::EndFrame()
+{
+	//Nothing in frame memory has a destructor to run
+	m_frameObjects = nullptr;
+	m_frameObjectCount = 0U;
+	m_frameTexts = nullptr;
+	m_frameTextCount = 0U;
+	m_frameLogLines = nullptr;
+	m_frameLogLineCount = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+DebugDrawBatch::DebugObjectT& DebugDrawBatch::AddObject( const DebugRenderOptionsT& options, eDebugDrawShape shape, eDebugDrawSpace space, float duration, TextureView* texture )
+{
+	DebugObjectT* newObject = nullptr;
+	if (duration > 0.f)
+	{
+		m_objects.emplace_back();
+		newObject = &m_objects.back();
+	}
+	else
+	{
+		m_frameObjects = ReserveFrameArray(*m_frameAllocator, m_frameObjects, m_frameObjectCount, m_frameObjectCapacity);
+		newObject = new (&m_frameObjects[m_frameObjectCount]) DebugObjectT();
+		m_frameObjectCount++;
+	}
+
+	DebugObjectT& object = *newObject;
+	object.beginColor = options.beginColor;
+	object.endColor = options.endColor;
+	object.texture = texture;
+	object.duration = (duration > 0.f) ? duration : 0.f;
+	object.shape = (uint8_t)shape;
+	object.space = (uint8_t)space;
+	object.pass = GetDrawPass(options, space);
+	return object;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+DebugDrawBatch::DebugTextPlacementT* DebugDrawBatch::AddTextPlacement( const DebugRenderOptionsT& options, const char* text, eDebugDrawSpace space, float duration )
+{
+	DebugTextPlacementT* placement = nullptr;
+	if (duration > 0.f)
+	{
+		m_texts.emplace_back();
+		DebugTextT& timedText = m_texts.back();
+		int length = snprintf(timedText.text, DEBUG_LOG_LINE_MAX_CHARS, "%s", text);
+		timedText.length = (length > 0) ? std::min((uint)length, DEBUG_LOG_LINE_MAX_CHARS - 1U) : 0U;
+		placement = &timedText.placement;
+	}
+	else
+	{
+		m_frameTexts = ReserveFrameArray(*m_frameAllocator, m_frameTexts, m_frameTextCount, m_frameTextCapacity);
+		DebugFrameTextT& frameText = *new (&m_frameTexts[m_frameTextCount]) DebugFrameTextT();
+		m_frameTextCount++;
+		frameText.text = m_frameAllocator->Format(frameText.length, "%s", text);
+		placement = &frameText.placement;
+	}
+
+	placement->beginColor = options.beginColor;
+	placement->endColor = options.endColor;
+	placement->duration = (duration > 0.f) ? duration : 0.f;
+	placement->space = (uint8_t)space;
+	placement->pass = GetDrawPass(options, space);
+	return placement;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddPoint( const DebugRenderOptionsT& options, const Vec3& position, float duration, float size, TextureView* texture )
+{
+	//A camera facing square, the cheapest shape that reads as a point from every side
+	float halfSize = size * 0.5f;
+	AddQuad(options, position, Vec2(-halfSize, -halfSize), Vec2(halfSize, halfSize), duration, texture, true);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddLine( const DebugRenderOptionsT& options, const Vec3& start, const Vec3& end, float duration, float thickness )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_LINE, DEBUG_DRAW_WORLD, duration, nullptr);
+	Vec3 direction = end - start;
+
+	//Any two sides perpendicular to the line; cross with the axis it is least aligned with
+	float absX = fabsf(direction.x);
+	float absY = fabsf(direction.y);
+	float absZ = fabsf(direction.z);
+	Vec3 helper = (absX <= absY && absX <= absZ) ? Vec3(1.f, 0.f, 0.f) : ((absY <= absZ) ? Vec3(0.f, 1.f, 0.f) : Vec3(0.f, 0.f, 1.f));
+	Vec3 sideA = Normalized(Cross(direction, helper));
+	Vec3 sideB = Normalized(Cross(direction, sideA));
+
+	object.origin = start;
+	object.axisI = sideA * thickness;
+	object.axisJ = sideB * thickness;
+	object.axisK = direction;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddBox( const DebugRenderOptionsT& options, const Vec3& center, const Vec3& halfExtents, float duration, TextureView* texture )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_BOX, DEBUG_DRAW_WORLD, duration, texture);
+	object.origin = center;
+	object.axisI = Vec3(halfExtents.x, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, halfExtents.y, 0.f);
+	object.axisK = Vec3(0.f, 0.f, halfExtents.z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddWireBox( const DebugRenderOptionsT& options, const Vec3& center, const Vec3& halfExtents, float duration )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_WIRE_BOX, DEBUG_DRAW_WORLD, duration, nullptr);
+	object.origin = center;
+	object.axisI = Vec3(halfExtents.x, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, halfExtents.y, 0.f);
+	object.axisK = Vec3(0.f, 0.f, halfExtents.z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddSphere( const DebugRenderOptionsT& options, const Vec3& center, float radius, float duration, TextureView* texture )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_SPHERE, DEBUG_DRAW_WORLD, duration, texture);
+	object.origin = center;
+	object.axisI = Vec3(radius, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, radius, 0.f);
+	object.axisK = Vec3(0.f, 0.f, radius);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddWireSphere( const DebugRenderOptionsT& options, const Vec3& center, float radius, float duration )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_WIRE_SPHERE, DEBUG_DRAW_WORLD, duration, nullptr);
+	object.origin = center;
+	object.axisI = Vec3(radius, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, radius, 0.f);
+	object.axisK = Vec3(0.f, 0.f, radius);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddQuad( const DebugRenderOptionsT& options, const Vec3& position, const Vec2& mins, const Vec2& maxs, float duration, TextureView* texture, bool isBillboarded )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_QUAD, DEBUG_DRAW_WORLD, duration, texture);
+	object.origin = position;
+	object.isBillboarded = isBillboarded;
+	object.billboardMins = mins;
+	object.billboardMaxs = maxs;
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+	if (!isBillboarded)
+	{
+		object.origin = position + Vec3(mins.x, mins.y, 0.f);
+		object.axisI = Vec3(maxs.x - mins.x, 0.f, 0.f);
+		object.axisJ = Vec3(0.f, maxs.y - mins.y, 0.f);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddText( const DebugRenderOptionsT& options, const Vec3& position, const Vec2& pivot, const char* text, float height, float duration, bool isBillboarded )
+{
+	DebugTextPlacementT* placement = AddTextPlacement(options, text, DEBUG_DRAW_WORLD, duration);
+	placement->position = position;
+	placement->pivot = pivot;
+	placement->height = height;
+	placement->isBillboarded = isBillboarded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddPoint2D( const DebugRenderOptionsT& options, const Vec2& position, float duration, float size )
+{
+	float halfSize = size * 0.5f;
+	AddQuad2D(options, Vec2(position.x - halfSize, position.y - halfSize), Vec2(position.x + halfSize, position.y + halfSize), duration);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddLine2D( const DebugRenderOptionsT& options, const Vec2& start, const Vec2& end, float duration, float thickness )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_QUAD, DEBUG_DRAW_SCREEN, duration, nullptr);
+	Vec3 direction = Vec3(end.x - start.x, end.y - start.y, 0.f);
+	//Turned a quarter counter clockwise, so the quad keeps its winding
+	Vec3 side = Normalized(Vec3(-direction.y, direction.x, 0.f)) * thickness;
+
+	object.origin = Vec3(start.x, start.y, 0.f) - side * 0.5f;
+	object.axisI = direction;
+	object.axisJ = side;
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddQuad2D( const DebugRenderOptionsT& options, const Vec2& mins, const Vec2& maxs, float duration, TextureView* texture )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_QUAD, DEBUG_DRAW_SCREEN, duration, texture);
+	object.origin = Vec3(mins.x, mins.y, 0.f);
+	object.axisI = Vec3(maxs.x - mins.x, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, maxs.y - mins.y, 0.f);
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddWireQuad2D( const DebugRenderOptionsT& options, const Vec2& mins, const Vec2& maxs, float duration )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_WIRE_QUAD, DEBUG_DRAW_SCREEN, duration, nullptr);
+	object.origin = Vec3(mins.x, mins.y, 0.f);
+	object.axisI = Vec3(maxs.x - mins.x, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, maxs.y - mins.y, 0.f);
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddDisc2D( const DebugRenderOptionsT& options, const Vec2& center, float radius, float duration )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_DISC, DEBUG_DRAW_SCREEN, duration, nullptr);
+	object.origin = Vec3(center.x, center.y, 0.f);
+	object.axisI = Vec3(radius, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, radius, 0.f);
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddRing2D( const DebugRenderOptionsT& options, const Vec2& center, float radius, float duration )
+{
+	DebugObjectT& object = AddObject(options, DEBUG_SHAPE_RING, DEBUG_DRAW_SCREEN, duration, nullptr);
+	object.origin = Vec3(center.x, center.y, 0.f);
+	object.axisI = Vec3(radius, 0.f, 0.f);
+	object.axisJ = Vec3(0.f, radius, 0.f);
+	object.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddArrow2D( const DebugRenderOptionsT& options, const Vec2& start, const Vec2& end, float duration, float thickness )
+{
+	Vec3 direction = Vec3(end.x - start.x, end.y - start.y, 0.f);
+	float length = sqrtf(Dot(direction, direction));
+	float headLength = std::min(thickness * DEBUG_DRAW_ARROW_HEAD_SCALE, length);
+	Vec3 forward = Normalized(direction);
+	Vec2 headStart = Vec2(end.x - forward.x * headLength, end.y - forward.y * headLength);
+
+	if (length > headLength)
+	{
+		AddLine2D(options, start, headStart, duration, thickness);
+	}
+
+	//Turned a quarter counter clockwise like AddLine2D's side, so the head keeps its winding
+	DebugObjectT& head = AddObject(options, DEBUG_SHAPE_ARROW_HEAD, DEBUG_DRAW_SCREEN, duration, nullptr);
+	head.origin = Vec3(headStart.x, headStart.y, 0.f);
+	head.axisI = forward * headLength;
+	head.axisJ = Vec3(-forward.y, forward.x, 0.f) * headLength;
+	head.axisK = Vec3(0.f, 0.f, 1.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddText2D( const DebugRenderOptionsT& options, const Vec2& position, const Vec2& pivot, const char* text, float height, float duration )
+{
+	DebugTextPlacementT* placement = AddTextPlacement(options, text, DEBUG_DRAW_SCREEN, duration);
+	placement->position = Vec3(position.x, position.y, 0.f);
+	placement->pivot = pivot;
+	placement->height = height;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddLogLine( const Rgba& color, float duration, const char* format, ... )
+{
+	va_list args;
+	va_start(args, format);
+	if (duration > 0.f)
+	{
+		m_logLines.emplace_back();
+		DebugLogLineT& line = m_logLines.back();
+		int length = vsnprintf(line.text, DEBUG_LOG_LINE_MAX_CHARS, format, args);
+		line.length = (length > 0) ? std::min((uint)length, DEBUG_LOG_LINE_MAX_CHARS - 1U) : 0U;
+		line.color = color;
+		line.duration = duration;
+	}
+	else
+	{
+		m_frameLogLines = ReserveFrameArray(*m_frameAllocator, m_frameLogLines, m_frameLogLineCount, m_frameLogLineCapacity);
+		DebugFrameLogLineT& line = *new (&m_frameLogLines[m_frameLogLineCount]) DebugFrameLogLineT();
+		m_frameLogLineCount++;
+		line.text = m_frameAllocator->FormatV(line.length, format, args);
+		line.color = color;
+	}
+	va_end(args);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::SetLogLayout( BitmapFont* font, const Vec2& topLeft, float lineHeight )
+{
+	m_font = font;
+	m_logTopLeft = topLeft;
+	m_logLineHeight = lineHeight;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The glyph verts from firstTextVert to the end go out as one run
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddTextRun( uint space, uint pass, uint firstTextVert )
+{
+	DebugTextRunT run;
+	run.bucket = GetBucket(space, pass, DEBUG_DRAW_TRIANGLES, m_font->GetTexture());
+	run.firstTextVert = firstTextVert;
+	run.vertCount = (uint)m_textVerts.size() - firstTextVert;
+	m_buckets[run.bucket].vertCount += run.vertCount;
+	m_textRuns.push_back(run);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// BitmapFont takes a std::string, the one member string keeps its buffer so only the first long text allocates. The glyphs
+// are laid out at the origin first, their box then gives the offset that puts the pivot on the position
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddTextVerts( const DebugTextPlacementT& placement, const char* text, uint length )
+{
+	float fraction = (placement.duration > 0.f) ? std::min(placement.age / placement.duration, 1.f) : 0.f;
+	uint firstTextVert = (uint)m_textVerts.size();
+	m_fontText.assign(text, length);
+	m_font->AddVertsForText2D(m_textVerts, Vec2(0.f, 0.f), placement.height, m_fontText, LerpColor(placement.beginColor, placement.endColor, fraction));
+
+	uint endTextVert = (uint)m_textVerts.size();
+	if (endTextVert == firstTextVert)
+	{
+		return;
+	}
+
+	Vec2 mins = Vec2(m_textVerts[firstTextVert].m_position.x, m_textVerts[firstTextVert].m_position.y);
+	Vec2 maxs = mins;
+	for (uint vertIndex = firstTextVert; vertIndex < endTextVert; ++vertIndex)
+	{
+		const Vec3& position = m_textVerts[vertIndex].m_position;
+		mins = Vec2(std::min(mins.x, position.x), std::min(mins.y, position.y));
+		maxs = Vec2(std::max(maxs.x, position.x), std::max(maxs.y, position.y));
+	}
+	float offsetX = -(mins.x + (maxs.x - mins.x) * placement.pivot.x);
+	float offsetY = -(mins.y + (maxs.y - mins.y) * placement.pivot.y);
+
+	Vec3 right = placement.isBillboarded ? m_right : Vec3(1.f, 0.f, 0.f);
+	Vec3 up = placement.isBillboarded ? m_up : Vec3(0.f, 1.f, 0.f);
+	for (uint vertIndex = firstTextVert; vertIndex < endTextVert; ++vertIndex)
+	{
+		Vec3& position = m_textVerts[vertIndex].m_position;
+		position = placement.position + right * (position.x + offsetX) + up * (position.y + offsetY);
+	}
+	AddTextRun(placement.space, placement.pass, firstTextVert);
+
+	if (placement.pass == DEBUG_DRAW_PASS_XRAY_VISIBLE)
+	{
+		for (uint vertIndex = firstTextVert; vertIndex < endTextVert; ++vertIndex)
+		{
+			Vertex_PCU hiddenVert = m_textVerts[vertIndex];
+			hiddenVert.m_color.a *= DEBUG_DRAW_XRAY_HIDDEN_ALPHA;
+			m_textVerts.push_back(hiddenVert);
+		}
+		AddTextRun(placement.space, DEBUG_DRAW_PASS_XRAY_HIDDEN, endTextVert);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::AddLogVerts( const char* text, uint length, const Rgba& color, Vec2& linePosition )
+{
+	linePosition.y -= m_logLineHeight;
+	uint firstTextVert = (uint)m_textVerts.size();
+	m_fontText.assign(text, length);
+	m_font->AddVertsForText2D(m_textVerts, linePosition, m_logLineHeight, m_fontText, color);
+	AddTextRun(DEBUG_DRAW_SCREEN, DEBUG_DRAW_PASS_ALWAYS, firstTextVert);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint DebugDrawBatch::GetBucket( uint space, uint pass, uint topology, TextureView* texture )
+{
+	//Objects tend to come in runs of the same kind, check the last hit before searching
+	if (m_lastBucket < m_buckets.size())
+	{
+		const DebugBucketT& lastBucket = m_buckets[m_lastBucket];
+		if (lastBucket.space == space && lastBucket.pass == pass && lastBucket.topology == topology && lastBucket.texture == texture)
+		{
+			return m_lastBucket;
+		}
+	}
+
+	for (uint bucketIndex = 0; bucketIndex < (uint)m_buckets.size(); ++bucketIndex)
+	{
+		const DebugBucketT& bucket = m_buckets[bucketIndex];
+		if (bucket.space == space && bucket.pass == pass && bucket.topology == topology && bucket.texture == texture)
+		{
+			m_lastBucket = bucketIndex;
+			return bucketIndex;
+		}
+	}
+
+	DebugBucketT bucket;
+	bucket.space = (uint8_t)space;
+	bucket.pass = (uint8_t)pass;
+	bucket.topology = (uint8_t)topology;
+	bucket.texture = texture;
+	m_buckets.push_back(bucket);
+	m_lastBucket = (uint)m_buckets.size() - 1U;
+	return m_lastBucket;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::Finish( const Vec3& right, const Vec3& up, JobScheduler* scheduler )
+{
+	m_right = right;
+	m_up = up;
+
+	//Bucket every object and count each bucket's verts
+	m_buckets.clear();
+	m_lastBucket = 0U;
+	uint objectCount = GetObjectCount();
+	for (uint objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+	{
+		DebugObjectT& object = GetObject(objectIndex);
+		const DebugShapeT& shape = m_shapes[object.shape];
+		object.bucket = GetBucket(object.space, object.pass, shape.topology, object.texture);
+		m_buckets[object.bucket].vertCount += shape.vertCount;
+
+		if (object.pass == DEBUG_DRAW_PASS_XRAY_VISIBLE)
+		{
+			object.hiddenBucket = GetBucket(object.space, DEBUG_DRAW_PASS_XRAY_HIDDEN, shape.topology, object.texture);
+			m_buckets[object.hiddenBucket].vertCount += shape.vertCount;
+		}
+	}
+
+	//Texts and then the log go after the objects that share their buckets
+	m_textVerts.clear();
+	m_textRuns.clear();
+	if (m_font != nullptr)
+	{
+		for (const DebugTextT& text : m_texts)
+		{
+			AddTextVerts(text.placement, text.text, text.length);
+		}
+		for (uint textIndex = 0; textIndex < m_frameTextCount; ++textIndex)
+		{
+			const DebugFrameTextT& text = m_frameTexts[textIndex];
+			AddTextVerts(text.placement, text.text, text.length);
+		}
+
+		Vec2 linePosition = m_logTopLeft;
+		for (const DebugLogLineT& line : m_logLines)
+		{
+			AddLogVerts(line.text, line.length, line.color, linePosition);
+		}
+		for (uint lineIndex = 0; lineIndex < m_frameLogLineCount; ++lineIndex)
+		{
+			const DebugFrameLogLineT& line = m_frameLogLines[lineIndex];
+			AddLogVerts(line.text, line.length, line.color, linePosition);
+		}
+	}
+
+	//Draw order is space then pass; textures keep the order they were first used in
+	uint bucketCount = (uint)m_buckets.size();
+	m_bucketOrder.resize(bucketCount);
+	for (uint bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex)
+	{
+		m_bucketOrder[bucketIndex] = bucketIndex;
+	}
+	std::sort(m_bucketOrder.begin(), m_bucketOrder.end(), [this](uint a, uint b)
+	{
+		const DebugBucketT& bucketA = m_buckets[a];
+		const DebugBucketT& bucketB = m_buckets[b];
+		if (bucketA.space != bucketB.space)
+		{
+			return bucketA.space < bucketB.space;
+		}
+		if (bucketA.pass != bucketB.pass)
+		{
+			return bucketA.pass < bucketB.pass;
+		}
+		return a < b;
+	});
+
+	m_draws.clear();
+	uint vertTotal = 0U;
+	for (uint bucketIndex : m_bucketOrder)
+	{
+		DebugBucketT& bucket = m_buckets[bucketIndex];
+		bucket.firstVert = vertTotal;
+		vertTotal += bucket.vertCount;
+
+		DebugDrawT draw;
+		draw.space = (eDebugDrawSpace)bucket.space;
+		draw.pass = (eDebugDrawPass)bucket.pass;
+		draw.topology = (eDebugDrawTopology)bucket.topology;
+		draw.texture = bucket.texture;
+		draw.firstVert = bucket.firstVert;
+		draw.vertCount = bucket.vertCount;
+		m_draws.push_back(draw);
+	}
+
+	//Hand out each object's place in add order, so a bucket draws in the order its objects were added
+	m_bucketCursors.resize(bucketCount);
+	for (uint bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex)
+	{
+		m_bucketCursors[bucketIndex] = m_buckets[bucketIndex].firstVert;
+	}
+	for (uint objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+	{
+		DebugObjectT& object = GetObject(objectIndex);
+		uint vertCount = m_shapes[object.shape].vertCount;
+		object.firstVert = m_bucketCursors[object.bucket];
+		m_bucketCursors[object.bucket] += vertCount;
+
+		if (object.pass == DEBUG_DRAW_PASS_XRAY_VISIBLE)
+		{
+			object.hiddenFirstVert = m_bucketCursors[object.hiddenBucket];
+			m_bucketCursors[object.hiddenBucket] += vertCount;
+		}
+	}
+
+	m_verts.resize(vertTotal);
+	for (const DebugTextRunT& run : m_textRuns)
+	{
+		std::copy(m_textVerts.begin() + run.firstTextVert, m_textVerts.begin() + run.firstTextVert + run.vertCount, m_verts.begin() + m_bucketCursors[run.bucket]);
+		m_bucketCursors[run.bucket] += run.vertCount;
+	}
+
+	if (scheduler != nullptr && objectCount > DEBUG_DRAW_WRITE_GRAIN)
+	{
+		scheduler->ParallelFor(0U, objectCount, DEBUG_DRAW_WRITE_GRAIN, [this](uint beginObject, uint endObject)
+		{
+			WriteObjects(beginObject, endObject);
+		});
+	}
+	else
+	{
+		WriteObjects(0U, objectCount);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DebugDrawBatch::WriteObjects( uint beginObject, uint endObject )
+{
+	Vertex_PCU* verts = m_verts.data();
+	for (uint objectIndex = beginObject; objectIndex < endObject; ++objectIndex)
+	{
+		const DebugObjectT& object = GetObject(objectIndex);
+		const DebugShapeT& shape = m_shapes[object.shape];
+
+		float fraction = (object.duration > 0.f) ? std::min(object.age / object.duration, 1.f) : 0.f;
+		Rgba color = LerpColor(object.beginColor, object.endColor, fraction);
+
+		Vec3 origin = object.origin;
+		Vec3 axisI = object.axisI;
+		Vec3 axisJ = object.axisJ;
+		if (object.isBillboarded)
+		{
+			origin = origin + m_right * object.billboardMins.x + m_up * object.billboardMins.y;
+			axisI = m_right * (object.billboardMaxs.x - object.billboardMins.x);
+			axisJ = m_up * (object.billboardMaxs.y - object.billboardMins.y);
+		}
+
+		TransformShape(shape, origin, axisI, axisJ, object.axisK, color, verts + object.firstVert);
+		if (object.pass == DEBUG_DRAW_PASS_XRAY_VISIBLE)
+		{
+			color.a *= DEBUG_DRAW_XRAY_HIDDEN_ALPHA;
+			TransformShape(shape, origin, axisI, axisJ, object.axisK, color, verts + object.hiddenFirstVert);
+		}
+	}
+}
@@ -0,0 +1,307 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+#include "Engine/Renderer/DebugRender.hpp"
+//Game Systems
+#include "Game/FrameAllocator.hpp"
+//Third Party
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class BitmapFont;
+class JobScheduler;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//World thickness of AddLine when none is given
+constexpr float DEBUG_DRAW_LINE_THICKNESS = 0.02f;
+//Alpha of the XRAY copy drawn where the object is hidden
+constexpr float DEBUG_DRAW_XRAY_HIDDEN_ALPHA = 0.25f;
+//Timed log lines and texts are cut to this, terminator included
+constexpr uint DEBUG_LOG_LINE_MAX_CHARS = 128U;
+//Length and width of an arrow head, in shaft thicknesses
+constexpr float DEBUG_DRAW_ARROW_HEAD_SCALE = 4.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eDebugDrawSpace
+{
+	DEBUG_DRAW_WORLD,
+	DEBUG_DRAW_SCREEN,
+
+	DEBUG_DRAW_SPACE_COUNT
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Depth state of a draw, in the order they are drawn. XRAY objects go out twice: faded where hidden, then depth tested
+//------------------------------------------------------------------------------------------------------------------------------
+enum eDebugDrawPass
+{
+	DEBUG_DRAW_PASS_USE_DEPTH,
+	DEBUG_DRAW_PASS_XRAY_HIDDEN,
+	DEBUG_DRAW_PASS_XRAY_VISIBLE,
+	DEBUG_DRAW_PASS_ALWAYS,
+
+	DEBUG_DRAW_PASS_COUNT
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eDebugDrawTopology
+{
+	DEBUG_DRAW_TRIANGLES,
+	//Pairs of verts, one pixel wide whatever the scale
+	DEBUG_DRAW_LINES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eDebugDrawShape
+{
+	DEBUG_SHAPE_BOX,
+	DEBUG_SHAPE_WIRE_BOX,
+	DEBUG_SHAPE_SPHERE,
+	DEBUG_SHAPE_WIRE_SPHERE,
+	DEBUG_SHAPE_LINE,
+	DEBUG_SHAPE_QUAD,
+	DEBUG_SHAPE_WIRE_QUAD,
+	DEBUG_SHAPE_DISC,
+	DEBUG_SHAPE_RING,
+	DEBUG_SHAPE_ARROW_HEAD,
+
+	DEBUG_SHAPE_COUNT
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A unit mesh as separate component arrays, padded to a multiple of 4 so the SIMD loop can always load whole groups
+//------------------------------------------------------------------------------------------------------------------------------
+struct DebugShapeT
+{
+	std::vector<float>					x;
+	std::vector<float>					y;
+	std::vector<float>					z;
+	std::vector<float>					u;
+	std::vector<float>					v;
+	uint								vertCount = 0U;
+	eDebugDrawTopology					topology = DEBUG_DRAW_TRIANGLES;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One bucket's draw: every vertex in it shares the space, depth pass, topology and texture
+//------------------------------------------------------------------------------------------------------------------------------
+struct DebugDrawT
+{
+	eDebugDrawSpace						space = DEBUG_DRAW_WORLD;
+	eDebugDrawPass						pass = DEBUG_DRAW_PASS_USE_DEPTH;
+	eDebugDrawTopology					topology = DEBUG_DRAW_TRIANGLES;
+	TextureView*						texture = nullptr;
+	uint								firstVert = 0U;
+	uint								vertCount = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Retained debug primitives merged into one vertex array per frame, grouped into one draw per (space, depth pass, topology,
+// texture), so the overlay costs a handful of draws however many objects are alive. Every shape is a unit mesh built once and
+// placed with an affine transform on the CPU, four vertices at a time with SSE where available.
+//
+// Objects live for their duration, fading from beginColor to endColor; a duration of 0 is drawn for one frame. Wire shapes and
+// rings are line lists, so they stay one pixel wide at any size. Text is laid out with the log's font in Finish.
+//
+// One frame objects, texts and log lines, strings included, are placed in the FrameAllocator's memory for the frame, while timed
+// ones are kept in pooled arrays that reuse their slots. Once the allocator has grown to fit, a steady overlay makes no heap
+// allocations.
+//------------------------------------------------------------------------------------------------------------------------------
+class DebugDrawBatch
+{
+public:
+	//The allocator has to outlive the batch, and its EndFrame come after the batch's
+	explicit DebugDrawBatch( FrameAllocator* frameAllocator = g_frameAllocator );
+	~DebugDrawBatch();
+
+	//Ages every timed object and log line and drops the ones past their duration. Call before adding the frame's objects
+	void								BeginFrame( float deltaSeconds );
+	//Drops the frame's one frame objects, texts and log lines, their memory goes back with the allocator's frame. Call once the
+	//frame's verts have been drawn
+	void								EndFrame();
+
+	void								AddPoint( const DebugRenderOptionsT& options, const Vec3& position, float duration, float size = 0.1f, TextureView* texture = nullptr );
+	void								AddLine( const DebugRenderOptionsT& options, const Vec3& start, const Vec3& end, float duration, float thickness = DEBUG_DRAW_LINE_THICKNESS );
+	void								AddBox( const DebugRenderOptionsT& options, const Vec3& center, const Vec3& halfExtents, float duration, TextureView* texture = nullptr );
+	void								AddWireBox( const DebugRenderOptionsT& options, const Vec3& center, const Vec3& halfExtents, float duration );
+	void								AddSphere( const DebugRenderOptionsT& options, const Vec3& center, float radius, float duration, TextureView* texture = nullptr );
+	void								AddWireSphere( const DebugRenderOptionsT& options, const Vec3& center, float radius, float duration );
+	//Points are billboarded squares
+	//mins and maxs are in the quad's plane around position: the camera's when billboarded, else world X and Y
+	void								AddQuad( const DebugRenderOptionsT& options, const Vec3& position, const Vec2& mins, const Vec2& maxs, float duration, TextureView* texture = nullptr, bool isBillboarded = true );
+	//pivot is the point of the text's box placed at position, (0, 0) bottom left to (1, 1) top right. Same plane as AddQuad
+	void								AddText( const DebugRenderOptionsT& options, const Vec3& position, const Vec2& pivot, const char* text, float height, float duration, bool isBillboarded = true );
+
+	//Screen space, in the 2D debug camera's units
+	void								AddPoint2D( const DebugRenderOptionsT& options, const Vec2& position, float duration, float size = 10.f );
+	void								AddLine2D( const DebugRenderOptionsT& options, const Vec2& start, const Vec2& end, float duration, float thickness = 2.f );
+	void								AddQuad2D( const DebugRenderOptionsT& options, const Vec2& mins, const Vec2& maxs, float duration, TextureView* texture = nullptr );
+	void								AddWireQuad2D( const DebugRenderOptionsT& options, const Vec2& mins, const Vec2& maxs, float duration );
+	void								AddDisc2D( const DebugRenderOptionsT& options, const Vec2& center, float radius, float duration );
+	void								AddRing2D( const DebugRenderOptionsT& options, const Vec2& center, float radius, float duration );
+	//The head is DEBUG_DRAW_ARROW_HEAD_SCALE thicknesses long and ends at end
+	void								AddArrow2D( const DebugRenderOptionsT& options, const Vec2& start, const Vec2& end, float duration, float thickness = 2.f );
+	void								AddText2D( const DebugRenderOptionsT& options, const Vec2& position, const Vec2& pivot, const char* text, float height, float duration );
+
+	//printf style, drawn in screen space one line under the other, timed lines first. Neither the log nor any text is drawn
+	//until there is a font
+	void								AddLogLine( const Rgba& color, float duration, const char* format, ... );
+	void								SetLogLayout( BitmapFont* font, const Vec2& topLeft, float lineHeight );
+
+	//Builds the frame's vertices. Billboards face along right and up, usually the camera's I and J basis
+	void								Finish( const Vec3& right, const Vec3& up, JobScheduler* scheduler = nullptr );
+
+	uint								GetObjectCount() const { return (uint)m_objects.size() + m_frameObjectCount; }
+	uint								GetFrameObjectCount() const { return m_frameObjectCount; }
+	uint								GetTextCount() const { return (uint)m_texts.size() + m_frameTextCount; }
+	uint								GetLogLineCount() const { return (uint)m_logLines.size() + m_frameLogLineCount; }
+	const std::vector<Vertex_PCU>&		GetVerts() const { return m_verts; }
+	//Ordered by space, then pass, then first use of the topology and texture
+	const std::vector<DebugDrawT>&		GetDraws() const { return m_draws; }
+	uint								GetShapeVertCount( eDebugDrawShape shape ) const { return m_shapes[shape].vertCount; }
+
+private:
+	struct DebugObjectT
+	{
+		Vec3							origin;
+		Vec3							axisI;
+		Vec3							axisJ;
+		Vec3							axisK;
+		//Billboards only, resolved against the camera in Finish
+		Vec2							billboardMins;
+		Vec2							billboardMaxs;
+		Rgba							beginColor;
+		Rgba							endColor;
+		TextureView*					texture = nullptr;
+		float							duration = 0.f;
+		float							age = 0.f;
+		uint8_t							shape = DEBUG_SHAPE_BOX;
+		uint8_t							space = DEBUG_DRAW_WORLD;
+		bool							isBillboarded = false;
+		uint8_t							pass = DEBUG_DRAW_PASS_USE_DEPTH;
+
+		//Filled by Finish
+		uint							bucket = 0U;
+		uint							hiddenBucket = 0U;
+		uint							firstVert = 0U;
+		uint							hiddenFirstVert = 0U;
+	};
+
+	struct DebugBucketT
+	{
+		uint8_t							space = DEBUG_DRAW_WORLD;
+		uint8_t							pass = DEBUG_DRAW_PASS_USE_DEPTH;
+		uint8_t							topology = DEBUG_DRAW_TRIANGLES;
+		TextureView*					texture = nullptr;
+		uint							vertCount = 0U;
+		uint							firstVert = 0U;
+	};
+
+	struct DebugLogLineT
+	{
+		char							text[DEBUG_LOG_LINE_MAX_CHARS];
+		uint							length = 0U;
+		Rgba							color;
+		float							duration = 0.f;
+		float							age = 0.f;
+	};
+
+	//Text is in frame memory
+	struct DebugFrameLogLineT
+	{
+		const char*						text = nullptr;
+		uint							length = 0U;
+		Rgba							color;
+	};
+
+	struct DebugTextPlacementT
+	{
+		Vec3							position;
+		Vec2							pivot;
+		float							height = 0.f;
+		Rgba							beginColor;
+		Rgba							endColor;
+		float							duration = 0.f;
+		float							age = 0.f;
+		uint8_t							space = DEBUG_DRAW_WORLD;
+		bool							isBillboarded = false;
+		uint8_t							pass = DEBUG_DRAW_PASS_USE_DEPTH;
+	};
+
+	struct DebugTextT
+	{
+		DebugTextPlacementT				placement;
+		char							text[DEBUG_LOG_LINE_MAX_CHARS];
+		uint							length = 0U;
+	};
+
+	//Text is in frame memory
+	struct DebugFrameTextT
+	{
+		DebugTextPlacementT				placement;
+		const char*						text = nullptr;
+		uint							length = 0U;
+	};
+
+	//Glyph verts laid out in Finish, copied to their bucket after the objects
+	struct DebugTextRunT
+	{
+		uint							bucket = 0U;
+		uint							firstTextVert = 0U;
+		uint							vertCount = 0U;
+	};
+
+	DebugObjectT&						AddObject( const DebugRenderOptionsT& options, eDebugDrawShape shape, eDebugDrawSpace space, float duration, TextureView* texture );
+	DebugTextPlacementT*				AddTextPlacement( const DebugRenderOptionsT& options, const char* text, eDebugDrawSpace space, float duration );
+	//Timed objects first, then the frame's
+	DebugObjectT&						GetObject( uint objectIndex ) { return (objectIndex < m_objects.size()) ? m_objects[objectIndex] : m_frameObjects[objectIndex - m_objects.size()]; }
+	uint								GetBucket( uint space, uint pass, uint topology, TextureView* texture );
+	void								AddTextRun( uint space, uint pass, uint firstTextVert );
+	void								AddTextVerts( const DebugTextPlacementT& placement, const char* text, uint length );
+	void								AddLogVerts( const char* text, uint length, const Rgba& color, Vec2& linePosition );
+	void								WriteObjects( uint beginObject, uint endObject );
+
+private:
+	DebugShapeT							m_shapes[DEBUG_SHAPE_COUNT];
+	std::vector<DebugObjectT>			m_objects;
+	std::vector<DebugTextT>				m_texts;
+	std::vector<DebugLogLineT>			m_logLines;
+
+	//Arrays in frame memory. They start at the last frame's size, so a steady frame sets each one up once
+	FrameAllocator*						m_frameAllocator = nullptr;
+	DebugObjectT*						m_frameObjects = nullptr;
+	uint								m_frameObjectCount = 0U;
+	uint								m_frameObjectCapacity = 0U;
+	DebugFrameTextT*					m_frameTexts = nullptr;
+	uint								m_frameTextCount = 0U;
+	uint								m_frameTextCapacity = 0U;
+	DebugFrameLogLineT*					m_frameLogLines = nullptr;
+	uint								m_frameLogLineCount = 0U;
+	uint								m_frameLogLineCapacity = 0U;
+
+	BitmapFont*							m_font = nullptr;
+	Vec2								m_logTopLeft;
+	float								m_logLineHeight = 16.f;
+	std::string							m_fontText;
+	//Texts then the log, in the order their runs go out
+	std::vector<Vertex_PCU>				m_textVerts;
+	std::vector<DebugTextRunT>			m_textRuns;
+
+	//Kept between frames so a steady overlay allocates nothing
+	std::vector<DebugBucketT>			m_buckets;
+	uint								m_lastBucket = 0U;
+	std::vector<uint>					m_bucketOrder;
+	std::vector<uint>					m_bucketCursors;
+	std::vector<Vertex_PCU>				m_verts;
+	std::vector<DebugDrawT>				m_draws;
+
+	Vec3								m_right = Vec3(1.f, 0.f, 0.f);
+	Vec3								m_up = Vec3(0.f, 1.f, 0.f);
+};
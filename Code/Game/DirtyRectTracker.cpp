@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/DirtyRectTracker.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+static ImageRegionT GetUnion( const ImageRegionT& a, const ImageRegionT& b )
+{
+	return ImageRegionT(a.minX < b.minX ? a.minX : b.minX, a.minY < b.minY ? a.minY : b.minY,
+		a.maxX > b.maxX ? a.maxX : b.maxX, a.maxY > b.maxY ? a.maxY : b.maxY);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t GetIntersectionArea( const ImageRegionT& a, const ImageRegionT& b )
+{
+	ImageRegionT intersection(a.minX > b.minX ? a.minX : b.minX, a.minY > b.minY ? a.minY : b.minY,
+		a.maxX < b.maxX ? a.maxX : b.maxX, a.maxY < b.maxY ? a.maxY : b.maxY);
+	return intersection.IsEmpty() ? 0U : intersection.GetArea();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool AreTouching( const ImageRegionT& a, const ImageRegionT& b )
+{
+	return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+DirtyRectTracker::DirtyRectTracker( uint width, uint height, uint maxRegions )
+	: m_width(width),
+	m_height(height),
+	m_maxRegions(maxRegions > 0U ? maxRegions : 1U)
+{
+}
+
+DirtyRectTracker::~DirtyRectTracker()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DirtyRectTracker::MarkDirty( const ImageRegionT& region )
+{
+	ImageRegionT clamped(region.minX, region.minY, region.maxX < m_width ? region.maxX : m_width, region.maxY < m_height ? region.maxY : m_height);
+	if (clamped.IsEmpty())
+	{
+		return;
+	}
+
+	InsertRegion(clamped);
+
+	while (m_regions.size() > m_maxRegions)
+	{
+		MergeCheapestPair();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DirtyRectTracker::MarkAllDirty()
+{
+	m_regions.clear();
+	MarkDirty(ImageRegionT(0U, 0U, m_width, m_height));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DirtyRectTracker::ConsumeRegions( std::vector<ImageRegionT>& outRegions )
+{
+	outRegions.insert(outRegions.end(), m_regions.begin(), m_regions.end());
+	m_regions.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t DirtyRectTracker::GetDirtyTexelCount() const
+{
+	uint64_t texelCount = 0U;
+	for (const ImageRegionT& region : m_regions)
+	{
+		texelCount += region.GetArea();
+	}
+
+	return texelCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DirtyRectTracker::InsertRegion( ImageRegionT region )
+{
+	//Keep absorbing neighbours until nothing else merges; a grown region can reach rectangles it did not touch before
+	bool hasMerged = true;
+	while (hasMerged)
+	{
+		hasMerged = false;
+
+		for (size_t regionIndex = 0; regionIndex < m_regions.size(); ++regionIndex)
+		{
+			const ImageRegionT& existing = m_regions[regionIndex];
+			if (!AreTouching(region, existing))
+			{
+				continue;
+			}
+
+			uint64_t overlap = GetIntersectionArea(region, existing);
+			ImageRegionT merged = GetUnion(region, existing);
+			uint64_t wastedArea = merged.GetArea() - (region.GetArea() + existing.GetArea() - overlap);
+
+			//Overlaps always merge so the same texels are never uploaded twice
+			if (overlap > 0U || wastedArea * 4U <= merged.GetArea())
+			{
+				region = merged;
+				m_regions[regionIndex] = m_regions.back();
+				m_regions.pop_back();
+				hasMerged = true;
+				break;
+			}
+		}
+	}
+
+	m_regions.push_back(region);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void DirtyRectTracker::MergeCheapestPair()
+{
+	size_t bestA = 0U;
+	size_t bestB = 1U;
+	uint64_t bestWaste = ~0ULL;
+
+	for (size_t indexA = 0; indexA < m_regions.size(); ++indexA)
+	{
+		for (size_t indexB = indexA + 1U; indexB < m_regions.size(); ++indexB)
+		{
+			const ImageRegionT& a = m_regions[indexA];
+			const ImageRegionT& b = m_regions[indexB];
+			uint64_t waste = GetUnion(a, b).GetArea() - a.GetArea() - b.GetArea();
+			if (waste < bestWaste)
+			{
+				bestWaste = waste;
+				bestA = indexA;
+				bestB = indexB;
+			}
+		}
+	}
+
+	ImageRegionT merged = GetUnion(m_regions[bestA], m_regions[bestB]);
+
+	//Remove the higher index first so the lower one stays valid
+	m_regions[bestB] = m_regions.back();
+	m_regions.pop_back();
+	m_regions[bestA] = m_regions.back();
+	m_regions.pop_back();
+
+	InsertRegion(merged);
+}
@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Texel rectangle, max exclusive
+//------------------------------------------------------------------------------------------------------------------------------
+struct ImageRegionT
+{
+	uint								minX = 0U;
+	uint								minY = 0U;
+	uint								maxX = 0U;
+	uint								maxY = 0U;
+
+	ImageRegionT() {}
+	ImageRegionT( uint regionMinX, uint regionMinY, uint regionMaxX, uint regionMaxY )
+		: minX(regionMinX), minY(regionMinY), maxX(regionMaxX), maxY(regionMaxY) {}
+
+	uint								GetWidth() const { return maxX - minX; }
+	uint								GetHeight() const { return maxY - minY; }
+	uint64_t							GetArea() const { return (uint64_t)GetWidth() * (uint64_t)GetHeight(); }
+	bool								IsEmpty() const { return maxX <= minX || maxY <= minY; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collects the regions of an image written since the last upload and coalesces them into a few non overlapping rectangles.
+// Touching or overlapping regions merge when the union wastes at most a quarter of its area; past maxRegions the pair that
+// wastes the least is merged, so one update never turns into hundreds of tiny copies.
+//------------------------------------------------------------------------------------------------------------------------------
+class DirtyRectTracker
+{
+public:
+	explicit DirtyRectTracker( uint width, uint height, uint maxRegions = 16U );
+	~DirtyRectTracker();
+
+	void								MarkDirty( const ImageRegionT& region );
+	void								MarkAllDirty();
+	bool								IsDirty() const { return !m_regions.empty(); }
+
+	//Appends the coalesced regions and clears the tracker
+	void								ConsumeRegions( std::vector<ImageRegionT>& outRegions );
+	uint64_t							GetDirtyTexelCount() const;
+
+	uint								GetWidth() const { return m_width; }
+	uint								GetHeight() const { return m_height; }
+
+private:
+	void								InsertRegion( ImageRegionT region );
+	void								MergeCheapestPair();
+
+private:
+	uint								m_width = 0U;
+	uint								m_height = 0U;
+	uint								m_maxRegions = 16U;
+
+	//Never overlapping
+	std::vector<ImageRegionT>			m_regions;
+};
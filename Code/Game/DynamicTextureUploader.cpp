@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/DynamicTextureUploader.hpp"
+//Third Party
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+DynamicTextureUploader::DynamicTextureUploader( const char* tag, uint width, uint height, uint maxRegions )
+	: m_tag(tag),
+	m_dirtyRects(width, height, maxRegions)
+{
+}
+
+DynamicTextureUploader::~DynamicTextureUploader()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DynamicTextureUploader::BeginStaging( JobScheduler& scheduler, const uint32_t* sourceTexels, uint sourceWidth )
+{
+	if (!m_dirtyRects.IsDirty() || IsStaging() || HasStagedRegions())
+	{
+		return false;
+	}
+
+	m_regionScratch.clear();
+	m_dirtyRects.ConsumeRegions(m_regionScratch);
+
+	//Staging buffers are kept between updates, a steady stream of same sized regions stops allocating
+	if (m_stagedRegions.size() < m_regionScratch.size())
+	{
+		m_stagedRegions.resize(m_regionScratch.size());
+	}
+	m_stagedRegionCount = (uint)m_regionScratch.size();
+
+	for (size_t regionIndex = 0; regionIndex < m_regionScratch.size(); ++regionIndex)
+	{
+		StagedRegionT& staged = m_stagedRegions[regionIndex];
+		staged.region = m_regionScratch[regionIndex];
+		staged.texels.resize((size_t)staged.region.GetArea());
+
+		FunctionJob* copyJob = new FunctionJob([&staged, sourceTexels, sourceWidth]()
+		{
+			uint width = staged.region.GetWidth();
+			for (uint y = staged.region.minY; y < staged.region.maxY; ++y)
+			{
+				const uint32_t* sourceRow = sourceTexels + (size_t)y * sourceWidth + staged.region.minX;
+				memcpy(staged.texels.data() + (size_t)(y - staged.region.minY) * width, sourceRow, width * sizeof(uint32_t));
+			}
+		});
+		copyJob->SetCounter(&m_stagingCounter);
+		scheduler.Dispatch(copyJob);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t DynamicTextureUploader::Submit( JobScheduler& scheduler, const RegionUploadCallback& upload )
+{
+	scheduler.WaitForCounter(m_stagingCounter);
+
+	size_t uploadBytes = 0U;
+	for (uint regionIndex = 0; regionIndex < m_stagedRegionCount; ++regionIndex)
+	{
+		const StagedRegionT& staged = m_stagedRegions[regionIndex];
+		if (upload)
+		{
+			upload(staged);
+		}
+
+		uploadBytes += staged.GetByteCount();
+	}
+
+	m_lastRegionCount = m_stagedRegionCount;
+	m_lastUploadBytes = uploadBytes;
+	m_totalUploadBytes += uploadBytes;
+	m_stagedRegionCount = 0U;
+
+	return uploadBytes;
+}
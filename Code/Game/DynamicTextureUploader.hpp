@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/DirtyRectTracker.hpp"
+#include "Game/JobScheduler.hpp"
+//Third Party
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One coalesced region copied out of the source image, rows tightly packed
+//------------------------------------------------------------------------------------------------------------------------------
+struct StagedRegionT
+{
+	ImageRegionT						region;
+	std::vector<uint32_t>				texels;
+
+	uint								GetRowPitch() const { return region.GetWidth() * (uint)sizeof(uint32_t); }
+	size_t								GetByteCount() const { return texels.size() * sizeof(uint32_t); }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Incremental upload path for procedurally updated RGBA8 textures. Writers mark what they changed, BeginStaging coalesces the
+// dirty rectangles and copies each one into a staging buffer on the JobScheduler, and Submit hands the staged regions to the
+// texture one sub-resource update at a time on the main thread. Bandwidth follows what changed instead of the texture size.
+//
+// The source must not be written between BeginStaging and the end of staging (IsStaging).
+//------------------------------------------------------------------------------------------------------------------------------
+class DynamicTextureUploader
+{
+public:
+	typedef std::function<void( const StagedRegionT& stagedRegion )> RegionUploadCallback;
+
+public:
+	explicit DynamicTextureUploader( const char* tag, uint width, uint height, uint maxRegions = 16U );
+	~DynamicTextureUploader();
+
+	void								MarkDirty( const ImageRegionT& region ) { m_dirtyRects.MarkDirty(region); }
+	void								MarkAllDirty() { m_dirtyRects.MarkAllDirty(); }
+	bool								IsDirty() const { return m_dirtyRects.IsDirty(); }
+
+	//Returns false if nothing was dirty or the previous regions are still staged but not submitted
+	bool								BeginStaging( JobScheduler& scheduler, const uint32_t* sourceTexels, uint sourceWidth );
+	bool								IsStaging() const { return !m_stagingCounter.IsDone(); }
+	bool								HasStagedRegions() const { return m_stagedRegionCount > 0U; }
+
+	//Waits for the staging jobs, then calls upload once per region. Returns the bytes staged, which is what upload should send
+	size_t								Submit( JobScheduler& scheduler, const RegionUploadCallback& upload );
+
+	const char*							GetTag() const { return m_tag.c_str(); }
+	uint								GetLastRegionCount() const { return m_lastRegionCount; }
+	size_t								GetLastUploadBytes() const { return m_lastUploadBytes; }
+	uint64_t							GetTotalUploadBytes() const { return m_totalUploadBytes; }
+
+private:
+	std::string							m_tag;
+	DirtyRectTracker					m_dirtyRects;
+
+	//Only the first m_stagedRegionCount are live, the rest keep their buffers for the next update
+	std::vector<StagedRegionT>			m_stagedRegions;
+	uint								m_stagedRegionCount = 0U;
+	std::vector<ImageRegionT>			m_regionScratch;
+	JobCounter							m_stagingCounter;
+
+	uint								m_lastRegionCount = 0U;
+	size_t								m_lastUploadBytes = 0U;
+	uint64_t							m_totalUploadBytes = 0U;
+};
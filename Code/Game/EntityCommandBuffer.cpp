@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/EntityCommandBuffer.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+EntityCommandBuffer::EntityCommandBuffer( FrameAllocator* frameAllocator )
+	: m_commands(FrameStdAllocator<EntityCommandT>(frameAllocator))
+{
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Spawn( const EntityDescT& desc )
+{
+	EntityCommandT command;
+	command.type = ENTITY_COMMAND_SPAWN;
+	command.desc = desc;
+	m_commands.push_back(command);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Despawn( const EntityHandle& handle )
+{
+	EntityCommandT command;
+	command.type = ENTITY_COMMAND_DESPAWN;
+	command.handle = handle;
+	m_commands.push_back(command);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Apply( EntityStore& store ) const
+{
+	for (const EntityCommandT& command : m_commands)
+	{
+		switch (command.type)
+		{
+		case ENTITY_COMMAND_SPAWN:
+			store.Spawn(command.desc);
+			break;
+		case ENTITY_COMMAND_DESPAWN:
+			store.MarkGarbage(command.handle);
+			break;
+		default:
+			break;
+		}
+	}
+}
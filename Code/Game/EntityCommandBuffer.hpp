@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/EntityStore.hpp"
+#include "Game/FrameAllocator.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eEntityCommandType
+{
+	ENTITY_COMMAND_SPAWN = 0,
+	ENTITY_COMMAND_DESPAWN,
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct EntityCommandT
+{
+	eEntityCommandType					type = ENTITY_COMMAND_SPAWN;
+	EntityHandle						handle;
+	EntityDescT							desc;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Structural changes recorded while the store is being updated in parallel. Each chunk job owns one buffer, so recording
+// needs no locks, and Apply replays the commands in the order they were recorded. Commands are frame memory from the recording
+// thread's own arena, so a buffer has to be applied and cleared by the end of the next frame; Clear lets go of its storage.
+//------------------------------------------------------------------------------------------------------------------------------
+class EntityCommandBuffer
+{
+public:
+	explicit EntityCommandBuffer( FrameAllocator* frameAllocator = g_frameAllocator );
+	~EntityCommandBuffer();
+
+	void								Spawn( const EntityDescT& desc );
+	void								Despawn( const EntityHandle& handle );
+
+	//Spawns are added to the end of the store, despawns are queued as garbage. Stale handles are ignored
+	void								Apply( EntityStore& store ) const;
+	void								Clear() { FrameVector<EntityCommandT>(m_commands.get_allocator()).swap(m_commands); }
+
+	uint								GetCommandCount() const { return (uint)m_commands.size(); }
+
+private:
+	FrameVector<EntityCommandT>			m_commands;
+};
@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/EntitySimulation.hpp"
+//Game Systems
+#include "Game/JobScheduler.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+EntitySimulation::EntitySimulation( uint chunkSize, FrameAllocator* frameAllocator )
+	: m_chunkSize(chunkSize > 0U ? chunkSize : 1U),
+	m_frameAllocator(frameAllocator)
+{
+}
+
+EntitySimulation::~EntitySimulation()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntitySimulation::Update( EntityStore& store, float deltaTime, JobScheduler* scheduler, const EntityChunkFunction& chunkFunction )
+{
+	uint entityCount = store.GetCount();
+	uint chunkCount = (entityCount + m_chunkSize - 1U) / m_chunkSize;
+
+	if (m_chunkCommands.size() < chunkCount)
+	{
+		m_chunkCommands.resize(chunkCount, EntityCommandBuffer(m_frameAllocator));
+	}
+
+	if (scheduler != nullptr && chunkCount > 1U)
+	{
+		scheduler->ParallelFor(0U, chunkCount, 1U, [&](uint beginChunk, uint endChunk)
+		{
+			for (uint chunkIndex = beginChunk; chunkIndex < endChunk; ++chunkIndex)
+			{
+				RunChunk(store, chunkIndex, entityCount, deltaTime, chunkFunction);
+			}
+		});
+	}
+	else
+	{
+		for (uint chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+		{
+			RunChunk(store, chunkIndex, entityCount, deltaTime, chunkFunction);
+		}
+	}
+
+	//Sync point: structural changes in chunk order, then recorded order within a chunk
+	m_lastCommandCount = 0U;
+	for (uint chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		m_lastCommandCount += m_chunkCommands[chunkIndex].GetCommandCount();
+		m_chunkCommands[chunkIndex].Apply(store);
+		m_chunkCommands[chunkIndex].Clear();
+	}
+
+	store.RemoveGarbage();
+	m_lastChunkCount = chunkCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntitySimulation::RunChunk( EntityStore& store, uint chunkIndex, uint entityCount, float deltaTime, const EntityChunkFunction& chunkFunction )
+{
+	uint beginIndex = chunkIndex * m_chunkSize;
+	uint endIndex = (beginIndex + m_chunkSize < entityCount) ? beginIndex + m_chunkSize : entityCount;
+
+	store.UpdateRange(beginIndex, endIndex, deltaTime);
+
+	if (chunkFunction)
+	{
+		chunkFunction(store, beginIndex, endIndex, m_chunkCommands[chunkIndex]);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpawnSeededEntities( EntityStore& entities, uint entityCount, uint32_t& seed )
+{
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		//Cheap LCG so every run simulates the same world
+		EntityDescT desc;
+		seed = seed * 1664525U + 1013904223U;
+		desc.position = Vec2((float)(seed >> 8) / 16777216.f * WORLD_WIDTH, (float)(seed & 0xFFFF) / 65536.f * WORLD_HEIGHT);
+		seed = seed * 1664525U + 1013904223U;
+		desc.velocity = Vec2((float)(seed >> 8) / 16777216.f * 20.f - 10.f, (float)(seed & 0xFFFF) / 65536.f * 20.f - 10.f);
+		desc.angularVelocity = 90.f;
+		entities.Spawn(desc);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Projectiles that left the world are gone
+//------------------------------------------------------------------------------------------------------------------------------
+void DespawnOffScreenEntities( EntityStore& store, uint beginIndex, uint endIndex, EntityCommandBuffer& commands )
+{
+	for (uint entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+	{
+		if (store.IsOffScreen(entityIndex))
+		{
+			commands.Despawn(store.GetHandle(entityIndex));
+		}
+	}
+}
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/EntityCommandBuffer.hpp"
+//Third Party
+#include <functional>
+#include <vector>
+
+class JobScheduler;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Gameplay logic for one chunk. It may read anything in the store but only write entities in [beginIndex, endIndex);
+// spawning and despawning goes through the chunk's command buffer
+//------------------------------------------------------------------------------------------------------------------------------
+typedef std::function<void( EntityStore& store, uint beginIndex, uint endIndex, EntityCommandBuffer& commands )> EntityChunkFunction;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Runs the entity update as fixed size chunks on the JobScheduler. Chunk boundaries depend only on the entity count, never on
+// the worker count, and every entity is only written by its own chunk, so the result is bit identical to running the chunks
+// serially. The command buffers are applied in chunk order at the sync point after all chunks finished, then garbage is
+// reclaimed, which keeps spawn order, handles and dense indices deterministic too.
+//
+// Note the per entity math must not change with vector width: floating point contraction has to stay off so vectorized and
+// remainder iterations round the same way. Game.vcxproj sets /fp:precise for that and no /arch:AVX2, so nothing is fused.
+//------------------------------------------------------------------------------------------------------------------------------
+class EntitySimulation
+{
+public:
+	//The command buffers are recorded into frameAllocator, whose EndFrame has to come after each Update's
+	explicit EntitySimulation( uint chunkSize = 4096U, FrameAllocator* frameAllocator = g_frameAllocator );
+	~EntitySimulation();
+
+	//A null scheduler runs the same chunks on the calling thread
+	void								Update( EntityStore& store, float deltaTime, JobScheduler* scheduler, const EntityChunkFunction& chunkFunction = nullptr );
+
+	uint								GetChunkSize() const { return m_chunkSize; }
+	uint								GetLastChunkCount() const { return m_lastChunkCount; }
+	uint								GetLastCommandCount() const { return m_lastCommandCount; }
+
+private:
+	void								RunChunk( EntityStore& store, uint chunkIndex, uint entityCount, float deltaTime, const EntityChunkFunction& chunkFunction );
+
+private:
+	uint								m_chunkSize = 4096U;
+	FrameAllocator*						m_frameAllocator = nullptr;
+	std::vector<EntityCommandBuffer>	m_chunkCommands;
+
+	uint								m_lastChunkCount = 0U;
+	uint								m_lastCommandCount = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Spawns entityCount entities spread over the world from a cheap LCG, so the same seed always gives the same world
+void								SpawnSeededEntities( EntityStore& entities, uint entityCount, uint32_t& seed );
+//The world's EntityChunkFunction: projectiles that left the world are gone
+void								DespawnOffScreenEntities( EntityStore& store, uint beginIndex, uint endIndex, EntityCommandBuffer& commands );
@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/EntityStore.hpp"
+//Third Party
+#include <math.h>
+
+#if defined(_MSC_VER)
+#define ENTITY_RESTRICT __restrict
+#else
+#define ENTITY_RESTRICT __restrict__
+#endif
+
+constexpr uint DEBUG_DISC_SEGMENTS = 16U;
+constexpr uint DEBUG_DISC_VERTS = DEBUG_DISC_SEGMENTS * 3U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Unit disc shared by every entity's debug draw (used to be two Vertex_PCU[48] arrays inside each Entity)
+//------------------------------------------------------------------------------------------------------------------------------
+struct UnitDiscT
+{
+	UnitDiscT()
+	{
+		const float radiansPerSegment = 6.2831853f / (float)DEBUG_DISC_SEGMENTS;
+		for (uint segmentIndex = 0; segmentIndex < DEBUG_DISC_SEGMENTS; ++segmentIndex)
+		{
+			float startRadians = radiansPerSegment * (float)segmentIndex;
+			float endRadians = startRadians + radiansPerSegment;
+
+			verts[segmentIndex * 3U] = Vec2(0.f, 0.f);
+			verts[segmentIndex * 3U + 1U] = Vec2(cosf(startRadians), sinf(startRadians));
+			verts[segmentIndex * 3U + 2U] = Vec2(cosf(endRadians), sinf(endRadians));
+		}
+	}
+
+	Vec2								verts[DEBUG_DISC_VERTS];
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const Vec2* GetUnitDiscVerts()
+{
+	//Built on first use; the initialization of a function local static is thread safe, debug verts are built from jobs
+	static const UnitDiscT s_unitDisc;
+	return s_unitDisc.verts;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+EntityStore::EntityStore( uint initialCapacity )
+{
+	Reserve(initialCapacity);
+}
+
+EntityStore::~EntityStore()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::Reserve( uint capacity )
+{
+	m_positionX.reserve(capacity);
+	m_positionY.reserve(capacity);
+	m_velocityX.reserve(capacity);
+	m_velocityY.reserve(capacity);
+	m_flags.reserve(capacity);
+	m_physicsRadius.reserve(capacity);
+	m_cosmeticRadius.reserve(capacity);
+	m_rotationDegrees.reserve(capacity);
+	m_angularVelocity.reserve(capacity);
+	m_uniformScale.reserve(capacity);
+	m_colors.reserve(capacity);
+	m_denseToSlot.reserve(capacity);
+	m_handles.Reserve(capacity);
+	m_slotToDense.reserve(capacity);
+	m_garbageSlots.reserve(capacity);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+EntityHandle EntityStore::Spawn( const EntityDescT& desc )
+{
+	uint entityIndex = GetCount();
+
+	uint32_t slot = m_handles.AllocateSlot();
+	if (slot >= m_slotToDense.size())
+	{
+		m_slotToDense.resize(slot + 1U);
+	}
+	m_slotToDense[slot] = entityIndex;
+	m_denseToSlot.push_back(slot);
+
+	m_positionX.push_back(desc.position.x);
+	m_positionY.push_back(desc.position.y);
+	m_velocityX.push_back(desc.velocity.x);
+	m_velocityY.push_back(desc.velocity.y);
+	m_flags.push_back(ENTITY_FLAG_ALIVE);
+	m_physicsRadius.push_back(desc.physicsRadius);
+	m_cosmeticRadius.push_back(desc.cosmeticRadius);
+	m_rotationDegrees.push_back(desc.rotationDegrees);
+	m_angularVelocity.push_back(desc.angularVelocity);
+	m_uniformScale.push_back(desc.uniformScale);
+	m_colors.push_back(desc.color);
+
+	EntityHandle handle;
+	handle.slot = slot;
+	handle.generation = m_handles.GetGeneration(slot);
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool EntityStore::MarkGarbage( const EntityHandle& handle )
+{
+	uint entityIndex;
+	if (!TryGetIndex(handle, entityIndex))
+	{
+		return false;
+	}
+
+	//Marking twice must not queue the slot twice
+	if ((m_flags[entityIndex] & ENTITY_FLAG_GARBAGE) == 0)
+	{
+		m_flags[entityIndex] |= ENTITY_FLAG_GARBAGE;
+		m_garbageSlots.push_back(handle.slot);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only visits the queued garbage: each one is swap-removed with the last dense entity and its slot goes back to the pool
+//------------------------------------------------------------------------------------------------------------------------------
+uint EntityStore::RemoveGarbage()
+{
+	uint removedCount = (uint)m_garbageSlots.size();
+
+	for (uint32_t slot : m_garbageSlots)
+	{
+		uint entityIndex = m_slotToDense[slot];
+		uint lastIndex = GetCount() - 1U;
+		if (entityIndex != lastIndex)
+		{
+			MoveEntity(lastIndex, entityIndex);
+			m_slotToDense[m_denseToSlot[entityIndex]] = entityIndex;
+		}
+		PopBack();
+		m_handles.FreeSlot(slot);
+	}
+
+	m_garbageSlots.clear();
+	return removedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool EntityStore::IsValid( const EntityHandle& handle ) const
+{
+	uint entityIndex;
+	return TryGetIndex(handle, entityIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool EntityStore::TryGetIndex( const EntityHandle& handle, uint& outEntityIndex ) const
+{
+	if (!m_handles.IsCurrent(handle.slot, handle.generation))
+	{
+		return false;
+	}
+
+	outEntityIndex = m_slotToDense[handle.slot];
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+EntityHandle EntityStore::GetHandle( uint entityIndex ) const
+{
+	EntityHandle handle;
+	handle.slot = m_denseToSlot[entityIndex];
+	handle.generation = m_handles.GetGeneration(handle.slot);
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::Clear()
+{
+	m_positionX.clear();
+	m_positionY.clear();
+	m_velocityX.clear();
+	m_velocityY.clear();
+	m_flags.clear();
+	m_physicsRadius.clear();
+	m_cosmeticRadius.clear();
+	m_rotationDegrees.clear();
+	m_angularVelocity.clear();
+	m_uniformScale.clear();
+	m_colors.clear();
+
+	m_handles.FreeAllSlots();
+	m_denseToSlot.clear();
+	m_garbageSlots.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::Update( float deltaTime )
+{
+	UpdateRange(0U, GetCount(), deltaTime);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Straight loops over raw column pointers with no aliasing and no branches, so the compiler vectorizes each of them
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::UpdateRange( uint beginIndex, uint endIndex, float deltaTime )
+{
+	float* ENTITY_RESTRICT positionX = m_positionX.data();
+	float* ENTITY_RESTRICT positionY = m_positionY.data();
+	const float* ENTITY_RESTRICT velocityX = m_velocityX.data();
+	const float* ENTITY_RESTRICT velocityY = m_velocityY.data();
+	float* ENTITY_RESTRICT rotationDegrees = m_rotationDegrees.data();
+	const float* ENTITY_RESTRICT angularVelocity = m_angularVelocity.data();
+	uint8_t* ENTITY_RESTRICT flags = m_flags.data();
+
+	for (uint entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+	{
+		positionX[entityIndex] += velocityX[entityIndex] * deltaTime;
+		positionY[entityIndex] += velocityY[entityIndex] * deltaTime;
+	}
+
+	for (uint entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+	{
+		rotationDegrees[entityIndex] += angularVelocity[entityIndex] * deltaTime;
+	}
+
+	const float minX = m_screenMin.x;
+	const float minY = m_screenMin.y;
+	const float maxX = m_screenMax.x;
+	const float maxY = m_screenMax.y;
+	for (uint entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+	{
+		float x = positionX[entityIndex];
+		float y = positionY[entityIndex];
+		uint8_t isOnScreen = (uint8_t)((x >= minX) & (x <= maxX) & (y >= minY) & (y <= maxY));
+		flags[entityIndex] = (uint8_t)((flags[entityIndex] & ~ENTITY_FLAG_OFFSCREEN) | ((isOnScreen ^ 1U) << 1));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::SetScreenBounds( const Vec2& minBounds, const Vec2& maxBounds )
+{
+	m_screenMin = minBounds;
+	m_screenMax = maxBounds;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::AddDebugVerts( std::vector<Vertex_PCU>& outVerts, bool usePhysicsRadius ) const
+{
+	const Vec2* unitDisc = GetUnitDiscVerts();
+	const std::vector<float>& radii = usePhysicsRadius ? m_physicsRadius : m_cosmeticRadius;
+
+	size_t firstVert = outVerts.size();
+	outVerts.resize(firstVert + (size_t)GetCount() * DEBUG_DISC_VERTS);
+	Vertex_PCU* vert = outVerts.data() + firstVert;
+
+	for (uint entityIndex = 0; entityIndex < GetCount(); ++entityIndex)
+	{
+		float centerX = m_positionX[entityIndex];
+		float centerY = m_positionY[entityIndex];
+		float radius = radii[entityIndex];
+		const Rgba& color = m_colors[entityIndex];
+
+		for (uint discIndex = 0; discIndex < DEBUG_DISC_VERTS; ++discIndex)
+		{
+			*vert++ = Vertex_PCU(Vec3(centerX + unitDisc[discIndex].x * radius, centerY + unitDisc[discIndex].y * radius, 0.f), color, Vec2(0.f, 0.f));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::SetVelocity( uint entityIndex, const Vec2& velocity )
+{
+	m_velocityX[entityIndex] = velocity.x;
+	m_velocityY[entityIndex] = velocity.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::MoveEntity( uint fromIndex, uint toIndex )
+{
+	m_positionX[toIndex] = m_positionX[fromIndex];
+	m_positionY[toIndex] = m_positionY[fromIndex];
+	m_velocityX[toIndex] = m_velocityX[fromIndex];
+	m_velocityY[toIndex] = m_velocityY[fromIndex];
+	m_flags[toIndex] = m_flags[fromIndex];
+	m_physicsRadius[toIndex] = m_physicsRadius[fromIndex];
+	m_cosmeticRadius[toIndex] = m_cosmeticRadius[fromIndex];
+	m_rotationDegrees[toIndex] = m_rotationDegrees[fromIndex];
+	m_angularVelocity[toIndex] = m_angularVelocity[fromIndex];
+	m_uniformScale[toIndex] = m_uniformScale[fromIndex];
+	m_colors[toIndex] = m_colors[fromIndex];
+	m_denseToSlot[toIndex] = m_denseToSlot[fromIndex];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EntityStore::PopBack()
+{
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_flags.pop_back();
+	m_physicsRadius.pop_back();
+	m_cosmeticRadius.pop_back();
+	m_rotationDegrees.pop_back();
+	m_angularVelocity.pop_back();
+	m_uniformScale.pop_back();
+	m_colors.pop_back();
+	m_denseToSlot.pop_back();
+}
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Game Systems
+#include "Game/GameCommon.hpp"
+#include "Game/HandlePool.hpp"
+//Third Party
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eEntityFlags : uint8_t
+{
+	ENTITY_FLAG_ALIVE = 1 << 0,
+	ENTITY_FLAG_OFFSCREEN = 1 << 1,
+	ENTITY_FLAG_GARBAGE = 1 << 2,
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Stable reference to an entity. The slot survives swap removes; the generation changes whenever the slot is reused, so a
+// handle to a despawned entity is detected instead of silently pointing at whoever took its place
+//------------------------------------------------------------------------------------------------------------------------------
+struct EntityHandle
+{
+	uint32_t							slot = 0xFFFFFFFFU;
+	uint32_t							generation = 0U;
+
+	bool								IsNull() const { return slot == 0xFFFFFFFFU; }
+	bool								operator==( const EntityHandle& other ) const { return slot == other.slot && generation == other.generation; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct EntityDescT
+{
+	Vec2								position = Vec2(0.f, 0.f);
+	Vec2								velocity = Vec2(0.f, 0.f);
+	float								rotationDegrees = 0.f;
+	float								angularVelocity = 0.f;
+	float								uniformScale = 1.f;
+	float								physicsRadius = 1.f;
+	float								cosmeticRadius = 1.f;
+	Rgba								color = Rgba::WHITE;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Structure of arrays storage for every entity in the game. Each property is its own contiguous column, so the per frame
+// update only streams through the columns it touches and its loops vectorize. Debug geometry is no longer stored per entity
+// (it was ~2 KB of Vertex_PCU each), AddDebugVerts expands one shared unit disc instead.
+//
+// Batch systems address entities by dense index, which is only stable until RemoveGarbage swap-removes. Anything that holds
+// on to an entity across frames keeps an EntityHandle. Slots come from a HandlePool and garbage is queued when it is marked,
+// so RemoveGarbage costs O(garbage), and once the columns and lists reached their high water mark spawning and despawning
+// no longer allocates.
+//------------------------------------------------------------------------------------------------------------------------------
+class EntityStore
+{
+public:
+	explicit EntityStore( uint initialCapacity = 0U );
+	~EntityStore();
+
+	EntityHandle						Spawn( const EntityDescT& desc );
+
+	//Queues the entity for the next RemoveGarbage. Returns false for stale handles
+	bool								MarkGarbage( const EntityHandle& handle );
+	uint								RemoveGarbage();
+
+	bool								IsValid( const EntityHandle& handle ) const;
+	bool								TryGetIndex( const EntityHandle& handle, uint& outEntityIndex ) const;
+	EntityHandle						GetHandle( uint entityIndex ) const;
+	void								Clear();
+	void								Reserve( uint capacity );
+
+	//Integrates motion and refreshes the off screen flag
+	void								Update( float deltaTime );
+	void								UpdateRange( uint beginIndex, uint endIndex, float deltaTime );
+
+	//Entities outside these bounds are flagged ENTITY_FLAG_OFFSCREEN
+	void								SetScreenBounds( const Vec2& minBounds, const Vec2& maxBounds );
+
+	//48 verts (16 triangle fan) per entity, built from the shared unit disc
+	void								AddDebugVerts( std::vector<Vertex_PCU>& outVerts, bool usePhysicsRadius ) const;
+
+	uint								GetCount() const { return (uint)m_positionX.size(); }
+	uint								GetCapacity() const { return (uint)m_positionX.capacity(); }
+	Vec2								GetPosition( uint entityIndex ) const { return Vec2(m_positionX[entityIndex], m_positionY[entityIndex]); }
+	Vec2								GetVelocity( uint entityIndex ) const { return Vec2(m_velocityX[entityIndex], m_velocityY[entityIndex]); }
+	float								GetPhysicsRadius( uint entityIndex ) const { return m_physicsRadius[entityIndex]; }
+	float								GetRotationDegrees( uint entityIndex ) const { return m_rotationDegrees[entityIndex]; }
+	const Rgba&							GetColor( uint entityIndex ) const { return m_colors[entityIndex]; }
+	uint8_t								GetFlags( uint entityIndex ) const { return m_flags[entityIndex]; }
+	bool								IsOffScreen( uint entityIndex ) const { return (m_flags[entityIndex] & ENTITY_FLAG_OFFSCREEN) != 0; }
+
+	void								SetVelocity( uint entityIndex, const Vec2& velocity );
+
+	//Raw columns for batch systems (collision, rendering)
+	const float*						GetPositionsX() const { return m_positionX.data(); }
+	const float*						GetPositionsY() const { return m_positionY.data(); }
+	const float*						GetVelocitiesX() const { return m_velocityX.data(); }
+	const float*						GetVelocitiesY() const { return m_velocityY.data(); }
+	const float*						GetPhysicsRadii() const { return m_physicsRadius.data(); }
+	const uint8_t*						GetFlagsColumn() const { return m_flags.data(); }
+
+private:
+	void								MoveEntity( uint fromIndex, uint toIndex );
+	void								PopBack();
+
+private:
+	//Hot, touched every frame
+	std::vector<float>					m_positionX;
+	std::vector<float>					m_positionY;
+	std::vector<float>					m_velocityX;
+	std::vector<float>					m_velocityY;
+	std::vector<uint8_t>				m_flags;
+
+	//Warm, read by collision and debug draw
+	std::vector<float>					m_physicsRadius;
+	std::vector<float>					m_cosmeticRadius;
+
+	//Cold
+	std::vector<float>					m_rotationDegrees;
+	std::vector<float>					m_angularVelocity;
+	std::vector<float>					m_uniformScale;
+	std::vector<Rgba>					m_colors;
+	std::vector<uint32_t>				m_denseToSlot;
+
+	//Slots and generations come from the pool, this maps each slot to where its entity currently is
+	HandlePool							m_handles;
+	std::vector<uint32_t>				m_slotToDense;
+	std::vector<uint32_t>				m_garbageSlots;
+
+	Vec2								m_screenMin = Vec2(0.f, 0.f);
+	Vec2								m_screenMax = Vec2(WORLD_WIDTH, WORLD_HEIGHT);
+};
@@ -0,0 +1,322 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/FontAtlas.hpp"
+//Engine Systems
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+//Game Systems
+#include "Game/ImageDecoder.hpp"
+#include "Game/VirtualFileSystem.hpp"
+//Third Party
+#include <algorithm>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Largest 2D texture D3D11 will create
+constexpr int MAX_FONT_ATLAS_HEIGHT = 16384;
+//BitmapFont emits every glyph as two triangles
+constexpr uint VERTS_PER_GLYPH = 6U;
+//Images are loaded bottom row first (stbi flip), while .fnt glyph rects are measured from the top of the png
+constexpr bool FONT_PAGE_ROWS_FLIPPED = true;
+
+//------------------------------------------------------------------------------------------------------------------------------
+FontAtlas::FontAtlas( uint atlasWidth, uint gutter )
+	: m_atlasWidth(atlasWidth),
+	m_gutter(gutter)
+{
+}
+
+FontAtlas::~FontAtlas()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool FontAtlas::AddFontFromFnt( const BitmapFont* font, const std::string& fntPath, uint firstChar, uint lastChar )
+{
+	tinyxml2::XMLDocument fntDoc;
+	if (g_virtualFileSystem != nullptr)
+	{
+		std::string fntText;
+		g_virtualFileSystem->ReadTextFile(fntPath, fntText);
+		fntDoc.Parse(fntText.c_str(), fntText.size());
+	}
+	else
+	{
+		fntDoc.LoadFile(fntPath.c_str());
+	}
+	if (fntDoc.ErrorID() != tinyxml2::XML_SUCCESS)
+	{
+		DebuggerPrintf("\n FontAtlas: could not load %s", fntPath.c_str());
+		return false;
+	}
+
+	XMLElement* rootElement = fntDoc.RootElement();
+	XMLElement* commonElement = rootElement->FirstChildElement("common");
+	XMLElement* pagesElement = rootElement->FirstChildElement("pages");
+	XMLElement* charsElement = rootElement->FirstChildElement("chars");
+	XMLElement* pageElement = (pagesElement != nullptr) ? pagesElement->FirstChildElement("page") : nullptr;
+	if (commonElement == nullptr || pageElement == nullptr || charsElement == nullptr)
+	{
+		DebuggerPrintf("\n FontAtlas: %s is missing common, pages or chars", fntPath.c_str());
+		return false;
+	}
+
+	//Page files are relative to the .fnt. Only page 0 is packed, none of our fonts have more
+	size_t folderEnd = fntPath.find_last_of("/\\");
+	std::string folder = (folderEnd == std::string::npos) ? std::string() : fntPath.substr(0, folderEnd + 1);
+	IntVec2 pageDimensions(commonElement->IntAttribute("scaleW"), commonElement->IntAttribute("scaleH"));
+	uint pageIndex = AddPage(folder + pageElement->Attribute("file"), pageDimensions);
+
+	for (XMLElement* charElement = charsElement->FirstChildElement("char"); charElement != nullptr; charElement = charElement->NextSiblingElement("char"))
+	{
+		uint charID = charElement->UnsignedAttribute("id");
+		IntVec2 size(charElement->IntAttribute("width"), charElement->IntAttribute("height"));
+		if (charID < firstChar || charID > lastChar || charElement->IntAttribute("page") != 0 || size.x <= 0 || size.y <= 0)
+		{
+			continue;
+		}
+
+		IntVec2 sourceMin(charElement->IntAttribute("x"), charElement->IntAttribute("y"));
+		if (FONT_PAGE_ROWS_FLIPPED)
+		{
+			sourceMin.y = pageDimensions.y - (sourceMin.y + size.y);
+		}
+
+		AddRect(font, pageIndex, sourceMin, size);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool FontAtlas::AddFontPage( const BitmapFont* font, const std::string& imagePath )
+{
+	DecodedImageT pageImage;
+	if (!DecodeImageFileRGBA8(imagePath, pageImage))
+	{
+		DebuggerPrintf("\n FontAtlas: could not load %s", imagePath.c_str());
+		return false;
+	}
+
+	IntVec2 pageDimensions((int)pageImage.width, (int)pageImage.height);
+	uint pageIndex = AddPage(imagePath, pageDimensions);
+	AddRect(font, pageIndex, IntVec2(0, 0), pageDimensions);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint FontAtlas::AddPage( const std::string& imagePath, const IntVec2& dimensions )
+{
+	FontAtlasPageT page;
+	page.imagePath = imagePath;
+	page.dimensions = dimensions;
+	m_pages.push_back(page);
+	return (uint)m_pages.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FontAtlas::AddRect( const BitmapFont* font, uint pageIndex, const IntVec2& sourceMin, const IntVec2& size )
+{
+	FontAtlasRectT rect;
+	rect.font = font;
+	rect.pageIndex = pageIndex;
+	rect.sourceMin = sourceMin;
+	rect.size = size;
+	m_rects.push_back(rect);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool FontAtlas::Pack()
+{
+	//Tallest first, so every shelf is filled with glyphs of about its own height
+	std::vector<uint> order(m_rects.size());
+	for (uint rectIndex = 0; rectIndex < (uint)m_rects.size(); ++rectIndex)
+	{
+		order[rectIndex] = rectIndex;
+	}
+
+	std::sort(order.begin(), order.end(), [this](uint lhs, uint rhs)
+	{
+		const IntVec2& lhsSize = m_rects[lhs].size;
+		const IntVec2& rhsSize = m_rects[rhs].size;
+		return (lhsSize.y != rhsSize.y) ? (lhsSize.y > rhsSize.y) : (lhsSize.x > rhsSize.x);
+	});
+
+	int gutter = (int)m_gutter;
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	for (uint rectIndex : order)
+	{
+		FontAtlasRectT& rect = m_rects[rectIndex];
+		int paddedWidth = rect.size.x + 2 * gutter;
+		int paddedHeight = rect.size.y + 2 * gutter;
+		if (paddedWidth > (int)m_atlasWidth)
+		{
+			DebuggerPrintf("\n FontAtlas: a %d texel wide glyph does not fit a %u texel atlas", rect.size.x, m_atlasWidth);
+			return false;
+		}
+
+		if (shelfX + paddedWidth > (int)m_atlasWidth)
+		{
+			shelfY += shelfHeight;
+			shelfX = 0;
+			shelfHeight = 0;
+		}
+
+		rect.atlasMin = IntVec2(shelfX + gutter, shelfY + gutter);
+		shelfX += paddedWidth;
+		shelfHeight = std::max(shelfHeight, paddedHeight);
+	}
+
+	//No mips on the atlas, so only round the height up to whole 4x4 blocks instead of a power of two
+	int usedHeight = shelfY + shelfHeight;
+	int atlasHeight = (usedHeight + 3) & ~3;
+
+	if (atlasHeight > MAX_FONT_ATLAS_HEIGHT)
+	{
+		DebuggerPrintf("\n FontAtlas: glyphs need %d rows, more than a texture can hold", usedHeight);
+		return false;
+	}
+
+	m_dimensions = IntVec2((int)m_atlasWidth, atlasHeight);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool FontAtlas::Build()
+{
+	if (!Pack())
+	{
+		return false;
+	}
+
+	//Gutters stay transparent black
+	size_t atlasRowPitch = (size_t)m_dimensions.x * 4U;
+	m_texels.assign(atlasRowPitch * (size_t)m_dimensions.y, 0U);
+
+	//One page in memory at a time, the 2048 pages are big
+	DecodedImageT pageImage;
+	for (uint pageIndex = 0; pageIndex < (uint)m_pages.size(); ++pageIndex)
+	{
+		const FontAtlasPageT& page = m_pages[pageIndex];
+		if (!DecodeImageFileRGBA8(page.imagePath, pageImage) || (int)pageImage.width != page.dimensions.x || (int)pageImage.height != page.dimensions.y)
+		{
+			DebuggerPrintf("\n FontAtlas: could not load %s at %dx%d", page.imagePath.c_str(), page.dimensions.x, page.dimensions.y);
+			m_texels.clear();
+			return false;
+		}
+
+		for (const FontAtlasRectT& rect : m_rects)
+		{
+			if (rect.pageIndex != pageIndex)
+			{
+				continue;
+			}
+
+			for (int y = 0; y < rect.size.y; ++y)
+			{
+				const unsigned char* sourceRow = pageImage.GetRow((uint)(rect.sourceMin.y + y)) + (size_t)rect.sourceMin.x * 4U;
+				unsigned char* atlasRow = m_texels.data() + (size_t)(rect.atlasMin.y + y) * atlasRowPitch + (size_t)rect.atlasMin.x * 4U;
+				memcpy(atlasRow, sourceRow, (size_t)rect.size.x * 4U);
+			}
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FontAtlas::ReleaseTexels()
+{
+	std::vector<unsigned char>().swap(m_texels);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint FontAtlas::RemapVerts( const BitmapFont* font, std::vector<Vertex_PCU>& verts, uint firstVert ) const
+{
+	const FontAtlasRectT* anyRect = FindFirstRect(font);
+	if (anyRect == nullptr || m_dimensions.x == 0)
+	{
+		return 0U;
+	}
+
+	//The font's UVs span its own page
+	const IntVec2& pageDimensions = m_pages[anyRect->pageIndex].dimensions;
+	float pageWidth = (float)pageDimensions.x;
+	float pageHeight = (float)pageDimensions.y;
+	float invAtlasWidth = 1.f / (float)m_dimensions.x;
+	float invAtlasHeight = 1.f / (float)m_dimensions.y;
+
+	uint missingCount = 0U;
+	uint endVert = firstVert + ((uint)verts.size() - firstVert) / VERTS_PER_GLYPH * VERTS_PER_GLYPH;
+	for (uint quadStart = firstVert; quadStart < endVert; quadStart += VERTS_PER_GLYPH)
+	{
+		Vertex_PCU* quad = &verts[quadStart];
+
+		//The center of the quad's UVs picks the glyph, so small insets or outsets in the font's UVs do not matter
+		float centerU = 0.f;
+		float centerV = 0.f;
+		for (uint vertIndex = 0; vertIndex < VERTS_PER_GLYPH; ++vertIndex)
+		{
+			centerU += quad[vertIndex].m_uvTexCoords.x;
+			centerV += quad[vertIndex].m_uvTexCoords.y;
+		}
+
+		const FontAtlasRectT* rect = FindRect(font, centerU / (float)VERTS_PER_GLYPH * pageWidth, centerV / (float)VERTS_PER_GLYPH * pageHeight);
+		if (rect == nullptr)
+		{
+			for (uint vertIndex = 1; vertIndex < VERTS_PER_GLYPH; ++vertIndex)
+			{
+				quad[vertIndex].m_position = quad[0].m_position;
+			}
+			missingCount++;
+			continue;
+		}
+
+		float offsetX = (float)(rect->atlasMin.x - rect->sourceMin.x);
+		float offsetY = (float)(rect->atlasMin.y - rect->sourceMin.y);
+		for (uint vertIndex = 0; vertIndex < VERTS_PER_GLYPH; ++vertIndex)
+		{
+			Vec2& uv = quad[vertIndex].m_uvTexCoords;
+			uv.x = (uv.x * pageWidth + offsetX) * invAtlasWidth;
+			uv.y = (uv.y * pageHeight + offsetY) * invAtlasHeight;
+		}
+	}
+
+	return missingCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool FontAtlas::ContainsFont( const BitmapFont* font ) const
+{
+	return FindFirstRect(font) != nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const FontAtlasRectT* FontAtlas::FindFirstRect( const BitmapFont* font ) const
+{
+	for (const FontAtlasRectT& rect : m_rects)
+	{
+		if (rect.font == font)
+		{
+			return &rect;
+		}
+	}
+
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const FontAtlasRectT* FontAtlas::FindRect( const BitmapFont* font, float texelX, float texelY ) const
+{
+	for (const FontAtlasRectT& rect : m_rects)
+	{
+		if (rect.font == font
+			&& texelX >= (float)rect.sourceMin.x && texelX < (float)(rect.sourceMin.x + rect.size.x)
+			&& texelY >= (float)rect.sourceMin.y && texelY < (float)(rect.sourceMin.y + rect.size.y))
+		{
+			return &rect;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Third Party
+#include <string>
+#include <vector>
+
+class BitmapFont;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One source page, in the row order the engine's Image loads it
+//------------------------------------------------------------------------------------------------------------------------------
+struct FontAtlasPageT
+{
+	std::string							imagePath;
+	IntVec2								dimensions;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A glyph (or a whole page for grid fonts) copied into the atlas. Both corners are in Image texels
+//------------------------------------------------------------------------------------------------------------------------------
+struct FontAtlasRectT
+{
+	const BitmapFont*					font = nullptr;
+	uint								pageIndex = 0U;
+	IntVec2								sourceMin;
+	IntVec2								size;
+	IntVec2								atlasMin;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Packs the glyphs of several BitmapFont pages into one image at startup so UI text from every font can share a texture.
+// Glyphs are shelf packed tallest first with a transparent gutter between them. Text is still laid out by the BitmapFont
+// that owns it; RemapVerts then moves each glyph quad's UVs from the font's page into the atlas.
+//------------------------------------------------------------------------------------------------------------------------------
+class FontAtlas
+{
+public:
+	explicit FontAtlas( uint atlasWidth = 4096U, uint gutter = 2U );
+	~FontAtlas();
+
+	//AngelCode .fnt fonts: only glyphs in [firstChar, lastChar] are packed, the rest of the page is skipped
+	bool								AddFontFromFnt( const BitmapFont* font, const std::string& fntPath, uint firstChar = 32U, uint lastChar = 126U );
+	//Fixed grid fonts have no glyph table, so the whole page is packed as one rect
+	bool								AddFontPage( const BitmapFont* font, const std::string& imagePath );
+
+	uint								AddPage( const std::string& imagePath, const IntVec2& dimensions );
+	void								AddRect( const BitmapFont* font, uint pageIndex, const IntVec2& sourceMin, const IntVec2& size );
+
+	//Pack only places the rects, Build also decodes the pages and copies their texels into the atlas
+	bool								Pack();
+	bool								Build();
+	void								ReleaseTexels();
+
+	//Returns how many quads had no glyph in the atlas; those are collapsed so they draw nothing
+	uint								RemapVerts( const BitmapFont* font, std::vector<Vertex_PCU>& verts, uint firstVert = 0U ) const;
+
+	bool								ContainsFont( const BitmapFont* font ) const;
+	//RGBA8 rows of GetDimensions().x texels, bottom row first like the pages. Empty until Build and after ReleaseTexels
+	const std::vector<unsigned char>&	GetTexels() const { return m_texels; }
+	const IntVec2&						GetDimensions() const { return m_dimensions; }
+	const std::vector<FontAtlasRectT>&	GetRects() const { return m_rects; }
+
+private:
+	const FontAtlasRectT*				FindFirstRect( const BitmapFont* font ) const;
+	const FontAtlasRectT*				FindRect( const BitmapFont* font, float texelX, float texelY ) const;
+
+private:
+	uint								m_atlasWidth = 4096U;
+	uint								m_gutter = 2U;
+
+	std::vector<FontAtlasPageT>			m_pages;
+	std::vector<FontAtlasRectT>			m_rects;
+
+	IntVec2								m_dimensions;
+	std::vector<unsigned char>			m_texels;
+};
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/FrameAllocator.hpp"
+//Third Party
+#include <thread>
+
+FrameAllocator* g_frameAllocator = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint FRAME_ALLOCATOR_NO_FRAME = 0xFFFFFFFFU;
+
+static std::atomic<uint> s_nextFrameAllocatorId(1U);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One thread's pair of arenas. Only the owning thread touches the arenas; the frame tags and sizes are atomic so EndFrame can
+// read them from the main thread
+//------------------------------------------------------------------------------------------------------------------------------
+struct FrameAllocatorThreadT
+{
+	FrameAllocatorThreadT( size_t bytes, std::thread::id owner )
+		: arenas{ FrameArena(bytes), FrameArena(bytes) },
+		ownerId(owner)
+	{
+		for (uint buffer = 0; buffer < 2U; ++buffer)
+		{
+			arenaFrames[buffer].store(FRAME_ALLOCATOR_NO_FRAME, std::memory_order_relaxed);
+			arenaBytes[buffer].store(0U, std::memory_order_relaxed);
+			arenaSpills[buffer].store(0U, std::memory_order_relaxed);
+		}
+	}
+
+	FrameArena							arenas[2];
+	std::atomic<uint>					arenaFrames[2];
+	std::atomic<size_t>					arenaBytes[2];
+	std::atomic<uint>					arenaSpills[2];
+	std::thread::id						ownerId;
+};
+
+//The state of the allocator the thread used last, the others are looked up by owner
+static thread_local FrameAllocatorThreadT* t_frameAllocatorThread = nullptr;
+static thread_local uint t_frameAllocatorId = 0U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+FrameAllocator::FrameAllocator( size_t bytesPerThread )
+	: m_bytesPerThread(bytesPerThread)
+	, m_id(s_nextFrameAllocatorId.fetch_add(1U))
+	, m_frameIndex(0U)
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	for (FrameAllocatorThreadT* thread : m_threads)
+	{
+		delete thread;
+	}
+	m_threads.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+FrameArena& FrameAllocator::GetThreadArena( FrameAllocatorThreadT*& outThread, uint& outBuffer )
+{
+	if (t_frameAllocatorId != m_id)
+	{
+		t_frameAllocatorThread = FindOrAddThread();
+		t_frameAllocatorId = m_id;
+	}
+
+	uint frameIndex = m_frameIndex.load(std::memory_order_acquire);
+	uint buffer = frameIndex & 1U;
+	FrameAllocatorThreadT& thread = *t_frameAllocatorThread;
+
+	//Last used two frames ago, the frame after it has had its chance to read it
+	if (thread.arenaFrames[buffer].load(std::memory_order_relaxed) != frameIndex)
+	{
+		thread.arenas[buffer].Reset();
+		thread.arenaBytes[buffer].store(0U, std::memory_order_relaxed);
+		thread.arenaSpills[buffer].store(0U, std::memory_order_relaxed);
+		thread.arenaFrames[buffer].store(frameIndex, std::memory_order_release);
+	}
+
+	outThread = &thread;
+	outBuffer = buffer;
+	return thread.arenas[buffer];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Only on a thread's first allocation here or when it comes back from another allocator, so the lock is off the common path
+//------------------------------------------------------------------------------------------------------------------------------
+FrameAllocatorThreadT* FrameAllocator::FindOrAddThread()
+{
+	std::thread::id threadId = std::this_thread::get_id();
+	std::lock_guard<std::mutex> lock(m_threadLock);
+	for (FrameAllocatorThreadT* thread : m_threads)
+	{
+		if (thread->ownerId == threadId)
+		{
+			return thread;
+		}
+	}
+
+	FrameAllocatorThreadT* thread = new FrameAllocatorThreadT(m_bytesPerThread, threadId);
+	m_threads.push_back(thread);
+	return thread;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* FrameAllocator::Allocate( size_t byteCount, size_t alignment )
+{
+	FrameAllocatorThreadT* thread = nullptr;
+	uint buffer = 0U;
+	FrameArena& arena = GetThreadArena(thread, buffer);
+
+	void* memory = arena.Allocate(byteCount, alignment);
+	thread->arenaBytes[buffer].store(arena.GetUsedBytes(), std::memory_order_relaxed);
+	thread->arenaSpills[buffer].store(arena.GetSpillCount(), std::memory_order_relaxed);
+	return memory;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* FrameAllocator::Format( uint& outLength, const char* format, ... )
+{
+	va_list args;
+	va_start(args, format);
+	const char* text = FormatV(outLength, format, args);
+	va_end(args);
+	return text;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* FrameAllocator::FormatV( uint& outLength, const char* format, va_list args )
+{
+	FrameAllocatorThreadT* thread = nullptr;
+	uint buffer = 0U;
+	FrameArena& arena = GetThreadArena(thread, buffer);
+
+	const char* text = arena.FormatV(outLength, format, args);
+
+	thread->arenaBytes[buffer].store(arena.GetUsedBytes(), std::memory_order_relaxed);
+	thread->arenaSpills[buffer].store(arena.GetSpillCount(), std::memory_order_relaxed);
+	return text;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FrameAllocator::EndFrame()
+{
+	uint frameIndex = m_frameIndex.load(std::memory_order_relaxed);
+	uint buffer = frameIndex & 1U;
+
+	//Threads that did not allocate this frame still have an older frame's tag and are left out
+	size_t frameBytes = 0U;
+	uint spillCount = 0U;
+	{
+		std::lock_guard<std::mutex> lock(m_threadLock);
+		for (FrameAllocatorThreadT* thread : m_threads)
+		{
+			if (thread->arenaFrames[buffer].load(std::memory_order_acquire) == frameIndex)
+			{
+				frameBytes += thread->arenaBytes[buffer].load(std::memory_order_relaxed);
+				spillCount += thread->arenaSpills[buffer].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	m_lastFrameBytes = frameBytes;
+	m_lastFrameSpillCount = spillCount;
+	if (frameBytes > m_highWaterBytes)
+	{
+		m_highWaterBytes = frameBytes;
+	}
+
+	m_frameIndex.store(frameIndex + 1U, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint FrameAllocator::GetThreadCount()
+{
+	std::lock_guard<std::mutex> lock(m_threadLock);
+	return (uint)m_threads.size();
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/FrameArena.hpp"
+//Third Party
+#include <atomic>
+#include <mutex>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+struct FrameAllocatorThreadT;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Starting size of each thread's two arenas, they grow to fit the thread's busiest frame
+constexpr size_t FRAME_ALLOCATOR_THREAD_BYTES = 256U * 1024U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Per-frame scratch memory for every thread. Each thread that allocates gets two FrameArenas and uses them on alternate
+// frames, so what one frame builds stays readable through the next one, which is when the render side looks at it. An arena
+// is reset by its own thread on its first allocation two frames later; EndFrame only moves the frame on and gathers the sizes.
+// Any number of allocators can be live, a thread keeps one pair of arenas in each it allocates from.
+//
+// Nothing is freed or destroyed. Jobs that run longer than a frame should not keep frame memory past the end of the next one.
+//------------------------------------------------------------------------------------------------------------------------------
+class FrameAllocator
+{
+public:
+	explicit FrameAllocator( size_t bytesPerThread = FRAME_ALLOCATOR_THREAD_BYTES );
+	~FrameAllocator();
+
+	//From the calling thread's arena for this frame. Safe from any thread
+	void*								Allocate( size_t byteCount, size_t alignment = FRAME_ARENA_DEFAULT_ALIGNMENT );
+	template <typename T>
+	T*									AllocateArray( uint count ) { return (T*)Allocate(sizeof(T) * count, alignof(T)); }
+	const char*							Format( uint& outLength, const char* format, ... );
+	const char*							FormatV( uint& outLength, const char* format, va_list args );
+
+	//Main thread, once all of the frame's work is done
+	void								EndFrame();
+
+	uint								GetFrameIndex() const { return m_frameIndex.load(std::memory_order_relaxed); }
+	//Every thread's bytes in the last frame that ended
+	size_t								GetLastFrameBytes() const { return m_lastFrameBytes; }
+	//Most any one frame has used
+	size_t								GetHighWaterBytes() const { return m_highWaterBytes; }
+	//Heap allocations the arenas made in the last frame that ended, 0 once they have grown to fit
+	uint								GetLastFrameSpillCount() const { return m_lastFrameSpillCount; }
+	uint								GetThreadCount();
+
+private:
+	FrameArena&							GetThreadArena( FrameAllocatorThreadT*& outThread, uint& outBuffer );
+	FrameAllocatorThreadT*				FindOrAddThread();
+
+private:
+	size_t								m_bytesPerThread = 0U;
+	//Tells this allocator's thread states apart from those of one that was deleted before it
+	uint								m_id = 0U;
+	std::atomic<uint>					m_frameIndex;
+
+	std::mutex							m_threadLock;
+	std::vector<FrameAllocatorThreadT*>	m_threads;
+
+	size_t								m_lastFrameBytes = 0U;
+	size_t								m_highWaterBytes = 0U;
+	uint								m_lastFrameSpillCount = 0U;
+};
+
+extern FrameAllocator* g_frameAllocator;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// STL allocator over a FrameAllocator, g_frameAllocator unless given one. deallocate does nothing, so a container that grows
+// leaves its old buffers behind until the arena is reset. Without an allocator it falls back to the heap
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+class FrameStdAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameStdAllocator() : m_allocator(g_frameAllocator) {}
+	explicit FrameStdAllocator( FrameAllocator* allocator ) : m_allocator(allocator) {}
+	template <typename U>
+	FrameStdAllocator( const FrameStdAllocator<U>& other ) : m_allocator(other.GetFrameAllocator()) {}
+
+	T*									allocate( size_t count );
+	void								deallocate( T* items, size_t count );
+
+	FrameAllocator*						GetFrameAllocator() const { return m_allocator; }
+
+private:
+	FrameAllocator*						m_allocator = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==( const FrameStdAllocator<T>& a, const FrameStdAllocator<U>& b ) { return a.GetFrameAllocator() == b.GetFrameAllocator(); }
+template <typename T, typename U>
+bool operator!=( const FrameStdAllocator<T>& a, const FrameStdAllocator<U>& b ) { return a.GetFrameAllocator() != b.GetFrameAllocator(); }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, FrameStdAllocator<char>> FrameString;
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+T* FrameStdAllocator<T>::allocate( size_t count )
+{
+	if (m_allocator == nullptr)
+	{
+		return (T*)::operator new(count * sizeof(T));
+	}
+	return (T*)m_allocator->Allocate(count * sizeof(T), alignof(T));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+void FrameStdAllocator<T>::deallocate( T* items, size_t count )
+{
+	UNUSED(count);
+	if (m_allocator == nullptr)
+	{
+		::operator delete(items);
+	}
+}
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/FrameArena.hpp"
+//Third Party
+#include <stdio.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uintptr_t AlignAddress( uintptr_t address, size_t alignment )
+{
+	return (address + alignment - 1U) & ~(uintptr_t)(alignment - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+FrameArena::FrameArena( size_t capacityBytes )
+{
+	m_block.resize(capacityBytes);
+}
+
+FrameArena::~FrameArena()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* FrameArena::Allocate( size_t byteCount, size_t alignment )
+{
+	uintptr_t base = (uintptr_t)m_block.data();
+	size_t alignedOffset = (size_t)(AlignAddress(base + m_offset, alignment) - base);
+	if (alignedOffset + byteCount <= m_block.size())
+	{
+		m_offset = alignedOffset + byteCount;
+		if (GetUsedBytes() > m_highWaterBytes)
+		{
+			m_highWaterBytes = GetUsedBytes();
+		}
+		return m_block.data() + alignedOffset;
+	}
+
+	//Padded so the start can be aligned. Moving the outer vector keeps every spill's bytes where they are
+	m_spills.emplace_back(byteCount + alignment);
+	std::vector<unsigned char>& spill = m_spills.back();
+	m_spillBytes += spill.size();
+	if (GetUsedBytes() > m_highWaterBytes)
+	{
+		m_highWaterBytes = GetUsedBytes();
+	}
+	return (void*)AlignAddress((uintptr_t)spill.data(), alignment);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* FrameArena::Format( uint& outLength, const char* format, ... )
+{
+	va_list args;
+	va_start(args, format);
+	const char* text = FormatV(outLength, format, args);
+	va_end(args);
+	return text;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* FrameArena::FormatV( uint& outLength, const char* format, va_list args )
+{
+	//Straight into what is left of the block, formatting a second time only when it does not fit
+	size_t available = m_block.size() - m_offset;
+	char* text = (available > 0U) ? (char*)m_block.data() + m_offset : nullptr;
+
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int length = vsnprintf(text, available, format, argsCopy);
+	va_end(argsCopy);
+
+	if (length < 0)
+	{
+		outLength = 0U;
+		return "";
+	}
+
+	outLength = (uint)length;
+	if ((size_t)length < available)
+	{
+		m_offset += (size_t)length + 1U;
+		if (GetUsedBytes() > m_highWaterBytes)
+		{
+			m_highWaterBytes = GetUsedBytes();
+		}
+		return text;
+	}
+
+	char* spilledText = (char*)Allocate((size_t)length + 1U, 1U);
+	vsnprintf(spilledText, (size_t)length + 1U, format, args);
+	return spilledText;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FrameArena::Reset()
+{
+	if (!m_spills.empty())
+	{
+		//Doubling, so a frame that keeps growing a little does not spill every time
+		size_t usedBytes = GetUsedBytes();
+		size_t capacity = (m_block.size() > 256U) ? m_block.size() : 256U;
+		while (capacity < usedBytes)
+		{
+			capacity *= 2U;
+		}
+
+		std::vector<unsigned char>().swap(m_block);
+		m_block.resize(capacity);
+		m_spills.clear();
+		m_spillBytes = 0U;
+	}
+
+	m_offset = 0U;
+}
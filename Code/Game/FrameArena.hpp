@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr size_t FRAME_ARENA_DEFAULT_ALIGNMENT = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Linear allocator for data that only lives until the end of the frame. Allocate bumps an offset into one block and Reset
+// drops everything at once; nothing is freed on its own and no destructors run, so only trivially destructible data goes here.
+//
+// A frame that outgrows the block spills into extra heap blocks instead of failing, and the next Reset grows the block to
+// that frame's size, so after a few frames a steady workload allocates nothing.
+//------------------------------------------------------------------------------------------------------------------------------
+class FrameArena
+{
+public:
+	explicit FrameArena( size_t capacityBytes );
+	~FrameArena();
+
+	//alignment must be a power of two
+	void*								Allocate( size_t byteCount, size_t alignment = FRAME_ARENA_DEFAULT_ALIGNMENT );
+	template <typename T>
+	T*									AllocateArray( uint count ) { return (T*)Allocate(sizeof(T) * count, alignof(T)); }
+
+	//printf into the arena. The string is null terminated, its length without the terminator goes to outLength
+	const char*							Format( uint& outLength, const char* format, ... );
+	const char*							FormatV( uint& outLength, const char* format, va_list args );
+
+	void								Reset();
+
+	//Since the last Reset, spilled blocks included
+	size_t								GetUsedBytes() const { return m_offset + m_spillBytes; }
+	size_t								GetCapacityBytes() const { return m_block.size(); }
+	//Most any frame has used
+	size_t								GetHighWaterBytes() const { return m_highWaterBytes; }
+	//Heap allocations made since the last Reset, 0 once the block fits the frame
+	uint								GetSpillCount() const { return (uint)m_spills.size(); }
+
+private:
+	std::vector<unsigned char>			m_block;
+	size_t								m_offset = 0U;
+
+	std::vector<std::vector<unsigned char>>	m_spills;
+	size_t								m_spillBytes = 0U;
+	size_t								m_highWaterBytes = 0U;
+};
@@ -25,16 +25,35 @@
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/TextureView.hpp"
 #include "Engine/Commons/UnitTest.hpp"
-#include "Engine/Commons/Callstack.hpp"
 #include "Engine/Commons/Profiler/Profiler.hpp"
 #include "Engine/Core/Async/UniformAsyncRingBuffer.hpp"
 #include "Engine/Commons/Profiler/ProfileLogScope.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Renderer/Sampler.hpp"
+//Game Systems
+#include "Game/BinaryLog.hpp"
+#include "Game/CallstackTable.hpp"
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/DynamicTextureUploader.hpp"
+#include "Game/EntitySimulation.hpp"
+#include "Game/EntityStore.hpp"
+#include "Game/FontAtlas.hpp"
+#include "Game/FrameAllocator.hpp"
+#include "Game/JobScheduler.hpp"
+#include "Game/MandelbrotGenerator.hpp"
+#include "Game/MeshCache.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/SpatialHashGrid.hpp"
+#include "Game/SpriteBatch.hpp"
+#include "Game/TextRunCache.hpp"
+#include "Game/TextureStreamer.hpp"
 //#include "Engine/Core/JobSystem/MadleBrotJob.hpp"
 //#include "Engine/Core/JobSystem/JobSystem.hpp"
 
 //#include "ThirdParty/PhysX/include/PxPhysicsAPI.h"
+//Third Party
+#include <stdio.h>
+#include <thread>
 
 //------------------------------------------------------------------------------------------------------------------------------
 //Create Camera and set to null 
@@ -43,6 +62,8 @@
 #define LOG_MESSAGES_PER_THREAD_TEST   (1024)
 
 float g_shakeAmount = 0.0f;
+//For the console commands, which are static
+Game* g_theGame = nullptr;
 
 RandomNumberGenerator* g_randomNumGen;
 extern RenderContext* g_renderContext;	// Declare these first
@@ -50,10 +71,25 @@ extern AudioSystem* g_audio;
 extern uint gTestCount;
 bool g_debugMode = false;
 
+//Bounds of the LOD meshes for picking a level. The capsule's sphere is around its model origin, which it is built 1 unit away
+//from, so it also covers the capsule however m_capsuleModel turns it
+static const Vec3 SPHERE_WORLD_CENTER = Vec3(5.f, 0.f, 0.f);
+constexpr float SPHERE_BOUNDING_RADIUS = 1.f;
+constexpr float CAPSULE_BOUNDING_RADIUS = 3.5f;
+//Slots in the engine light buffer, MAX_LIGHTS in dot3_include.hlsl
+constexpr uint LIGHT_BUFFER_SLOT_COUNT = 8U;
+
 //------------------------------------------------------------------------------------------------------------------------------
 Game::Game()
 {
 	m_isGameAlive = true;
+
+	if (g_isHeadless)
+	{
+		//Fonts and sounds need the render context and audio system
+		return;
+	}
+
 	m_testAudioID = g_audio->CreateOrGetSound("Data/Audio/UproarLilWayne.mp3");
 
 	m_squirrelFixedFont = g_renderContext->CreateOrGetBitmapFontFromFile("SquirrelFixedFont");
@@ -88,11 +124,11 @@ static void LogTest()
 	{
 		if (g_RNG->GetRandomFloatInRange(0.f, 1.f) < 0.5f )
 		{
-			g_LogSystem->LogCallstackf("debug", format, hash_id, i);
+			g_binaryLog->LogCallstackf("debug", format, hash_id, i);
 		}
 		else 
 		{
-			g_LogSystem->Logf("debug", format, hash_id, i);
+			g_binaryLog->Logf("debug", format, hash_id, i);
 		}
 
 		DebuggerPrintf(format, hash_id);
@@ -118,13 +154,22 @@ STATIC bool Game::LogThreadTest(EventArgs& args)
 
 void Game::StartUp()
 {
-	SetupMouseData();
+	g_theGame = this;
+
+	if (!g_isHeadless)
+	{
+		SetupMouseData();
+	}
+
 	SetupCameras();
 
-	GetandSetShaders();
-	LoadGameTextures();
+	if (!g_isHeadless)
+	{
+		GetandSetShaders();
+		LoadGameTextures();
 
-	LoadGameMaterials();
+		LoadGameMaterials();
+	}
 
 	g_devConsole->PrintString(Rgba::BLUE, "this is a test string");
 	g_devConsole->PrintString(Rgba::RED, "this is also a test string");
@@ -133,22 +178,47 @@ void Game::StartUp()
 
 	g_eventSystem->SubscribeEventCallBackFn("TestEvent", TestEvent);
 
-	g_eventSystem->SubscribeEventCallBackFn("ToggleLight1", ToggleLight1);
-	g_eventSystem->SubscribeEventCallBackFn("ToggleLight2", ToggleLight2);
-	g_eventSystem->SubscribeEventCallBackFn("ToggleLight3", ToggleLight3);
-	g_eventSystem->SubscribeEventCallBackFn("ToggleLight4", ToggleLight4);
+	g_eventSystem->SubscribeEventCallBackFn("ToggleLight", ToggleLight);
 	g_eventSystem->SubscribeEventCallBackFn("ToggleAllPointLights", ToggleAllPointLights);
 	g_eventSystem->SubscribeEventCallBackFn("LogThreadTest", LogThreadTest);
-
-	CreateInitialMeshes();
+	g_eventSystem->SubscribeEventCallBackFn("LogThreadBenchmark", LogThreadBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("JobSchedulerBenchmark", JobSchedulerBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("MandelbrotBenchmark", MandelbrotBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("EntityBenchmark", EntityBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("EntityChurnBenchmark", EntityChurnBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("CollisionBenchmark", CollisionBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("SpriteBatchBenchmark", SpriteBatchBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("DebugDrawBenchmark", DebugDrawBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("MeshOptimizerBenchmark", MeshOptimizerBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("ShaderCacheBenchmark", ShaderCacheBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("LightClusterBenchmark", LightClusterBenchmark);
+	g_eventSystem->SubscribeEventCallBackFn("FrameAllocatorStats", FrameAllocatorStats);
+	g_eventSystem->SubscribeEventCallBackFn("RunUnitTests", RunUnitTests);
+
+	m_entities = new EntityStore(WORLD_ENTITY_COUNT);
+	m_entitySimulation = new EntitySimulation(WORLD_ENTITY_CHUNK_SIZE);
+	SpawnWorldEntities();
+	m_textRunCache = new TextRunCache();
+	m_spriteBatch = new SpriteBatch();
+	m_debugDraw = new DebugDrawBatch();
+	m_collisionGrid = new SpatialHashGrid(Vec2(0.f, 0.f), Vec2(WORLD_WIDTH, WORLD_HEIGHT), 1.f);
+	g_lightManager = new LightManager(LIGHT_BUFFER_SLOT_COUNT);
+
+	m_mandelbrot = new MandelbrotGenerator(1024, 1024);
+	m_mandelbrot->Start(MandelbrotViewT(), true);
+	m_mandelbrotUploader = new DynamicTextureUploader("MandelbrotTexture", 1024, 1024);
+	m_textureViewMandleBrot = g_renderBackend->CreateUpdatableTexture(m_mandelbrotUploader->GetTag(), m_mandelbrot->GetWidth(), m_mandelbrot->GetHeight(), m_mandelbrot->GetPixels(), m_textureMandleBrot);
 
 	CreateInitialLight();
 
-	m_imageMandleBrot = new Image(Rgba::WHITE, 1024, 1024);
-	m_textureMandleBrot = new Texture2D(g_renderContext);
-	m_textureMandleBrot->LoadTextureFromImageDynamic(*m_imageMandleBrot);
-	m_textureViewMandleBrot = m_textureMandleBrot->CreateTextureView2D();
+	if (!g_isHeadless)
+	{
+		CreateInitialMeshes();
+
+		CreateFontAtlas();
+	}
 	
+	//The heavy tests are above 10, RunUnitTests runs them
 	UnitTestRunAllCategories(10);
 	//UnitTestRun("TestCategory", 10);
 	//UnitTestRun("AnotherTestCategory", 10);
@@ -167,44 +237,52 @@ void Game::BeginFrame()
 	
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::EndFrame()
+{
+	//The frame has been drawn, its one frame debug objects can go
+	m_debugDraw->EndFrame();
+}
+
 UNITTEST("LogFlushTest", "LoggingSystem", 30)
 {
-	g_LogSystem->Logf("PrintFilter", "I am a Logf call");
-	g_LogSystem->Logf("FlushFilter", "I am now calling flush");
-	g_LogSystem->LogFlush();
+	g_binaryLog->Logf("PrintFilter", "I am a Logf call");
+	g_binaryLog->Logf("FlushFilter", "I am now calling flush");
+	g_binaryLog->LogFlush();
 	return true;
 }
 
 UNITTEST("LogFilterTest", "LoggingSystem", 0)
 {
-	g_LogSystem->LogEnableAll();
-	g_LogSystem->Logf("testFilter", "I am a testFilter String");
-	g_LogSystem->LogFlush();
+	g_binaryLog->LogEnableAll();
+	g_binaryLog->Logf("testFilter", "I am a testFilter String");
+	g_binaryLog->LogFlush();
 	
-	g_LogSystem->LogDisableAll();
-	g_LogSystem->Logf("testFilter", "I am also a testFilter String");
-	g_LogSystem->LogFlush();
+	g_binaryLog->LogDisableAll();
+	g_binaryLog->Logf("testFilter", "I am also a testFilter String");
+	g_binaryLog->LogFlush();
 	
-	g_LogSystem->LogEnable("testFilter");
-	g_LogSystem->Logf("testFilter", "I am a testFilter who was written to log");
-	g_LogSystem->LogFlush();
-
-	g_LogSystem->LogEnable("AnotherTestFilter");
-	g_LogSystem->Logf("AnotherTestFilter", "I am a AnotherTestFilter string");
-	g_LogSystem->LogDisable("testFilter");
-	g_LogSystem->Logf("testFilter", "I am a testFilter who was written to log");
-	g_LogSystem->LogFlush();
-
+	g_binaryLog->LogEnable("testFilter");
+	g_binaryLog->Logf("testFilter", "I am a testFilter who was written to log");
+	g_binaryLog->LogFlush();
+
+	g_binaryLog->LogEnable("AnotherTestFilter");
+	g_binaryLog->Logf("AnotherTestFilter", "I am a AnotherTestFilter string");
+	g_binaryLog->LogDisable("testFilter");
+	g_binaryLog->Logf("testFilter", "I am a testFilter who was written to log");
+	g_binaryLog->LogFlush();
+
+	//This is the game's log, leave every filter on for the rest of the run
+	g_binaryLog->LogEnableAll();
 	return true;
 }
 
-
 UNITTEST("TestUnitTest", "TestCategory", 10)
 {
 	CONFIRM(CosDegrees(0.f) == 1.f);
 
-	Callstack callStackObject = CallstackGet();
-	GetCallstackToString(callStackObject);
+	CallstackTable callstacks;
+	CONFIRM(callstacks.Capture() != INVALID_CALLSTACK_ID);
 	return true;
 }
 
@@ -212,8 +290,8 @@ UNITTEST("AnotherTestUnitTest", "AnotherTestCategory", 50)
 {
 	CONFIRM(CosDegrees(10.f) != 1.f);
 
-	Callstack callStackObject = CallstackGet();
-	GetCallstackToString(callStackObject);
+	CallstackTable callstacks;
+	CONFIRM(callstacks.Capture() != INVALID_CALLSTACK_ID);
 	return true;
 }
 
@@ -228,7 +306,12 @@ void Game::SetupMouseData()
 
 void Game::SetupCameras()
 {
-	IntVec2 client = g_windowContext->GetTrueClientBounds();
+	IntVec2 client = IntVec2(HEADLESS_CLIENT_WIDTH, HEADLESS_CLIENT_HEIGHT);
+	if (!g_isHeadless)
+	{
+		client = g_windowContext->GetTrueClientBounds();
+	}
+
 	float aspect = (float)client.x / (float)client.y;
 
 	//Create the Camera and setOrthoView
@@ -246,7 +329,9 @@ void Game::SetupCameras()
 	//Set Projection Perspective for main cam
 	m_camPosition = Vec3(0.f, 0.f, -10.f);
 	m_mainCamera->SetColorTarget(nullptr);
-	m_mainCamera->SetPerspectiveProjection( m_camFOVDegrees, 0.1f, 100.0f, SCREEN_ASPECT);
+	m_mainCamera->SetPerspectiveProjection( m_camFOVDegrees, MAIN_CAMERA_NEAR_Z, MAIN_CAMERA_FAR_Z, SCREEN_ASPECT);
+	float halfFOVDegrees = m_camFOVDegrees * 0.5f;
+	m_lodPixelsPerRadius = (float)client.y * 0.5f * CosDegrees(halfFOVDegrees) / SinDegrees(halfFOVDegrees);
 
 	//Create the world bounds AABB2
 	Vec2 minWorldBounds = Vec2::ZERO;
@@ -275,62 +360,62 @@ void Game::SetStartupDebugRenderObjects()
 	//------------------------------------------------------------------------------------------------------------------------------
 
 	//Make 2D Point on screen
-	g_debugRenderer->DebugRenderPoint2D(options, Vec2(10.f, 10.f), 5.0f);
+	m_debugDraw->AddPoint2D(options, Vec2(10.f, 10.f), 5.0f);
 	//Make 2D Point at screen center
 	options.beginColor = Rgba::BLUE;
 	options.endColor = Rgba::BLACK;
-	g_debugRenderer->DebugRenderPoint2D(options, Vec2(0.f, 0.f), 10.f);
+	m_debugDraw->AddPoint2D(options, Vec2(0.f, 0.f), 10.f);
 
 	options.beginColor = Rgba::YELLOW;
 	options.endColor = Rgba::RED;
 	//Draw a line in 2D screen space
-	g_debugRenderer->DebugRenderLine2D(options, Vec2(ctv->m_width * -0.5f, ctv->m_height * -0.5f), Vec2(-150.f, -150.f), 20.f);
+	m_debugDraw->AddLine2D(options, Vec2(ctv->m_width * -0.5f, ctv->m_height * -0.5f), Vec2(-150.f, -150.f), 20.f);
 
 	//Draw a quad in 2D screen space
 	options.beginColor = Rgba::GREEN;
 	options.endColor = Rgba::RED;
-	g_debugRenderer->DebugRenderQuad2D(options, AABB2(Vec2(-150.f, -150.f), Vec2(-100.f, -100.f)), 20.f);
+	m_debugDraw->AddQuad2D(options, Vec2(-150.f, -150.f), Vec2(-100.f, -100.f), 20.f);
 
 	//Textured Quad
 	options.beginColor = Rgba::WHITE;
 	options.endColor = Rgba::RED;
-	g_debugRenderer->DebugRenderQuad2D(options, AABB2(Vec2(-200.f, -200.f), Vec2(-150.f, -150.f)), 20.f, m_textureTest);
+	m_debugDraw->AddQuad2D(options, Vec2(-200.f, -200.f), Vec2(-150.f, -150.f), 20.f, m_textureTest->GetView());
 
 	//Disc2D
 	options.beginColor = Rgba::DARK_GREY;
 	options.endColor = Rgba::ORANGE;
-	g_debugRenderer->DebugRenderDisc2D(options, Disc2D(Vec2(100.f, 100.f), 25.f), 10.f);
+	m_debugDraw->AddDisc2D(options, Vec2(100.f, 100.f), 25.f, 10.f);
 
 	//Ring2D
 	options.beginColor = Rgba::ORANGE;
 	options.endColor = Rgba::DARK_GREY;
-	g_debugRenderer->DebugRenderRing2D(options, Disc2D(Vec2(100.f, 100.f), 25.f), 10.f, 5.f);
+	m_debugDraw->AddRing2D(options, Vec2(100.f, 100.f), 25.f, 10.f);
 
 	//Ring2D
 	options.beginColor = Rgba::WHITE;
 	options.endColor = Rgba::WHITE;
-	g_debugRenderer->DebugRenderRing2D(options, Disc2D(Vec2(150.f, 100.f), 2000.f), 10.f, 1.f);
+	m_debugDraw->AddRing2D(options, Vec2(150.f, 100.f), 2000.f, 10.f);
 
 	//Wired Quad
 	options.beginColor = Rgba::WHITE;
 	options.endColor = Rgba::WHITE;
-	g_debugRenderer->DebugRenderWireQuad2D(options, AABB2(Vec2(100.f, -100.f), Vec2(150.f, -50.f)), 20.f);
+	m_debugDraw->AddWireQuad2D(options, Vec2(100.f, -100.f), Vec2(150.f, -50.f), 20.f);
 
 	//Text
 	options.beginColor = Rgba::WHITE;
 	options.endColor = Rgba::RED;
 	const char* text2D = "Read me bruh";
-	g_debugRenderer->DebugRenderText2D(options, Vec2(-100.f, 200.f), Vec2(100.f, 200.f), text2D, DEFAULT_TEXT_HEIGHT, 20.f);
+	m_debugDraw->AddText2D(options, Vec2(-100.f, 200.f), Vec2(0.f, 0.f), text2D, DEFAULT_TEXT_HEIGHT, 20.f);
 
 	//Arrow 2D
 	options.beginColor = Rgba::GREEN;
 	options.endColor = Rgba::GREEN;
-	g_debugRenderer->DebugRenderArrow2D(options, Vec2(0.f, 0.f), Vec2(200.f, 200.f), 20.f, 5.f);
+	m_debugDraw->AddArrow2D(options, Vec2(0.f, 0.f), Vec2(200.f, 200.f), 20.f, 5.f);
 
 	//Arrow 2D
 	options.beginColor = Rgba::BLUE;
 	options.endColor = Rgba::BLUE;
-	g_debugRenderer->DebugRenderArrow2D(options, Vec2(0.f, 0.f), Vec2(200.f, -200.f), 20.f, 5.f);
+	m_debugDraw->AddArrow2D(options, Vec2(0.f, 0.f), Vec2(200.f, -200.f), 20.f, 5.f);
 
 	//------------------------------------------------------------------------------------------------------------------------------
 	// 3D Objects
@@ -343,93 +428,81 @@ void Game::SetStartupDebugRenderObjects()
 
 	options3D.mode = DEBUG_RENDER_XRAY;
 	//make a 3D point
-	g_debugRenderer->DebugRenderPoint(options3D, Vec3(0.0f, 0.0f, 0.0f), 10000.0f );
+	m_debugDraw->AddPoint(options3D, Vec3(0.0f, 0.0f, 0.0f), 10000.0f);
 
 	options3D.mode = DEBUG_RENDER_USE_DEPTH;
 	//Make a 3D textured point
 	options3D.beginColor = Rgba::BLUE;
 	options3D.endColor = Rgba::RED;
-	g_debugRenderer->DebugRenderPoint(options3D, Vec3(-10.0f, 0.0f, 0.0f), 20.f, 1.f, m_textureTest);
+	m_debugDraw->AddPoint(options3D, Vec3(-10.0f, 0.0f, 0.0f), 20.f, 1.f, m_textureTest->GetView());
 
 	options3D.mode = DEBUG_RENDER_XRAY;
 	//Make a line in 3D
 	options3D.beginColor = Rgba::BLUE;
 	options3D.endColor = Rgba::BLACK;
-	g_debugRenderer->DebugRenderLine(options3D, Vec3(0.f, 0.f, 5.f), Vec3(10.f, 0.f, 10.f), 2000.f);
+	m_debugDraw->AddLine(options3D, Vec3(0.f, 0.f, 5.f), Vec3(10.f, 0.f, 10.f), 2000.f);
 
 	options3D.mode = DEBUG_RENDER_USE_DEPTH;
 	//Make a line in 3D
 	options3D.beginColor = Rgba::BLUE;
 	options3D.endColor = Rgba::BLACK;
-	g_debugRenderer->DebugRenderLine(options3D, Vec3(0.f, 0.f, 5.f), Vec3(10.f, 0.f, 10.f), 2000.f);
+	m_debugDraw->AddLine(options3D, Vec3(0.f, 0.f, 5.f), Vec3(10.f, 0.f, 10.f), 2000.f);
 
 	//Make a sphere
 	options3D.beginColor = Rgba::RED;
 	options3D.endColor = Rgba::BLACK;
-	g_debugRenderer->DebugRenderSphere(options3D, Vec3(0.f, 3.f, 0.f), 1.f, 10.f, nullptr);
+	m_debugDraw->AddSphere(options3D, Vec3(0.f, 3.f, 0.f), 1.f, 10.f);
 	
 	//Make a sphere
 	options3D.beginColor = Rgba::GREEN;
 	options3D.endColor = Rgba::WHITE;
-	g_debugRenderer->DebugRenderSphere(options3D, Vec3(0.f, -3.f, 0.f), 1.f, 200.f, m_sphereTexture);
+	m_debugDraw->AddSphere(options3D, Vec3(0.f, -3.f, 0.f), 1.f, 200.f, m_sphereTexture->GetView());
 	
 	//Make a wire sphere
 	options3D.beginColor = Rgba::WHITE;
 	options3D.endColor = Rgba::WHITE;
-	g_debugRenderer->DebugRenderWireSphere(options3D, Vec3(0.f, -2.f, 0.f), 1.f, 200.f);
+	m_debugDraw->AddWireSphere(options3D, Vec3(0.f, -2.f, 0.f), 1.f, 200.f);
 	
 	//Make a cube
 	options3D.beginColor = Rgba::DARK_GREY;
 	options3D.endColor = Rgba::WHITE;
-	AABB3 cube = AABB3::UNIT_CUBE;
-	g_debugRenderer->DebugRenderBox(options3D, cube, Vec3(-5.f, -1.5f, 0.f), 20.f);
+	Vec3 cubeHalfExtents = Vec3(0.5f, 0.5f, 0.5f);
+	m_debugDraw->AddBox(options3D, Vec3(-5.f, -1.5f, 0.f), cubeHalfExtents, 20.f);
 
 	//Make a wire cube
 	options3D.beginColor = Rgba::DARK_GREY;
 	options3D.endColor = Rgba::WHITE;
-	g_debugRenderer->DebugRenderWireBox(options3D, cube, Vec3(-5.f, 1.5f, 0.f), 20.f);
+	m_debugDraw->AddWireBox(options3D, Vec3(-5.f, 1.5f, 0.f), cubeHalfExtents, 20.f);
 
 	//Make a quad 3D no billboard
 	options3D.beginColor = Rgba::WHITE;
 	options3D.endColor = Rgba::RED;
-	AABB2 quad = AABB2(Vec3(-1.f, -1.f, 0.f), Vec3(1.f, 1.f, 0.f));
 	Vec3 position = Vec3(3.f, 2.f, 1.f);
-	g_debugRenderer->DebugRenderQuad(options3D, quad, position, 2000.f, m_textureTest, false);
+	m_debugDraw->AddQuad(options3D, position, Vec2(-1.f, -1.f), Vec2(1.f, 1.f), 2000.f, m_textureTest->GetView(), false);
 
 	//Make a quad 3D 
 	options3D.beginColor = Rgba::WHITE;
 	options3D.endColor = Rgba::RED;
-	quad = AABB2(Vec3(-1.f, -1.f, 0.f), Vec3(1.f, 1.f, 0.f));
 	position = Vec3(5.f, 2.f, 1.f);
-	g_debugRenderer->DebugRenderQuad(options3D, quad, position, 2000.f, m_textureTest);
+	m_debugDraw->AddQuad(options3D, position, Vec2(-1.f, -1.f), Vec2(1.f, 1.f), 2000.f, m_textureTest->GetView());
 
 	//Make text
 	options3D.beginColor = Rgba::WHITE;
 	options3D.endColor = Rgba::RED;
 	const char* text = "This is some text";
-	g_debugRenderer->DebugRenderText3D(options3D, Vec3(1.f, 1.f, 1.f), Vec2(1.f, 1.f), text, 0.1f, 20000.f);
+	m_debugDraw->AddText(options3D, Vec3(1.f, 1.f, 1.f), Vec2(1.f, 1.f), text, 0.1f, 20000.f);
 
 	//Make text non billboarded
 	options3D.beginColor = Rgba::BLUE;
 	options3D.endColor = Rgba::RED;
 	const char* textNB = "Billboard this";
-	g_debugRenderer->DebugRenderText3D(options3D, Vec3(1.f, 0.5f, 0.f), Vec2(-1.f, 1.f), textNB, 0.2f, 20000.f, false);
+	m_debugDraw->AddText(options3D, Vec3(1.f, 0.5f, 0.f), Vec2(0.f, 1.f), textNB, 0.2f, 20000.f, false);
 
 	//------------------------------------------------------------------------------------------------------------------------------
 	//	LOG Objects
 	//------------------------------------------------------------------------------------------------------------------------------
-	//Setup Debug Options
-	options.mode = DEBUG_RENDER_ALWAYS;
-	options.beginColor = Rgba::WHITE;
-	options.endColor = Rgba::YELLOW;
-	const char* debugText1 = "Debug Log Test";
-	g_debugRenderer->DebugAddToLog(options, debugText1, Rgba::YELLOW, 10.f);
-
-	//Setup Debug Options
-	options.beginColor = Rgba::WHITE;
-	options.endColor = Rgba::GREEN;
-	const char* debugText2 = "This is another Debug String";
-	g_debugRenderer->DebugAddToLog(options, debugText2, Rgba::GREEN, 20.f);
+	m_debugDraw->AddLogLine(Rgba::YELLOW, 10.f, "Debug Log Test");
+	m_debugDraw->AddLogLine(Rgba::GREEN, 20.f, "This is another Debug String");
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -445,82 +518,43 @@ STATIC bool Game::TestEvent(EventArgs& args)
 	return true;
 }
 
-STATIC bool Game::ToggleLight1( EventArgs& args )
-{
-	UNUSED(args);
-	if(g_renderContext->m_cpuLightBuffer.lights[1].color.a != 0.f)
-	{
-		g_devConsole->PrintString(Rgba::RED, "Disabling Light 1");
-		g_renderContext->m_cpuLightBuffer.lights[1].color.a = 0.f;
-	}
-	else
-	{
-		g_devConsole->PrintString(Rgba::GREEN, "Enabling Light 1");
-		g_renderContext->m_cpuLightBuffer.lights[1].color.a = 1.f;
-	}
-	return true;
-}
-
-STATIC bool Game::ToggleLight2( EventArgs& args )
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool Game::ToggleLight( EventArgs& args )
 {
-	UNUSED(args);
-	if(g_renderContext->m_cpuLightBuffer.lights[2].color.a != 0.f)
+	//Point lights are numbered from 1 like they always were on the console
+	uint lightIndex = (uint)args.GetValue("index", 1);
+	const uint pointLightCount = (uint)(sizeof(g_theGame->m_pointLights) / sizeof(g_theGame->m_pointLights[0]));
+	LightHandle handle;
+	if (lightIndex >= 1U && lightIndex <= pointLightCount)
 	{
-		g_devConsole->PrintString(Rgba::RED, "Disabling Light 2");
-		g_renderContext->m_cpuLightBuffer.lights[2].color.a = 0.f;
+		handle = g_theGame->m_pointLights[lightIndex - 1U];
 	}
-	else
+	const LightDescT* light = g_lightManager->GetLight(handle);
+	char message[64];
+	if (light == nullptr)
 	{
-		g_devConsole->PrintString(Rgba::GREEN, "Enabling Light 2");
-		g_renderContext->m_cpuLightBuffer.lights[2].color.a = 1.f;
+		snprintf(message, sizeof(message), "No point light %u", lightIndex);
+		g_devConsole->PrintString(Rgba::RED, message);
+		return false;
 	}
-	return true;
-}
 
-STATIC bool Game::ToggleLight3( EventArgs& args )
-{
-	UNUSED(args);
-	if(g_renderContext->m_cpuLightBuffer.lights[3].color.a != 0.f)
-	{
-		g_devConsole->PrintString(Rgba::RED, "Disabling Light 3");
-		g_renderContext->m_cpuLightBuffer.lights[3].color.a = 0.f;
-	}
-	else
-	{
-		g_devConsole->PrintString(Rgba::GREEN, "Enabling Light 3");
-		g_renderContext->m_cpuLightBuffer.lights[3].color.a = 1.f;
-	}
-	return true;
-}
-
-STATIC bool Game::ToggleLight4( EventArgs& args )
-{
-	UNUSED(args);
-	if(g_renderContext->m_cpuLightBuffer.lights[4].color.a != 0.f)
-	{
-		g_devConsole->PrintString(Rgba::RED, "Disabling Light 4");
-		g_renderContext->m_cpuLightBuffer.lights[4].color.a = 0.f;
-	}
-	else
-	{
-		g_devConsole->PrintString(Rgba::GREEN, "Enabling Light 4");
-		g_renderContext->m_cpuLightBuffer.lights[4].color.a = 1.f;
-	}
+	bool isEnabled = !light->isEnabled;
+	g_lightManager->SetEnabled(handle, isEnabled);
+	snprintf(message, sizeof(message), "%s Light %u", isEnabled ? "Enabling" : "Disabling", lightIndex);
+	g_devConsole->PrintString(isEnabled ? Rgba::GREEN : Rgba::RED, message);
 	return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
 STATIC bool Game::ToggleAllPointLights( EventArgs& args )
 {
 	UNUSED(args);
-	for(int i = 1; i < 5; i++)
+	for (const LightHandle& handle : g_theGame->m_pointLights)
 	{
-		if(g_renderContext->m_cpuLightBuffer.lights[i].color.a != 0.f)
+		const LightDescT* light = g_lightManager->GetLight(handle);
+		if (light != nullptr)
 		{
-			g_renderContext->m_cpuLightBuffer.lights[i].color.a = 0.f;
-		}
-		else
-		{
-			g_renderContext->m_cpuLightBuffer.lights[i].color.a = 1.f;
+			g_lightManager->SetEnabled(handle, !light->isEnabled);
 		}
 	}
 	g_devConsole->PrintString(Rgba::GREEN, "Toggled All Point Lights");
@@ -673,8 +707,11 @@ void Game::Shutdown()
 	delete m_cube;
 	m_cube = nullptr;
 
-	delete m_sphere;
-	m_sphere = nullptr;
+	for (GPUMesh* lod : m_sphereLods)
+	{
+		delete lod;
+	}
+	m_sphereLods.clear();
 
 	delete m_quad;
 	m_quad = nullptr;
@@ -682,8 +719,63 @@ void Game::Shutdown()
 	delete m_baseQuad;
 	m_baseQuad = nullptr;
 
-	delete m_capsule;
-	m_capsule = nullptr;
+	for (GPUMesh* lod : m_capsuleLods)
+	{
+		delete lod;
+	}
+	m_capsuleLods.clear();
+
+	delete m_meshCache;
+	m_meshCache = nullptr;
+
+	delete m_collisionGrid;
+	m_collisionGrid = nullptr;
+
+	delete g_lightManager;
+	g_lightManager = nullptr;
+
+	delete m_entitySimulation;
+	m_entitySimulation = nullptr;
+
+	delete m_textRunCache;
+	m_textRunCache = nullptr;
+
+	delete m_spriteBatch;
+	m_spriteBatch = nullptr;
+
+	delete m_debugDraw;
+	m_debugDraw = nullptr;
+
+	delete m_textureStreamer;
+	m_textureStreamer = nullptr;
+
+	delete m_fontAtlasView;
+	m_fontAtlasView = nullptr;
+
+	delete m_fontAtlasTexture;
+	m_fontAtlasTexture = nullptr;
+
+	delete m_fontAtlas;
+	m_fontAtlas = nullptr;
+
+	delete m_entities;
+	m_entities = nullptr;
+
+	if (m_mandelbrotUploader != nullptr)
+	{
+		//Drop whatever is staged, the staging jobs still copy out of the generator into the uploader
+		m_mandelbrotUploader->Submit(*g_jobScheduler, nullptr);
+		delete m_mandelbrotUploader;
+		m_mandelbrotUploader = nullptr;
+	}
+
+	if (m_mandelbrot != nullptr)
+	{
+		//Tile jobs write into the generator
+		m_mandelbrot->WaitForPass(*g_jobScheduler);
+		delete m_mandelbrot;
+		m_mandelbrot = nullptr;
+	}
 
 	delete m_textureViewMandleBrot;
 	m_textureViewMandleBrot = nullptr;
@@ -691,6 +783,8 @@ void Game::Shutdown()
 	delete m_textureMandleBrot;
 	m_textureMandleBrot = nullptr;
 
+	g_theGame = nullptr;
+
 	//FreeResources();
 }
 
@@ -724,33 +818,33 @@ void Game::HandleCharacter( unsigned char charCode )
 	}
 }
 
-void Game::EnablePointLight( uint slot, const Vec3& position, const Vec3& direction, const Rgba& color /*= Rgba::WHITE*/, float intensity /*= 1.f*/, const Vec3& diffuseAttenuation, const Vec3& specularAttenuation ) const
+LightHandle Game::EnablePointLight( const Vec3& position, const Vec3& direction, const Rgba& color /*= Rgba::WHITE*/, float intensity /*= 1.f*/, const Vec3& diffuseAttenuation, const Vec3& specularAttenuation ) const
 {
-	LightT pointLight;
+	LightDescT pointLight;
 
 	pointLight.position = position;
 	pointLight.color = color;
-	pointLight.color.a = intensity;
+	pointLight.intensity = intensity;
 	pointLight.direction = direction;
 	pointLight.diffuseAttenuation = diffuseAttenuation;
 	pointLight.specularAttenuation = specularAttenuation;
 
-	g_renderContext->EnableLight(slot, pointLight);
+	return g_lightManager->CreateLight(pointLight);
 }
 
-void Game::EnableDirectionalLight( const Vec3& position, const Vec3& direction,  const Rgba& color /*= Rgba::WHITE*/, float intensity /*= 1.f*/, const Vec3& diffuseAttenuation, const Vec3& specularAttenuation) const
+LightHandle Game::EnableDirectionalLight( const Vec3& position, const Vec3& direction,  const Rgba& color /*= Rgba::WHITE*/, float intensity /*= 1.f*/, const Vec3& diffuseAttenuation, const Vec3& specularAttenuation) const
 {
-	LightT directionalLight;
+	LightDescT directionalLight;
 
 	directionalLight.position = position;
 	directionalLight.color = color;
-	directionalLight.color.a = intensity;
+	directionalLight.intensity = intensity;
 	directionalLight.direction = direction;
-	directionalLight.isDirection = 1.f;
+	directionalLight.isDirectional = true;
 	directionalLight.diffuseAttenuation = diffuseAttenuation;
 	directionalLight.specularAttenuation = specularAttenuation;
 
-	g_renderContext->EnableLight(0U, directionalLight);
+	return g_lightManager->CreateLight(directionalLight);
 }
 
 void Game::Render() const
@@ -758,7 +852,7 @@ void Game::Render() const
 	gProfiler->ProfilerPush("Game::Render");
 
 	//Get the ColorTargetView from rendercontext
-	ColorTargetView *colorTargetView = g_renderContext->GetFrameColorTarget();
+	ColorTargetView *colorTargetView = g_renderBackend->GetFrameColorTarget();
 
 	//Setup what we are rendering to
 	m_mainCamera->SetColorTarget(colorTargetView);
@@ -770,10 +864,10 @@ void Game::Render() const
 // 	camTransform = Matrix44::SetTranslation3D(m_camPosition, camTransform);
 // 	m_mainCamera->SetModelMatrix(camTransform);
 // 
-	g_renderContext->BeginCamera(*m_mainCamera); 
-	g_renderContext->BindTextureViewWithSampler(0U, nullptr);
+	g_renderBackend->BeginCamera(*m_mainCamera); 
+	g_renderBackend->BindTextureViewWithSampler(0U, nullptr);
 	
-	g_renderContext->ClearColorTargets(Rgba(ui_testColor[0], ui_testColor[1], ui_testColor[2], 1.f));
+	g_renderBackend->ClearColorTargets(Rgba(ui_testColor[0], ui_testColor[1], ui_testColor[2], 1.f));
 // 
 // 	float intensity = Clamp(m_ambientIntensity, 0.f, 1.f);
 // 	g_renderContext->SetAmbientLight( Rgba::WHITE, intensity ); 
@@ -808,9 +902,9 @@ void Game::Render() const
 //  	g_renderContext->SetModelMatrix(m_quadTransfrom);
 //  	g_renderContext->DrawMesh(m_quad);
 
-	//RenderIsoSprite();
+	RenderIsoSprite();
 
-	g_renderContext->EndCamera();
+	g_renderBackend->EndCamera();
 
 	/*
 	//Render the Quad
@@ -819,28 +913,27 @@ void Game::Render() const
 	g_renderContext->DrawMesh( m_baseQuad );	
 	*/
 
-	g_renderContext->BindShader(m_shader);
+	g_renderBackend->BindShader(m_shader);
 
 	if(!m_consoleDebugOnce)
 	{
-		EventArgs* args = new EventArgs();
+		EventArgs args;
 		std::string key = "TestString";
 		std::string value = "This is a test";
-		args->SetValue(key, value);
-		g_devConsole->Command_Test(*args);
+		args.SetValue(key, value);
+		g_devConsole->Command_Test(args);
 		g_devConsole->ExecuteCommandLine("Exec Health=25");
 		g_devConsole->ExecuteCommandLine("Exec Health=85 Armor=100");
 	}
 
-	//Uncomment to get Debug Rendering to work
-	//DebugRenderToCamera();
+	DebugRenderToCamera();
 
 	RenderUI();
 
 	if(g_devConsole->IsOpen())
 	{	
-		g_renderContext->BindShader(m_shader);
-		g_devConsole->Render(*g_renderContext, *m_devConsoleCamera, DEVCONSOLE_LINE_HEIGHT);
+		g_renderBackend->BindShader(m_shader);
+		g_renderBackend->RenderDevConsole(*m_devConsoleCamera, DEVCONSOLE_LINE_HEIGHT);
 	}	
 
 	gProfiler->ProfilerPop();
@@ -849,26 +942,26 @@ void Game::Render() const
 
 void Game::RenderUsingMaterial() const
 {
-	g_renderContext->BindMaterial(m_testMaterial);
+	g_renderBackend->BindMaterial(m_testMaterial);
 
 	//Render the cube
-	g_renderContext->BindTextureViewWithSampler(0U, m_boxTexturePath);  
-	g_renderContext->SetModelMatrix(m_cubeTransform);
-	g_renderContext->DrawMesh( m_cube ); 
+	g_renderBackend->BindTextureViewWithSampler(0U, m_boxTexture->GetView());  
+	g_renderBackend->SetModelMatrix(m_cubeTransform);
+	g_renderBackend->DrawMesh("Meshes", m_cube); 
 
 	//Render the sphere
-	g_renderContext->BindTextureViewWithSampler(0U, m_sphereTexturePath); 
-	g_renderContext->SetModelMatrix( m_sphereTransform ); 
-	g_renderContext->DrawMesh( m_sphere ); 
+	g_renderBackend->BindTextureViewWithSampler(0U, m_sphereTexture->GetView()); 
+	g_renderBackend->SetModelMatrix( m_sphereTransform ); 
+	g_renderBackend->DrawMesh("Meshes", GetMeshLodForCamera(m_sphereLods, SPHERE_WORLD_CENTER, SPHERE_BOUNDING_RADIUS)); 
 
 	//Render the Quad
-	g_renderContext->BindTextureViewWithSampler(0U, nullptr);
-	g_renderContext->SetModelMatrix(Matrix44::IDENTITY);
-	g_renderContext->DrawMesh( m_quad );
+	g_renderBackend->BindTextureViewWithSampler(0U, nullptr);
+	g_renderBackend->SetModelMatrix(Matrix44::IDENTITY);
+	g_renderBackend->DrawMesh("Meshes", m_quad);
 
 	//Render the capsule here
-	g_renderContext->SetModelMatrix(m_capsuleModel);
-	g_renderContext->DrawMesh(m_capsule);
+	g_renderBackend->SetModelMatrix(m_capsuleModel);
+	g_renderBackend->DrawMesh("Meshes", GetMeshLodForCamera(m_capsuleLods, m_capsuleModel.GetTBasis(), CAPSULE_BOUNDING_RADIUS));
 }
 
 void Game::RenderUsingLegacy() const
@@ -877,22 +970,22 @@ void Game::RenderUsingLegacy() const
 	//g_renderContext->BindShader( m_shader );
 	if(m_normalMode)
 	{
-		g_renderContext->BindShader( m_normalShader );
+		g_renderBackend->BindShader( m_normalShader );
 	}
 	else
 	{
-		g_renderContext->BindShader( m_defaultLit );
+		g_renderBackend->BindShader( m_defaultLit );
 	}
 
 	//Render the cube
-	g_renderContext->BindTextureViewWithSampler(0U, m_boxTexturePath);  
-	g_renderContext->SetModelMatrix(m_cubeTransform);
-	g_renderContext->DrawMesh( m_cube ); 
+	g_renderBackend->BindTextureViewWithSampler(0U, m_boxTexture->GetView());  
+	g_renderBackend->SetModelMatrix(m_cubeTransform);
+	g_renderBackend->DrawMesh("Meshes", m_cube); 
 
 	//Render the sphere
-	g_renderContext->BindTextureViewWithSampler(0U, m_sphereTexturePath); 
-	g_renderContext->SetModelMatrix( m_sphereTransform ); 
-	g_renderContext->DrawMesh( m_sphere ); 
+	g_renderBackend->BindTextureViewWithSampler(0U, m_sphereTexture->GetView()); 
+	g_renderBackend->SetModelMatrix( m_sphereTransform ); 
+	g_renderBackend->DrawMesh("Meshes", GetMeshLodForCamera(m_sphereLods, SPHERE_WORLD_CENTER, SPHERE_BOUNDING_RADIUS)); 
 
 	//Render the Quad
 	//g_renderContext->BindTextureViewWithSampler(0U, nullptr);
@@ -900,36 +993,52 @@ void Game::RenderUsingLegacy() const
 	//g_renderContext->DrawMesh( m_quad );
 
 	//Render the capsule here
-	g_renderContext->SetModelMatrix(m_capsuleModel);
-	g_renderContext->DrawMesh(m_capsule);
+	g_renderBackend->SetModelMatrix(m_capsuleModel);
+	g_renderBackend->DrawMesh("Meshes", GetMeshLodForCamera(m_capsuleLods, m_capsuleModel.GetTBasis(), CAPSULE_BOUNDING_RADIUS));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Picks the level whose triangle density suits the mesh's size on screen under the main camera
+//------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* Game::GetMeshLodForCamera( const std::vector<GPUMesh*>& lods, const Vec3& worldCenter, float boundingRadius ) const
+{
+	float distance = (worldCenter - m_camPosition).GetLength();
+	float projectedRadiusPixels = (distance > boundingRadius) ? boundingRadius * m_lodPixelsPerRadius / distance : MESH_LOD0_RADIUS_PIXELS;
+	return lods[SelectMeshLod(projectedRadiusPixels, (uint)lods.size())];
 }
 
 void Game::DebugRenderToScreen() const
 {
 	Camera& debugCamera = g_debugRenderer->Get2DCamera();
-	debugCamera.m_colorTargetView = g_renderContext->GetFrameColorTarget();
+	debugCamera.m_colorTargetView = g_renderBackend->GetFrameColorTarget();
 	
-	g_renderContext->BindShader(m_shader);
-	g_renderContext->BeginCamera(debugCamera);
+	g_renderBackend->BindShader(m_shader);
+	g_renderBackend->BeginCamera(debugCamera);
 	
 	g_debugRenderer->DebugRenderToScreen();
+	DrawDebugBatch(DEBUG_DRAW_SCREEN);
 
-	g_renderContext->EndCamera();
+	g_renderBackend->EndCamera();
 	
 }
 
 void Game::DebugRenderToCamera() const
 {
 	Camera& debugCamera3D = *m_mainCamera;
-	debugCamera3D.m_colorTargetView = g_renderContext->GetFrameColorTarget();
+	debugCamera3D.m_colorTargetView = g_renderBackend->GetFrameColorTarget();
 
-	g_renderContext->BindShader(m_shader);
-	g_renderContext->BeginCamera(debugCamera3D);
+	g_renderBackend->BindShader(m_shader);
+	g_renderBackend->BeginCamera(debugCamera3D);
 	
-	g_debugRenderer->Setup3DCamera(&debugCamera3D);
-	g_debugRenderer->DebugRenderToCamera();
+	//Headless has no engine debug renderer, the batch's world draws are still recorded
+	if (g_debugRenderer != nullptr)
+	{
+		g_debugRenderer->Setup3DCamera(&debugCamera3D);
+		g_debugRenderer->DebugRenderToCamera();
+	}
+	DrawDebugBatch(DEBUG_DRAW_WORLD);
 
-	g_renderContext->EndCamera();
+	g_renderBackend->EndCamera();
 }
 
 void Game::PostRender()
@@ -937,13 +1046,20 @@ void Game::PostRender()
 	//Debug bools
 	m_consoleDebugOnce = true;
 
+	if (g_isHeadless)
+	{
+		return;
+	}
+
 	if(!m_isDebugSetup)
 	{
 		//SetStartupDebugRenderObjects();
 
-		ColorTargetView* ctv = g_renderContext->GetFrameColorTarget();
+		ColorTargetView* ctv = g_renderBackend->GetFrameColorTarget();
 		//Setup debug render client data
 		g_debugRenderer->SetClientDimensions( ctv->m_height, ctv->m_width );
+		//The 2D debug camera is centered on the screen
+		m_debugDraw->SetLogLayout(m_squirrelFixedFont, Vec2(ctv->m_width * -0.5f + 10.f, ctv->m_height * 0.5f - 10.f), 16.f);
 
 		m_isDebugSetup = true;
 
@@ -951,7 +1067,7 @@ void Game::PostRender()
 	}
 
 	//All screen Debug information
-	//DebugRenderToScreen();
+	DebugRenderToScreen();
 
 	g_ImGUI->Render();
 }
@@ -960,12 +1076,23 @@ void Game::Update( float deltaTime )
 {
 	gProfiler->ProfilerPush("Game::Update");
 
-	//GenerateMandleBrotImage();
+	GenerateMandleBrotImage();
+	m_textRunCache->EndFrame();
+	m_debugDraw->BeginFrame(deltaTime);
+
+	if (!g_isHeadless)
+	{
+		m_textureStreamer->Update();
+	}
 
 	UpdateLightPositions();
+	SubmitLights();
 
-	//Figure out update state for only move on alt + move
-	UpdateMouseInputs(deltaTime);
+	if (!g_isHeadless)
+	{
+		//Figure out update state for only move on alt + move
+		UpdateMouseInputs(deltaTime);
+	}
 
 // 	if(g_devConsole->GetFrameCount() > 1 && !m_devConsoleSetup)
 // 	{
@@ -977,27 +1104,29 @@ void Game::Update( float deltaTime )
 // 	}
 
 	//UpdateCamera(deltaTime);
-	g_renderContext->m_frameCount++;
+	if (!g_isHeadless)
+	{
+		g_renderContext->m_frameCount++;
+	}
 
 	CheckXboxInputs();
 	m_animTime += deltaTime;
 
-	DebugRenderOptionsT options;
 	float currentTime = static_cast<float>(GetCurrentTimeSeconds());
-	const char* text = "Current Time %f";
-	
-	g_debugRenderer->DebugAddToLog(options, text, Rgba::YELLOW, 0.f, currentTime);
 
-	text = "F5 to Toggle Material/Legacy mode";
-	g_debugRenderer->DebugAddToLog(options, text, Rgba::WHITE, 0.f);
-	
-	text = "UP/DOWN to increase/decrease emissive factor";
-	g_debugRenderer->DebugAddToLog(options, text, Rgba::WHITE, 0.f);
+	//One frame lines, their text goes in the debug draw's frame arena
+	m_debugDraw->AddLogLine(Rgba::YELLOW, 0.f, "Current Time %f", currentTime);
+	m_debugDraw->AddLogLine(Rgba::WHITE, 0.f, "F5 to Toggle Material/Legacy mode");
+	m_debugDraw->AddLogLine(Rgba::WHITE, 0.f, "UP/DOWN to increase/decrease emissive factor");
+	m_debugDraw->AddLogLine(Rgba::WHITE, 0.f, "Frame memory %.1f KB, high water %.1f KB", (double)g_frameAllocator->GetLastFrameBytes() / 1024.0,
+		(double)g_frameAllocator->GetHighWaterBytes() / 1024.0);
 
 	//Update the camera's transform
 	Matrix44 camTransform = Matrix44::MakeFromEuler( m_mainCamera->GetEuler(), m_rotationOrder ); 
 	camTransform = Matrix44::SetTranslation3D(m_camPosition, camTransform);
 	m_mainCamera->SetModelMatrix(camTransform);
+
+	m_debugDraw->Finish(m_mainCamera->m_cameraModel.GetIBasis(), m_mainCamera->m_cameraModel.GetJBasis(), g_jobScheduler);
 	
 	//float currentTime = static_cast<float>(GetCurrentTimeSeconds());
 
@@ -1007,7 +1136,7 @@ void Game::Update( float deltaTime )
 	m_cubeTransform = Matrix44::SetTranslation3D( Vec3(-5.0f, 0.0f, 0.0f), m_cubeTransform);
 
 	m_sphereTransform = Matrix44::MakeFromEuler( Vec3(0.0f, -45.0f * currentTime, 0.0f) ); 
-	m_sphereTransform = Matrix44::SetTranslation3D( Vec3(5.0f, 0.0f, 0.0f), m_sphereTransform);
+	m_sphereTransform = Matrix44::SetTranslation3D( SPHERE_WORLD_CENTER, m_sphereTransform);
 
 	m_quadTransfrom = Matrix44::SetTranslation3D(Vec3(0.f, 2.f, 0.f), m_quadTransfrom);
 
@@ -1015,11 +1144,17 @@ void Game::Update( float deltaTime )
 
 	m_testDirection = m_testDirection.GetRotatedAboutYDegrees(currentTime * ui_testSlider);
 
+	m_entitySimulation->Update(*m_entities, deltaTime, g_jobScheduler, DespawnOffScreenEntities);
+
+	//The simulation already removed this frame's garbage
 	CheckCollisions();
 
-	ClearGarbageEntities();	
+	SpawnWorldEntities();
 
-	UpdateImGUI();
+	if (!g_isHeadless)
+	{
+		UpdateImGUI();
+	}
 
 	gProfiler->ProfilerPop();
 }
@@ -1079,6 +1214,19 @@ void Game::UpdateCamera(float deltaTime)
 
 void Game::ClearGarbageEntities()
 {
+	m_entities->RemoveGarbage();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tops the world back up to WORLD_ENTITY_COUNT. The seed carries over, so every run spawns the same entities in the same order
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::SpawnWorldEntities()
+{
+	uint entityCount = m_entities->GetCount();
+	if (entityCount < WORLD_ENTITY_COUNT)
+	{
+		SpawnSeededEntities(*m_entities, WORLD_ENTITY_COUNT - entityCount, m_entitySpawnSeed);
+	}
 }
 
 void Game::CheckXboxInputs()
@@ -1087,7 +1235,41 @@ void Game::CheckXboxInputs()
 }
 
 void Game::CheckCollisions()
-{		
+{
+	PROFILE_FUNCTION();
+
+	const float* positionsX = m_entities->GetPositionsX();
+	const float* positionsY = m_entities->GetPositionsY();
+	const float* radii = m_entities->GetPhysicsRadii();
+
+	m_collisionGrid->Rebuild(positionsX, positionsY, radii, m_entities->GetCount());
+
+	m_collisionPairs.clear();
+	m_collisionGrid->FindCandidatePairs(m_collisionPairs, g_jobScheduler);
+	SpatialHashGrid::FilterOverlappingPairs(positionsX, positionsY, radii, m_collisionPairs);
+
+	//Equal mass elastic bounce along the contact normal, only for pairs still moving into each other
+	for (const CollisionPairT& pair : m_collisionPairs)
+	{
+		Vec2 normal = m_entities->GetPosition(pair.entityB) - m_entities->GetPosition(pair.entityA);
+		float distanceSquared = normal.x * normal.x + normal.y * normal.y;
+		if (distanceSquared <= 0.f)
+		{
+			continue;
+		}
+
+		Vec2 velocityA = m_entities->GetVelocity(pair.entityA);
+		Vec2 velocityB = m_entities->GetVelocity(pair.entityB);
+		float approachSpeed = ((velocityA.x - velocityB.x) * normal.x + (velocityA.y - velocityB.y) * normal.y) / distanceSquared;
+		if (approachSpeed <= 0.f)
+		{
+			continue;
+		}
+
+		Vec2 impulse = normal * approachSpeed;
+		m_entities->SetVelocity(pair.entityA, velocityA - impulse);
+		m_entities->SetVelocity(pair.entityB, velocityB + impulse);
+	}
 }
 
 bool Game::IsAlive()
@@ -1099,32 +1281,56 @@ bool Game::IsAlive()
 //------------------------------------------------------------------------------------------------------------------------------
 bool Game::GenerateMandleBrotImage()
 {
-	if (m_imageMandleBrot == nullptr)
+	if (m_mandelbrot == nullptr)
 	{
 		return false;
 	}
 
-	/*
-	IntVec2 imageSize = m_imageMandleBrot->GetImageDimensions();
-
-	// number of iterations to check if item is in set
-	uint MAX_ITERATIONS = 1000;
+	//Tiles are only touched by the jobs while a pass runs, pick them up next frame
+	if (m_mandelbrot->IsPassRunning())
+	{
+		return true;
+	}
 
-	for (uint y = 0; y < (uint)imageSize.y; ++y)
+	//The staging copies of the last pass run on the workers; the next pass can't overwrite the pixels until they are done
+	if (m_mandelbrotUploader->HasStagedRegions())
 	{
-		//Make the mandleBrot generation job to run the row		
-		MandleBrotJob* mandleBrotJob = new MandleBrotJob(m_imageMandleBrot, y, MAX_ITERATIONS);
-		mandleBrotJob->SetJobCategory(JOB_GENERIC);
+		if (m_mandelbrotUploader->IsStaging())
+		{
+			return true;
+		}
 
-		UpdateTextureRowJob* texUpdateJob = new UpdateTextureRowJob(m_imageMandleBrot, m_textureMandleBrot, y);
-		texUpdateJob->SetJobCategory(JOB_RENDER);
+		//Each merged region goes to the texture as it was staged, nothing outside it is sent
+		m_mandelbrotUploader->Submit(*g_jobScheduler, [this](const StagedRegionT& staged)
+		{
+			g_renderBackend->UpdateTextureRegion(m_mandelbrotUploader->GetTag(), m_textureMandleBrot, staged.region, staged.texels.data());
+		});
 
-		mandleBrotJob->AddSuccessor(texUpdateJob);
+		m_mandelbrot->DispatchNextPass(*g_jobScheduler);
+		return true;
+	}
 
-		mandleBrotJob->Dispatch();
-		texUpdateJob->Dispatch();
+	//Most frames have none, the ones that do use frame memory
+	FrameVector<uint> dirtyTiles;
+	m_mandelbrot->ConsumeDirtyTiles(dirtyTiles);
+	for (uint tileIndex : dirtyTiles)
+	{
+		ImageRegionT tileRegion;
+		m_mandelbrot->GetTileBounds(tileIndex, tileRegion.minX, tileRegion.minY, tileRegion.maxX, tileRegion.maxY);
+		m_mandelbrotUploader->MarkDirty(tileRegion);
+	}
+
+	if (!dirtyTiles.empty())
+	{
+		const MandelbrotStatsT& stats = m_mandelbrot->GetLastPassStats();
+		DebuggerPrintf("\n Mandelbrot pass %u/%u: %.2f ms | %.2f Mpix/s", m_mandelbrot->GetPassIndex(), m_mandelbrot->GetPassCount(), stats.seconds * 1000.0, stats.GetMegaPixelsPerSecond());
+	}
+
+	if (!m_mandelbrotUploader->BeginStaging(*g_jobScheduler, m_mandelbrot->GetPixels(), m_mandelbrot->GetWidth()))
+	{
+		//Nothing new (first frame, or the image is complete)
+		m_mandelbrot->DispatchNextPass(*g_jobScheduler);
 	}
-	*/
 
 	return true;
 }
@@ -1145,40 +1351,35 @@ void Game::UpdateLightPositions()
 	options.space = DEBUG_RENDER_WORLD;
 	//Light 1
 	m_dynamicLight0Pos = Vec3(-3.f, 2.f * CosDegrees(currentTime * 20.f), 2.f * SinDegrees(currentTime * 20.f));
-
-	g_renderContext->m_cpuLightBuffer.lights[1].position = m_dynamicLight0Pos;
-	g_renderContext->m_lightBufferDirty = true;
+	g_lightManager->SetPosition(m_pointLights[0], m_dynamicLight0Pos);
 
 	options.beginColor = Rgba::GREEN;
 	options.endColor = Rgba::GREEN * 0.4f;
-	g_debugRenderer->DebugRenderPoint(options, m_dynamicLight0Pos, 0.1f, 0.1f, nullptr);
+	m_debugDraw->AddPoint(options, m_dynamicLight0Pos, 0.f, 0.1f);
 
 	//Light 2
 	m_dynamicLight1Pos = Vec3(3.f, 3.f * CosDegrees(currentTime * 40.f), 3.f * SinDegrees(currentTime * 40.f));
-	g_renderContext->m_cpuLightBuffer.lights[2].position = m_dynamicLight1Pos;
-	g_renderContext->m_lightBufferDirty = true;
+	g_lightManager->SetPosition(m_pointLights[1], m_dynamicLight1Pos);
 
 	options.beginColor = Rgba::BLUE;
 	options.endColor = Rgba::BLUE * 0.4f;
-	g_debugRenderer->DebugRenderPoint(options, m_dynamicLight1Pos, 0.1f, 0.1f, nullptr);
+	m_debugDraw->AddPoint(options, m_dynamicLight1Pos, 0.f, 0.1f);
 
 	//Light 3
 	m_dynamicLight2Pos = Vec3(-1.f, 1.f * CosDegrees(currentTime * 30.f), 1.f * SinDegrees(currentTime * 30.f));
-	g_renderContext->m_cpuLightBuffer.lights[3].position = m_dynamicLight2Pos;
-	g_renderContext->m_lightBufferDirty = true;
+	g_lightManager->SetPosition(m_pointLights[2], m_dynamicLight2Pos);
 
 	options.beginColor = Rgba::YELLOW;
 	options.endColor = Rgba::YELLOW * 0.4f;
-	g_debugRenderer->DebugRenderPoint(options, m_dynamicLight2Pos, 0.1f, 0.1f, nullptr);
+	m_debugDraw->AddPoint(options, m_dynamicLight2Pos, 0.f, 0.1f);
 
 	//Light 4
 	m_dynamicLight3Pos = Vec3(4.f * CosDegrees(currentTime * 60.f), 0.f , 4.f * SinDegrees(currentTime * 60.f));
-	g_renderContext->m_cpuLightBuffer.lights[4].position = m_dynamicLight3Pos;
-	g_renderContext->m_lightBufferDirty = true;
+	g_lightManager->SetPosition(m_pointLights[3], m_dynamicLight3Pos);
 
 	options.beginColor = Rgba::MAGENTA;
 	options.endColor = Rgba::MAGENTA * 0.4f;
-	g_debugRenderer->DebugRenderPoint(options, m_dynamicLight3Pos, 0.1f, 0.1f, nullptr);
+	m_debugDraw->AddPoint(options, m_dynamicLight3Pos, 0.f, 0.1f);
 
 
 	/*
@@ -1193,159 +1394,259 @@ void Game::UpdateLightPositions()
 
 	g_renderContext->m_cpuLightBuffer.lights[0].position = m_dynamicLight0Pos;
 	*/
+}
 
-	//RenderIsoSprite();
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::SubmitLights()
+{
+	PROFILE_FUNCTION();
 
+	g_lightManager->Submit([](uint firstSlot, uint slotCount, const LightDescT* lights)
+	{
+		g_renderBackend->UploadLights(firstSlot, slotCount, lights);
+	});
 }
 
 void Game::RenderIsoSprite() const
 {
-	Vec2 right = Vec2(1.f, 0.f);
-	Vec2 up = Vec2(0.f, 1.f);
+	if (m_laborerIsoFrames.frames.empty())
+	{
+		return;
+	}
+
+	//Billboarded against the camera, the frame follows m_testDirection around. Laborers all share one sheet, so however many
+	//there are this stays one instanced draw
+	const Matrix44& cameraModel = m_mainCamera->m_cameraModel;
+	m_spriteBatch->Begin(cameraModel.GetIBasis(), cameraModel.GetJBasis(), cameraModel.GetKBasis());
+	m_spriteBatch->AddIsoSprite(m_laborerSheet->GetView(), m_laborerIsoFrames, Vec3(0.f, 2.f, 0.f), m_testDirection, Vec2(m_quadSize, m_quadSize));
+	m_spriteBatch->Finish(g_jobScheduler);
+
+	DrawSpriteBatch(*m_spriteBatch);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::DrawSpriteBatch( const SpriteBatch& batch ) const
+{
+	const std::vector<SpriteInstanceDataT>& instances = batch.GetInstances();
+	if (instances.empty())
+	{
+		return;
+	}
 
-	Vec3 mins = Vec3(-m_quadSize * 0.5f, -m_quadSize * 0.5f, 0.f);
-	Vec3 maxs = Vec3(m_quadSize * 0.5f, m_quadSize * 0.5f, 0.f);
+	g_renderBackend->BindShader(m_shader);
+	g_renderBackend->SetModelMatrix(Matrix44::IDENTITY);
 
-	AABB2 box = AABB2(mins, maxs);
+	for (const SpriteDrawT& draw : batch.GetDraws())
+	{
+		g_renderBackend->BindTextureViewWithSampler(0U, draw.texture);
+		g_renderBackend->DrawSpriteInstances("Sprites", &instances[draw.firstInstance], draw.instanceCount);
+	}
+
+	g_renderBackend->BindTextureView(0U, nullptr);
+}
 
-	CPUMesh mesh;
-	CPUMeshAddQuad(&mesh, AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f)), Rgba::WHITE);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::DrawDebugBatch( eDebugDrawSpace space ) const
+{
+	const std::vector<Vertex_PCU>& verts = m_debugDraw->GetVerts();
+	g_renderBackend->SetModelMatrix(Matrix44::IDENTITY);
 
-	g_renderContext->BindShader(g_renderContext->CreateOrGetShaderFromFile("default_unlit.xml"));
-	//TextureView* view = def->GetTexture();
-	TextureView* view = m_laborerSheet;
-	g_renderContext->BindTextureView(0U, view);
-	g_renderContext->SetModelMatrix(m_quadTransfrom);
+	for (const DebugDrawT& draw : m_debugDraw->GetDraws())
+	{
+		if (draw.space != space || draw.vertCount == 0U)
+		{
+			continue;
+		}
 
-	g_renderContext->DrawMesh(m_quad);
+		switch (draw.pass)
+		{
+		case DEBUG_DRAW_PASS_XRAY_HIDDEN:
+			g_renderBackend->SetShaderDepth(m_shader, eCompareOp::COMPARE_GREATER, false);
+			break;
+		case DEBUG_DRAW_PASS_ALWAYS:
+			g_renderBackend->SetShaderDepth(m_shader, eCompareOp::COMPARE_ALWAYS, false);
+			break;
+		default:
+			g_renderBackend->SetShaderDepth(m_shader, eCompareOp::COMPARE_LEQUAL, true);
+			break;
+		}
+		g_renderBackend->BindShader(m_shader);
+		if (draw.topology == DEBUG_DRAW_LINES)
+		{
+			g_renderBackend->DrawLineArray("DebugDraw", &verts[draw.firstVert], draw.vertCount);
+			continue;
+		}
+		g_renderBackend->BindTextureView(0U, draw.texture);
+		g_renderBackend->DrawVertexArray("DebugDraw", &verts[draw.firstVert], draw.vertCount);
+	}
 
-	g_renderContext->BindTextureView(0U, nullptr);
+	g_renderBackend->SetShaderDepth(m_shader, eCompareOp::COMPARE_LEQUAL, true);
+	g_renderBackend->BindShader(m_shader);
+	g_renderBackend->BindTextureView(0U, nullptr);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::RenderUI() const
 {
 	m_UICamera->SetViewport(Vec2::ZERO, Vec2::ONE);
-	g_renderContext->BeginCamera(*m_UICamera);
-	m_UICamera->UpdateUniformBuffer(g_renderContext);
-	g_renderContext->BindShader(m_shader);
+	g_renderBackend->BeginCamera(*m_UICamera);
+	g_renderBackend->UpdateCameraBuffer(*m_UICamera);
+	g_renderBackend->BindShader(m_shader);
 	m_UICamera->SetModelMatrix(Matrix44::IDENTITY);
 
 	Vec2 camMinBounds = m_UICamera->GetOrthoBottomLeft();
 	Vec2 camMaxBounds = m_UICamera->GetOrthoTopRight();
 
-	std::string printString = "AAA iiii ya! '/.,<> ya! Pack my box with five dozen liquor jugs.";
-	std::vector<Vertex_PCU> textVerts;
-	
-	//Retro font tests
-	printString = "The ATARI 400/800 font is from 1979";
-	textVerts.clear();
-	m_atariClassicFont->AddVertsForText2D(textVerts, Vec2(10.f, 410.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_atariClassicFont->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
-
-	printString = "The Apple II font is from 1977";
-	textVerts.clear();
-	m_apple2Font->AddVertsForText2D(textVerts, Vec2(10.f, 360.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_apple2Font->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
-
-	printString = "The Commodore 64 font is from 1982";
-	textVerts.clear();
-	m_commodoreFont->AddVertsForText2D(textVerts, Vec2(10.f, 310.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_commodoreFont->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
-
-	printString = "The Sinclair ZX Spectrum font is from 1982";
-	textVerts.clear();
-	m_sinclairZXSpectrumFont->AddVertsForText2D(textVerts, Vec2(10.f, 260.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_sinclairZXSpectrumFont->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
-
-	printString = "AAA iiii ya! '/.,<> ya! Pack my box with five dozen liquor jugs.";
+	//The test strings never change, so after the first frame every run is a cache hit
+	static const std::string pangram = "AAA iiii ya! '/.,<> ya! Pack my box with five dozen liquor jugs.";
+	m_uiTextVerts.clear();
+	m_uiTextRuns.clear();
 
-	//Tier 3 fonts
-	textVerts.clear();
-	m_IBM3270Font->AddVertsForText2D(textVerts, Vec2(10.f, 210.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_IBM3270Font->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
+	AddUIText(m_atariClassicFont, Vec2(10.f, 410.f), "The ATARI 400/800 font is from 1979", Rgba::YELLOW, SAMPLE_MODE_POINT);
+	AddUIText(m_apple2Font, Vec2(10.f, 360.f), "The Apple II font is from 1977", Rgba::YELLOW, SAMPLE_MODE_POINT);
+	AddUIText(m_commodoreFont, Vec2(10.f, 310.f), "The Commodore 64 font is from 1982", Rgba::YELLOW, SAMPLE_MODE_POINT);
+	AddUIText(m_sinclairZXSpectrumFont, Vec2(10.f, 260.f), "The Sinclair ZX Spectrum font is from 1982", Rgba::YELLOW, SAMPLE_MODE_POINT);
 
 	//Tier 3 fonts
-	textVerts.clear();
-	m_vineraHandFont->AddVertsForText2D(textVerts, Vec2(10.f, 160.f), m_fontHeight, printString, Rgba::YELLOW);
-	g_renderContext->BindTextureViewWithSampler(0U, m_vineraHandFont->GetTexture(), SAMPLE_MODE_LINEAR);
-	g_renderContext->DrawVertexArray(textVerts);
+	AddUIText(m_IBM3270Font, Vec2(10.f, 210.f), pangram, Rgba::YELLOW, SAMPLE_MODE_POINT);
+	AddUIText(m_vineraHandFont, Vec2(10.f, 160.f), pangram, Rgba::YELLOW, SAMPLE_MODE_LINEAR);
 
 	//Tier 2 fonts
-	textVerts.clear();
-	m_squirrelProportionalFont->AddVertsForText2D(textVerts, Vec2(10.f, 80.f), m_fontHeight, printString, Rgba::WHITE);
-	g_renderContext->BindTextureViewWithSampler(0U, m_squirrelProportionalFont->GetTexture(), SAMPLE_MODE_POINT);
-	g_renderContext->DrawVertexArray(textVerts);
+	AddUIText(m_squirrelProportionalFont, Vec2(10.f, 80.f), pangram, Rgba::WHITE, SAMPLE_MODE_POINT);
 
 	//Tier 1 fonts
-	textVerts.clear();
-	g_renderContext->BindTextureViewWithSampler(0U, m_squirrelFixedFont->GetTexture(), SAMPLE_MODE_POINT);
-	m_squirrelFixedFont->AddVertsForText2D(textVerts, Vec2(10.f, 10.f), m_fontHeight, printString, Rgba::ORANGE);
-	g_renderContext->DrawVertexArray(textVerts);
+	AddUIText(m_squirrelFixedFont, Vec2(10.f, 10.f), pangram, Rgba::ORANGE, SAMPLE_MODE_POINT);
+
+	DrawUITextBatches();
+
+	g_renderBackend->EndCamera();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::AddUIText( BitmapFont* font, const Vec2& position, const std::string& text, const Rgba& color, eSampleMode sampleMode ) const
+{
+	const std::vector<Vertex_PCU>& textVerts = m_textRunCache->GetRun(font, position, m_fontHeight, text, color);
+
+	//No glyphs without a font, which is always the case headless
+	if (textVerts.empty())
+	{
+		return;
+	}
+
+	//Fonts that did not make it into the atlas draw from their own page, in their place among the rest
+	bool isInAtlas = m_fontAtlasView != nullptr && m_fontAtlas->ContainsFont(font);
+	TextureView* textureView = isInAtlas ? m_fontAtlasView : font->GetTexture();
+
+	if (m_uiTextRuns.empty() || m_uiTextRuns.back().textureView != textureView || m_uiTextRuns.back().sampleMode != sampleMode)
+	{
+		UITextRunT run;
+		run.textureView = textureView;
+		run.sampleMode = sampleMode;
+		run.firstVert = (uint)m_uiTextVerts.size();
+		m_uiTextRuns.push_back(run);
+	}
 
-	g_renderContext->EndCamera();
+	m_uiTextVerts.insert(m_uiTextVerts.end(), textVerts.begin(), textVerts.end());
+	m_uiTextRuns.back().vertCount += (uint)textVerts.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A draw can only use one texture and sampler, so each run is one draw. Drawing them in order keeps overlapping text the way
+// it was added
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::DrawUITextBatches() const
+{
+	for (const UITextRunT& run : m_uiTextRuns)
+	{
+		g_renderBackend->BindTextureViewWithSampler(0U, run.textureView, run.sampleMode);
+		g_renderBackend->DrawVertexArray("UIText", m_uiTextVerts.data() + run.firstVert, run.vertCount);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Packs the printable glyphs of every UI font into one texture. If packing fails the fonts keep drawing from their own pages
+//------------------------------------------------------------------------------------------------------------------------------
+void Game::CreateFontAtlas()
+{
+	m_fontAtlas = new FontAtlas();
+	m_fontAtlas->AddFontFromFnt(m_atariClassicFont, "Data/Fonts/AtariClassic.fnt");
+	m_fontAtlas->AddFontFromFnt(m_apple2Font, "Data/Fonts/AppleIIFont.fnt");
+	m_fontAtlas->AddFontFromFnt(m_commodoreFont, "Data/Fonts/CommodorePET1977.fnt");
+	m_fontAtlas->AddFontFromFnt(m_sinclairZXSpectrumFont, "Data/Fonts/ZXSpectrum.fnt");
+	m_fontAtlas->AddFontFromFnt(m_IBM3270Font, "Data/Fonts/IBM3270.fnt");
+	m_fontAtlas->AddFontFromFnt(m_vineraHandFont, "Data/Fonts/VineraHand.fnt");
+	m_fontAtlas->AddFontPage(m_squirrelProportionalFont, "Data/Fonts/SquirrelProportionalFont.png");
+	m_fontAtlas->AddFontPage(m_squirrelFixedFont, "Data/Fonts/SquirrelFixedFont.png");
+
+	if (!m_fontAtlas->Build())
+	{
+		return;
+	}
+
+	//Never written again, so immutable; no mips, UI text is drawn at its own size
+	const IntVec2& atlasDimensions = m_fontAtlas->GetDimensions();
+	CookedTextureViewT atlasMips;
+	atlasMips.mipCount = 1U;
+	atlasMips.mips[0].width = (uint32_t)atlasDimensions.x;
+	atlasMips.mips[0].height = (uint32_t)atlasDimensions.y;
+	atlasMips.mips[0].data = m_fontAtlas->GetTexels().data();
+	atlasMips.mips[0].byteCount = m_fontAtlas->GetTexels().size();
+	m_fontAtlasView = g_renderBackend->CreateImmutableTexture("FontAtlas", atlasMips, m_fontAtlasTexture);
+
+	//The GPU copy is all we draw from
+	m_fontAtlas->ReleaseTexels();
+	m_textRunCache->SetFontAtlas(m_fontAtlas);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreateInitialLight()
 {
-	EnableDirectionalLight(Vec3(1.f, 1.f, 1.f), Vec3(0.f, 0.f, 1.f));
+	m_directionalLight = EnableDirectionalLight(Vec3(1.f, 1.f, 1.f), Vec3(0.f, 0.f, 1.f));
 
-	EnablePointLight(1U, m_dynamicLight0Pos, Vec3(1.f, 0.f, 0.5f),Rgba::GREEN);
-	EnablePointLight(2U, m_dynamicLight1Pos, Vec3(0.f, -1.f, 0.f), Rgba::BLUE, 1.f, Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.1f, 0.f));
-	EnablePointLight(3U, m_dynamicLight2Pos, Vec3(0.f, 0.f, 1.f), Rgba::YELLOW, 1.f, Vec3(0.f, 1.f, 0.1f), Vec3(0.f, 0.1f, 0.f));
-	EnablePointLight(4U, m_dynamicLight3Pos, Vec3(-1.f, -1.f, 0.f), Rgba::MAGENTA, 1.f, Vec3(0.f, 0.f, 1.f), Vec3(0.f, 0.f, 1.f));
+	m_pointLights[0] = EnablePointLight(m_dynamicLight0Pos, Vec3(1.f, 0.f, 0.5f),Rgba::GREEN);
+	m_pointLights[1] = EnablePointLight(m_dynamicLight1Pos, Vec3(0.f, -1.f, 0.f), Rgba::BLUE, 1.f, Vec3(0.f, 1.f, 0.f), Vec3(0.f, 0.1f, 0.f));
+	m_pointLights[2] = EnablePointLight(m_dynamicLight2Pos, Vec3(0.f, 0.f, 1.f), Rgba::YELLOW, 1.f, Vec3(0.f, 1.f, 0.1f), Vec3(0.f, 0.1f, 0.f));
+	m_pointLights[3] = EnablePointLight(m_dynamicLight3Pos, Vec3(-1.f, -1.f, 0.f), Rgba::MAGENTA, 1.f, Vec3(0.f, 0.f, 1.f), Vec3(0.f, 0.f, 1.f));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Game::CreateInitialMeshes()
 {
+	//Built once, after that every startup and F8 restart loads the cooked files from Data/Cache/Meshes
+	m_meshCache = new MeshCache();
 
 	//Meshes for A4
-	CPUMesh mesh;
-	CPUMeshAddQuad(&mesh, AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f)));
-	m_quad = new GPUMesh(g_renderContext);
-	m_quad->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
+	m_quad = m_meshCache->CreateOrLoadLitMesh("Quad", "CPUMeshAddQuad (-0.5,-0.5) (0.5,0.5)", [](CPUMesh& mesh)
+	{
+		CPUMeshAddQuad(&mesh, AABB2(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f)));
+	});
 
 	// create a cube (centered at zero, with sides 2 length)
-	CPUMeshAddCube( &mesh, AABB3( Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f)) ); 
-	
-	//mesh.SetLayout<Vertex_Lit>();
-	m_cube = new GPUMesh( g_renderContext ); 
-	m_cube->CreateFromCPUMesh<Vertex_Lit>( &mesh, GPU_MEMORY_USAGE_STATIC );
-
+	m_cube = m_meshCache->CreateOrLoadLitMesh("Cube", "CPUMeshAddCube (-0.5,-0.5,-0.5) (0.5,0.5,0.5)", [](CPUMesh& mesh)
+	{
+		CPUMeshAddCube(&mesh, AABB3(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f)));
+	});
 
 	// create a sphere, cenetered at zero, with 
-	mesh.Clear();
-	CPUMeshAddUVSphere( &mesh, Vec3::ZERO, 1.0f );  
-	
-	//mesh.SetLayout<Vertex_Lit>();
-	m_sphere = new GPUMesh( g_renderContext ); 
-	m_sphere->CreateFromCPUMesh<Vertex_Lit>( &mesh, GPU_MEMORY_USAGE_STATIC );
+	m_meshCache->CreateOrLoadLitMeshLods("UVSphere", "CPUMeshAddUVSphere (0,0,0) 1", [](CPUMesh& mesh)
+	{
+		CPUMeshAddUVSphere(&mesh, Vec3::ZERO, 1.0f);
+	}, m_sphereLods);
 
 	//Create another quad as a base plane
-	mesh.Clear();
-	CPUMeshAddQuad(&mesh, AABB2(Vec2(-50.f, -50.f), Vec2(50.f, 50.f)));
-
-	//mesh.SetLayout<Vertex_Lit>();
-	m_baseQuad = new GPUMesh( g_renderContext ); 
-	m_baseQuad->CreateFromCPUMesh<Vertex_Lit>( &mesh, GPU_MEMORY_USAGE_STATIC );
+	m_baseQuad = m_meshCache->CreateOrLoadLitMesh("BaseQuad", "CPUMeshAddQuad (-50,-50) (50,50)", [](CPUMesh& mesh)
+	{
+		CPUMeshAddQuad(&mesh, AABB2(Vec2(-50.f, -50.f), Vec2(50.f, 50.f)));
+	});
 
 	m_baseQuadTransform = Matrix44::IDENTITY;
 	m_baseQuadTransform = Matrix44::MakeFromEuler(Vec3(-90.f, 0.f, 0.f));
 	m_baseQuadTransform = Matrix44::SetTranslation3D(Vec3(0.f, -1.f, 0.f), m_baseQuadTransform);
 
-	mesh.Clear();
-	CPUMeshAddUVCapsule(&mesh, Vec3(0.f, 1.f, 1.f), Vec3(0.f, -1.f, 1.f), 2.f, Rgba::YELLOW);
-
-	m_capsule = new GPUMesh(g_renderContext);
-	m_capsule->CreateFromCPUMesh<Vertex_Lit>(&mesh, GPU_MEMORY_USAGE_STATIC);
+	m_meshCache->CreateOrLoadLitMeshLods("UVCapsule", "CPUMeshAddUVCapsule (0,1,1) (0,-1,1) 2 YELLOW", [](CPUMesh& mesh)
+	{
+		CPUMeshAddUVCapsule(&mesh, Vec3(0.f, 1.f, 1.f), Vec3(0.f, -1.f, 1.f), 2.f, Rgba::YELLOW);
+	}, m_capsuleLods);
 
 	m_capsuleModel = Matrix44::IDENTITY;
 	m_capsuleModel = Matrix44::MakeFromEuler(Vec3(-90.f, 0.f, 0.f));
@@ -1353,14 +1654,20 @@ void Game::CreateInitialMeshes()
 
 void Game::LoadGameTextures()
 {
+	//The placeholders are tiny, they are the only images still loaded on the main thread
+	m_textureStreamer = new TextureStreamer();
+	m_textureStreamer->LoadPlaceholder(TEXTURE_PLACEHOLDER_WHITE, "WHITE.png");
+	m_textureStreamer->LoadPlaceholder(TEXTURE_PLACEHOLDER_FLAT, "FLAT.png");
+
 	//Get the test texture
-	m_textureTest = g_renderContext->CreateOrGetTextureViewFromFile(m_testImagePath);
-	m_boxTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_boxTexturePath);
-	m_sphereTexture = g_renderContext->CreateOrGetTextureViewFromFile(m_sphereTexturePath);
+	m_textureTest = m_textureStreamer->RequestTexture(*g_jobScheduler, m_testImagePath);
+	m_boxTexture = m_textureStreamer->RequestTexture(*g_jobScheduler, m_boxTexturePath);
+	m_sphereTexture = m_textureStreamer->RequestTexture(*g_jobScheduler, m_sphereTexturePath);
 
 	//Load the sprite sheet from texture (Need to do XML test)
-	m_laborerSheet = g_renderContext->CreateOrGetTextureViewFromFile(m_laborerSheetPath);
-	m_testSheet = new SpriteSheet(m_laborerSheet, m_laborerSheetDim);
+	//The sheet only supplies sprite UVs here; draws bind m_laborerSheet->GetView() so they pick up the texture once it arrives
+	m_laborerSheet = m_textureStreamer->RequestTexture(*g_jobScheduler, m_laborerSheetPath);
+	m_testSheet = new SpriteSheet(m_laborerSheet->GetView(), m_laborerSheetDim);
 
 	CreateIsoSpriteDefenitions();
 }
@@ -1395,20 +1702,20 @@ void Game::CreateIsoSpriteDefenitions()
 
 	spriteDefs.push_back(SpriteDefenition(m_testSheet->GetSpriteDef(96), Vec2(0.5, 0.25)));
 	directions.push_back(Vec3(1.f, 0.f, 0.f));
-	
-	//m_isoSprite = new IsoSpriteDefenition(&spriteDefs[0], &directions[0], 7);
+
+	m_laborerIsoFrames = IsoSpriteFramesT(&spriteDefs[0], &directions[0], (uint)spriteDefs.size(), Vec2(0.5f, 0.25f));
 }
 
 void Game::GetandSetShaders()
 {
 	//Get the Shader
-	m_shader = g_renderContext->CreateOrGetShaderFromFile(m_xmlShaderPath);
+	m_shader = g_renderBackend->CreateOrGetShader(m_xmlShaderPath);
 	m_shader->SetDepth(eCompareOp::COMPARE_LEQUAL, true);
 
-	m_normalShader = g_renderContext->CreateOrGetShaderFromFile(m_normalColorShader);
+	m_normalShader = g_renderBackend->CreateOrGetShader(m_normalColorShader);
 	m_normalShader->SetDepth(eCompareOp::COMPARE_LEQUAL, true);
 
-	m_defaultLit = g_renderContext->CreateOrGetShaderFromFile(m_shaderLitPath);
+	m_defaultLit = g_renderBackend->CreateOrGetShader(m_shaderLitPath);
 	m_defaultLit->SetDepth(eCompareOp::COMPARE_LEQUAL, true);
 }
 
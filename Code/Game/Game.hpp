@@ -5,10 +5,14 @@
 #include "Engine/Math/Matrix44.hpp"
 #include "Engine/Math/Vertex_PCU.hpp"
 #include "Engine/Renderer/Material.hpp"
+#include "Engine/Renderer/Sampler.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
-#include "Engine/Renderer/IsoSpriteDefenition.hpp"
 //Game Systems
+#include "Game/DebugDrawBatch.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/LightManager.hpp"
+#include "Game/SpatialHashGrid.hpp"
+#include "Game/SpriteBatch.hpp"
 //Third Party
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -20,9 +24,29 @@ class Image;
 class Shader;
 class SpriteAnimDefenition;
 class GPUMesh;
+class MandelbrotGenerator;
+class DynamicTextureUploader;
+class EntityStore;
+class EntitySimulation;
+class TextRunCache;
+class MeshCache;
+class FontAtlas;
+class StreamedTexture;
+class TextureStreamer;
 
 struct Camera;
 
+//------------------------------------------------------------------------------------------------------------------------------
+// UI text sharing one texture and sampler mode. Runs are drawn in the order their text was added
+//------------------------------------------------------------------------------------------------------------------------------
+struct UITextRunT
+{
+	TextureView*						textureView = nullptr;
+	eSampleMode							sampleMode = SAMPLE_MODE_POINT;
+	uint								firstVert = 0U;
+	uint								vertCount = 0U;
+};
+
 //------------------------------------------------------------------------------------------------------------------------------
 class Game
 {
@@ -31,16 +55,27 @@ public:
 	~Game();
 	
 	static bool TestEvent(EventArgs& args);
-	static bool ToggleLight1(EventArgs& args);
-	static bool ToggleLight2(EventArgs& args);
-	static bool ToggleLight3(EventArgs& args);
-	static bool ToggleLight4(EventArgs& args);
+	static bool ToggleLight(EventArgs& args);
 	static bool ToggleAllPointLights(EventArgs& args);
 	static bool LogThreadTest(EventArgs& args);
+	static bool LogThreadBenchmark(EventArgs& args);
+	static bool JobSchedulerBenchmark(EventArgs& args);
+	static bool MandelbrotBenchmark(EventArgs& args);
+	static bool EntityBenchmark(EventArgs& args);
+	static bool EntityChurnBenchmark(EventArgs& args);
+	static bool CollisionBenchmark(EventArgs& args);
+	static bool SpriteBatchBenchmark(EventArgs& args);
+	static bool DebugDrawBenchmark(EventArgs& args);
+	static bool MeshOptimizerBenchmark(EventArgs& args);
+	static bool ShaderCacheBenchmark(EventArgs& args);
+	static bool LightClusterBenchmark(EventArgs& args);
+	static bool FrameAllocatorStats(EventArgs& args);
+	static bool RunUnitTests(EventArgs& args);
 
 	void								StartUp();
 	
 	void								BeginFrame();
+	void								EndFrame();
 
 	void								SetupMouseData();
 	void								SetupCameras();
@@ -58,12 +93,12 @@ public:
 	void								HandleKeyReleased( unsigned char keyCode );
 	void								HandleCharacter( unsigned char charCode );
 
-	void								EnablePointLight( uint slot, const Vec3& position, const Vec3& direction,
+	LightHandle							EnablePointLight( const Vec3& position, const Vec3& direction,
 															const Rgba& color = Rgba::WHITE, float intensity = 1.f,
 															const Vec3& diffuseAttenuation = Vec3(1.f, 0.f, 0.f),
 															const Vec3& specularAttenuation = Vec3(1.f, 0.f, 0.f)) const;
 	
-	void								EnableDirectionalLight( const Vec3& position, const Vec3& direction,
+	LightHandle							EnableDirectionalLight( const Vec3& position, const Vec3& direction,
 															const Rgba& color = Rgba::WHITE, float intensity = 1.f,
 															const Vec3& diffuseAttenuation = Vec3(1.f, 0.f, 0.f),
 															const Vec3& specularAttenuation = Vec3(1.f, 0.f, 0.f)) const;
@@ -74,8 +109,14 @@ public:
 	void								Render() const;
 	void								RenderUsingMaterial() const;
 	void								RenderUsingLegacy() const;
+	GPUMesh*							GetMeshLodForCamera( const std::vector<GPUMesh*>& lods, const Vec3& worldCenter, float boundingRadius ) const;
 	void								RenderIsoSprite() const;
+	void								DrawSpriteBatch( const SpriteBatch& batch ) const;
+	void								DrawDebugBatch( eDebugDrawSpace space ) const;
 	void								RenderUI() const;
+	void								AddUIText( BitmapFont* font, const Vec2& position, const std::string& text, const Rgba& color, eSampleMode sampleMode ) const;
+	void								DrawUITextBatches() const;
+	void								CreateFontAtlas();
 	void								DebugRenderToScreen() const;
 	void								DebugRenderToCamera() const;
 	void								PostRender();
@@ -83,8 +124,10 @@ public:
 	void								UpdateImGUI();
 	void								UpdateMouseInputs(float deltaTime);
 	void								UpdateLightPositions();
+	void								SubmitLights();
 	void								UpdateCamera(float deltaTime);
 	void								ClearGarbageEntities();
+	void								SpawnWorldEntities();
 	void								CheckXboxInputs();
 	void								CheckCollisions();
 
@@ -93,9 +136,16 @@ public:
 	bool								GenerateMandleBrotImage();
 private:
 
-	Image*								m_imageMandleBrot = nullptr;
 	Texture2D*							m_textureMandleBrot = nullptr;
 	TextureView*						m_textureViewMandleBrot = nullptr;
+	MandelbrotGenerator*				m_mandelbrot = nullptr;
+	DynamicTextureUploader*				m_mandelbrotUploader = nullptr;
+
+	EntityStore*						m_entities = nullptr;
+	EntitySimulation*					m_entitySimulation = nullptr;
+	uint32_t							m_entitySpawnSeed = 12345U;
+	SpatialHashGrid*					m_collisionGrid = nullptr;
+	std::vector<CollisionPairT>			m_collisionPairs;
 
 	bool								m_isGameAlive = false;
 	bool								m_consoleDebugOnce = false;
@@ -106,9 +156,11 @@ private:
 public:
 	SoundID								m_testAudioID = NULL;
 	
-	TextureView*						m_textureTest = nullptr;
-	TextureView*						m_boxTexture = nullptr;
-	TextureView*						m_sphereTexture = nullptr;
+	//Streamed in by m_textureStreamer, bind them through GetView()
+	TextureStreamer*					m_textureStreamer = nullptr;
+	StreamedTexture*					m_textureTest = nullptr;
+	StreamedTexture*					m_boxTexture = nullptr;
+	StreamedTexture*					m_sphereTexture = nullptr;
 	
 	//All fonts for tests
 	BitmapFont*							m_squirrelFixedFont = nullptr;
@@ -121,6 +173,14 @@ public:
 	BitmapFont*							m_commodoreFont = nullptr;
 	BitmapFont*							m_sinclairZXSpectrumFont = nullptr;
 	BitmapFont*							m_atariClassicFont = nullptr;
+	TextRunCache*						m_textRunCache = nullptr;
+
+	//Every UI font packed into one texture, so text in a row that shares a sampler mode is one draw
+	FontAtlas*							m_fontAtlas = nullptr;
+	Texture2D*							m_fontAtlasTexture = nullptr;
+	TextureView*						m_fontAtlasView = nullptr;
+	mutable std::vector<Vertex_PCU>		m_uiTextVerts;
+	mutable std::vector<UITextRunT>		m_uiTextRuns;
 
 	Image*								m_testImage = nullptr;
 	float								m_animTime = 0.f;
@@ -155,17 +215,20 @@ public:
 	GPUMesh*							m_cube = nullptr; 
 	Matrix44							m_cubeTransform; // cube's model matrix
 
-	GPUMesh*							m_sphere = nullptr;
+	std::vector<GPUMesh*>				m_sphereLods;
 	Matrix44							m_sphereTransform;   // sphere's model matrix
 
 	GPUMesh*							m_quad = nullptr;
+	MeshCache*							m_meshCache = nullptr;
 	Matrix44							m_quadTransfrom;
 
 	GPUMesh*							m_baseQuad = nullptr;
 	Matrix44							m_baseQuadTransform;
 
-	GPUMesh*							m_capsule = nullptr;
+	std::vector<GPUMesh*>				m_capsuleLods;
 	Matrix44							m_capsuleModel;
+	//Pixels per world unit of radius at distance 1 in front of the main camera, for LOD selection
+	float								m_lodPixelsPerRadius = 1.f;
 
 	//Lighting Assignment
 	int									m_lightSlot;
@@ -180,6 +243,8 @@ public:
 	Vec3								m_dynamicLight1Pos = Vec3::ZERO;
 	Vec3								m_dynamicLight2Pos = Vec3::ZERO;
 	Vec3								m_dynamicLight3Pos = Vec3::ZERO;
+	LightHandle							m_directionalLight;
+	LightHandle							m_pointLights[4];
 	
 	//Light movement
 	float								m_ySpeed = 2.f;
@@ -217,12 +282,17 @@ public:
 	Vec2								m_position = Vec2::ZERO;
 	Vec2								m_targetPosition = Vec2::ZERO;
 	std::string							m_laborerSheetPath = "Laborer_spriteshee_2k.png";
-	TextureView*						m_laborerSheet = nullptr;
+	StreamedTexture*					m_laborerSheet = nullptr;
 	IntVec2								m_laborerSheetDim = IntVec2(16, 16);
 	SpriteSheet* 						m_testSheet = nullptr;
-	IsoSpriteDefenition*				m_isoSprite = nullptr;
+	IsoSpriteFramesT					m_laborerIsoFrames;
+	SpriteBatch*						m_spriteBatch = nullptr;
+	//World and screen debug primitives, merged into a few draws each frame
+	DebugDrawBatch*						m_debugDraw = nullptr;
 
 	float								m_quadSize = 1.f;
 
 	Vec3								m_testDirection = Vec3(0.f, 0.f, 1.f);
-};
\ No newline at end of file
+};
+
+extern Game* g_theGame;
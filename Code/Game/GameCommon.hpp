@@ -6,6 +6,14 @@ constexpr float WORLD_HEIGHT = 150.f;
 constexpr float WORLD_CENTER_X = WORLD_WIDTH / 2.f;
 constexpr float WORLD_CENTER_Y = WORLD_HEIGHT / 2.f;
 constexpr float SCREEN_ASPECT = 16.f/9.f;
+//Main camera depth range, the light clusters slice the same range
+constexpr float MAIN_CAMERA_NEAR_Z = 0.1f;
+constexpr float MAIN_CAMERA_FAR_Z = 100.f;
+
+//Entities kept alive in the world, the ones that leave it are replaced by new ones
+constexpr uint WORLD_ENTITY_COUNT = 2000U;
+//Small enough that the world update splits into a chunk for every worker
+constexpr uint WORLD_ENTITY_CHUNK_SIZE = 256U;
 
 constexpr float CAMERA_SHAKE_REDUCTION_PER_SECOND = 1.f;
 constexpr float MAX_SHAKE = 2.0f;
@@ -14,10 +22,16 @@ constexpr float DEVCONSOLE_LINE_HEIGHT = 12.0f;
 
 constexpr float CLIENT_ASPECT = 2.0f; // We are requesting a 1:1 aspect (square) window area
 
+//Client size used for cameras when running without a window (Main_Headless)
+constexpr int HEADLESS_CLIENT_WIDTH = 1920;
+constexpr int HEADLESS_CLIENT_HEIGHT = 1080;
+
 class RenderContext;
 class InputSystem;
 class AudioSystem;
 
 extern RenderContext* g_renderContext;
 extern InputSystem* g_inputSystem;
-extern AudioSystem* g_audio;
\ No newline at end of file
+extern AudioSystem* g_audio;
+
+extern bool g_isHeadless;
\ No newline at end of file
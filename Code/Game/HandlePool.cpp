@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/HandlePool.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+HandlePool::HandlePool( uint initialCapacity )
+{
+	Reserve(initialCapacity);
+}
+
+HandlePool::~HandlePool()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void HandlePool::Reserve( uint capacity )
+{
+	m_generations.reserve(capacity);
+	m_isLive.reserve(capacity);
+	m_freePositions.reserve(capacity);
+	m_freeSlots.reserve(capacity);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t HandlePool::AllocateSlot()
+{
+	if (m_freeSlots.empty())
+	{
+		AddFreeSlot();
+	}
+
+	uint32_t slot = m_freeSlots.back();
+	m_freeSlots.pop_back();
+
+	m_isLive[slot] = 1U;
+	m_liveCount++;
+	return slot;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool HandlePool::ClaimSlot( uint32_t slot )
+{
+	while (slot >= m_generations.size())
+	{
+		AddFreeSlot();
+	}
+
+	if (m_isLive[slot] != 0U)
+	{
+		return false;
+	}
+
+	//The last free slot takes this one's place
+	uint32_t position = m_freePositions[slot];
+	uint32_t lastSlot = m_freeSlots.back();
+	m_freeSlots[position] = lastSlot;
+	m_freePositions[lastSlot] = position;
+	m_freeSlots.pop_back();
+
+	m_isLive[slot] = 1U;
+	m_liveCount++;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool HandlePool::FreeSlot( uint32_t slot )
+{
+	if (!IsSlotLive(slot))
+	{
+		return false;
+	}
+
+	//Outstanding handles to this slot are stale from here on
+	m_generations[slot]++;
+	m_isLive[slot] = 0U;
+	m_liveCount--;
+
+	PushFreeSlot(slot);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void HandlePool::FreeAllSlots()
+{
+	//Highest first, so the lowest slots are reused first and live slots stay packed at the front
+	m_freeSlots.clear();
+	for (uint32_t slot = (uint32_t)m_generations.size(); slot-- > 0U;)
+	{
+		if (m_isLive[slot] != 0U)
+		{
+			m_generations[slot]++;
+			m_isLive[slot] = 0U;
+		}
+		PushFreeSlot(slot);
+	}
+	m_liveCount = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void HandlePool::AddFreeSlot()
+{
+	uint32_t slot = (uint32_t)m_generations.size();
+	m_generations.push_back(0U);
+	m_isLive.push_back(0U);
+	m_freePositions.push_back(0U);
+	PushFreeSlot(slot);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void HandlePool::PushFreeSlot( uint32_t slot )
+{
+	m_freePositions[slot] = (uint32_t)m_freeSlots.size();
+	m_freeSlots.push_back(slot);
+}
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The slot table behind EntityHandle and LightHandle. A slot's generation is bumped when it is freed, so a handle kept past
+// its owner is refused instead of reaching whoever took the slot next. Free slots sit on a LIFO list and each remembers where,
+// so allocating, claiming a particular slot and freeing are all O(1). Nothing allocates once the pool reached its high water
+// mark.
+//------------------------------------------------------------------------------------------------------------------------------
+class HandlePool
+{
+public:
+	explicit HandlePool( uint initialCapacity = 0U );
+	~HandlePool();
+
+	void								Reserve( uint capacity );
+
+	//The most recently freed slot, or a new one past the last
+	uint32_t							AllocateSlot();
+	//Takes this slot, adding free slots up to it if it is past the last. Returns false if it is live
+	bool								ClaimSlot( uint32_t slot );
+	//Returns false if the slot was not live
+	bool								FreeSlot( uint32_t slot );
+	//Every live slot is freed, so every outstanding handle goes stale. Slot 0 is the next one allocated
+	void								FreeAllSlots();
+
+	bool								IsCurrent( uint32_t slot, uint32_t generation ) const { return IsSlotLive(slot) && m_generations[slot] == generation; }
+	bool								IsSlotLive( uint32_t slot ) const { return slot < m_generations.size() && m_isLive[slot] != 0U; }
+	uint32_t							GetGeneration( uint32_t slot ) const { return m_generations[slot]; }
+
+	uint								GetSlotCount() const { return (uint)m_generations.size(); }
+	uint								GetLiveCount() const { return m_liveCount; }
+
+private:
+	void								AddFreeSlot();
+	void								PushFreeSlot( uint32_t slot );
+
+private:
+	std::vector<uint32_t>				m_generations;
+	std::vector<uint8_t>				m_isLive;
+	//Where each free slot sits in m_freeSlots, so ClaimSlot can swap it out
+	std::vector<uint32_t>				m_freePositions;
+	std::vector<uint32_t>				m_freeSlots;
+	uint								m_liveCount = 0U;
+};
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/ImageDecoder.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+#include "Game/VirtualFileSystem.hpp"
+//Third Party
+#include "ThirdParty/stb/stb_image.h"
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DecodeImageRGBA8( const unsigned char* fileBytes, size_t byteCount, DecodedImageT& outImage )
+{
+	//Flipped the same way the engine loads, every caller sets it so it never changes under a decode
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* texels = stbi_load_from_memory(fileBytes, (int)byteCount, &width, &height, &channels, 4);
+	if (texels == nullptr)
+	{
+		return false;
+	}
+
+	outImage.width = (uint)width;
+	outImage.height = (uint)height;
+	outImage.texels.resize((size_t)width * height * 4U);
+	memcpy(outImage.texels.data(), texels, outImage.texels.size());
+	stbi_image_free(texels);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DecodeImageFileRGBA8( const std::string& filePath, DecodedImageT& outImage )
+{
+	FileSpanT packedSpan;
+	if (g_virtualFileSystem != nullptr && g_virtualFileSystem->ReadPackedFile(filePath, packedSpan))
+	{
+		return DecodeImageRGBA8(packedSpan.data, packedSpan.size, outImage);
+	}
+
+	MappedFile looseFile;
+	if (!looseFile.Open(filePath))
+	{
+		return false;
+	}
+
+	return DecodeImageRGBA8(looseFile.GetData(), looseFile.GetSize(), outImage);
+}
@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tightly packed RGBA8 texels, bottom row first like the engine's Image, so rows and texel coordinates carry over from it
+//------------------------------------------------------------------------------------------------------------------------------
+struct DecodedImageT
+{
+	uint								width = 0U;
+	uint								height = 0U;
+	std::vector<unsigned char>			texels;
+
+	size_t								GetRowPitch() const { return (size_t)width * 4U; }
+	const unsigned char*				GetRow( uint y ) const { return texels.data() + (size_t)y * GetRowPitch(); }
+};
+
+//Any format stb_image reads, expanded to RGBA8. Safe from job workers
+bool	DecodeImageRGBA8( const unsigned char* fileBytes, size_t byteCount, DecodedImageT& outImage );
+//From the mounted pack, else the loose file, which is only mapped while it decodes
+bool	DecodeImageFileRGBA8( const std::string& filePath, DecodedImageT& outImage );
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/JobDeque.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobDeque::JobRingT::JobRingT( int64_t capacity )
+	: m_capacity(capacity),
+	m_mask(capacity - 1),
+	m_slots(new std::atomic<ScheduledJob*>[(size_t)capacity])
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobDeque::JobDeque( int64_t initialCapacity )
+	: m_top(0),
+	m_bottom(0)
+{
+	//Capacity has to be a power of two for the index mask
+	int64_t capacity = 1;
+	while (capacity < initialCapacity)
+	{
+		capacity <<= 1;
+	}
+
+	m_rings.emplace_back(new JobRingT(capacity));
+	m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+}
+
+JobDeque::~JobDeque()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobDeque::Push( ScheduledJob* job )
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_acquire);
+	JobRingT* ring = m_ring.load(std::memory_order_relaxed);
+
+	if (bottom - top > ring->m_capacity - 1)
+	{
+		ring = Grow(ring, bottom, top);
+	}
+
+	ring->Put(bottom, job);
+	m_bottom.store(bottom + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ScheduledJob* JobDeque::Pop()
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	JobRingT* ring = m_ring.load(std::memory_order_relaxed);
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		//Empty
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	ScheduledJob* job = ring->Get(bottom);
+	if (top == bottom)
+	{
+		//Last job, race the thieves for it
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ScheduledJob* JobDeque::Steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	JobRingT* ring = m_ring.load(std::memory_order_acquire);
+	ScheduledJob* job = ring->Get(top);
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		//Lost to the owner or another thief
+		return nullptr;
+	}
+
+	return job;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool JobDeque::IsEmpty() const
+{
+	return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobDeque::JobRingT* JobDeque::Grow( JobRingT* ring, int64_t bottom, int64_t top )
+{
+	JobRingT* grownRing = new JobRingT(ring->m_capacity * 2);
+	for (int64_t index = top; index < bottom; ++index)
+	{
+		grownRing->Put(index, ring->Get(index));
+	}
+
+	m_rings.emplace_back(grownRing);
+	m_ring.store(grownRing, std::memory_order_release);
+	return grownRing;
+}
@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class ScheduledJob;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Chase-Lev work stealing deque (with the memory orderings from Le et al. 2013). The owning thread pushes and pops at the
+// bottom without locks; any other thread may steal from the top, which only costs a CAS when it races the owner for the
+// last job. The ring grows when full; retired rings stay alive until the deque is destroyed since a thief may still read one.
+//------------------------------------------------------------------------------------------------------------------------------
+class JobDeque
+{
+public:
+	explicit JobDeque( int64_t initialCapacity = 1024 );
+	~JobDeque();
+
+	//Owner thread only
+	void								Push( ScheduledJob* job );
+	ScheduledJob*						Pop();
+
+	//Any thread
+	ScheduledJob*						Steal();
+	bool								IsEmpty() const;
+
+private:
+	struct JobRingT
+	{
+		explicit JobRingT( int64_t capacity );
+
+		ScheduledJob*					Get( int64_t index ) const { return m_slots[index & m_mask].load(std::memory_order_relaxed); }
+		void							Put( int64_t index, ScheduledJob* job ) { m_slots[index & m_mask].store(job, std::memory_order_relaxed); }
+
+		int64_t							m_capacity = 0;
+		int64_t							m_mask = 0;
+		std::unique_ptr<std::atomic<ScheduledJob*>[]>	m_slots;
+	};
+
+	JobRingT*							Grow( JobRingT* ring, int64_t bottom, int64_t top );
+
+private:
+	alignas(64) std::atomic<int64_t>	m_top;
+	alignas(64) std::atomic<int64_t>	m_bottom;
+	std::atomic<JobRingT*>				m_ring;
+
+	//Owner thread only
+	std::vector<std::unique_ptr<JobRingT>>	m_rings;
+};
@@ -0,0 +1,551 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/JobScheduler.hpp"
+//Engine Systems
+#include "Engine/Core/Time.hpp"
+
+JobScheduler* g_jobScheduler = nullptr;
+
+//Slot index used for threads that do not own a deque
+constexpr uint INVALID_JOB_SLOT = 0xFFFFFFFFU;
+//Failed find attempts before an idle worker goes to sleep
+constexpr uint JOB_WORKER_SPIN_COUNT = 64U;
+//Upper bound on how long a sleeping worker ignores new work if a wake up is ever missed
+constexpr int JOB_WORKER_SLEEP_MS = 10;
+
+static thread_local JobScheduler* t_jobScheduler = nullptr;
+static thread_local uint t_jobSlotIndex = INVALID_JOB_SLOT;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Splits itself in half (dispatching the upper half) until it is down to grain size, so the range spreads across workers
+// through stealing instead of being pushed one chunk at a time from the calling thread.
+//------------------------------------------------------------------------------------------------------------------------------
+class ParallelForJob : public ScheduledJob
+{
+public:
+	ParallelForJob( JobScheduler* scheduler, uint begin, uint end, uint grainSize, const std::function<void(uint, uint)>* body, JobCounter* counter )
+		: m_owningScheduler(scheduler),
+		m_begin(begin),
+		m_end(end),
+		m_grainSize(grainSize),
+		m_body(body),
+		m_batchCounter(counter)
+	{
+		SetCounter(counter);
+	}
+
+	virtual void Execute() override
+	{
+		while (m_end - m_begin > m_grainSize)
+		{
+			uint middle = m_begin + (m_end - m_begin) / 2U;
+			m_owningScheduler->Dispatch(new ParallelForJob(m_owningScheduler, middle, m_end, m_grainSize, m_body, m_batchCounter));
+			m_end = middle;
+		}
+
+		(*m_body)(m_begin, m_end);
+	}
+
+private:
+	JobScheduler*						m_owningScheduler = nullptr;
+	uint								m_begin = 0U;
+	uint								m_end = 0U;
+	uint								m_grainSize = 1U;
+	const std::function<void(uint, uint)>*	m_body = nullptr;
+	JobCounter*							m_batchCounter = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+ScheduledJob::ScheduledJob()
+	: m_predecessorCount(1)
+{
+}
+
+ScheduledJob::~ScheduledJob()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ScheduledJob::AddSuccessor( ScheduledJob* successor )
+{
+	successor->m_predecessorCount.fetch_add(1, std::memory_order_relaxed);
+	m_successors.push_back(successor);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ScheduledJob::SetCounter( JobCounter* counter )
+{
+	m_counter = counter;
+	m_counter->m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ScheduledJob::Dispatch()
+{
+	g_jobScheduler->Dispatch(this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+FunctionJob::FunctionJob( const std::function<void()>& function, eJobAffinity affinity )
+	: m_function(function)
+{
+	SetAffinity(affinity);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FunctionJob::Execute()
+{
+	m_function();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+JobScheduler::JobScheduler( uint workerCount )
+	: m_workerCount(workerCount),
+	m_isRunning(false),
+	m_injectedCount(0U),
+	m_externalExecutedCount(0U),
+	m_sleepingWorkers(0U),
+	m_wakeGeneration(0U)
+{
+	if (m_workerCount == 0U)
+	{
+		m_workerCount = GetDefaultWorkerCount();
+	}
+}
+
+JobScheduler::~JobScheduler()
+{
+	Shutdown();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint JobScheduler::GetDefaultWorkerCount()
+{
+	//Leave the main thread its own core. hardware_concurrency is 0 when it cannot tell
+	uint coreCount = std::thread::hardware_concurrency();
+	return (coreCount > 1U) ? coreCount - 1U : 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::Startup()
+{
+	if (m_isRunning)
+	{
+		return;
+	}
+
+	for (uint slotIndex = 0; slotIndex <= m_workerCount; ++slotIndex)
+	{
+		m_slots.emplace_back(new WorkerSlotT());
+	}
+
+	m_previousOwnerScheduler = t_jobScheduler;
+	m_previousOwnerSlotIndex = t_jobSlotIndex;
+	t_jobScheduler = this;
+	t_jobSlotIndex = 0U;
+
+	m_isRunning = true;
+	for (uint workerIndex = 0; workerIndex < m_workerCount; ++workerIndex)
+	{
+		m_workers.emplace_back(&JobScheduler::WorkerThreadMain, this, workerIndex + 1U);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Jobs still queued at shutdown are cancelled without running: their counters are released so nobody waits on them forever,
+// and successors they were the last hold on are cancelled with them. The renderer and the game are gone by now, MAIN and
+// RENDER jobs in particular could not run safely.
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::Shutdown()
+{
+	if (!m_isRunning)
+	{
+		return;
+	}
+
+	m_isRunning = false;
+	{
+		std::lock_guard<std::mutex> lock(m_sleepLock);
+	}
+	m_wakeSignal.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	//The workers are gone so this thread can pop from every deque
+	for (std::unique_ptr<WorkerSlotT>& slot : m_slots)
+	{
+		while (ScheduledJob* job = slot->deque.Pop())
+		{
+			CancelJob(job);
+		}
+	}
+	m_slots.clear();
+
+	for (ScheduledJob* job : m_injectedJobs)
+	{
+		CancelJob(job);
+	}
+	m_injectedJobs.clear();
+	m_injectedCount = 0U;
+
+	for (uint affinity = 0; affinity < NUM_JOB_AFFINITIES; ++affinity)
+	{
+		for (ScheduledJob* job : m_affinityJobs[affinity])
+		{
+			CancelJob(job);
+		}
+		m_affinityJobs[affinity].clear();
+	}
+
+	if (t_jobScheduler == this)
+	{
+		t_jobScheduler = m_previousOwnerScheduler;
+		t_jobSlotIndex = m_previousOwnerSlotIndex;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::Dispatch( ScheduledJob* job )
+{
+	job->m_scheduler = this;
+
+	//Drop the dispatch hold; if every predecessor is already done the job is ready now
+	if (job->m_predecessorCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		Enqueue(job);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint JobScheduler::ProcessAffinityForTimeInMS( eJobAffinity affinity, double maxMS )
+{
+	double endTime = GetCurrentTimeSeconds() + maxMS * 0.001;
+	uint processedCount = 0U;
+
+	uint slotIndex = INVALID_JOB_SLOT;
+	IsOwnedByCallingThread(slotIndex);
+
+	while (ScheduledJob* job = PopAffinityJob(affinity))
+	{
+		ExecuteJob(job, slotIndex);
+		processedCount++;
+
+		if (GetCurrentTimeSeconds() >= endTime)
+		{
+			break;
+		}
+	}
+
+	return processedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::WaitForCounter( const JobCounter& counter )
+{
+	uint slotIndex = INVALID_JOB_SLOT;
+	bool isOwner = IsOwnedByCallingThread(slotIndex);
+	uint32_t randomState = 0x9E3779B9U;
+
+	while (!counter.IsDone())
+	{
+		ScheduledJob* job = FindJob(slotIndex, randomState);
+
+		//The main thread is the only one allowed to run MAIN and RENDER jobs
+		if (job == nullptr && isOwner && slotIndex == 0U)
+		{
+			job = PopAffinityJob(JOB_AFFINITY_MAIN);
+			if (job == nullptr)
+			{
+				job = PopAffinityJob(JOB_AFFINITY_RENDER);
+			}
+		}
+
+		if (job != nullptr)
+		{
+			ExecuteJob(job, slotIndex);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::ParallelFor( uint begin, uint end, uint grainSize, const std::function<void(uint, uint)>& body )
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	JobCounter counter;
+	Dispatch(new ParallelForJob(this, begin, end, (grainSize > 0U) ? grainSize : 1U, &body, &counter));
+	WaitForCounter(counter);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t JobScheduler::GetExecutedCount() const
+{
+	uint64_t executedCount = m_externalExecutedCount.load(std::memory_order_relaxed);
+	for (const std::unique_ptr<WorkerSlotT>& slot : m_slots)
+	{
+		executedCount += slot->executedCount.load(std::memory_order_relaxed);
+	}
+	return executedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t JobScheduler::GetStealCount() const
+{
+	uint64_t stealCount = 0U;
+	for (const std::unique_ptr<WorkerSlotT>& slot : m_slots)
+	{
+		stealCount += slot->stealCount.load(std::memory_order_relaxed);
+	}
+	return stealCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::WorkerThreadMain( uint slotIndex )
+{
+	t_jobScheduler = this;
+	t_jobSlotIndex = slotIndex;
+
+	uint32_t randomState = 0x9E3779B9U * (slotIndex + 1U);
+	uint idleCount = 0U;
+
+	while (m_isRunning.load(std::memory_order_relaxed))
+	{
+		ScheduledJob* job = FindJob(slotIndex, randomState);
+		if (job != nullptr)
+		{
+			ExecuteJob(job, slotIndex);
+			idleCount = 0U;
+			continue;
+		}
+
+		if (++idleCount < JOB_WORKER_SPIN_COUNT)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		//Read the generation before the last look so a Dispatch racing with us always wakes us back up
+		uint64_t wakeGeneration = m_wakeGeneration.load(std::memory_order_seq_cst);
+		m_sleepingWorkers.fetch_add(1U, std::memory_order_seq_cst);
+
+		job = FindJob(slotIndex, randomState);
+		if (job == nullptr)
+		{
+			std::unique_lock<std::mutex> lock(m_sleepLock);
+			m_wakeSignal.wait_for(lock, std::chrono::milliseconds(JOB_WORKER_SLEEP_MS), [&]()
+			{
+				return !m_isRunning || m_wakeGeneration.load(std::memory_order_seq_cst) != wakeGeneration;
+			});
+		}
+
+		m_sleepingWorkers.fetch_sub(1U, std::memory_order_seq_cst);
+		idleCount = 0U;
+
+		if (job != nullptr)
+		{
+			ExecuteJob(job, slotIndex);
+		}
+	}
+
+	t_jobScheduler = nullptr;
+	t_jobSlotIndex = INVALID_JOB_SLOT;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Own deque first (LIFO, cache warm), then jobs injected from other threads, then steal from a random victim onwards
+//------------------------------------------------------------------------------------------------------------------------------
+ScheduledJob* JobScheduler::FindJob( uint slotIndex, uint32_t& randomState )
+{
+	if (slotIndex != INVALID_JOB_SLOT)
+	{
+		ScheduledJob* job = m_slots[slotIndex]->deque.Pop();
+		if (job != nullptr)
+		{
+			return job;
+		}
+	}
+
+	if (m_injectedCount.load(std::memory_order_acquire) > 0U)
+	{
+		std::lock_guard<std::mutex> lock(m_injectLock);
+		if (!m_injectedJobs.empty())
+		{
+			ScheduledJob* job = m_injectedJobs.front();
+			m_injectedJobs.pop_front();
+			m_injectedCount.fetch_sub(1U, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	//xorshift32
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+
+	uint slotCount = (uint)m_slots.size();
+	uint firstVictim = randomState % slotCount;
+	for (uint victimOffset = 0; victimOffset < slotCount; ++victimOffset)
+	{
+		uint victimIndex = (firstVictim + victimOffset) % slotCount;
+		if (victimIndex == slotIndex)
+		{
+			continue;
+		}
+
+		ScheduledJob* job = m_slots[victimIndex]->deque.Steal();
+		if (job != nullptr)
+		{
+			if (slotIndex != INVALID_JOB_SLOT)
+			{
+				m_slots[slotIndex]->stealCount.fetch_add(1U, std::memory_order_relaxed);
+			}
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ScheduledJob* JobScheduler::PopAffinityJob( eJobAffinity affinity )
+{
+	std::lock_guard<std::mutex> lock(m_affinityLock);
+
+	std::deque<ScheduledJob*>& jobs = m_affinityJobs[affinity];
+	if (jobs.empty())
+	{
+		return nullptr;
+	}
+
+	ScheduledJob* job = jobs.front();
+	jobs.pop_front();
+	return job;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::Enqueue( ScheduledJob* job )
+{
+	if (job->m_affinity != JOB_AFFINITY_ANY)
+	{
+		std::lock_guard<std::mutex> lock(m_affinityLock);
+		m_affinityJobs[job->m_affinity].push_back(job);
+		return;
+	}
+
+	uint slotIndex = INVALID_JOB_SLOT;
+	if (IsOwnedByCallingThread(slotIndex))
+	{
+		m_slots[slotIndex]->deque.Push(job);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_injectLock);
+		m_injectedJobs.push_back(job);
+		m_injectedCount.fetch_add(1U, std::memory_order_release);
+	}
+
+	WakeWorkers();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::ExecuteJob( ScheduledJob* job, uint slotIndex )
+{
+	job->Execute();
+
+	for (ScheduledJob* successor : job->m_successors)
+	{
+		if (successor->m_predecessorCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			successor->m_scheduler = this;
+			Enqueue(successor);
+		}
+	}
+
+	if (job->m_counter != nullptr)
+	{
+		job->m_counter->m_count.fetch_sub(1, std::memory_order_release);
+	}
+
+	if (slotIndex != INVALID_JOB_SLOT)
+	{
+		std::atomic<uint64_t>& executedCount = m_slots[slotIndex]->executedCount;
+		executedCount.store(executedCount.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+	}
+	else
+	{
+		m_externalExecutedCount.fetch_add(1U, std::memory_order_relaxed);
+	}
+
+	delete job;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Does everything ExecuteJob does after Execute, except that ready successors are cancelled instead of queued
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::CancelJob( ScheduledJob* job )
+{
+	std::vector<ScheduledJob*> cancelledJobs;
+	cancelledJobs.push_back(job);
+
+	while (!cancelledJobs.empty())
+	{
+		ScheduledJob* cancelledJob = cancelledJobs.back();
+		cancelledJobs.pop_back();
+
+		for (ScheduledJob* successor : cancelledJob->m_successors)
+		{
+			if (successor->m_predecessorCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				cancelledJobs.push_back(successor);
+			}
+		}
+
+		if (cancelledJob->m_counter != nullptr)
+		{
+			cancelledJob->m_counter->m_count.fetch_sub(1, std::memory_order_release);
+		}
+
+		delete cancelledJob;
+		m_cancelledCount++;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void JobScheduler::WakeWorkers()
+{
+	//Only touch shared state when somebody is actually asleep, pushes stay contention free under load
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_sleepingWorkers.load(std::memory_order_relaxed) == 0U)
+	{
+		return;
+	}
+
+	m_wakeGeneration.fetch_add(1U, std::memory_order_seq_cst);
+	{
+		std::lock_guard<std::mutex> lock(m_sleepLock);
+	}
+	m_wakeSignal.notify_one();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool JobScheduler::IsOwnedByCallingThread( uint& outSlotIndex ) const
+{
+	if (t_jobScheduler != this)
+	{
+		outSlotIndex = INVALID_JOB_SLOT;
+		return false;
+	}
+
+	outSlotIndex = t_jobSlotIndex;
+	return true;
+}
@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/JobDeque.hpp"
+//Third Party
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobScheduler;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Work stealing scheduler for fine grained game jobs. Every worker owns a JobDeque; jobs dispatched from a worker go to its
+// own deque and idle workers steal from the others, so there is no shared queue to contend on. The thread that calls
+// Startup (the main thread) owns a deque as well and helps out while it waits on a JobCounter.
+//
+// Affinities match the JobSystem categories: ANY runs on the worker pool, MAIN and RENDER jobs are queued until the main
+// thread processes them (App::BeginFrame), same as JOB_MAIN / JOB_RENDER.
+//------------------------------------------------------------------------------------------------------------------------------
+enum eJobAffinity
+{
+	JOB_AFFINITY_ANY = 0,
+	JOB_AFFINITY_MAIN,
+	JOB_AFFINITY_RENDER,
+
+	NUM_JOB_AFFINITIES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Counts outstanding jobs so a thread can wait on a batch of them
+//------------------------------------------------------------------------------------------------------------------------------
+class JobCounter
+{
+public:
+	bool								IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class ScheduledJob;
+	friend class JobScheduler;
+	std::atomic<int>					m_count{0};
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Base job. Allocate with new: once dispatched the scheduler owns the job and deletes it after it (and the release of its
+// successors) has run. Successors and counters have to be set up before the job is dispatched. A job still queued when the
+// scheduler shuts down is deleted without running, its counter is still released.
+//------------------------------------------------------------------------------------------------------------------------------
+class ScheduledJob
+{
+	friend class JobScheduler;
+
+public:
+	ScheduledJob();
+	virtual ~ScheduledJob();
+
+	virtual void						Execute() = 0;
+
+	void								SetAffinity( eJobAffinity affinity ) { m_affinity = affinity; }
+	eJobAffinity						GetAffinity() const { return m_affinity; }
+
+	//The successor will not be queued until this job and every other predecessor finished
+	void								AddSuccessor( ScheduledJob* successor );
+	void								SetCounter( JobCounter* counter );
+
+	void								Dispatch();
+
+private:
+	eJobAffinity						m_affinity = JOB_AFFINITY_ANY;
+	JobScheduler*						m_scheduler = nullptr;
+	JobCounter*							m_counter = nullptr;
+
+	//Starts at 1 for the Dispatch call itself
+	std::atomic<int>					m_predecessorCount;
+	std::vector<ScheduledJob*>			m_successors;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class FunctionJob : public ScheduledJob
+{
+public:
+	explicit FunctionJob( const std::function<void()>& function, eJobAffinity affinity = JOB_AFFINITY_ANY );
+
+	virtual void						Execute() override;
+
+private:
+	std::function<void()>				m_function;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class JobScheduler
+{
+public:
+	//No worker count means GetDefaultWorkerCount
+	explicit JobScheduler( uint workerCount = 0U );
+	~JobScheduler();
+
+	//One per core but the main thread's, never less than one
+	static uint							GetDefaultWorkerCount();
+
+	void								Startup();
+	void								Shutdown();
+
+	void								Dispatch( ScheduledJob* job );
+
+	//Runs queued MAIN or RENDER jobs on the calling thread until the time runs out or the queue is empty
+	uint								ProcessAffinityForTimeInMS( eJobAffinity affinity, double maxMS );
+
+	//Helps execute jobs until the counter reaches zero. The Startup thread also runs MAIN/RENDER jobs while it waits
+	void								WaitForCounter( const JobCounter& counter );
+
+	//Splits [begin, end) recursively into chunks of at most grainSize and waits for all of them
+	void								ParallelFor( uint begin, uint end, uint grainSize, const std::function<void(uint, uint)>& body );
+
+	uint								GetWorkerCount() const { return m_workerCount; }
+	uint64_t							GetExecutedCount() const;
+	uint64_t							GetStealCount() const;
+	//Jobs Shutdown found still queued, or waiting on one of them, and deleted without running
+	uint64_t							GetCancelledCount() const { return m_cancelledCount; }
+
+private:
+	void								WorkerThreadMain( uint slotIndex );
+	ScheduledJob*						FindJob( uint slotIndex, uint32_t& randomState );
+	ScheduledJob*						PopAffinityJob( eJobAffinity affinity );
+	void								Enqueue( ScheduledJob* job );
+	void								ExecuteJob( ScheduledJob* job, uint slotIndex );
+	void								CancelJob( ScheduledJob* job );
+	void								WakeWorkers();
+	bool								IsOwnedByCallingThread( uint& outSlotIndex ) const;
+
+private:
+	uint								m_workerCount = 0U;
+	std::atomic<bool>					m_isRunning;
+
+	//Index 0 belongs to the Startup thread, 1..m_workerCount to the workers. Counters are per slot so they do not false share
+	struct WorkerSlotT
+	{
+		JobDeque						deque;
+		alignas(64) std::atomic<uint64_t>	executedCount{0U};
+		std::atomic<uint64_t>			stealCount{0U};
+	};
+	std::vector<std::unique_ptr<WorkerSlotT>>	m_slots;
+	std::vector<std::thread>			m_workers;
+
+	//Jobs dispatched from threads that do not own a deque
+	std::mutex							m_injectLock;
+	std::deque<ScheduledJob*>			m_injectedJobs;
+	std::atomic<uint>					m_injectedCount;
+	std::atomic<uint64_t>				m_externalExecutedCount;
+
+	//MAIN and RENDER jobs
+	std::mutex							m_affinityLock;
+	std::deque<ScheduledJob*>			m_affinityJobs[NUM_JOB_AFFINITIES];
+
+	//Idle workers sleep here; m_wakeGeneration changes whenever new work shows up
+	std::mutex							m_sleepLock;
+	std::condition_variable				m_wakeSignal;
+	std::atomic<uint>					m_sleepingWorkers;
+	std::atomic<uint64_t>				m_wakeGeneration;
+
+	uint64_t							m_cancelledCount = 0U;
+
+	//Restored on Shutdown so a temporary scheduler (benchmarks, tests) does not steal the main thread from g_jobScheduler
+	JobScheduler*						m_previousOwnerScheduler = nullptr;
+	uint								m_previousOwnerSlotIndex = 0U;
+};
+
+extern JobScheduler* g_jobScheduler;
@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/LightClusterGrid.hpp"
+//Game Systems
+#include "Game/JobScheduler.hpp"
+//Third Party
+#include <math.h>
+#include <string.h>
+
+//Few enough jobs that a handful of lights is not all overhead
+constexpr uint LIGHTS_PER_BOUND_JOB = 256U;
+constexpr float LIGHT_CLUSTER_DEGREES_TO_RADIANS = 3.14159265f / 180.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+float ComputeLightRadius( float intensity, const Vec3& attenuation, float cutoff )
+{
+	if (intensity <= 0.f || cutoff <= 0.f)
+	{
+		return 0.f;
+	}
+
+	//Out to where the attenuation denominator reaches intensity / cutoff
+	float target = intensity / cutoff;
+	if (attenuation.x >= target)
+	{
+		return 0.f;
+	}
+
+	if (attenuation.z > 0.f)
+	{
+		float discriminant = attenuation.y * attenuation.y - 4.f * attenuation.z * (attenuation.x - target);
+		return (-attenuation.y + sqrtf(discriminant)) / (2.f * attenuation.z);
+	}
+
+	if (attenuation.y > 0.f)
+	{
+		return (target - attenuation.x) / attenuation.y;
+	}
+
+	return LIGHT_RADIUS_UNBOUNDED;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tile boundary b is the plane through the eye at NDC -1 + 2b / tileCount. Stored as the two coefficients of its unit normal
+// in (lateral, depth), so a distance is lateral * a + depth * b, positive towards the higher tiles
+//------------------------------------------------------------------------------------------------------------------------------
+static void ComputeTilePlanes( float tanHalfFov, uint tileCount, std::vector<float>& outPlanes )
+{
+	outPlanes.resize((tileCount + 1U) * 2U);
+	for (uint boundary = 0; boundary <= tileCount; ++boundary)
+	{
+		float slope = (-1.f + 2.f * (float)boundary / (float)tileCount) * tanHalfFov;
+		float inverseLength = 1.f / sqrtf(1.f + slope * slope);
+		outPlanes[boundary * 2U] = inverseLength;
+		outPlanes[boundary * 2U + 1U] = -slope * inverseLength;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The tiles along one screen axis a view space sphere touches
+//------------------------------------------------------------------------------------------------------------------------------
+static void FindTileRange( float lateral, float depth, float radius, const std::vector<float>& planes, uint16_t& outMin, uint16_t& outMax, bool& outIsVisible )
+{
+	int minTile = -1;
+	int maxTile = -1;
+
+	uint boundaryCount = (uint)planes.size() / 2U;
+	float lowDistance = 0.f;
+	for (uint boundary = 0; boundary < boundaryCount; ++boundary)
+	{
+		float distance = lateral * planes[boundary * 2U] + depth * planes[boundary * 2U + 1U];
+
+		//The tile before this boundary touches the sphere if the sphere reaches past both of its sides
+		if (boundary > 0U && lowDistance >= -radius && distance <= radius)
+		{
+			int tile = (int)boundary - 1;
+			minTile = (minTile < 0) ? tile : minTile;
+			maxTile = tile;
+		}
+		lowDistance = distance;
+	}
+
+	outIsVisible = outIsVisible && minTile >= 0;
+	outMin = (uint16_t)((minTile < 0) ? 0 : minTile);
+	outMax = (uint16_t)((maxTile < 0) ? 0 : maxTile);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+LightClusterGrid::LightClusterGrid( uint tileCountX, uint tileCountY, uint sliceCount )
+	: m_tileCountX(tileCountX),
+	m_tileCountY(tileCountY),
+	m_sliceCount(sliceCount)
+{
+	m_clusters.resize((size_t)m_tileCountX * m_tileCountY * m_sliceCount);
+	m_sliceIndices.resize(m_sliceCount);
+	m_sliceLights.resize(m_sliceCount);
+}
+
+LightClusterGrid::~LightClusterGrid()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::Build( const LightClusterViewT& view, const Vec3* positions, const float* radii, uint lightCount, JobScheduler* scheduler )
+{
+	m_view = view;
+	m_tanHalfFovY = tanf(view.fovDegrees * 0.5f * LIGHT_CLUSTER_DEGREES_TO_RADIANS);
+	m_tanHalfFovX = m_tanHalfFovY * view.aspect;
+	ComputeTilePlanes(m_tanHalfFovX, m_tileCountX, m_tilePlanesX);
+	ComputeTilePlanes(m_tanHalfFovY, m_tileCountY, m_tilePlanesY);
+
+	float logDepthRange = logf(view.farZ / view.nearZ);
+	m_sliceScale = (float)m_sliceCount / logDepthRange;
+	m_sliceBias = -(float)m_sliceCount * logf(view.nearZ) / logDepthRange;
+
+	m_lightBounds.resize(lightCount);
+	if (scheduler != nullptr && lightCount > LIGHTS_PER_BOUND_JOB)
+	{
+		scheduler->ParallelFor(0U, lightCount, LIGHTS_PER_BOUND_JOB, [this, positions, radii](uint beginLight, uint endLight)
+		{
+			BoundLights(beginLight, endLight, positions, radii);
+		});
+	}
+	else
+	{
+		BoundLights(0U, lightCount, positions, radii);
+	}
+
+	//Each slice gets the lights that reach it, so filling a slice never looks at the rest
+	m_visibleLightCount = 0U;
+	for (std::vector<uint32_t>& sliceLights : m_sliceLights)
+	{
+		sliceLights.clear();
+	}
+	for (uint lightIndex = 0; lightIndex < lightCount; ++lightIndex)
+	{
+		const LightBoundsT& bounds = m_lightBounds[lightIndex];
+		for (uint slice = bounds.minSlice; slice <= bounds.maxSlice; ++slice)
+		{
+			m_sliceLights[slice].push_back(lightIndex);
+		}
+		m_visibleLightCount += (bounds.minSlice <= bounds.maxSlice) ? 1U : 0U;
+	}
+
+	//Each slice owns its clusters and its part of the list, so slices fill without sharing anything
+	if (scheduler != nullptr)
+	{
+		scheduler->ParallelFor(0U, m_sliceCount, 1U, [this](uint beginSlice, uint endSlice)
+		{
+			for (uint slice = beginSlice; slice < endSlice; ++slice)
+			{
+				FillSlice(slice);
+			}
+		});
+	}
+	else
+	{
+		for (uint slice = 0; slice < m_sliceCount; ++slice)
+		{
+			FillSlice(slice);
+		}
+	}
+
+	//Slices are laid end to end in slice order, then each rebases its clusters onto where it landed
+	size_t indexCount = 0U;
+	for (const std::vector<uint32_t>& sliceIndices : m_sliceIndices)
+	{
+		indexCount += sliceIndices.size();
+	}
+	m_lightIndices.resize(indexCount);
+
+	uint32_t sliceStart = 0U;
+	uint tilesPerSlice = m_tileCountX * m_tileCountY;
+	for (uint slice = 0; slice < m_sliceCount; ++slice)
+	{
+		const std::vector<uint32_t>& sliceIndices = m_sliceIndices[slice];
+		if (!sliceIndices.empty())
+		{
+			memcpy(m_lightIndices.data() + sliceStart, sliceIndices.data(), sliceIndices.size() * sizeof(uint32_t));
+		}
+
+		LightClusterT* clusters = m_clusters.data() + (size_t)slice * tilesPerSlice;
+		for (uint tileIndex = 0; tileIndex < tilesPerSlice; ++tileIndex)
+		{
+			clusters[tileIndex].offset += sliceStart;
+		}
+		sliceStart += (uint32_t)sliceIndices.size();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetSliceForDepth( float viewDepth ) const
+{
+	if (viewDepth < m_view.nearZ)
+	{
+		return -1;
+	}
+	if (viewDepth >= m_view.farZ)
+	{
+		return (int)m_sliceCount;
+	}
+
+	int slice = (int)floorf(logf(viewDepth) * m_sliceScale + m_sliceBias);
+	return (slice < 0) ? 0 : ((slice >= (int)m_sliceCount) ? (int)m_sliceCount - 1 : slice);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BoundLights( uint beginLight, uint endLight, const Vec3* positions, const float* radii )
+{
+	for (uint lightIndex = beginLight; lightIndex < endLight; ++lightIndex)
+	{
+		LightBoundsT bounds;
+		float radius = radii[lightIndex];
+		if (radius <= 0.f)
+		{
+			m_lightBounds[lightIndex] = bounds;
+			continue;
+		}
+
+		Vec3 offset = positions[lightIndex] - m_view.position;
+		float viewX = offset.x * m_view.right.x + offset.y * m_view.right.y + offset.z * m_view.right.z;
+		float viewY = offset.x * m_view.up.x + offset.y * m_view.up.y + offset.z * m_view.up.z;
+		float viewZ = offset.x * m_view.forward.x + offset.y * m_view.forward.y + offset.z * m_view.forward.z;
+
+		bool isVisible = (viewZ + radius >= m_view.nearZ) && (viewZ - radius < m_view.farZ);
+		if (isVisible)
+		{
+			FindTileRange(viewX, viewZ, radius, m_tilePlanesX, bounds.minX, bounds.maxX, isVisible);
+			//Tile rows count down from the top of the screen, like pixel rows
+			FindTileRange(-viewY, viewZ, radius, m_tilePlanesY, bounds.minY, bounds.maxY, isVisible);
+		}
+
+		if (isVisible)
+		{
+			float nearDepth = (viewZ - radius > m_view.nearZ) ? viewZ - radius : m_view.nearZ;
+			int lastSlice = GetSliceForDepth(viewZ + radius);
+			bounds.minSlice = (uint16_t)GetSliceForDepth(nearDepth);
+			bounds.maxSlice = (uint16_t)((lastSlice >= (int)m_sliceCount) ? (int)m_sliceCount - 1 : lastSlice);
+		}
+
+		m_lightBounds[lightIndex] = bounds;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Counts per cluster, turns the counts into offsets, then uses the counts again as write cursors. Lights stay in index order
+// within a cluster
+//------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::FillSlice( uint slice )
+{
+	LightClusterT* clusters = m_clusters.data() + (size_t)slice * m_tileCountX * m_tileCountY;
+	uint tilesPerSlice = m_tileCountX * m_tileCountY;
+	for (uint tileIndex = 0; tileIndex < tilesPerSlice; ++tileIndex)
+	{
+		clusters[tileIndex] = LightClusterT();
+	}
+
+	const std::vector<uint32_t>& sliceLights = m_sliceLights[slice];
+	for (uint32_t lightIndex : sliceLights)
+	{
+		const LightBoundsT& bounds = m_lightBounds[lightIndex];
+		for (uint tileY = bounds.minY; tileY <= bounds.maxY; ++tileY)
+		{
+			for (uint tileX = bounds.minX; tileX <= bounds.maxX; ++tileX)
+			{
+				clusters[tileY * m_tileCountX + tileX].count++;
+			}
+		}
+	}
+
+	uint32_t offset = 0U;
+	for (uint tileIndex = 0; tileIndex < tilesPerSlice; ++tileIndex)
+	{
+		clusters[tileIndex].offset = offset;
+		offset += clusters[tileIndex].count;
+		clusters[tileIndex].count = 0U;
+	}
+
+	std::vector<uint32_t>& sliceIndices = m_sliceIndices[slice];
+	sliceIndices.resize(offset);
+	for (uint32_t lightIndex : sliceLights)
+	{
+		const LightBoundsT& bounds = m_lightBounds[lightIndex];
+		for (uint tileY = bounds.minY; tileY <= bounds.maxY; ++tileY)
+		{
+			for (uint tileX = bounds.minX; tileX <= bounds.maxX; ++tileX)
+			{
+				LightClusterT& cluster = clusters[tileY * m_tileCountX + tileX];
+				sliceIndices[cluster.offset + cluster.count++] = lightIndex;
+			}
+		}
+	}
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Third Party
+#include <stdint.h>
+#include <vector>
+
+class JobScheduler;
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Light below 1/256 of full brightness no longer changes an 8 bit channel
+constexpr float LIGHT_CUTOFF_BRIGHTNESS = 1.f / 256.f;
+//Returned for constant attenuation, which never falls off
+constexpr float LIGHT_RADIUS_UNBOUNDED = 1e30f;
+
+//Distance at which intensity / (a.x + a.y * d + a.z * d^2) drops to the cutoff, 0 if it never reaches it
+float	ComputeLightRadius( float intensity, const Vec3& attenuation, float cutoff = LIGHT_CUTOFF_BRIGHTNESS );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The camera the grid is built for: the camera model's bases and the perspective it was given
+//------------------------------------------------------------------------------------------------------------------------------
+struct LightClusterViewT
+{
+	Vec3								position;
+	Vec3								right = Vec3(1.f, 0.f, 0.f);
+	Vec3								up = Vec3(0.f, 1.f, 0.f);
+	Vec3								forward = Vec3(0.f, 0.f, 1.f);
+	//Vertical, as Camera::SetPerspectiveProjection takes it
+	float								fovDegrees = 60.f;
+	float								aspect = 1.f;
+	float								nearZ = 0.1f;
+	float								farZ = 100.f;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One froxel's run in the light index list
+//------------------------------------------------------------------------------------------------------------------------------
+struct LightClusterT
+{
+	uint32_t							offset = 0U;
+	uint32_t							count = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// CPU clustered light assignment. The view frustum is cut into screen tiles and exponential depth slices (froxels) and every
+// light's bounding sphere is binned into the froxels it touches, giving per froxel an offset and count into one compact list
+// of light indices. A lit pixel would then only walk the lights of its own froxel instead of every light in the scene. Nothing
+// binds the result yet: the engine's RenderContext cannot bind structured buffers, so this is the CPU half plus the
+// LightClusterBenchmark console command that times it.
+//
+// Tiles are tested against the planes through the eye, slices against the sphere's depth range, so the assignment is
+// conservative: a light can land in a froxel its sphere misses near a corner, never the other way round. Lights are binned in
+// parallel, then each slice fills its own part of the list, so the result is the same with or without a scheduler.
+//------------------------------------------------------------------------------------------------------------------------------
+class LightClusterGrid
+{
+public:
+	explicit LightClusterGrid( uint tileCountX = 16U, uint tileCountY = 9U, uint sliceCount = 24U );
+	~LightClusterGrid();
+
+	//Lights are spheres in world space; a radius of 0 or less drops the light. Indices in the list are into these arrays
+	void								Build( const LightClusterViewT& view, const Vec3* positions, const float* radii, uint lightCount, JobScheduler* scheduler = nullptr );
+
+	const std::vector<LightClusterT>&	GetClusters() const { return m_clusters; }
+	const std::vector<uint32_t>&		GetLightIndices() const { return m_lightIndices; }
+	uint								GetClusterIndex( uint tileX, uint tileY, uint slice ) const { return (slice * m_tileCountY + tileY) * m_tileCountX + tileX; }
+	//-1 in front of the near plane, sliceCount past the far plane
+	int									GetSliceForDepth( float viewDepth ) const;
+
+	uint								GetTileCountX() const { return m_tileCountX; }
+	uint								GetTileCountY() const { return m_tileCountY; }
+	uint								GetSliceCount() const { return m_sliceCount; }
+	uint								GetVisibleLightCount() const { return m_visibleLightCount; }
+	//Clusters plus index list, what a frame would upload
+	size_t								GetUploadBytes() const { return m_clusters.size() * sizeof(LightClusterT) + m_lightIndices.size() * sizeof(uint32_t); }
+
+private:
+	//Inclusive froxel bounds of one light, minSlice > maxSlice when it is outside the frustum
+	struct LightBoundsT
+	{
+		uint16_t						minX = 0U;
+		uint16_t						maxX = 0U;
+		uint16_t						minY = 0U;
+		uint16_t						maxY = 0U;
+		uint16_t						minSlice = 1U;
+		uint16_t						maxSlice = 0U;
+	};
+
+	void								BoundLights( uint beginLight, uint endLight, const Vec3* positions, const float* radii );
+	void								FillSlice( uint slice );
+
+private:
+	uint								m_tileCountX = 0U;
+	uint								m_tileCountY = 0U;
+	uint								m_sliceCount = 0U;
+
+	LightClusterViewT					m_view;
+	float								m_tanHalfFovX = 1.f;
+	float								m_tanHalfFovY = 1.f;
+	std::vector<float>					m_tilePlanesX;
+	std::vector<float>					m_tilePlanesY;
+	float								m_sliceScale = 0.f;
+	float								m_sliceBias = 0.f;
+
+	std::vector<LightBoundsT>			m_lightBounds;
+	uint								m_visibleLightCount = 0U;
+	//Per slice, the lights whose depth range covers it
+	std::vector<std::vector<uint32_t>>	m_sliceLights;
+
+	//Per slice, the slice's part of the index list with cluster offsets relative to its start
+	std::vector<std::vector<uint32_t>>	m_sliceIndices;
+	std::vector<LightClusterT>			m_clusters;
+	std::vector<uint32_t>				m_lightIndices;
+};
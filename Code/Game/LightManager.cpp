@@ -0,0 +1,315 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/LightManager.hpp"
+//Game Systems
+#include "Game/LightClusterGrid.hpp"
+#include "Game/RenderRecorder.hpp"
+
+LightManager* g_lightManager = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A light that would add nothing to any pixel
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsLightSwitchedOff( const LightDescT& light )
+{
+	if (!light.isEnabled || light.intensity <= 0.f)
+	{
+		return true;
+	}
+
+	if (light.isDirectional)
+	{
+		return false;
+	}
+
+	return ComputeLightRadius(light.intensity, light.diffuseAttenuation) <= 0.f && ComputeLightRadius(light.intensity, light.specularAttenuation) <= 0.f;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsSameVec3( const Vec3& a, const Vec3& b )
+{
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsSameLight( const LightDescT& a, const LightDescT& b )
+{
+	return IsSameVec3(a.position, b.position) && IsSameVec3(a.direction, b.direction)
+		&& a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b && a.color.a == b.color.a
+		&& a.intensity == b.intensity && IsSameVec3(a.diffuseAttenuation, b.diffuseAttenuation)
+		&& IsSameVec3(a.specularAttenuation, b.specularAttenuation) && a.isDirectional == b.isDirectional && a.isEnabled == b.isEnabled;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static LightDescT MakeSwitchedOffLight()
+{
+	LightDescT light;
+	light.intensity = 0.f;
+	light.isEnabled = false;
+	return light;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+LightManager::LightManager( uint slotCount )
+{
+	m_lights.resize(slotCount, MakeSwitchedOffLight());
+	m_submitted.resize(slotCount, MakeSwitchedOffLight());
+	m_handles.Reserve(slotCount);
+	m_dirtyBits.resize((slotCount + 63U) / 64U, 0U);
+	m_freeBits.resize((slotCount + 63U) / 64U, 0U);
+
+	//Whatever the buffer held before us is unknown, the first Submit writes every slot
+	for (uint slot = 0; slot < slotCount; ++slot)
+	{
+		MarkDirty(slot);
+		m_freeBits[slot >> 6] |= 1ULL << (slot & 63U);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+LightManager::~LightManager()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+LightHandle LightManager::CreateLight( const LightDescT& desc )
+{
+	LightHandle handle;
+	uint slot = FindLowestFreeSlot();
+	if (slot >= m_lights.size())
+	{
+		return handle;
+	}
+
+	m_handles.ClaimSlot(slot);
+	m_freeBits[slot >> 6] &= ~(1ULL << (slot & 63U));
+	m_lights[slot] = desc;
+	MarkDirty(slot);
+
+	handle.slot = slot;
+	handle.generation = m_handles.GetGeneration(slot);
+	return handle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::DestroyLight( const LightHandle& handle )
+{
+	if (!IsValid(handle))
+	{
+		return false;
+	}
+
+	m_lights[handle.slot] = MakeSwitchedOffLight();
+	MarkDirty(handle.slot);
+	m_handles.FreeSlot(handle.slot);
+	m_freeBits[handle.slot >> 6] |= 1ULL << (handle.slot & 63U);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint LightManager::FindLowestFreeSlot() const
+{
+	for (uint wordIndex = 0; wordIndex < (uint)m_freeBits.size(); ++wordIndex)
+	{
+		uint64_t freeBits = m_freeBits[wordIndex];
+		if (freeBits == 0U)
+		{
+			continue;
+		}
+
+		uint bit = 0U;
+		while ((freeBits & 1U) == 0U)
+		{
+			freeBits >>= 1;
+			bit++;
+		}
+		return wordIndex * 64U + bit;
+	}
+
+	return (uint)m_lights.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::IsValid( const LightHandle& handle ) const
+{
+	return m_handles.IsCurrent(handle.slot, handle.generation);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const LightDescT* LightManager::GetLight( const LightHandle& handle ) const
+{
+	return IsValid(handle) ? &m_lights[handle.slot] : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+LightDescT* LightManager::GetMutableLight( const LightHandle& handle )
+{
+	return IsValid(handle) ? &m_lights[handle.slot] : nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::SetLight( const LightHandle& handle, const LightDescT& desc )
+{
+	LightDescT* light = GetMutableLight(handle);
+	if (light == nullptr)
+	{
+		return false;
+	}
+
+	if (!IsSameLight(*light, desc))
+	{
+		*light = desc;
+		MarkDirty(handle.slot);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::SetPosition( const LightHandle& handle, const Vec3& position )
+{
+	LightDescT* light = GetMutableLight(handle);
+	if (light == nullptr)
+	{
+		return false;
+	}
+
+	if (!IsSameVec3(light->position, position))
+	{
+		light->position = position;
+		MarkDirty(handle.slot);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::SetIntensity( const LightHandle& handle, float intensity )
+{
+	LightDescT* light = GetMutableLight(handle);
+	if (light == nullptr)
+	{
+		return false;
+	}
+
+	if (light->intensity != intensity)
+	{
+		light->intensity = intensity;
+		MarkDirty(handle.slot);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::SetEnabled( const LightHandle& handle, bool isEnabled )
+{
+	LightDescT* light = GetMutableLight(handle);
+	if (light == nullptr)
+	{
+		return false;
+	}
+
+	if (light->isEnabled != isEnabled)
+	{
+		light->isEnabled = isEnabled;
+		MarkDirty(handle.slot);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LightManager::PrepareSlot( uint slot )
+{
+	if (!IsDirty(slot))
+	{
+		return false;
+	}
+	m_dirtyBits[slot >> 6] &= ~(1ULL << (slot & 63U));
+
+	const LightDescT& light = m_lights[slot];
+	if (IsLightSwitchedOff(light))
+	{
+		//Already off in the buffer, moving or dimming an off light changes nothing the GPU sees
+		if (m_hasSubmitted && IsLightSwitchedOff(m_submitted[slot]))
+		{
+			return false;
+		}
+
+		m_submitted[slot] = MakeSwitchedOffLight();
+		return true;
+	}
+
+	m_submitted[slot] = light;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t LightManager::Submit( const LightRangeUploadCallback& upload )
+{
+	m_lastRangeCount = 0U;
+	m_lastSlotCount = 0U;
+
+	size_t uploadBytes = 0U;
+	uint slotCount = (uint)m_lights.size();
+	uint slot = 0U;
+	while (slot < slotCount)
+	{
+		//Skip whole clean words before looking at single slots
+		if ((slot & 63U) == 0U && m_dirtyBits[slot >> 6] == 0U)
+		{
+			slot += 64U;
+			continue;
+		}
+
+		if (!PrepareSlot(slot))
+		{
+			slot++;
+			continue;
+		}
+
+		uint firstSlot = slot;
+		slot++;
+		while (slot < slotCount && PrepareSlot(slot))
+		{
+			slot++;
+		}
+
+		uint rangeSlots = slot - firstSlot;
+		upload(firstSlot, rangeSlots, &m_submitted[firstSlot]);
+
+		m_lastRangeCount++;
+		m_lastSlotCount += rangeSlots;
+	}
+
+	//The ranges only decide what is written into the CPU copy; the RenderContext sends the whole constant buffer once when
+	//any of it changed
+	if (m_lastRangeCount > 0U)
+	{
+		uploadBytes = GetLightBufferBytes();
+		if (g_renderRecorder != nullptr)
+		{
+			g_renderRecorder->RecordUpload("LightBuffer", uploadBytes);
+		}
+	}
+
+	m_hasSubmitted = true;
+	m_totalUploadBytes += uploadBytes;
+	return uploadBytes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LightManager::GatherPointLights( std::vector<Vec3>& outPositions, std::vector<float>& outRadii ) const
+{
+	outPositions.clear();
+	outRadii.clear();
+
+	for (const LightDescT& light : m_submitted)
+	{
+		if (light.isDirectional || IsLightSwitchedOff(light))
+		{
+			continue;
+		}
+
+		float diffuseRadius = ComputeLightRadius(light.intensity, light.diffuseAttenuation);
+		float specularRadius = ComputeLightRadius(light.intensity, light.specularAttenuation);
+		outPositions.push_back(light.position);
+		outRadii.push_back((diffuseRadius > specularRadius) ? diffuseRadius : specularRadius);
+	}
+}
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Game Systems
+#include "Game/HandlePool.hpp"
+//Third Party
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+//light_buffer in dot3_include.hlsl: ambient and the specular and emissive factors in two float4 rows, then MAX_LIGHTS light_t
+constexpr uint LIGHT_BUFFER_HEADER_BYTES = 32U;
+//light_t, five float4 rows
+constexpr uint LIGHT_BUFFER_BYTES_PER_LIGHT = 80U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Stable reference to a light. The generation changes whenever the slot is reused, so a destroyed light's handle is refused
+//------------------------------------------------------------------------------------------------------------------------------
+struct LightHandle
+{
+	uint32_t							slot = 0xFFFFFFFFU;
+	uint32_t							generation = 0U;
+
+	bool								IsNull() const { return slot == 0xFFFFFFFFU; }
+	bool								operator==( const LightHandle& other ) const { return slot == other.slot && generation == other.generation; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct LightDescT
+{
+	Vec3								position;
+	Vec3								direction = Vec3(0.f, 0.f, 1.f);
+	Rgba								color = Rgba::WHITE;
+	float								intensity = 1.f;
+	Vec3								diffuseAttenuation = Vec3(1.f, 0.f, 0.f);
+	Vec3								specularAttenuation = Vec3(1.f, 0.f, 0.f);
+	bool								isDirectional = false;
+	bool								isEnabled = true;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Owns the lights in the GPU light buffer, one slot each. Every setter marks its slot dirty only when the value changes, and
+// Submit hands the dirty slots to the upload callback as contiguous ranges, so a frame where one light moves writes one light.
+// The buffer itself still goes up whole, and only on frames where something was written.
+//
+// Lights that can not show up are submitted as switched off (intensity 0) instead: disabled ones, zero intensity, and point
+// lights whose attenuation puts them below LIGHT_CUTOFF_BRIGHTNESS everywhere. A slot that was already submitted off is not
+// uploaded again while it stays off.
+//------------------------------------------------------------------------------------------------------------------------------
+class LightManager
+{
+public:
+	//firstSlot, slotCount and the lights as they should be in the buffer, switched off ones with intensity 0
+	typedef std::function<void( uint firstSlot, uint slotCount, const LightDescT* lights )> LightRangeUploadCallback;
+
+public:
+	explicit LightManager( uint slotCount );
+	~LightManager();
+
+	//Lowest free slot first. Returns a null handle when every slot is taken
+	LightHandle							CreateLight( const LightDescT& desc );
+	bool								DestroyLight( const LightHandle& handle );
+	bool								IsValid( const LightHandle& handle ) const;
+	const LightDescT*					GetLight( const LightHandle& handle ) const;
+
+	bool								SetLight( const LightHandle& handle, const LightDescT& desc );
+	bool								SetPosition( const LightHandle& handle, const Vec3& position );
+	bool								SetIntensity( const LightHandle& handle, float intensity );
+	bool								SetEnabled( const LightHandle& handle, bool isEnabled );
+
+	//Calls upload once per run of dirty slots. Returns the bytes sent to the GPU, the whole buffer or nothing, and records
+	//them with the RenderRecorder
+	size_t								Submit( const LightRangeUploadCallback& upload );
+
+	//The submitted point lights as spheres, for the light clusters; switched off lights are left out
+	void								GatherPointLights( std::vector<Vec3>& outPositions, std::vector<float>& outRadii ) const;
+
+	uint								GetSlotCount() const { return (uint)m_lights.size(); }
+	uint								GetLiveCount() const { return m_handles.GetLiveCount(); }
+	size_t								GetLightBufferBytes() const { return LIGHT_BUFFER_HEADER_BYTES + m_lights.size() * LIGHT_BUFFER_BYTES_PER_LIGHT; }
+	uint								GetLastRangeCount() const { return m_lastRangeCount; }
+	uint								GetLastSlotCount() const { return m_lastSlotCount; }
+	uint64_t							GetTotalUploadBytes() const { return m_totalUploadBytes; }
+
+private:
+	LightDescT*							GetMutableLight( const LightHandle& handle );
+	void								MarkDirty( uint slot ) { m_dirtyBits[slot >> 6] |= 1ULL << (slot & 63U); }
+	bool								IsDirty( uint slot ) const { return (m_dirtyBits[slot >> 6] & (1ULL << (slot & 63U))) != 0U; }
+	//The lowest free slot, or slotCount when every one is taken
+	uint								FindLowestFreeSlot() const;
+	//Clears the slot's dirty bit and returns false if it does not need uploading
+	bool								PrepareSlot( uint slot );
+
+private:
+	//Per slot. Free slots hold a switched off light
+	std::vector<LightDescT>				m_lights;
+	HandlePool							m_handles;
+	//A set bit per free slot. The buffer is only a few words, so the lowest free slot is one scan
+	std::vector<uint64_t>				m_freeBits;
+
+	std::vector<uint64_t>				m_dirtyBits;
+	//What the buffer holds, so switched off slots are only sent once
+	std::vector<LightDescT>				m_submitted;
+	bool								m_hasSubmitted = false;
+
+	uint								m_lastRangeCount = 0U;
+	uint								m_lastSlotCount = 0U;
+	uint64_t							m_totalUploadBytes = 0U;
+};
+
+extern LightManager* g_lightManager;
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/LogThreadBuffer.hpp"
+//Third Party
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+LogThreadBuffer::LogThreadBuffer( uint32_t threadID, size_t capacityPowerOfTwo )
+	: m_threadID(threadID),
+	m_writeIndex(0U),
+	m_writtenCount(0U),
+	m_droppedCount(0U),
+	m_isRetired(false),
+	m_readIndex(0U)
+{
+	//Round up so indices can be masked instead of wrapped with a modulo
+	m_capacity = 1U;
+	while (m_capacity < capacityPowerOfTwo)
+	{
+		m_capacity <<= 1U;
+	}
+
+	m_mask = m_capacity - 1U;
+	m_bytes.resize(m_capacity);
+}
+
+LogThreadBuffer::~LogThreadBuffer()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LogThreadBuffer::TryWrite( const void* header, size_t headerSize, const void* payload, size_t payloadSize )
+{
+	size_t recordSize = headerSize + payloadSize;
+	uint64_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+
+	//Only refresh the consumer index when the cached one says we are full
+	if (writeIndex + recordSize - m_cachedReadIndex > m_capacity)
+	{
+		m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+		if (writeIndex + recordSize - m_cachedReadIndex > m_capacity)
+		{
+			m_droppedCount.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+	}
+
+	CopyIn(writeIndex, header, headerSize);
+	CopyIn(writeIndex + headerSize, payload, payloadSize);
+
+	m_writeIndex.store(writeIndex + recordSize, std::memory_order_release);
+
+	//Only this thread writes the count, so there is no read-modify-write
+	m_writtenCount.store(m_writtenCount.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t LogThreadBuffer::ReadAll( std::vector<unsigned char>& outBytes )
+{
+	uint64_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+	uint64_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+
+	size_t byteCount = (size_t)(writeIndex - readIndex);
+	if (byteCount == 0U)
+	{
+		return 0U;
+	}
+
+	size_t start = (size_t)readIndex & m_mask;
+	size_t firstPart = (byteCount < m_capacity - start) ? byteCount : m_capacity - start;
+
+	outBytes.insert(outBytes.end(), m_bytes.data() + start, m_bytes.data() + start + firstPart);
+	outBytes.insert(outBytes.end(), m_bytes.data(), m_bytes.data() + (byteCount - firstPart));
+
+	m_readIndex.store(writeIndex, std::memory_order_release);
+	return byteCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogThreadBuffer::Reset( uint32_t threadID )
+{
+	m_threadID = threadID;
+	m_writeIndex.store(0U, std::memory_order_relaxed);
+	m_cachedReadIndex = 0U;
+	m_writtenCount.store(0U, std::memory_order_relaxed);
+	m_droppedCount.store(0U, std::memory_order_relaxed);
+	m_readIndex.store(0U, std::memory_order_relaxed);
+	m_isRetired.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t LogThreadBuffer::GetUsedBytes() const
+{
+	return (size_t)(m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogThreadBuffer::CopyIn( uint64_t writeIndex, const void* data, size_t byteCount )
+{
+	size_t start = (size_t)writeIndex & m_mask;
+	size_t firstPart = (byteCount < m_capacity - start) ? byteCount : m_capacity - start;
+
+	memcpy(m_bytes.data() + start, data, firstPart);
+	memcpy(m_bytes.data(), (const unsigned char*)data + firstPart, byteCount - firstPart);
+}
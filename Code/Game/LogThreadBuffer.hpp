@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Single producer / single consumer byte ring used by BinaryLog. Each logging thread owns one and is the only writer; the log
+// writer thread is the only reader. Writes never block: a record that does not fit is dropped and counted.
+//
+// The owning thread retires the ring when it exits. Once the reader has drained a retired ring, Reset hands it to a new thread.
+//------------------------------------------------------------------------------------------------------------------------------
+class LogThreadBuffer
+{
+public:
+	explicit LogThreadBuffer( uint32_t threadID, size_t capacityPowerOfTwo );
+	~LogThreadBuffer();
+
+	//Producer side
+	bool								TryWrite( const void* header, size_t headerSize, const void* payload, size_t payloadSize );
+
+	//Consumer side. Appends every committed byte to outBytes and frees the space in the ring
+	size_t								ReadAll( std::vector<unsigned char>& outBytes );
+
+	//The producer's last call, nothing is written after it
+	void								Retire() { m_isRetired.store(true, std::memory_order_release); }
+	bool								IsRetired() const { return m_isRetired.load(std::memory_order_acquire); }
+	//Only once neither side references the ring. Empties it and clears the counts for the next owner
+	void								Reset( uint32_t threadID );
+
+	uint32_t							GetThreadID() const { return m_threadID; }
+	uint64_t							GetWrittenCount() const { return m_writtenCount.load(std::memory_order_relaxed); }
+	uint64_t							GetDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+	size_t								GetUsedBytes() const;
+	size_t								GetCapacity() const { return m_capacity; }
+
+private:
+	void								CopyIn( uint64_t writeIndex, const void* data, size_t byteCount );
+
+private:
+	std::vector<unsigned char>			m_bytes;
+	size_t								m_capacity = 0U;
+	size_t								m_mask = 0U;
+	uint32_t							m_threadID = 0U;
+
+	//Producer and consumer indices live on separate cache lines so they do not false share
+	alignas(64) std::atomic<uint64_t>	m_writeIndex;
+	uint64_t							m_cachedReadIndex = 0U;
+	std::atomic<uint64_t>				m_writtenCount;
+	std::atomic<uint64_t>				m_droppedCount;
+	std::atomic<bool>					m_isRetired;
+
+	alignas(64) std::atomic<uint64_t>	m_readIndex;
+};
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Headless entry point for the build/perf farm: the Headless|x64 configuration (HEADLESS_BUILD). Runs App::StartUp and
+// App::RunFrame for a fixed number of frames with no window, GPU or sound device; Game::Render submits through the
+// RecordingRenderBackend. Prints frame timings plus what the RenderRecorder captured.
+//
+// The Engine only builds with MSVC, so this is a Windows console executable for now. The RecordingRenderBackend it runs on has
+// no platform code; the D3D11 one is in RenderBackend_D3D11.cpp.
+//
+// Usage (from the Run directory so Data/ resolves): Protogame3D_Headless [-frames=N]
+//------------------------------------------------------------------------------------------------------------------------------
+#if defined(HEADLESS_BUILD)
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/WindowContext.hpp"
+//Game Systems
+#include "Game/App.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RenderRecorder.hpp"
+//Third Party
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+extern App* g_theApp;
+
+WindowContext* g_windowContext = nullptr;
+const char* APP_NAME = "Protogame 3D (Headless)";
+
+constexpr uint DEFAULT_HEADLESS_FRAME_COUNT = 600U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint ParseFrameCount( int argc, char** argv )
+{
+	const char* frameArg = "-frames=";
+	size_t frameArgLength = strlen(frameArg);
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strncmp(argv[argIndex], frameArg, frameArgLength) == 0)
+		{
+			int frames = atoi(argv[argIndex] + frameArgLength);
+			if (frames > 0)
+			{
+				return (uint)frames;
+			}
+		}
+	}
+
+	return DEFAULT_HEADLESS_FRAME_COUNT;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void PrintFrameTimings( std::vector<double>& frameTimesMS )
+{
+	if (frameTimesMS.empty())
+	{
+		return;
+	}
+
+	double totalMS = 0.0;
+	for (double frameMS : frameTimesMS)
+	{
+		totalMS += frameMS;
+	}
+
+	std::sort(frameTimesMS.begin(), frameTimesMS.end());
+	size_t count = frameTimesMS.size();
+
+	double averageMS = totalMS / (double)count;
+	double medianMS = frameTimesMS[count / 2];
+	double p95MS = frameTimesMS[std::min(count - 1, (count * 95) / 100)];
+	double maxMS = frameTimesMS[count - 1];
+
+	printf("\n Headless frames: %u", (uint)count);
+	printf("\n Frame CPU ms: avg %.4f | median %.4f | p95 %.4f | min %.4f | max %.4f", averageMS, medianMS, p95MS, frameTimesMS[0], maxMS);
+
+	//Single line the perf farm can scrape
+	printf("\n HEADLESS_FRAME_MS avg=%.4f median=%.4f p95=%.4f max=%.4f \n", averageMS, medianMS, p95MS, maxMS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Startup()
+{
+	g_isHeadless = true;
+
+	g_theApp = new App();
+	g_theApp->StartUp();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Shutdown()
+{
+	delete g_theApp;
+	g_theApp = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	uint frameCount = ParseFrameCount(argc, argv);
+
+	Startup();
+
+	std::vector<double> frameTimesMS;
+	frameTimesMS.reserve(frameCount);
+
+	for (uint frameIndex = 0; frameIndex < frameCount && !g_theApp->IsQuitting(); ++frameIndex)
+	{
+		double frameStart = GetCurrentTimeSeconds();
+		g_theApp->RunFrame();
+		frameTimesMS.push_back((GetCurrentTimeSeconds() - frameStart) * 1000.0);
+	}
+
+	PrintFrameTimings(frameTimesMS);
+
+	if (g_renderRecorder != nullptr)
+	{
+		g_renderRecorder->PrintSummary();
+	}
+
+	Shutdown();
+	return 0;
+}
+
+#endif
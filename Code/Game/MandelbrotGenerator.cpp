@@ -0,0 +1,522 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MandelbrotGenerator.hpp"
+//Engine Systems
+#include "Engine/Core/Time.hpp"
+//Third Party
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MANDELBROT_HAS_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and Clang only emit AVX2 instructions in functions that ask for them; MSVC allows the intrinsics anywhere
+#if defined(MANDELBROT_HAS_X86_SIMD) && defined(__GNUC__)
+#define MANDELBROT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MANDELBROT_TARGET_AVX2
+#endif
+
+//Progressive passes, coarsest first. Every stride is a power of two dividing the tile size
+static const uint PROGRESSIVE_STRIDES[] = { 8U, 4U, 2U, 1U };
+constexpr uint NUM_PROGRESSIVE_PASSES = sizeof(PROGRESSIVE_STRIDES) / sizeof(PROGRESSIVE_STRIDES[0]);
+
+//SIMD kernels read whole lane groups, so sample arrays are padded to a multiple of this
+constexpr uint MANDELBROT_LANE_PADDING = 16U;
+
+//Computes count pixels at cx[0], cx[1]... on row cy. Returns the total iterations run
+typedef uint64_t (*MandelbrotRowKernel)( const float* cx, float cy, uint count, uint maxIterations, uint* outIterations );
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t MandelbrotRowScalar( const float* cx, float cy, uint count, uint maxIterations, uint* outIterations )
+{
+	uint64_t totalIterations = 0U;
+	for (uint pixelIndex = 0; pixelIndex < count; ++pixelIndex)
+	{
+		float zx = 0.f;
+		float zy = 0.f;
+		uint iteration = 0U;
+
+		while (iteration < maxIterations)
+		{
+			float zx2 = zx * zx;
+			float zy2 = zy * zy;
+			if (zx2 + zy2 > 4.f)
+			{
+				break;
+			}
+
+			zy = 2.f * zx * zy + cy;
+			zx = zx2 - zy2 + cx[pixelIndex];
+			iteration++;
+		}
+
+		outIterations[pixelIndex] = iteration;
+		totalIterations += iteration;
+	}
+
+	return totalIterations;
+}
+
+#if defined(MANDELBROT_HAS_X86_SIMD)
+//------------------------------------------------------------------------------------------------------------------------------
+// 8 pixels per group as two SSE registers
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t MandelbrotRowSSE( const float* cx, float cy, uint count, uint maxIterations, uint* outIterations )
+{
+	const __m128 four = _mm_set1_ps(4.f);
+	const __m128 two = _mm_set1_ps(2.f);
+	const __m128 cyVec = _mm_set1_ps(cy);
+
+	uint64_t totalIterations = 0U;
+	alignas(16) uint groupIterations[8];
+
+	for (uint groupStart = 0; groupStart < count; groupStart += 8U)
+	{
+		__m128 cxA = _mm_loadu_ps(cx + groupStart);
+		__m128 cxB = _mm_loadu_ps(cx + groupStart + 4U);
+
+		__m128 zxA = _mm_setzero_ps();
+		__m128 zyA = _mm_setzero_ps();
+		__m128 zxB = _mm_setzero_ps();
+		__m128 zyB = _mm_setzero_ps();
+		__m128i iterationsA = _mm_setzero_si128();
+		__m128i iterationsB = _mm_setzero_si128();
+
+		for (uint iteration = 0; iteration < maxIterations; ++iteration)
+		{
+			__m128 zx2A = _mm_mul_ps(zxA, zxA);
+			__m128 zy2A = _mm_mul_ps(zyA, zyA);
+			__m128 zx2B = _mm_mul_ps(zxB, zxB);
+			__m128 zy2B = _mm_mul_ps(zyB, zyB);
+
+			//Lanes stay escaped once |z| > 2 (z only grows, and NaN compares false)
+			__m128 activeA = _mm_cmple_ps(_mm_add_ps(zx2A, zy2A), four);
+			__m128 activeB = _mm_cmple_ps(_mm_add_ps(zx2B, zy2B), four);
+			if ((_mm_movemask_ps(activeA) | _mm_movemask_ps(activeB)) == 0)
+			{
+				break;
+			}
+
+			//Active lanes are all ones (-1), subtracting counts them
+			iterationsA = _mm_sub_epi32(iterationsA, _mm_castps_si128(activeA));
+			iterationsB = _mm_sub_epi32(iterationsB, _mm_castps_si128(activeB));
+
+			zyA = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, zxA), zyA), cyVec);
+			zxA = _mm_add_ps(_mm_sub_ps(zx2A, zy2A), cxA);
+			zyB = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, zxB), zyB), cyVec);
+			zxB = _mm_add_ps(_mm_sub_ps(zx2B, zy2B), cxB);
+		}
+
+		_mm_store_si128((__m128i*)groupIterations, iterationsA);
+		_mm_store_si128((__m128i*)(groupIterations + 4), iterationsB);
+
+		uint groupCount = (count - groupStart < 8U) ? count - groupStart : 8U;
+		for (uint laneIndex = 0; laneIndex < groupCount; ++laneIndex)
+		{
+			outIterations[groupStart + laneIndex] = groupIterations[laneIndex];
+			totalIterations += groupIterations[laneIndex];
+		}
+	}
+
+	return totalIterations;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Two 8 pixel groups in flight at once; a single group is bound by the multiply/add latency chain
+//------------------------------------------------------------------------------------------------------------------------------
+MANDELBROT_TARGET_AVX2 static uint64_t MandelbrotRowAVX2( const float* cx, float cy, uint count, uint maxIterations, uint* outIterations )
+{
+	const __m256 four = _mm256_set1_ps(4.f);
+	const __m256 two = _mm256_set1_ps(2.f);
+	const __m256 cyVec = _mm256_set1_ps(cy);
+
+	uint64_t totalIterations = 0U;
+	alignas(32) uint groupIterations[16];
+
+	for (uint groupStart = 0; groupStart < count; groupStart += 16U)
+	{
+		__m256 cxA = _mm256_loadu_ps(cx + groupStart);
+		__m256 cxB = _mm256_loadu_ps(cx + groupStart + 8U);
+
+		__m256 zxA = _mm256_setzero_ps();
+		__m256 zyA = _mm256_setzero_ps();
+		__m256 zxB = _mm256_setzero_ps();
+		__m256 zyB = _mm256_setzero_ps();
+		__m256i iterationsA = _mm256_setzero_si256();
+		__m256i iterationsB = _mm256_setzero_si256();
+
+		for (uint iteration = 0; iteration < maxIterations; ++iteration)
+		{
+			__m256 zx2A = _mm256_mul_ps(zxA, zxA);
+			__m256 zy2A = _mm256_mul_ps(zyA, zyA);
+			__m256 zx2B = _mm256_mul_ps(zxB, zxB);
+			__m256 zy2B = _mm256_mul_ps(zyB, zyB);
+
+			__m256 activeA = _mm256_cmp_ps(_mm256_add_ps(zx2A, zy2A), four, _CMP_LE_OQ);
+			__m256 activeB = _mm256_cmp_ps(_mm256_add_ps(zx2B, zy2B), four, _CMP_LE_OQ);
+			if ((_mm256_movemask_ps(activeA) | _mm256_movemask_ps(activeB)) == 0)
+			{
+				break;
+			}
+
+			iterationsA = _mm256_sub_epi32(iterationsA, _mm256_castps_si256(activeA));
+			iterationsB = _mm256_sub_epi32(iterationsB, _mm256_castps_si256(activeB));
+
+			zyA = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(two, zxA), zyA), cyVec);
+			zxA = _mm256_add_ps(_mm256_sub_ps(zx2A, zy2A), cxA);
+			zyB = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(two, zxB), zyB), cyVec);
+			zxB = _mm256_add_ps(_mm256_sub_ps(zx2B, zy2B), cxB);
+		}
+
+		_mm256_store_si256((__m256i*)groupIterations, iterationsA);
+		_mm256_store_si256((__m256i*)(groupIterations + 8), iterationsB);
+
+		uint groupCount = (count - groupStart < 16U) ? count - groupStart : 16U;
+		for (uint laneIndex = 0; laneIndex < groupCount; ++laneIndex)
+		{
+			outIterations[groupStart + laneIndex] = groupIterations[laneIndex];
+			totalIterations += groupIterations[laneIndex];
+		}
+	}
+
+	return totalIterations;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsAVX2Available()
+{
+#if defined(_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7)
+	{
+		return false;
+	}
+
+	//AVX and OSXSAVE from leaf 1, AVX2 from leaf 7, then check the OS saves the YMM registers
+	__cpuid(cpuInfo, 1);
+	bool hasAVX = (cpuInfo[2] & (1 << 28)) != 0 && (cpuInfo[2] & (1 << 27)) != 0;
+	__cpuidex(cpuInfo, 7, 0);
+	bool hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
+
+	return hasAVX && hasAVX2 && (_xgetbv(0) & 6) == 6;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+static MandelbrotRowKernel GetRowKernel( eMandelbrotKernel kernel )
+{
+	switch (kernel)
+	{
+#if defined(MANDELBROT_HAS_X86_SIMD)
+	case MANDELBROT_KERNEL_SSE:
+		return MandelbrotRowSSE;
+	case MANDELBROT_KERNEL_AVX2:
+		return MandelbrotRowAVX2;
+#endif
+	default:
+		return MandelbrotRowScalar;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MandelbrotGenerator::MandelbrotGenerator( uint width, uint height, uint tileSize )
+	: m_width(width),
+	m_height(height)
+{
+	//Tiles have to line up with the coarsest progressive grid
+	m_tileSize = (tileSize < 8U) ? 8U : (tileSize > MAX_MANDELBROT_TILE_SIZE ? MAX_MANDELBROT_TILE_SIZE : tileSize);
+	m_tileSize &= ~7U;
+
+	m_tilesX = (m_width + m_tileSize - 1U) / m_tileSize;
+	m_tilesY = (m_height + m_tileSize - 1U) / m_tileSize;
+
+	m_pixels.resize((size_t)m_width * m_height, 0xFF000000U);
+	m_columnCX.resize(m_width, 0.f);
+	m_rowCY.resize(m_height, 0.f);
+	m_dirtyTiles.resize(m_tilesX * m_tilesY, 0U);
+	m_tileIterations.resize(m_tilesX * m_tilesY, 0U);
+
+	m_kernel = GetBestKernel();
+	BuildPalette(m_view.maxIterations);
+}
+
+MandelbrotGenerator::~MandelbrotGenerator()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool MandelbrotGenerator::IsKernelSupported( eMandelbrotKernel kernel )
+{
+	switch (kernel)
+	{
+	case MANDELBROT_KERNEL_SCALAR:
+		return true;
+#if defined(MANDELBROT_HAS_X86_SIMD)
+	case MANDELBROT_KERNEL_SSE:
+		return true;
+	case MANDELBROT_KERNEL_AVX2:
+	{
+		static const bool s_hasAVX2 = IsAVX2Available();
+		return s_hasAVX2;
+	}
+#endif
+	default:
+		return false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC eMandelbrotKernel MandelbrotGenerator::GetBestKernel()
+{
+	if (IsKernelSupported(MANDELBROT_KERNEL_AVX2))
+	{
+		return MANDELBROT_KERNEL_AVX2;
+	}
+
+	if (IsKernelSupported(MANDELBROT_KERNEL_SSE))
+	{
+		return MANDELBROT_KERNEL_SSE;
+	}
+
+	return MANDELBROT_KERNEL_SCALAR;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC const char* MandelbrotGenerator::GetKernelName( eMandelbrotKernel kernel )
+{
+	switch (kernel)
+	{
+	case MANDELBROT_KERNEL_SCALAR:
+		return "scalar";
+	case MANDELBROT_KERNEL_SSE:
+		return "sse";
+	case MANDELBROT_KERNEL_AVX2:
+		return "avx2";
+	default:
+		return "unknown";
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::Start( const MandelbrotViewT& view, bool isProgressive, eMandelbrotKernel kernel )
+{
+	//A pass in flight still reads the old view, the caller has to WaitForPass first
+	if (IsPassRunning())
+	{
+		return;
+	}
+
+	if (view.maxIterations != m_view.maxIterations || m_palette.empty())
+	{
+		BuildPalette(view.maxIterations);
+	}
+
+	m_view = view;
+
+	//Coordinates come from the pixel position alone, so every pass, tile size and kernel sees the same c for a pixel
+	double pixelSize = m_view.width / (double)m_width;
+	double left = m_view.centerX - m_view.width * 0.5;
+	double top = m_view.centerY + pixelSize * (double)m_height * 0.5;
+	for (uint x = 0; x < m_width; ++x)
+	{
+		m_columnCX[x] = (float)(left + (double)x * pixelSize);
+	}
+	for (uint y = 0; y < m_height; ++y)
+	{
+		m_rowCY[y] = (float)(top - (double)y * pixelSize);
+	}
+
+	m_kernel = IsKernelSupported(kernel) ? kernel : GetBestKernel();
+	m_isProgressive = isProgressive;
+	m_passIndex = 0U;
+	m_passCount = isProgressive ? NUM_PROGRESSIVE_PASSES : 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Returns false when there is nothing to dispatch (a pass is still running, or the image is complete)
+//------------------------------------------------------------------------------------------------------------------------------
+bool MandelbrotGenerator::DispatchNextPass( JobScheduler& scheduler )
+{
+	if (IsPassRunning() || m_passIndex >= m_passCount)
+	{
+		return false;
+	}
+
+	FinishPass();
+
+	uint stride = m_isProgressive ? PROGRESSIVE_STRIDES[m_passIndex] : 1U;
+	DispatchPass(scheduler, stride, m_isProgressive && m_passIndex > 0U);
+	m_passIndex++;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::WaitForPass( JobScheduler& scheduler )
+{
+	scheduler.WaitForCounter(m_passCounter);
+	FinishPass();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MandelbrotStatsT MandelbrotGenerator::RunBenchmark( JobScheduler& scheduler, const MandelbrotViewT& view, eMandelbrotKernel kernel )
+{
+	WaitForPass(scheduler);
+	Start(view, false, kernel);
+
+	DispatchNextPass(scheduler);
+	WaitForPass(scheduler);
+
+	return m_lastPassStats;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::ConsumeDirtyTiles( FrameVector<uint>& outTileIndices )
+{
+	if (IsPassRunning())
+	{
+		return;
+	}
+
+	FinishPass();
+
+	for (uint tileIndex = 0; tileIndex < (uint)m_dirtyTiles.size(); ++tileIndex)
+	{
+		if (m_dirtyTiles[tileIndex] != 0U)
+		{
+			outTileIndices.push_back(tileIndex);
+			m_dirtyTiles[tileIndex] = 0U;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::GetTileBounds( uint tileIndex, uint& outMinX, uint& outMinY, uint& outMaxX, uint& outMaxY ) const
+{
+	outMinX = (tileIndex % m_tilesX) * m_tileSize;
+	outMinY = (tileIndex / m_tilesX) * m_tileSize;
+	outMaxX = (outMinX + m_tileSize < m_width) ? outMinX + m_tileSize : m_width;
+	outMaxY = (outMinY + m_tileSize < m_height) ? outMinY + m_tileSize : m_height;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::BuildPalette( uint maxIterations )
+{
+	m_palette.resize(maxIterations + 1U);
+
+	for (uint iteration = 0; iteration < maxIterations; ++iteration)
+	{
+		//Smooth cosine gradient, cycled a few times across the iteration range
+		float t = sqrtf((float)iteration / (float)maxIterations) * 4.f;
+		uint32_t r = (uint32_t)(127.5f + 127.5f * cosf(6.2831853f * (t + 0.0f)));
+		uint32_t g = (uint32_t)(127.5f + 127.5f * cosf(6.2831853f * (t + 0.15f)));
+		uint32_t b = (uint32_t)(127.5f + 127.5f * cosf(6.2831853f * (t + 0.35f)));
+		m_palette[iteration] = r | (g << 8) | (b << 16) | 0xFF000000U;
+	}
+
+	//Inside the set
+	m_palette[maxIterations] = 0xFF000000U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::DispatchPass( JobScheduler& scheduler, uint stride, bool skipCoarserSamples )
+{
+	m_passStartTime = GetCurrentTimeSeconds();
+	m_isPassInFlight = true;
+
+	uint tileCount = m_tilesX * m_tilesY;
+	for (uint tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+	{
+		m_tileIterations[tileIndex] = 0U;
+
+		FunctionJob* tileJob = new FunctionJob([this, tileIndex, stride, skipCoarserSamples]()
+		{
+			RenderTile(tileIndex, stride, skipCoarserSamples);
+		});
+		tileJob->SetCounter(&m_passCounter);
+		scheduler.Dispatch(tileJob);
+	}
+
+	//Samples this pass computes (the rest of the pixels are block filled)
+	uint64_t gridPixels = (uint64_t)((m_width + stride - 1U) / stride) * ((m_height + stride - 1U) / stride);
+	uint64_t coarserPixels = skipCoarserSamples ? (uint64_t)((m_width + 2U * stride - 1U) / (2U * stride)) * ((m_height + 2U * stride - 1U) / (2U * stride)) : 0U;
+	m_passPixelCount = gridPixels - coarserPixels;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::RenderTile( uint tileIndex, uint stride, bool skipCoarserSamples )
+{
+	uint minX, minY, maxX, maxY;
+	GetTileBounds(tileIndex, minX, minY, maxX, maxY);
+
+	MandelbrotRowKernel rowKernel = GetRowKernel(m_kernel);
+
+	float sampleCX[MAX_MANDELBROT_TILE_SIZE + MANDELBROT_LANE_PADDING] = {};
+	uint iterations[MAX_MANDELBROT_TILE_SIZE];
+	uint64_t tileIterations = 0U;
+
+	for (uint y = minY; y < maxY; y += stride)
+	{
+		//On rows the coarser passes already sampled, only the odd columns are new
+		bool isCoarseRow = skipCoarserSamples && (y % (2U * stride)) == 0U;
+		uint firstX = minX + (isCoarseRow ? stride : 0U);
+		uint step = isCoarseRow ? 2U * stride : stride;
+		if (firstX >= maxX)
+		{
+			continue;
+		}
+
+		uint count = (maxX - firstX + step - 1U) / step;
+		for (uint sampleIndex = 0; sampleIndex < count; ++sampleIndex)
+		{
+			sampleCX[sampleIndex] = m_columnCX[firstX + sampleIndex * step];
+		}
+		tileIterations += rowKernel(sampleCX, m_rowCY[y], count, m_view.maxIterations, iterations);
+
+		uint blockMaxY = (y + stride < maxY) ? y + stride : maxY;
+		for (uint sampleIndex = 0; sampleIndex < count; ++sampleIndex)
+		{
+			uint x = firstX + sampleIndex * step;
+			uint blockMaxX = (x + stride < maxX) ? x + stride : maxX;
+			uint32_t color = m_palette[iterations[sampleIndex]];
+
+			for (uint blockY = y; blockY < blockMaxY; ++blockY)
+			{
+				uint32_t* row = m_pixels.data() + (size_t)blockY * m_width;
+				for (uint blockX = x; blockX < blockMaxX; ++blockX)
+				{
+					row[blockX] = color;
+				}
+			}
+		}
+	}
+
+	m_tileIterations[tileIndex] = tileIterations;
+	m_dirtyTiles[tileIndex] = 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MandelbrotGenerator::FinishPass()
+{
+	if (!m_isPassInFlight || IsPassRunning())
+	{
+		return;
+	}
+
+	m_lastPassStats.seconds = GetCurrentTimeSeconds() - m_passStartTime;
+	m_lastPassStats.pixelCount = m_passPixelCount;
+	m_lastPassStats.iterationCount = 0U;
+	for (uint64_t tileIterations : m_tileIterations)
+	{
+		m_lastPassStats.iterationCount += tileIterations;
+	}
+
+	m_isPassInFlight = false;
+}
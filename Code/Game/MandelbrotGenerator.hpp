@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/FrameAllocator.hpp"
+#include "Game/JobScheduler.hpp"
+//Third Party
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tiled Mandelbrot renderer used as the CPU throughput benchmark. Each tile is a ScheduledJob on the JobScheduler. Rows are
+// iterated in 8 pixel lane groups (one AVX2 register, or two SSE registers; the AVX2 path keeps two groups in flight) and a
+// group stops iterating as soon as every lane escaped.
+//
+// Progressive mode renders the image in passes on an 8, 4, 2, 1 pixel grid. Each pass only computes the pixels the previous
+// passes did not and fills the block each sample covers, so the first pass (1/64th of the work) is the preview and the
+// passes add up to exactly one full render.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint MAX_MANDELBROT_TILE_SIZE = 256U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eMandelbrotKernel
+{
+	MANDELBROT_KERNEL_SCALAR = 0,
+	MANDELBROT_KERNEL_SSE,
+	MANDELBROT_KERNEL_AVX2,
+
+	NUM_MANDELBROT_KERNELS
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct MandelbrotViewT
+{
+	double								centerX = -0.5;
+	double								centerY = 0.0;
+	double								width = 3.0;
+	uint								maxIterations = 1000U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct MandelbrotStatsT
+{
+	double								seconds = 0.0;
+	uint64_t							pixelCount = 0U;
+	uint64_t							iterationCount = 0U;
+
+	double								GetMegaPixelsPerSecond() const { return (seconds > 0.0) ? (double)pixelCount / seconds * 1e-6 : 0.0; }
+	double								GetGigaIterationsPerSecond() const { return (seconds > 0.0) ? (double)iterationCount / seconds * 1e-9 : 0.0; }
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class MandelbrotGenerator
+{
+public:
+	explicit MandelbrotGenerator( uint width, uint height, uint tileSize = 64U );
+	~MandelbrotGenerator();
+
+	static bool							IsKernelSupported( eMandelbrotKernel kernel );
+	static eMandelbrotKernel			GetBestKernel();
+	static const char*					GetKernelName( eMandelbrotKernel kernel );
+
+	//Progressive rendering, driven once a frame. Start is ignored while a pass is in flight, WaitForPass first
+	void								Start( const MandelbrotViewT& view, bool isProgressive, eMandelbrotKernel kernel = NUM_MANDELBROT_KERNELS );
+	bool								DispatchNextPass( JobScheduler& scheduler );
+	bool								IsPassRunning() const { return !m_passCounter.IsDone(); }
+	bool								IsComplete() const { return m_passIndex >= m_passCount && !IsPassRunning(); }
+	void								WaitForPass( JobScheduler& scheduler );
+
+	//Renders the whole image at full resolution and blocks until done
+	MandelbrotStatsT					RunBenchmark( JobScheduler& scheduler, const MandelbrotViewT& view, eMandelbrotKernel kernel );
+
+	//Tiles written since the last call. Only call while no pass is running
+	void								ConsumeDirtyTiles( FrameVector<uint>& outTileIndices );
+	void								GetTileBounds( uint tileIndex, uint& outMinX, uint& outMinY, uint& outMaxX, uint& outMaxY ) const;
+
+	//RGBA8, row major
+	const uint32_t*						GetPixels() const { return m_pixels.data(); }
+	uint								GetWidth() const { return m_width; }
+	uint								GetHeight() const { return m_height; }
+	uint								GetPassIndex() const { return m_passIndex; }
+	uint								GetPassCount() const { return m_passCount; }
+	const MandelbrotStatsT&				GetLastPassStats() const { return m_lastPassStats; }
+
+private:
+	void								BuildPalette( uint maxIterations );
+	void								DispatchPass( JobScheduler& scheduler, uint stride, bool skipCoarserSamples );
+	void								RenderTile( uint tileIndex, uint stride, bool skipCoarserSamples );
+	void								FinishPass();
+
+private:
+	uint								m_width = 0U;
+	uint								m_height = 0U;
+	uint								m_tileSize = 64U;
+	uint								m_tilesX = 0U;
+	uint								m_tilesY = 0U;
+
+	MandelbrotViewT						m_view;
+	eMandelbrotKernel					m_kernel = MANDELBROT_KERNEL_SCALAR;
+	std::vector<uint32_t>				m_palette;
+	std::vector<uint32_t>				m_pixels;
+	std::vector<float>					m_columnCX;
+	std::vector<float>					m_rowCY;
+
+	//Only written by the tile jobs of one pass, read on the main thread between passes
+	std::vector<unsigned char>			m_dirtyTiles;
+	std::vector<uint64_t>				m_tileIterations;
+
+	uint								m_passIndex = 0U;
+	uint								m_passCount = 0U;
+	bool								m_isProgressive = false;
+	bool								m_isPassInFlight = false;
+	JobCounter							m_passCounter;
+	double								m_passStartTime = 0.0;
+	uint64_t							m_passPixelCount = 0U;
+	MandelbrotStatsT					m_lastPassStats;
+};
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MappedFile.hpp"
+//Third Party
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MappedFile::Open( const std::string& filePath )
+{
+	Close();
+
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_data = (const unsigned char*)view;
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStats;
+	if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	//The mapping keeps the file alive, the descriptor is not needed past this
+	void* view = mmap(nullptr, (size_t)fileStats.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_data = (const unsigned char*)view;
+	m_size = (size_t)fileStats.st_size;
+#endif
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MappedFile::Close()
+{
+	if (m_data == nullptr)
+	{
+		return;
+	}
+
+#if defined(_WIN32)
+	UnmapViewOfFile(m_data);
+	CloseHandle((HANDLE)m_mappingHandle);
+	CloseHandle((HANDLE)m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	munmap((void*)m_data, m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Makes every folder on the way to the file, existing ones are left alone
+//------------------------------------------------------------------------------------------------------------------------------
+void CreateFoldersForFile( const std::string& filePath )
+{
+	for (size_t slashIndex = filePath.find_first_of("/\\"); slashIndex != std::string::npos; slashIndex = filePath.find_first_of("/\\", slashIndex + 1))
+	{
+		std::string folder = filePath.substr(0, slashIndex);
+#if defined(_WIN32)
+		_mkdir(folder.c_str());
+#else
+		mkdir(folder.c_str(), 0755);
+#endif
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool WriteFileAtomically( const std::string& filePath, const std::function<bool( FILE* file )>& writeContents )
+{
+	CreateFoldersForFile(filePath);
+	std::string tempPath = filePath + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	bool isWritten = writeContents(file);
+	isWritten = (fclose(file) == 0) && isWritten;
+
+	if (!isWritten)
+	{
+		remove(tempPath.c_str());
+		return false;
+	}
+
+	remove(filePath.c_str());
+	return rename(tempPath.c_str(), filePath.c_str()) == 0;
+}
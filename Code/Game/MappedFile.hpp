@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Read only view of a whole file through the OS memory mapper. Pages are only read from disk when touched, and a file that
+// was read recently comes straight out of the OS file cache without a copy.
+//------------------------------------------------------------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool								Open( const std::string& filePath );
+	void								Close();
+
+	bool								IsOpen() const { return m_data != nullptr; }
+	const unsigned char*				GetData() const { return m_data; }
+	size_t								GetSize() const { return m_size; }
+
+private:
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+
+private:
+	const unsigned char*				m_data = nullptr;
+	size_t								m_size = 0U;
+
+#if defined(_WIN32)
+	void*								m_fileHandle = nullptr;
+	void*								m_mappingHandle = nullptr;
+#endif
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+//For the caches that write the files MappedFile reads back
+void	CreateFoldersForFile( const std::string& filePath );
+//writeContents fills a temporary file next to filePath, which is only renamed over it once every write and the close worked.
+//A crash or a failed write never leaves a file that looks valid, and readers never see a half written one
+bool	WriteFileAtomically( const std::string& filePath, const std::function<bool( FILE* file )>& writeContents );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// FNV-1a, 64 bit. Keys the cooked files and tables the caches look things up in; pass a running hash back in to continue it
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint64_t FNV1A_64_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV1A_64_PRIME = 1099511628211ULL;
+
+inline uint64_t HashFNV1a( const void* data, size_t byteCount, uint64_t hash = FNV1A_64_OFFSET_BASIS )
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t byteIndex = 0; byteIndex < byteCount; ++byteIndex)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= FNV1A_64_PRIME;
+	}
+	return hash;
+}
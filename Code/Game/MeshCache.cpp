@@ -0,0 +1,275 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MeshCache.hpp"
+//Engine Systems
+#include "Engine/Math/Vertex_Lit.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+#include "Game/MeshOptimizer.hpp"
+#include "Game/VirtualFileSystem.hpp"
+//Third Party
+#include <algorithm>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+extern RenderContext* g_renderContext;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint32_t AlignCookedOffset( uint32_t offset )
+{
+	return (offset + COOKED_MESH_BLOB_ALIGNMENT - 1U) & ~(COOKED_MESH_BLOB_ALIGNMENT - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t HashMeshRecipe( const std::string& recipe )
+{
+	return HashFNV1a(recipe.data(), recipe.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool WriteCookedMesh( const std::string& filePath, uint64_t recipeHash, eCookedVertexLayout layout, const void* vertices, uint vertexStride, uint vertexCount,
+	const uint* indices, uint indexCount )
+{
+	CookedMeshHeaderT header;
+	header.recipeHash = recipeHash;
+	header.vertexLayout = (uint16_t)layout;
+	header.vertexStride = (uint16_t)vertexStride;
+	header.vertexCount = vertexCount;
+	header.indexCount = indexCount;
+	header.vertexOffset = AlignCookedOffset(sizeof(CookedMeshHeaderT));
+	header.indexOffset = AlignCookedOffset(header.vertexOffset + vertexCount * vertexStride);
+
+	return WriteFileAtomically(filePath, [&](FILE* file)
+	{
+		static const unsigned char s_padding[COOKED_MESH_BLOB_ALIGNMENT] = {};
+		return fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(s_padding, 1, header.vertexOffset - sizeof(header), file) == header.vertexOffset - sizeof(header)
+			&& (vertexCount == 0U || fwrite(vertices, vertexStride, vertexCount, file) == vertexCount)
+			&& fwrite(s_padding, 1, header.indexOffset - (header.vertexOffset + vertexCount * vertexStride), file) == header.indexOffset - (header.vertexOffset + vertexCount * vertexStride)
+			&& (indexCount == 0U || fwrite(indices, sizeof(uint), indexCount, file) == indexCount);
+	});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReadCookedMesh( const unsigned char* data, size_t byteCount, uint64_t recipeHash, eCookedVertexLayout layout, uint vertexStride, CookedMeshViewT& outView )
+{
+	if (data == nullptr || byteCount < sizeof(CookedMeshHeaderT))
+	{
+		return false;
+	}
+
+	CookedMeshHeaderT header;
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != COOKED_MESH_MAGIC || header.version != COOKED_MESH_VERSION || header.headerSize != sizeof(CookedMeshHeaderT)
+		|| header.recipeHash != recipeHash || header.vertexLayout != (uint16_t)layout || header.vertexStride != vertexStride)
+	{
+		return false;
+	}
+
+	//64 bit math so a corrupt count can not wrap past the size check
+	uint64_t vertexEnd = (uint64_t)header.vertexOffset + (uint64_t)header.vertexCount * vertexStride;
+	uint64_t indexEnd = (uint64_t)header.indexOffset + (uint64_t)header.indexCount * sizeof(uint);
+	if (header.vertexOffset < sizeof(CookedMeshHeaderT) || (header.vertexOffset % COOKED_MESH_BLOB_ALIGNMENT) != 0U || (header.indexOffset % COOKED_MESH_BLOB_ALIGNMENT) != 0U
+		|| header.indexOffset < vertexEnd || indexEnd > (uint64_t)byteCount)
+	{
+		return false;
+	}
+
+	outView.vertices = data + header.vertexOffset;
+	outView.vertexCount = header.vertexCount;
+	outView.indices = (const uint*)(data + header.indexOffset);
+	outView.indexCount = header.indexCount;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MeshCache::MeshCache( const std::string& cacheFolder )
+	: m_cacheFolder(cacheFolder)
+{
+}
+
+MeshCache::~MeshCache()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint SelectMeshLod( float projectedRadiusPixels, uint lodCount )
+{
+	if (lodCount <= 1U || projectedRadiusPixels >= MESH_LOD0_RADIUS_PIXELS)
+	{
+		return 0U;
+	}
+
+	//Halving the triangles matches halving the covered area, which is the radius shrinking by sqrt(2)
+	float levelsDown = 2.f * log2f(MESH_LOD0_RADIUS_PIXELS / std::max(projectedRadiusPixels, 1.f));
+	return std::min((uint)levelsDown, lodCount - 1U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What goes into a cooked file's recipe hash besides the recipe itself: the optimizer's settings for every mesh, and the LOD
+// policy and the level for a LOD chain. Changing any of them is a miss and the mesh is cooked again
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashCookedMeshRecipe( const std::string& recipe )
+{
+	return HashMeshRecipe(recipe + " | " + GetMeshOptimizerSettings());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashCookedMeshLodRecipe( const std::string& recipe, const std::string& lodName )
+{
+	char lodSettings[96];
+	snprintf(lodSettings, sizeof(lodSettings), "lods %u error %g target 1/2 keep 3/4", MESH_LOD_MAX_COUNT, MESH_LOD_MAX_ERROR_FRACTION);
+	return HashCookedMeshRecipe(recipe + " " + lodName + " | " + lodSettings);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The generator's output as the vertex and index arrays that get uploaded and cooked, already optimized
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildOptimizedLitMesh( const std::function<void( CPUMesh& mesh )>& buildMesh, std::vector<Vertex_Lit>& outVertices, std::vector<uint>& outIndices )
+{
+	CPUMesh mesh;
+	buildMesh(mesh);
+
+	outVertices.clear();
+	outVertices.reserve(mesh.GetVertexCount());
+	for (uint vertexIndex = 0; vertexIndex < mesh.GetVertexCount(); ++vertexIndex)
+	{
+		outVertices.push_back(Vertex_Lit(mesh.m_vertices[vertexIndex]));
+	}
+	outIndices.assign(mesh.m_indices.begin(), mesh.m_indices.end());
+
+	uint vertexCount = (uint)outVertices.size();
+	OptimizeMesh(outVertices.data(), sizeof(Vertex_Lit), vertexCount, outIndices.data(), (uint)outIndices.size(), offsetof(Vertex_Lit, m_position));
+	outVertices.resize(vertexCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* MeshCache::CreateOrLoadLitMesh( const std::string& meshName, const std::string& recipe, const std::function<void( CPUMesh& mesh )>& buildMesh )
+{
+	std::string filePath = m_cacheFolder + meshName + ".mesh";
+	uint64_t recipeHash = HashCookedMeshRecipe(recipe);
+
+	GPUMesh* gpuMesh = LoadCookedLitMesh(filePath, recipeHash);
+	if (gpuMesh != nullptr)
+	{
+		return gpuMesh;
+	}
+
+	std::vector<Vertex_Lit> vertices;
+	std::vector<uint> indices;
+	BuildOptimizedLitMesh(buildMesh, vertices, indices);
+	return CreateAndCookLitMesh(filePath, recipeHash, vertices.data(), (uint)vertices.size(), indices.data(), (uint)indices.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MeshCache::CreateOrLoadLitMeshLods( const std::string& meshName, const std::string& recipe, const std::function<void( CPUMesh& mesh )>& buildMesh,
+	std::vector<GPUMesh*>& outLods )
+{
+	outLods.clear();
+
+	//Levels are only ever written as a complete chain, so the chain ends at the first level that is not on disk
+	for (uint lodIndex = 0; lodIndex < MESH_LOD_MAX_COUNT; ++lodIndex)
+	{
+		std::string lodName = meshName + "_LOD" + std::to_string(lodIndex);
+		GPUMesh* gpuMesh = LoadCookedLitMesh(m_cacheFolder + lodName + ".mesh", HashCookedMeshLodRecipe(recipe, lodName));
+		if (gpuMesh == nullptr)
+		{
+			break;
+		}
+		outLods.push_back(gpuMesh);
+	}
+
+	if (!outLods.empty())
+	{
+		return;
+	}
+
+	std::vector<Vertex_Lit> vertices;
+	std::vector<uint> indices;
+	BuildOptimizedLitMesh(buildMesh, vertices, indices);
+
+	//Errors are measured against the bounding radius, so the same recipe at any scale gets the same levels
+	Vec3 boundsMin = vertices.empty() ? Vec3::ZERO : vertices[0].m_position;
+	Vec3 boundsMax = boundsMin;
+	for (const Vertex_Lit& vertex : vertices)
+	{
+		boundsMin = Vec3(std::min(boundsMin.x, vertex.m_position.x), std::min(boundsMin.y, vertex.m_position.y), std::min(boundsMin.z, vertex.m_position.z));
+		boundsMax = Vec3(std::max(boundsMax.x, vertex.m_position.x), std::max(boundsMax.y, vertex.m_position.y), std::max(boundsMax.z, vertex.m_position.z));
+	}
+	Vec3 boundsExtents = (boundsMax - boundsMin) * 0.5f;
+	float maxError = sqrtf(boundsExtents.x * boundsExtents.x + boundsExtents.y * boundsExtents.y + boundsExtents.z * boundsExtents.z) * MESH_LOD_MAX_ERROR_FRACTION;
+
+	std::vector<uint> lodIndices;
+	for (uint lodIndex = 0; lodIndex < MESH_LOD_MAX_COUNT; ++lodIndex)
+	{
+		if (lodIndex > 0U)
+		{
+			//Simplify from the previous level, so every level only removes detail the one before still had
+			uint targetIndexCount = (uint)indices.size() / 6U * 3U;
+			lodIndices.resize(indices.size());
+			uint lodIndexCount = SimplifyMesh(lodIndices.data(), indices.data(), (uint)indices.size(), vertices.data(), sizeof(Vertex_Lit), (uint)vertices.size(),
+				offsetof(Vertex_Lit, m_position), targetIndexCount, maxError);
+			if (lodIndexCount == 0U || lodIndexCount > (uint)indices.size() / 4U * 3U)
+			{
+				break;
+			}
+
+			indices.assign(lodIndices.begin(), lodIndices.begin() + lodIndexCount);
+			uint vertexCount = (uint)vertices.size();
+			OptimizeMesh(vertices.data(), sizeof(Vertex_Lit), vertexCount, indices.data(), (uint)indices.size(), offsetof(Vertex_Lit, m_position));
+			vertices.resize(vertexCount);
+		}
+
+		std::string lodName = meshName + "_LOD" + std::to_string(lodIndex);
+		outLods.push_back(CreateAndCookLitMesh(m_cacheFolder + lodName + ".mesh", HashCookedMeshLodRecipe(recipe, lodName), vertices.data(), (uint)vertices.size(),
+			indices.data(), (uint)indices.size()));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* MeshCache::LoadCookedLitMesh( const std::string& filePath, uint64_t recipeHash )
+{
+	//A cook shipped in the pack first, then the one written here on an earlier run; a stale packed cook is passed over
+	FileSpanT packedSpan;
+	MappedFile looseFile;
+	CookedMeshViewT view;
+	bool isRead = g_virtualFileSystem != nullptr && g_virtualFileSystem->ReadPackedFile(filePath, packedSpan)
+		&& ReadCookedMesh(packedSpan.data, packedSpan.size, recipeHash, COOKED_VERTEX_LAYOUT_LIT, sizeof(Vertex_Lit), view);
+	if (!isRead && (!looseFile.Open(filePath) || !ReadCookedMesh(looseFile.GetData(), looseFile.GetSize(), recipeHash, COOKED_VERTEX_LAYOUT_LIT, sizeof(Vertex_Lit), view)))
+	{
+		return nullptr;
+	}
+
+	//Same calls CreateFromCPUMesh ends in, minus building the Vertex_Lit array
+	GPUMesh* gpuMesh = new GPUMesh(g_renderContext);
+	gpuMesh->CopyVertexArray<Vertex_Lit>((const Vertex_Lit*)view.vertices, view.vertexCount);
+	gpuMesh->CopyIndices(view.indices, view.indexCount);
+	gpuMesh->SetDrawCall(view.indexCount > 0U, (view.indexCount > 0U) ? view.indexCount : view.vertexCount);
+	m_loadedCount++;
+	return gpuMesh;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* MeshCache::CreateAndCookLitMesh( const std::string& filePath, uint64_t recipeHash, const void* vertices, uint vertexCount, const uint* indices, uint indexCount )
+{
+	GPUMesh* gpuMesh = new GPUMesh(g_renderContext);
+	gpuMesh->CopyVertexArray<Vertex_Lit>((const Vertex_Lit*)vertices, vertexCount);
+	gpuMesh->CopyIndices(indices, indexCount);
+	gpuMesh->SetDrawCall(indexCount > 0U, (indexCount > 0U) ? indexCount : vertexCount);
+
+	if (WriteCookedMesh(filePath, recipeHash, COOKED_VERTEX_LAYOUT_LIT, vertices, sizeof(Vertex_Lit), vertexCount, indices, indexCount))
+	{
+		m_cookedCount++;
+	}
+	else
+	{
+		DebuggerPrintf("\n MeshCache: could not write %s", filePath.c_str());
+	}
+
+	return gpuMesh;
+}
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CPUMesh;
+class GPUMesh;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Cooked mesh file layout
+//
+// File:	CookedMeshHeaderT, then vertexCount * vertexStride bytes at vertexOffset, then indexCount u32 at indexOffset.
+// Both blobs start on a 16 byte boundary so they can be used in place from a mapped file. The vertex blob is already in the
+// GPU vertex format named by vertexLayout; the stride is stored so a changed vertex struct is caught as a stale cache.
+// recipeHash identifies the generator and its parameters, a mismatch means the mesh has to be rebuilt.
+//
+// Version 2: blobs are welded and reordered by OptimizeMesh before they are written.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t COOKED_MESH_MAGIC = 0x48534D50U;	// "PMSH"
+constexpr uint16_t COOKED_MESH_VERSION = 2U;
+constexpr uint32_t COOKED_MESH_BLOB_ALIGNMENT = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eCookedVertexLayout : uint16_t
+{
+	COOKED_VERTEX_LAYOUT_PCU = 1,
+	COOKED_VERTEX_LAYOUT_LIT
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+struct CookedMeshHeaderT
+{
+	uint32_t							magic = COOKED_MESH_MAGIC;
+	uint16_t							version = COOKED_MESH_VERSION;
+	uint16_t							headerSize = sizeof(CookedMeshHeaderT);
+	uint64_t							recipeHash = 0U;
+	uint16_t							vertexLayout = COOKED_VERTEX_LAYOUT_LIT;
+	uint16_t							vertexStride = 0U;
+	uint32_t							vertexCount = 0U;
+	uint32_t							indexCount = 0U;
+	uint32_t							vertexOffset = 0U;
+	uint32_t							indexOffset = 0U;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pointers into a mapped cooked file, valid while the file stays open
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookedMeshViewT
+{
+	const void*							vertices = nullptr;
+	uint								vertexCount = 0U;
+	const uint*							indices = nullptr;
+	uint								indexCount = 0U;
+};
+
+uint64_t	HashMeshRecipe( const std::string& recipe );
+bool		WriteCookedMesh( const std::string& filePath, uint64_t recipeHash, eCookedVertexLayout layout, const void* vertices, uint vertexStride, uint vertexCount,
+				const uint* indices, uint indexCount );
+//Points outView into data. Fails on anything that does not match exactly, including a truncated file
+bool		ReadCookedMesh( const unsigned char* data, size_t byteCount, uint64_t recipeHash, eCookedVertexLayout layout, uint vertexStride, CookedMeshViewT& outView );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Level of detail policy: every level has about half the triangles of the one before, so a level is used until the mesh's
+// projected radius shrinks by another 1/sqrt(2). Simplification stops early once it would move the surface by more than
+// MESH_LOD_MAX_ERROR_FRACTION of the mesh's bounding radius, or once a level would not save a quarter of the triangles.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint MESH_LOD_MAX_COUNT = 5U;
+constexpr float MESH_LOD_MAX_ERROR_FRACTION = 0.05f;
+constexpr float MESH_LOD0_RADIUS_PIXELS = 256.f;
+
+//Index into a chain of lodCount levels for a mesh whose bounding sphere covers projectedRadiusPixels on screen
+uint		SelectMeshLod( float projectedRadiusPixels, uint lodCount );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Procedural meshes built once and then loaded from disk. The recipe is a readable description of the generator call; when a
+// cooked file with the same recipe exists its vertex and index blobs go from the mapped file straight into the GPUMesh, with
+// no CPUMesh and no per vertex work. Otherwise the mesh is built, optimized, uploaded, and cooked for next time, so the
+// vertex cache and overdraw reordering is paid once per recipe rather than once per run.
+//------------------------------------------------------------------------------------------------------------------------------
+class MeshCache
+{
+public:
+	explicit MeshCache( const std::string& cacheFolder = "Data/Cache/Meshes/" );
+	~MeshCache();
+
+	GPUMesh*							CreateOrLoadLitMesh( const std::string& meshName, const std::string& recipe, const std::function<void( CPUMesh& mesh )>& buildMesh );
+	//Full detail first. Each level is its own cooked file, holding only the vertices that level uses
+	void								CreateOrLoadLitMeshLods( const std::string& meshName, const std::string& recipe, const std::function<void( CPUMesh& mesh )>& buildMesh,
+											std::vector<GPUMesh*>& outLods );
+
+	uint								GetLoadedCount() const { return m_loadedCount; }
+	uint								GetCookedCount() const { return m_cookedCount; }
+
+private:
+	GPUMesh*							LoadCookedLitMesh( const std::string& filePath, uint64_t recipeHash );
+	GPUMesh*							CreateAndCookLitMesh( const std::string& filePath, uint64_t recipeHash, const void* vertices, uint vertexCount, const uint* indices, uint indexCount );
+
+private:
+	std::string							m_cacheFolder;
+	uint								m_loadedCount = 0U;
+	uint								m_cookedCount = 0U;
+};
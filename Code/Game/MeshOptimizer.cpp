@@ -0,0 +1,790 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MeshOptimizer.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint INVALID_MESH_INDEX = 0xFFFFFFFFU;
+
+//Forsyth's scoring constants, tuned against a 32 entry LRU model of the cache
+constexpr uint FORSYTH_CACHE_SIZE = 32U;
+constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.f;
+constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+//A collapse may turn a neighbouring triangle by up to about 75 degrees
+constexpr double SIMPLIFY_MIN_NORMAL_DOT = 0.25;
+constexpr uint SIMPLIFY_MAX_PASSES = 64U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Symmetric 4x4 quadric of a set of planes: the weighted sum of squared plane distances is p'Ap + 2b.p + c. Evaluate divides
+// by the summed weight, so the error is a mean squared distance no matter how much area went into the quadric
+//------------------------------------------------------------------------------------------------------------------------------
+struct QuadricT
+{
+	double								a00 = 0.0;
+	double								a11 = 0.0;
+	double								a22 = 0.0;
+	double								a01 = 0.0;
+	double								a02 = 0.0;
+	double								a12 = 0.0;
+	double								b0 = 0.0;
+	double								b1 = 0.0;
+	double								b2 = 0.0;
+	double								c = 0.0;
+	double								weight = 0.0;
+
+	void AddPlane( double nx, double ny, double nz, double d, double planeWeight )
+	{
+		a00 += planeWeight * nx * nx;	a11 += planeWeight * ny * ny;	a22 += planeWeight * nz * nz;
+		a01 += planeWeight * nx * ny;	a02 += planeWeight * nx * nz;	a12 += planeWeight * ny * nz;
+		b0 += planeWeight * nx * d;		b1 += planeWeight * ny * d;		b2 += planeWeight * nz * d;
+		c += planeWeight * d * d;
+		weight += planeWeight;
+	}
+
+	void Add( const QuadricT& other )
+	{
+		a00 += other.a00;	a11 += other.a11;	a22 += other.a22;
+		a01 += other.a01;	a02 += other.a02;	a12 += other.a12;
+		b0 += other.b0;		b1 += other.b1;		b2 += other.b2;
+		c += other.c;
+		weight += other.weight;
+	}
+
+	double Evaluate( const float* position ) const
+	{
+		double x = position[0];
+		double y = position[1];
+		double z = position[2];
+		double error = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+			+ 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+		return (error > 0.0 && weight > 0.0) ? error / weight : 0.0;
+	}
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SimplifyCollapseT
+{
+	uint								from = 0U;
+	uint								to = 0U;
+	double								cost = 0.0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const float* GetVertexPosition( const void* vertices, uint vertexStride, uint positionOffset, uint vertexIndex )
+{
+	return (const float*)((const unsigned char*)vertices + (size_t)vertexIndex * vertexStride + positionOffset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Twice the triangle's area along its normal
+//------------------------------------------------------------------------------------------------------------------------------
+static void ComputeTriangleCross( const float* p0, const float* p1, const float* p2, double* outCross )
+{
+	double e1[3] = { (double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2] };
+	double e2[3] = { (double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2] };
+	outCross[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	outCross[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	outCross[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Triangles around each vertex as one list: vertex v owns adjacency[adjacencyStart[v] .. adjacencyStart[v + 1])
+//------------------------------------------------------------------------------------------------------------------------------
+static void BuildTriangleAdjacency( const uint* indices, uint indexCount, uint vertexCount, std::vector<uint>& adjacencyStart, std::vector<uint>& adjacency )
+{
+	uint triangleCount = indexCount / 3U;
+	adjacencyStart.assign(vertexCount + 1U, 0U);
+	for (uint index = 0; index < triangleCount * 3U; ++index)
+	{
+		adjacencyStart[indices[index] + 1U]++;
+	}
+	for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		adjacencyStart[vertexIndex + 1U] += adjacencyStart[vertexIndex];
+	}
+
+	std::vector<uint> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	adjacency.resize(triangleCount * 3U);
+	for (uint index = 0; index < triangleCount * 3U; ++index)
+	{
+		adjacency[fill[indices[index]]++] = index / 3U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint WeldVertices( void* vertices, uint vertexStride, uint vertexCount, uint* indices, uint indexCount )
+{
+	if (vertexCount == 0U)
+	{
+		return 0U;
+	}
+
+	uint tableSize = 1U;
+	while (tableSize < vertexCount * 2U)
+	{
+		tableSize <<= 1U;
+	}
+
+	unsigned char* bytes = (unsigned char*)vertices;
+	std::vector<uint> table(tableSize, INVALID_MESH_INDEX);
+	std::vector<uint> remap(vertexCount);
+	uint weldedCount = 0U;
+
+	for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const unsigned char* vertex = bytes + (size_t)vertexIndex * vertexStride;
+
+		uint64_t hash = HashFNV1a(vertex, vertexStride);
+
+		uint slot = (uint)hash & (tableSize - 1U);
+		while (table[slot] != INVALID_MESH_INDEX && memcmp(bytes + (size_t)table[slot] * vertexStride, vertex, vertexStride) != 0)
+		{
+			slot = (slot + 1U) & (tableSize - 1U);
+		}
+
+		if (table[slot] == INVALID_MESH_INDEX)
+		{
+			//Compacting in place is safe, a vertex only ever moves into a slot that was already read
+			if (weldedCount != vertexIndex)
+			{
+				memcpy(bytes + (size_t)weldedCount * vertexStride, vertex, vertexStride);
+			}
+			table[slot] = weldedCount++;
+		}
+
+		remap[vertexIndex] = table[slot];
+	}
+
+	for (uint index = 0; index < indexCount; ++index)
+	{
+		indices[index] = remap[indices[index]];
+	}
+
+	return weldedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float ScoreForsythVertex( int cachePosition, uint remainingTriangles )
+{
+	if (remainingTriangles == 0U)
+	{
+		return -1.f;
+	}
+
+	float score = 0.f;
+	if (cachePosition >= 0 && cachePosition < 3)
+	{
+		//The last triangle's vertices get a fixed score so the very next triangle does not just share an edge with it
+		score = FORSYTH_LAST_TRIANGLE_SCORE;
+	}
+	else if (cachePosition >= 3)
+	{
+		float falloff = 1.f - (float)(cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3U);
+		score = powf(falloff, FORSYTH_CACHE_DECAY_POWER);
+	}
+
+	//Vertices with few triangles left are finished off first so they can leave the cache
+	score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)remainingTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+	return score;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void OptimizeVertexCache( uint* indices, uint indexCount, uint vertexCount )
+{
+	uint triangleCount = indexCount / 3U;
+	if (triangleCount < 2U)
+	{
+		return;
+	}
+
+	//The first remainingCount[v] triangles of a vertex's adjacency are the ones not emitted yet
+	std::vector<uint> adjacencyStart;
+	std::vector<uint> adjacency;
+	BuildTriangleAdjacency(indices, indexCount, vertexCount, adjacencyStart, adjacency);
+
+	std::vector<uint> remainingCount(vertexCount);
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		remainingCount[vertexIndex] = adjacencyStart[vertexIndex + 1U] - adjacencyStart[vertexIndex];
+		vertexScore[vertexIndex] = ScoreForsythVertex(-1, remainingCount[vertexIndex]);
+	}
+
+	uint bestTriangle = 0U;
+	float bestScore = -1.f;
+	for (uint triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+	{
+		const uint* triangle = &indices[triangleIndex * 3U];
+		float score = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestTriangle = triangleIndex;
+		}
+	}
+
+	std::vector<uint> output;
+	output.reserve(triangleCount * 3U);
+	std::vector<unsigned char> isEmitted(triangleCount, 0U);
+	uint cache[FORSYTH_CACHE_SIZE + 3U];
+	uint cacheCount = 0U;
+	uint deadEndCursor = 0U;
+
+	for (uint emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		if (bestTriangle == INVALID_MESH_INDEX)
+		{
+			//Nothing in the cache has triangles left, restart from the first triangle not emitted yet
+			while (isEmitted[deadEndCursor])
+			{
+				deadEndCursor++;
+			}
+			bestTriangle = deadEndCursor;
+		}
+
+		uint triangle[3] = { indices[bestTriangle * 3U], indices[bestTriangle * 3U + 1U], indices[bestTriangle * 3U + 2U] };
+		output.insert(output.end(), triangle, triangle + 3);
+		isEmitted[bestTriangle] = 1U;
+
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			uint* remaining = &adjacency[adjacencyStart[triangle[corner]]];
+			uint& count = remainingCount[triangle[corner]];
+			for (uint slot = 0; slot < count; ++slot)
+			{
+				if (remaining[slot] == bestTriangle)
+				{
+					remaining[slot] = remaining[count - 1U];
+					remaining[count - 1U] = bestTriangle;
+					count--;
+					break;
+				}
+			}
+		}
+
+		//The triangle's vertices move to the front, the rest shift back and anything past the cache size falls out
+		uint newCache[FORSYTH_CACHE_SIZE + 3U];
+		uint newCount = 0U;
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			if (std::find(newCache, newCache + newCount, triangle[corner]) == newCache + newCount)
+			{
+				newCache[newCount++] = triangle[corner];
+			}
+		}
+		for (uint cacheIndex = 0; cacheIndex < cacheCount; ++cacheIndex)
+		{
+			if (cache[cacheIndex] != triangle[0] && cache[cacheIndex] != triangle[1] && cache[cacheIndex] != triangle[2])
+			{
+				newCache[newCount++] = cache[cacheIndex];
+			}
+		}
+
+		for (uint cacheIndex = 0; cacheIndex < newCount; ++cacheIndex)
+		{
+			uint vertexIndex = newCache[cacheIndex];
+			cachePosition[vertexIndex] = (cacheIndex < FORSYTH_CACHE_SIZE) ? (int)cacheIndex : -1;
+			vertexScore[vertexIndex] = ScoreForsythVertex(cachePosition[vertexIndex], remainingCount[vertexIndex]);
+		}
+
+		cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(uint));
+
+		//Only triangles touching the cache changed score, the best of them goes next
+		bestTriangle = INVALID_MESH_INDEX;
+		bestScore = -1.f;
+		for (uint cacheIndex = 0; cacheIndex < newCount; ++cacheIndex)
+		{
+			uint vertexIndex = newCache[cacheIndex];
+			const uint* remaining = &adjacency[adjacencyStart[vertexIndex]];
+			for (uint slot = 0; slot < remainingCount[vertexIndex]; ++slot)
+			{
+				const uint* candidate = &indices[remaining[slot] * 3U];
+				float score = vertexScore[candidate[0]] + vertexScore[candidate[1]] + vertexScore[candidate[2]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = remaining[slot];
+				}
+			}
+		}
+	}
+
+	memcpy(indices, output.data(), output.size() * sizeof(uint));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void OptimizeOverdraw( uint* indices, uint indexCount, const void* vertices, uint vertexStride, uint vertexCount, uint positionOffset )
+{
+	uint triangleCount = indexCount / 3U;
+	if (triangleCount < 2U)
+	{
+		return;
+	}
+
+	//A triangle whose three vertices all miss the cache starts a cluster, so moving whole clusters costs almost no extra misses
+	std::vector<uint> clusterStarts;
+	std::vector<uint> cacheTime(vertexCount, 0U);
+	uint timestamp = MESH_OPTIMIZER_FIFO_CACHE_SIZE + 1U;
+	for (uint triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+	{
+		uint missCount = 0U;
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			uint vertexIndex = indices[triangleIndex * 3U + corner];
+			if (timestamp - cacheTime[vertexIndex] > MESH_OPTIMIZER_FIFO_CACHE_SIZE)
+			{
+				cacheTime[vertexIndex] = timestamp++;
+				missCount++;
+			}
+		}
+
+		if (triangleIndex == 0U || missCount == 3U)
+		{
+			clusterStarts.push_back(triangleIndex);
+		}
+	}
+
+	uint clusterCount = (uint)clusterStarts.size();
+	if (clusterCount < 2U)
+	{
+		return;
+	}
+	clusterStarts.push_back(triangleCount);
+
+	//Area weighted centroid and normal of every cluster, and of the whole mesh
+	std::vector<double> clusterData(clusterCount * 7U, 0.0);
+	double meshCentroid[3] = {};
+	double meshArea = 0.0;
+	for (uint clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+	{
+		double* data = &clusterData[clusterIndex * 7U];
+		for (uint triangleIndex = clusterStarts[clusterIndex]; triangleIndex < clusterStarts[clusterIndex + 1U]; ++triangleIndex)
+		{
+			const float* p0 = GetVertexPosition(vertices, vertexStride, positionOffset, indices[triangleIndex * 3U]);
+			const float* p1 = GetVertexPosition(vertices, vertexStride, positionOffset, indices[triangleIndex * 3U + 1U]);
+			const float* p2 = GetVertexPosition(vertices, vertexStride, positionOffset, indices[triangleIndex * 3U + 2U]);
+
+			double cross[3];
+			ComputeTriangleCross(p0, p1, p2, cross);
+			double area = sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+			for (uint axis = 0; axis < 3U; ++axis)
+			{
+				data[axis] += area * ((double)p0[axis] + p1[axis] + p2[axis]) / 3.0;
+				data[3U + axis] += cross[axis];
+			}
+			data[6] += area;
+		}
+
+		meshCentroid[0] += data[0];
+		meshCentroid[1] += data[1];
+		meshCentroid[2] += data[2];
+		meshArea += data[6];
+	}
+
+	if (meshArea <= 0.0)
+	{
+		return;
+	}
+
+	//Clusters far out along their own normal face the camera from most directions, drawing them first lets depth reject the rest
+	std::vector<double> sortKey(clusterCount, 0.0);
+	for (uint clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+	{
+		const double* data = &clusterData[clusterIndex * 7U];
+		double normalLength = sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+		if (data[6] <= 0.0 || normalLength <= 0.0)
+		{
+			continue;
+		}
+
+		for (uint axis = 0; axis < 3U; ++axis)
+		{
+			double offset = data[axis] / data[6] - meshCentroid[axis] / meshArea;
+			sortKey[clusterIndex] += offset * data[3U + axis] / normalLength;
+		}
+	}
+
+	std::vector<uint> order(clusterCount);
+	for (uint clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex)
+	{
+		order[clusterIndex] = clusterIndex;
+	}
+	std::stable_sort(order.begin(), order.end(), [&sortKey](uint lhs, uint rhs)
+	{
+		return sortKey[lhs] > sortKey[rhs];
+	});
+
+	std::vector<uint> output;
+	output.reserve(triangleCount * 3U);
+	for (uint clusterIndex : order)
+	{
+		output.insert(output.end(), indices + clusterStarts[clusterIndex] * 3U, indices + clusterStarts[clusterIndex + 1U] * 3U);
+	}
+
+	memcpy(indices, output.data(), output.size() * sizeof(uint));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint OptimizeVertexFetch( void* vertices, uint vertexStride, uint vertexCount, uint* indices, uint indexCount )
+{
+	if (indexCount == 0U)
+	{
+		return vertexCount;
+	}
+
+	std::vector<uint> remap(vertexCount, INVALID_MESH_INDEX);
+	uint usedCount = 0U;
+	for (uint index = 0; index < indexCount; ++index)
+	{
+		uint& newIndex = remap[indices[index]];
+		if (newIndex == INVALID_MESH_INDEX)
+		{
+			newIndex = usedCount++;
+		}
+		indices[index] = newIndex;
+	}
+
+	unsigned char* bytes = (unsigned char*)vertices;
+	std::vector<unsigned char> source(bytes, bytes + (size_t)vertexCount * vertexStride);
+	for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		if (remap[vertexIndex] != INVALID_MESH_INDEX)
+		{
+			memcpy(bytes + (size_t)remap[vertexIndex] * vertexStride, &source[(size_t)vertexIndex * vertexStride], vertexStride);
+		}
+	}
+
+	return usedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+MeshOptimizeStatsT OptimizeMesh( void* vertices, uint vertexStride, uint& vertexCount, uint* indices, uint indexCount, uint positionOffset )
+{
+	MeshOptimizeStatsT stats;
+	stats.vertexCountBefore = vertexCount;
+	stats.acmrBefore = ComputeVertexCacheACMR(indices, indexCount, vertexCount);
+
+	//Non indexed meshes are drawn straight from the vertex buffer, there is nothing to reorder
+	if (indexCount >= 3U)
+	{
+		vertexCount = WeldVertices(vertices, vertexStride, vertexCount, indices, indexCount);
+		OptimizeVertexCache(indices, indexCount, vertexCount);
+		OptimizeOverdraw(indices, indexCount, vertices, vertexStride, vertexCount, positionOffset);
+		vertexCount = OptimizeVertexFetch(vertices, vertexStride, vertexCount, indices, indexCount);
+	}
+
+	stats.vertexCountAfter = vertexCount;
+	stats.acmrAfter = ComputeVertexCacheACMR(indices, indexCount, vertexCount);
+	return stats;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+float ComputeVertexCacheACMR( const uint* indices, uint indexCount, uint vertexCount, uint cacheSize )
+{
+	uint triangleCount = indexCount / 3U;
+	if (triangleCount == 0U)
+	{
+		return 0.f;
+	}
+
+	//A vertex is still cached if fewer than cacheSize misses happened since it was loaded
+	std::vector<uint> cacheTime(vertexCount, 0U);
+	uint timestamp = cacheSize + 1U;
+	uint missCount = 0U;
+	for (uint index = 0; index < triangleCount * 3U; ++index)
+	{
+		uint vertexIndex = indices[index];
+		if (timestamp - cacheTime[vertexIndex] > cacheSize)
+		{
+			cacheTime[vertexIndex] = timestamp++;
+			missCount++;
+		}
+	}
+
+	return (float)missCount / (float)triangleCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Rejects collapses that would fold a triangle over or pinch the surface into a non manifold fin
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsCollapseValid( const SimplifyCollapseT& collapse, const std::vector<uint>& triangles, const std::vector<uint>& adjacencyStart,
+	const std::vector<uint>& adjacency, const void* vertices, uint vertexStride, uint positionOffset, uint& outRemovedCount )
+{
+	const float* targetPosition = GetVertexPosition(vertices, vertexStride, positionOffset, collapse.to);
+	std::vector<uint> fromNeighbours;
+	outRemovedCount = 0U;
+
+	for (uint slot = adjacencyStart[collapse.from]; slot < adjacencyStart[collapse.from + 1U]; ++slot)
+	{
+		const uint* triangle = &triangles[adjacency[slot] * 3U];
+		if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+		{
+			outRemovedCount++;
+			continue;
+		}
+
+		const float* before[3];
+		const float* after[3];
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			before[corner] = GetVertexPosition(vertices, vertexStride, positionOffset, triangle[corner]);
+			after[corner] = (triangle[corner] == collapse.from) ? targetPosition : before[corner];
+			if (triangle[corner] != collapse.from)
+			{
+				fromNeighbours.push_back(triangle[corner]);
+			}
+		}
+
+		double crossBefore[3];
+		double crossAfter[3];
+		ComputeTriangleCross(before[0], before[1], before[2], crossBefore);
+		ComputeTriangleCross(after[0], after[1], after[2], crossAfter);
+		double lengthBefore = sqrt(crossBefore[0] * crossBefore[0] + crossBefore[1] * crossBefore[1] + crossBefore[2] * crossBefore[2]);
+		double lengthAfter = sqrt(crossAfter[0] * crossAfter[0] + crossAfter[1] * crossAfter[1] + crossAfter[2] * crossAfter[2]);
+		double dot = crossBefore[0] * crossAfter[0] + crossBefore[1] * crossAfter[1] + crossBefore[2] * crossAfter[2];
+
+		//Zero area triangles have no facing to flip (UV sphere poles are full of them)
+		if (lengthBefore > 0.0 && dot < SIMPLIFY_MIN_NORMAL_DOT * lengthBefore * lengthAfter)
+		{
+			return false;
+		}
+	}
+
+	//Link condition: the two vertices may only share the neighbours opposite the edge, one per removed triangle
+	std::sort(fromNeighbours.begin(), fromNeighbours.end());
+	fromNeighbours.erase(std::unique(fromNeighbours.begin(), fromNeighbours.end()), fromNeighbours.end());
+
+	std::vector<uint> sharedNeighbours;
+	for (uint slot = adjacencyStart[collapse.to]; slot < adjacencyStart[collapse.to + 1U]; ++slot)
+	{
+		const uint* triangle = &triangles[adjacency[slot] * 3U];
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			if (triangle[corner] != collapse.from && triangle[corner] != collapse.to && std::binary_search(fromNeighbours.begin(), fromNeighbours.end(), triangle[corner]))
+			{
+				sharedNeighbours.push_back(triangle[corner]);
+			}
+		}
+	}
+
+	std::sort(sharedNeighbours.begin(), sharedNeighbours.end());
+	uint sharedCount = (uint)(std::unique(sharedNeighbours.begin(), sharedNeighbours.end()) - sharedNeighbours.begin());
+	return sharedCount <= outRemovedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint SimplifyMesh( uint* outIndices, const uint* indices, uint indexCount, const void* vertices, uint vertexStride, uint vertexCount,
+	uint positionOffset, uint targetIndexCount, float maxError, float* outError )
+{
+	std::vector<uint> triangles(indices, indices + indexCount / 3U * 3U);
+	double maxCost = (double)maxError * (double)maxError;
+	double largestCost = 0.0;
+
+	//Plane quadrics weighted by area, so slivers do not pin their vertices
+	std::vector<QuadricT> quadrics(vertexCount);
+	for (uint triangleIndex = 0; triangleIndex < (uint)triangles.size() / 3U; ++triangleIndex)
+	{
+		const uint* triangle = &triangles[triangleIndex * 3U];
+		const float* p0 = GetVertexPosition(vertices, vertexStride, positionOffset, triangle[0]);
+		const float* p1 = GetVertexPosition(vertices, vertexStride, positionOffset, triangle[1]);
+		const float* p2 = GetVertexPosition(vertices, vertexStride, positionOffset, triangle[2]);
+
+		double cross[3];
+		ComputeTriangleCross(p0, p1, p2, cross);
+		double length = sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+		if (length <= 0.0)
+		{
+			continue;
+		}
+
+		double nx = cross[0] / length;
+		double ny = cross[1] / length;
+		double nz = cross[2] / length;
+		double d = -(nx * p0[0] + ny * p0[1] + nz * p0[2]);
+		for (uint corner = 0; corner < 3U; ++corner)
+		{
+			quadrics[triangle[corner]].AddPlane(nx, ny, nz, d, length * 0.5);
+		}
+	}
+
+	//Edges with one triangle are open borders or UV seams, edges with more than two are non manifold. Their vertices never move
+	std::vector<unsigned char> isLocked(vertexCount, 0U);
+	{
+		std::vector<uint64_t> edges;
+		edges.reserve(triangles.size());
+		for (uint index = 0; index < (uint)triangles.size(); ++index)
+		{
+			uint a = triangles[index];
+			uint b = triangles[(index % 3U == 2U) ? index - 2U : index + 1U];
+			if (a != b)
+			{
+				edges.push_back(((uint64_t)std::min(a, b) << 32U) | std::max(a, b));
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+		for (size_t runStart = 0; runStart < edges.size();)
+		{
+			size_t runEnd = runStart + 1;
+			while (runEnd < edges.size() && edges[runEnd] == edges[runStart])
+			{
+				runEnd++;
+			}
+
+			if (runEnd - runStart != 2)
+			{
+				isLocked[(uint)(edges[runStart] >> 32U)] = 1U;
+				isLocked[(uint)(edges[runStart] & 0xFFFFFFFFU)] = 1U;
+			}
+			runStart = runEnd;
+		}
+	}
+
+	std::vector<uint> adjacencyStart;
+	std::vector<uint> adjacency;
+	std::vector<SimplifyCollapseT> collapses;
+	std::vector<uint> remap(vertexCount);
+	std::vector<unsigned char> isTouched(vertexCount);
+
+	//Each pass takes the cheapest collapses that do not touch each other, then rebuilds; a pass of independent collapses keeps
+	//every neighbourhood the flip test looks at unchanged until the pass ends
+	for (uint passIndex = 0; passIndex < SIMPLIFY_MAX_PASSES && (uint)triangles.size() > targetIndexCount; ++passIndex)
+	{
+		BuildTriangleAdjacency(triangles.data(), (uint)triangles.size(), vertexCount, adjacencyStart, adjacency);
+
+		collapses.clear();
+		for (uint index = 0; index < (uint)triangles.size(); ++index)
+		{
+			uint a = triangles[index];
+			uint b = triangles[(index % 3U == 2U) ? index - 2U : index + 1U];
+			for (uint direction = 0; direction < 2U && a != b; ++direction)
+			{
+				SimplifyCollapseT collapse;
+				collapse.from = (direction == 0U) ? a : b;
+				collapse.to = (direction == 0U) ? b : a;
+				if (isLocked[collapse.from])
+				{
+					continue;
+				}
+
+				QuadricT quadric = quadrics[collapse.from];
+				quadric.Add(quadrics[collapse.to]);
+				collapse.cost = quadric.Evaluate(GetVertexPosition(vertices, vertexStride, positionOffset, collapse.to));
+				collapses.push_back(collapse);
+			}
+		}
+
+		//Ties broken by index so the result never depends on the sort implementation
+		std::sort(collapses.begin(), collapses.end(), [](const SimplifyCollapseT& lhs, const SimplifyCollapseT& rhs)
+		{
+			if (lhs.cost != rhs.cost)
+			{
+				return lhs.cost < rhs.cost;
+			}
+			return (lhs.from != rhs.from) ? (lhs.from < rhs.from) : (lhs.to < rhs.to);
+		});
+
+		for (uint vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			remap[vertexIndex] = vertexIndex;
+			isTouched[vertexIndex] = 0U;
+		}
+
+		uint trianglesToRemove = ((uint)triangles.size() - targetIndexCount + 2U) / 3U;
+		uint removedCount = 0U;
+		uint collapseCount = 0U;
+		for (const SimplifyCollapseT& collapse : collapses)
+		{
+			if (removedCount >= trianglesToRemove || collapse.cost > maxCost)
+			{
+				break;
+			}
+
+			uint collapseRemovedCount = 0U;
+			if (isTouched[collapse.from] || isTouched[collapse.to]
+				|| !IsCollapseValid(collapse, triangles, adjacencyStart, adjacency, vertices, vertexStride, positionOffset, collapseRemovedCount))
+			{
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			for (uint slot = adjacencyStart[collapse.from]; slot < adjacencyStart[collapse.from + 1U]; ++slot)
+			{
+				const uint* triangle = &triangles[adjacency[slot] * 3U];
+				isTouched[triangle[0]] = 1U;
+				isTouched[triangle[1]] = 1U;
+				isTouched[triangle[2]] = 1U;
+			}
+			isTouched[collapse.to] = 1U;
+
+			removedCount += collapseRemovedCount;
+			collapseCount++;
+			largestCost = std::max(largestCost, collapse.cost);
+		}
+
+		if (collapseCount == 0U)
+		{
+			break;
+		}
+
+		uint keptCount = 0U;
+		for (uint index = 0; index < (uint)triangles.size(); index += 3U)
+		{
+			uint a = remap[triangles[index]];
+			uint b = remap[triangles[index + 1U]];
+			uint c = remap[triangles[index + 2U]];
+			if (a != b && b != c && a != c)
+			{
+				triangles[keptCount++] = a;
+				triangles[keptCount++] = b;
+				triangles[keptCount++] = c;
+			}
+		}
+		triangles.resize(keptCount);
+	}
+
+	if (!triangles.empty())
+	{
+		memcpy(outIndices, triangles.data(), triangles.size() * sizeof(uint));
+	}
+
+	if (outError != nullptr)
+	{
+		*outError = (float)sqrt(largestCost);
+	}
+
+	return (uint)triangles.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const char* GetMeshOptimizerSettings()
+{
+	struct MeshOptimizerSettingsT
+	{
+		MeshOptimizerSettingsT()
+		{
+			snprintf(text, sizeof(text), "optimizer %u forsyth %u %g %g %g %g simplify %g %u", MESH_OPTIMIZER_VERSION, FORSYTH_CACHE_SIZE,
+				FORSYTH_LAST_TRIANGLE_SCORE, FORSYTH_CACHE_DECAY_POWER, FORSYTH_VALENCE_BOOST_SCALE, FORSYTH_VALENCE_BOOST_POWER, SIMPLIFY_MIN_NORMAL_DOT,
+				SIMPLIFY_MAX_PASSES);
+		}
+
+		char							text[128];
+	};
+
+	static const MeshOptimizerSettingsT s_settings;
+	return s_settings.text;
+}
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Index buffer optimization and simplification for triangle lists. Everything works on raw vertex and index arrays so it can
+// run on any vertex format: vertices are only ever compared or moved as whole strides, and the geometric passes read the
+// position as 3 floats at positionOffset inside each vertex.
+//
+// The order OptimizeMesh runs them in matters. Welding first gives the cache pass real sharing to work with, the overdraw
+// pass only moves whole clusters so it keeps most of the cache order, and the fetch pass goes last because it renumbers
+// vertices in the order the final index buffer first uses them.
+//------------------------------------------------------------------------------------------------------------------------------
+
+//ACMR (average cache miss ratio, transformed vertices per triangle) is measured against a FIFO cache this big
+constexpr uint MESH_OPTIMIZER_FIFO_CACHE_SIZE = 16U;
+//Bump whenever a pass changes what it outputs for the same input; the tuning constants are covered by the settings text
+constexpr uint MESH_OPTIMIZER_VERSION = 1U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct MeshOptimizeStatsT
+{
+	uint								vertexCountBefore = 0U;
+	uint								vertexCountAfter = 0U;
+	float								acmrBefore = 0.f;
+	float								acmrAfter = 0.f;
+};
+
+//Merges bitwise identical vertices, keeping the first of each. Returns the new vertex count
+uint				WeldVertices( void* vertices, uint vertexStride, uint vertexCount, uint* indices, uint indexCount );
+//Reorders triangles for the post transform vertex cache (Forsyth's linear speed method)
+void				OptimizeVertexCache( uint* indices, uint indexCount, uint vertexCount );
+//Splits the cache ordered triangles into clusters and draws the outward facing clusters first
+void				OptimizeOverdraw( uint* indices, uint indexCount, const void* vertices, uint vertexStride, uint vertexCount, uint positionOffset );
+//Renumbers vertices in first use order and drops unused ones. Returns the new vertex count
+uint				OptimizeVertexFetch( void* vertices, uint vertexStride, uint vertexCount, uint* indices, uint indexCount );
+
+//All four passes above; vertexCount is updated in place
+MeshOptimizeStatsT	OptimizeMesh( void* vertices, uint vertexStride, uint& vertexCount, uint* indices, uint indexCount, uint positionOffset );
+
+float				ComputeVertexCacheACMR( const uint* indices, uint indexCount, uint vertexCount, uint cacheSize = MESH_OPTIMIZER_FIFO_CACHE_SIZE );
+
+//Quadric error edge collapse onto existing vertices. Open borders and UV seams are locked, so attributes never stretch across
+//them. Errors are RMS distances to the original surface around a vertex: collapses above maxError are never taken, and
+//outError is the largest one that was. Writes at most indexCount indices and returns how many
+uint				SimplifyMesh( uint* outIndices, const uint* indices, uint indexCount, const void* vertices, uint vertexStride, uint vertexCount,
+						uint positionOffset, uint targetIndexCount, float maxError, float* outError = nullptr );
+
+//The version and every tuning constant the passes use, for the keys of anything cooked from their output
+const char*			GetMeshOptimizerSettings();
+
+//Whether an index buffer for this many vertices can be stored as u16
+inline bool			CanUse16BitIndices( uint vertexCount ) { return vertexCount <= 65536U; }
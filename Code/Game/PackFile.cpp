@@ -0,0 +1,360 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/PackFile.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <algorithm>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr size_t PACK_LZ_MIN_MATCH = 4U;
+constexpr size_t PACK_LZ_MAX_OFFSET = 65535U;
+constexpr uint32_t PACK_LZ_HASH_BITS = 14U;
+constexpr uint32_t PACK_LZ_NO_POSITION = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string NormalizePackPath( const std::string& path )
+{
+	std::string normalized;
+	normalized.reserve(path.size());
+	for (char character : path)
+	{
+		normalized += (character == '\\') ? '/' : (char)tolower((unsigned char)character);
+	}
+
+	while (normalized.compare(0, 2, "./") == 0)
+	{
+		normalized.erase(0, 2);
+	}
+	return normalized;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t HashPackPath( const std::string& normalizedPath )
+{
+	return HashFNV1a(normalizedPath.data(), normalizedPath.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WritePackLZLength( size_t length, std::vector<unsigned char>& outBytes )
+{
+	//Only called for the part of a length past the 15 its nibble holds
+	while (length >= 255U)
+	{
+		outBytes.push_back(255U);
+		length -= 255U;
+	}
+	outBytes.push_back((unsigned char)length);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WritePackLZSequence( const unsigned char* literals, size_t literalCount, size_t offset, size_t matchLength, std::vector<unsigned char>& outBytes )
+{
+	size_t matchCode = (matchLength > 0U) ? matchLength - PACK_LZ_MIN_MATCH : 0U;
+	unsigned char token = (unsigned char)(((literalCount < 15U ? literalCount : 15U) << 4) | (matchCode < 15U ? matchCode : 15U));
+	outBytes.push_back(token);
+	if (literalCount >= 15U)
+	{
+		WritePackLZLength(literalCount - 15U, outBytes);
+	}
+	outBytes.insert(outBytes.end(), literals, literals + literalCount);
+
+	//The final sequence stops after its literals
+	if (matchLength == 0U)
+	{
+		return;
+	}
+
+	outBytes.push_back((unsigned char)(offset & 0xFFU));
+	outBytes.push_back((unsigned char)(offset >> 8));
+	if (matchCode >= 15U)
+	{
+		WritePackLZLength(matchCode - 15U, outBytes);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool CompressPackLZ( const unsigned char* bytes, size_t byteCount, std::vector<unsigned char>& outBytes )
+{
+	outBytes.clear();
+	outBytes.reserve(byteCount);
+
+	//Greedy, one candidate per hash slot: fast enough to pack the whole data folder every build
+	std::vector<uint32_t> hashTable((size_t)1U << PACK_LZ_HASH_BITS, PACK_LZ_NO_POSITION);
+	size_t anchor = 0U;
+	size_t position = 0U;
+	while (position + PACK_LZ_MIN_MATCH <= byteCount)
+	{
+		uint32_t sequence;
+		memcpy(&sequence, bytes + position, sizeof(sequence));
+		uint32_t slot = (sequence * 2654435761U) >> (32U - PACK_LZ_HASH_BITS);
+		uint32_t candidate = hashTable[slot];
+		hashTable[slot] = (uint32_t)position;
+
+		if (candidate == PACK_LZ_NO_POSITION || position - candidate > PACK_LZ_MAX_OFFSET || memcmp(bytes + candidate, bytes + position, PACK_LZ_MIN_MATCH) != 0)
+		{
+			position++;
+			continue;
+		}
+
+		size_t matchLength = PACK_LZ_MIN_MATCH;
+		while (position + matchLength < byteCount && bytes[candidate + matchLength] == bytes[position + matchLength])
+		{
+			matchLength++;
+		}
+
+		WritePackLZSequence(bytes + anchor, position - anchor, position - candidate, matchLength, outBytes);
+		position += matchLength;
+		anchor = position;
+
+		if (outBytes.size() >= byteCount)
+		{
+			outBytes.clear();
+			return false;
+		}
+	}
+
+	WritePackLZSequence(bytes + anchor, byteCount - anchor, 0U, 0U, outBytes);
+	if (outBytes.size() >= byteCount)
+	{
+		outBytes.clear();
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadPackLZLength( const unsigned char*& input, const unsigned char* inputEnd, size_t& inOutLength )
+{
+	unsigned char extra = 255U;
+	while (extra == 255U)
+	{
+		if (input >= inputEnd)
+		{
+			return false;
+		}
+		extra = *input++;
+		inOutLength += extra;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DecompressPackLZ( const unsigned char* stored, size_t storedSize, unsigned char* output, size_t outputSize )
+{
+	const unsigned char* input = stored;
+	const unsigned char* inputEnd = stored + storedSize;
+	size_t written = 0U;
+
+	while (input < inputEnd)
+	{
+		unsigned char token = *input++;
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15U && !ReadPackLZLength(input, inputEnd, literalCount))
+		{
+			return false;
+		}
+		if (literalCount > (size_t)(inputEnd - input) || literalCount > outputSize - written)
+		{
+			return false;
+		}
+		memcpy(output + written, input, literalCount);
+		input += literalCount;
+		written += literalCount;
+
+		//Only the last sequence ends after its literals, so a stream cut off after a match is refused below
+		if (input == inputEnd)
+		{
+			return written == outputSize;
+		}
+
+		if (inputEnd - input < 2)
+		{
+			return false;
+		}
+		size_t offset = (size_t)input[0] | ((size_t)input[1] << 8);
+		input += 2;
+
+		size_t matchLength = token & 15U;
+		if (matchLength == 15U && !ReadPackLZLength(input, inputEnd, matchLength))
+		{
+			return false;
+		}
+		matchLength += PACK_LZ_MIN_MATCH;
+
+		if (offset == 0U || offset > written || matchLength > outputSize - written)
+		{
+			return false;
+		}
+
+		//Byte by byte, a match may overlap the bytes it is producing
+		const unsigned char* match = output + written - offset;
+		for (size_t byteIndex = 0; byteIndex < matchLength; ++byteIndex)
+		{
+			output[written + byteIndex] = match[byteIndex];
+		}
+		written += matchLength;
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool WritePackFile( const std::string& filePath, const std::vector<PackSourceT>& sources, float minCompressionSaving, std::string& outError )
+{
+	struct PendingEntryT
+	{
+		PackEntryT						entry;
+		std::string						name;
+		const std::vector<unsigned char>*	bytes = nullptr;
+		std::vector<unsigned char>		compressed;
+	};
+
+	std::vector<PendingEntryT> pending(sources.size());
+	for (size_t sourceIndex = 0; sourceIndex < sources.size(); ++sourceIndex)
+	{
+		PendingEntryT& entry = pending[sourceIndex];
+		entry.name = NormalizePackPath(sources[sourceIndex].path);
+		entry.bytes = &sources[sourceIndex].bytes;
+		entry.entry.pathHash = HashPackPath(entry.name);
+		entry.entry.size = (uint32_t)entry.bytes->size();
+		entry.entry.nameLength = (uint16_t)entry.name.size();
+
+		if (entry.bytes->size() > 0xFFFFFFFFULL || entry.name.size() > 0xFFFFU)
+		{
+			outError = "too large for a pack entry: " + entry.name;
+			return false;
+		}
+
+		//Already compressed formats (png, jpg, ogg) fail the saving test and are stored as they are
+		if (sources[sourceIndex].isCompressible && !entry.bytes->empty() && CompressPackLZ(entry.bytes->data(), entry.bytes->size(), entry.compressed)
+			&& (float)entry.compressed.size() <= (float)entry.bytes->size() * (1.f - minCompressionSaving))
+		{
+			entry.entry.compression = PACK_COMPRESSION_LZ;
+			entry.entry.storedSize = (uint32_t)entry.compressed.size();
+		}
+		else
+		{
+			entry.compressed.clear();
+			entry.entry.storedSize = entry.entry.size;
+		}
+	}
+
+	std::sort(pending.begin(), pending.end(), []( const PendingEntryT& a, const PendingEntryT& b ) { return a.entry.pathHash < b.entry.pathHash; });
+	for (size_t entryIndex = 1; entryIndex < pending.size(); ++entryIndex)
+	{
+		if (pending[entryIndex].entry.pathHash == pending[entryIndex - 1].entry.pathHash)
+		{
+			outError = "path hash collision between " + pending[entryIndex - 1].name + " and " + pending[entryIndex].name;
+			return false;
+		}
+	}
+
+	PackHeaderT header;
+	header.entryCount = (uint32_t)pending.size();
+	header.nameOffset = (uint32_t)(sizeof(PackHeaderT) + pending.size() * sizeof(PackEntryT));
+
+	std::string names;
+	for (PendingEntryT& entry : pending)
+	{
+		entry.entry.nameOffset = (uint32_t)names.size();
+		names += entry.name;
+	}
+	header.nameBytes = (uint32_t)names.size();
+
+	uint64_t offset = header.nameOffset + header.nameBytes;
+	for (PendingEntryT& entry : pending)
+	{
+		offset = (offset + PACK_ENTRY_ALIGNMENT - 1U) & ~(uint64_t)(PACK_ENTRY_ALIGNMENT - 1U);
+		entry.entry.offset = offset;
+		offset += entry.entry.storedSize;
+	}
+
+	bool isWritten = WriteFileAtomically(filePath, [&](FILE* file)
+	{
+		bool isFileWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+		for (const PendingEntryT& entry : pending)
+		{
+			isFileWritten = isFileWritten && fwrite(&entry.entry, sizeof(PackEntryT), 1, file) == 1;
+		}
+		isFileWritten = isFileWritten && (names.empty() || fwrite(names.data(), 1, names.size(), file) == names.size());
+
+		static const unsigned char s_padding[PACK_ENTRY_ALIGNMENT] = {};
+		uint64_t written = header.nameOffset + header.nameBytes;
+		for (const PendingEntryT& entry : pending)
+		{
+			size_t paddingSize = (size_t)(entry.entry.offset - written);
+			const unsigned char* data = (entry.entry.compression == PACK_COMPRESSION_LZ) ? entry.compressed.data() : entry.bytes->data();
+			isFileWritten = isFileWritten && fwrite(s_padding, 1, paddingSize, file) == paddingSize
+				&& (entry.entry.storedSize == 0U || fwrite(data, 1, entry.entry.storedSize, file) == entry.entry.storedSize);
+			written = entry.entry.offset + entry.entry.storedSize;
+		}
+		return isFileWritten;
+	});
+
+	if (!isWritten)
+	{
+		outError = "could not write " + filePath;
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReadPackIndex( const unsigned char* data, size_t dataSize, PackIndexViewT& outView )
+{
+	if (data == nullptr || dataSize < sizeof(PackHeaderT))
+	{
+		return false;
+	}
+
+	PackHeaderT header;
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != PACK_MAGIC || header.version != PACK_VERSION || header.headerSize != sizeof(PackHeaderT)
+		|| (uint64_t)header.nameOffset != sizeof(PackHeaderT) + (uint64_t)header.entryCount * sizeof(PackEntryT)
+		|| (uint64_t)header.nameOffset + header.nameBytes > (uint64_t)dataSize)
+	{
+		return false;
+	}
+
+	const PackEntryT* entries = (const PackEntryT*)(data + sizeof(PackHeaderT));
+	uint64_t dataStart = (uint64_t)header.nameOffset + header.nameBytes;
+	for (uint32_t entryIndex = 0; entryIndex < header.entryCount; ++entryIndex)
+	{
+		const PackEntryT& entry = entries[entryIndex];
+		bool isSorted = (entryIndex == 0U) || entries[entryIndex - 1U].pathHash < entry.pathHash;
+		bool isStoredRight = (entry.compression == PACK_COMPRESSION_NONE && entry.storedSize == entry.size)
+			|| (entry.compression == PACK_COMPRESSION_LZ && entry.storedSize > 0U);
+
+		//64 bit math so a corrupt offset can not wrap past the size check
+		if (!isSorted || !isStoredRight || (entry.offset % PACK_ENTRY_ALIGNMENT) != 0U || entry.offset < dataStart
+			|| entry.offset + entry.storedSize > (uint64_t)dataSize || (uint64_t)entry.nameOffset + entry.nameLength > header.nameBytes)
+		{
+			return false;
+		}
+	}
+
+	outView.entries = entries;
+	outView.entryCount = header.entryCount;
+	outView.names = (const char*)(data + header.nameOffset);
+	outView.data = data;
+	outView.dataSize = dataSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const PackEntryT* FindPackEntry( const PackIndexViewT& view, const std::string& normalizedPath )
+{
+	uint64_t pathHash = HashPackPath(normalizedPath);
+	const PackEntryT* end = view.entries + view.entryCount;
+	const PackEntryT* entry = std::lower_bound(view.entries, end, pathHash, []( const PackEntryT& candidate, uint64_t hash ) { return candidate.pathHash < hash; });
+	if (entry == end || entry->pathHash != pathHash || entry->nameLength != normalizedPath.size()
+		|| memcmp(view.names + entry->nameOffset, normalizedPath.data(), normalizedPath.size()) != 0)
+	{
+		return nullptr;
+	}
+	return entry;
+}
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Third Party
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pack file layout (shared by VirtualFileSystem and the Packer tool)
+//
+// File:	PackHeaderT, entryCount PackEntryT sorted by pathHash, the entry names, then the entry data. Every entry's data
+// starts on a PACK_ENTRY_ALIGNMENT boundary, so an uncompressed entry can be used in place from the mapped pack.
+// Names are normalized (forward slashes, lower case) and hashed with FNV-1a; they are stored so a lookup can confirm the hit
+// and the Packer can refuse two paths with the same hash.
+// Compressed entries use PACK_COMPRESSION_LZ: sequences of [token][literal length bytes][literals][u16 offset][match length
+// bytes], token high nibble = literal count, low nibble = match length - 4, a nibble of 15 continues in bytes of 255. The
+// last sequence has literals only.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t PACK_MAGIC = 0x4B415050U;	// "PPAK"
+constexpr uint16_t PACK_VERSION = 1U;
+constexpr uint32_t PACK_ENTRY_ALIGNMENT = 16U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum ePackCompression : uint16_t
+{
+	PACK_COMPRESSION_NONE = 0,
+	PACK_COMPRESSION_LZ
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+struct PackHeaderT
+{
+	uint32_t							magic = PACK_MAGIC;
+	uint16_t							version = PACK_VERSION;
+	uint16_t							headerSize = sizeof(PackHeaderT);
+	uint32_t							entryCount = 0U;
+	uint32_t							nameOffset = 0U;
+	uint32_t							nameBytes = 0U;
+};
+
+struct PackEntryT
+{
+	uint64_t							pathHash = 0U;
+	uint64_t							offset = 0U;
+	uint32_t							storedSize = 0U;
+	uint32_t							size = 0U;
+	uint32_t							nameOffset = 0U;
+	uint16_t							nameLength = 0U;
+	uint16_t							compression = PACK_COMPRESSION_NONE;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A file to go into a pack, as the Packer collects them
+//------------------------------------------------------------------------------------------------------------------------------
+struct PackSourceT
+{
+	std::string							path;
+	std::vector<unsigned char>			bytes;
+	//Off for files a reader wants to use in place (cooked textures), a compressed entry has to be copied out first
+	bool								isCompressible = true;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Pointers into a mapped pack, valid while the mapping stays open
+//------------------------------------------------------------------------------------------------------------------------------
+struct PackIndexViewT
+{
+	const PackEntryT*					entries = nullptr;
+	uint32_t							entryCount = 0U;
+	const char*							names = nullptr;
+	//The whole pack, entry offsets count from here
+	const unsigned char*				data = nullptr;
+	size_t								dataSize = 0U;
+};
+
+//"./Data\Images/Foo.PNG" and "data/images/foo.png" are the same entry
+std::string		NormalizePackPath( const std::string& path );
+uint64_t		HashPackPath( const std::string& normalizedPath );
+
+//Returns false if the input would not get smaller, outBytes is then left empty
+bool			CompressPackLZ( const unsigned char* bytes, size_t byteCount, std::vector<unsigned char>& outBytes );
+//Fails on anything that would read or write out of bounds, or does not fill exactly outputSize bytes
+bool			DecompressPackLZ( const unsigned char* stored, size_t storedSize, unsigned char* output, size_t outputSize );
+
+//Entries that compress by less than minCompressionSaving (a fraction of their size) are stored as they are
+bool			WritePackFile( const std::string& filePath, const std::vector<PackSourceT>& sources, float minCompressionSaving, std::string& outError );
+//Validates the header and every entry against the file size
+bool			ReadPackIndex( const unsigned char* data, size_t dataSize, PackIndexViewT& outView );
+//Binary search on the sorted index; the name is compared too, so a hash collision with a missing file is not a hit
+const PackEntryT*	FindPackEntry( const PackIndexViewT& view, const std::string& normalizedPath );
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RenderBackend.hpp"
+//Game Systems
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/DirtyRectTracker.hpp"
+#include "Game/RenderRecorder.hpp"
+#include "Game/SpriteBatch.hpp"
+
+RenderBackend* g_renderBackend = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+RecordingRenderBackend::RecordingRenderBackend( RenderRecorder* recorder )
+	: m_recorder(recorder)
+{
+	m_clearTag = m_recorder->InternTag("Clear");
+	m_devConsoleTag = m_recorder->InternTag("DevConsole");
+}
+
+RecordingRenderBackend::~RecordingRenderBackend()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BeginCamera( Camera& camera )
+{
+	UNUSED(camera);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::UpdateCameraBuffer( Camera& camera )
+{
+	UNUSED(camera);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::ClearColorTargets( const Rgba& clearColor )
+{
+	UNUSED(clearColor);
+	m_recorder->RecordDraw(m_clearTag, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::SetShaderDepth( Shader* shader, eCompareOp compareOp, bool writeDepth )
+{
+	UNUSED(shader);
+	UNUSED(compareOp);
+	UNUSED(writeDepth);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindTextureView( uint slot, TextureView* view )
+{
+	UNUSED(slot);
+	UNUSED(view);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindTextureViewWithSampler( uint slot, TextureView* view )
+{
+	UNUSED(slot);
+	UNUSED(view);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::BindTextureViewWithSampler( uint slot, TextureView* view, eSampleMode sampleMode )
+{
+	UNUSED(slot);
+	UNUSED(view);
+	UNUSED(sampleMode);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawVertexArray( const char* tag, const Vertex_PCU* verts, uint vertCount )
+{
+	UNUSED(verts);
+	m_recorder->RecordDraw(tag, vertCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawMesh( const char* tag, GPUMesh* mesh )
+{
+	//Meshes are never created without a device, only the draw is counted
+	UNUSED(mesh);
+	m_recorder->RecordDraw(tag, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawSpriteInstances( const char* tag, const SpriteInstanceDataT* instances, uint instanceCount )
+{
+	UNUSED(instances);
+	if (instanceCount == 0U)
+	{
+		return;
+	}
+
+	m_recorder->RecordUpload(tag, (size_t)instanceCount * sizeof(SpriteInstanceDataT));
+	m_recorder->RecordDraw(tag, SPRITE_QUAD_VERTEX_COUNT, instanceCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::DrawLineArray( const char* tag, const Vertex_PCU* verts, uint vertCount )
+{
+	UNUSED(verts);
+	m_recorder->RecordDraw(tag, vertCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::RenderDevConsole( Camera& camera, float lineHeight )
+{
+	UNUSED(camera);
+	UNUSED(lineHeight);
+	m_recorder->RecordDraw(m_devConsoleTag, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::UploadLights( uint firstSlot, uint slotCount, const LightDescT* lights )
+{
+	//The LightManager records the light uploads itself
+	UNUSED(firstSlot);
+	UNUSED(slotCount);
+	UNUSED(lights);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* RecordingRenderBackend::CreateImmutableTexture( const char* tag, const CookedTextureViewT& mips, Texture2D*& outTexture )
+{
+	m_recorder->RecordUpload(tag, GetCookedTextureByteCount(mips));
+	outTexture = nullptr;
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* RecordingRenderBackend::CreateUpdatableTexture( const char* tag, uint width, uint height, const uint32_t* texels, Texture2D*& outTexture )
+{
+	UNUSED(texels);
+	m_recorder->RecordUpload(tag, (size_t)width * height * sizeof(uint32_t));
+	outTexture = nullptr;
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RecordingRenderBackend::UpdateTextureRegion( const char* tag, Texture2D* texture, const ImageRegionT& region, const uint32_t* texels )
+{
+	UNUSED(texture);
+	UNUSED(texels);
+	m_recorder->RecordUpload(tag, (size_t)region.GetArea() * sizeof(uint32_t));
+}
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Matrix44.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+#include "Engine/Renderer/Sampler.hpp"
+#include "Engine/Renderer/Shader.hpp"
+//Third Party
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class ColorTargetView;
+class GPUMesh;
+class Material;
+class RenderContext;
+class RenderRecorder;
+class ShaderCache;
+class Texture2D;
+class TextureView;
+struct Camera;
+struct CookedTextureViewT;
+struct ID3D11Buffer;
+struct ID3D11InputLayout;
+struct ID3D11PixelShader;
+struct ID3D11VertexShader;
+struct ImageRegionT;
+struct LightDescT;
+struct SpriteInstanceDataT;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What Game's render path submits through. The windowed build forwards to the RenderContext; headless builds have no device and
+// use the recording backend, so the same Game::Render runs on both and the recorder sees exactly what a real frame submits.
+//
+// Draws carry a tag naming what they are for (UI text, debug draw, sprites...), which only the recording backend uses.
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	//Null when there is no swap chain
+	virtual ColorTargetView*			GetFrameColorTarget() = 0;
+	virtual void						BeginCamera( Camera& camera ) = 0;
+	virtual void						EndCamera() = 0;
+	virtual void						UpdateCameraBuffer( Camera& camera ) = 0;
+	virtual void						ClearColorTargets( const Rgba& clearColor ) = 0;
+
+	//Shader paths as the RenderContext takes them. Null with no device
+	virtual Shader*						CreateOrGetShader( const std::string& shaderPath ) = 0;
+	virtual void						BindShader( Shader* shader ) = 0;
+	virtual void						SetShaderDepth( Shader* shader, eCompareOp compareOp, bool writeDepth ) = 0;
+	virtual void						BindMaterial( Material* material ) = 0;
+	virtual void						BindTextureView( uint slot, TextureView* view ) = 0;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view ) = 0;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view, eSampleMode sampleMode ) = 0;
+	virtual void						SetModelMatrix( const Matrix44& model ) = 0;
+
+	virtual void						DrawVertexArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) = 0;
+	void								DrawVertexArray( const char* tag, const std::vector<Vertex_PCU>& verts ) { DrawVertexArray(tag, verts.data(), (uint)verts.size()); }
+	virtual void						DrawMesh( const char* tag, GPUMesh* mesh ) = 0;
+	//One quad per instance with the bound texture, and the bound shader's depth and blend but the sprite shader's stages
+	virtual void						DrawSpriteInstances( const char* tag, const SpriteInstanceDataT* instances, uint instanceCount ) = 0;
+	//Pairs of verts as one pixel lines, untextured, with the bound shader's depth and blend but the line shader's stages
+	virtual void						DrawLineArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) = 0;
+	virtual void						RenderDevConsole( Camera& camera, float lineHeight ) = 0;
+
+	//Writes lights into the light buffer, slotCount of them starting at firstSlot
+	virtual void						UploadLights( uint firstSlot, uint slotCount, const LightDescT* lights ) = 0;
+
+	//Immutable textures get every mip of the view when they are created. Updatable ones are a single RGBA8 mip that takes
+	//region updates from tightly packed rows. Both return the view to bind, or null with no device; view and texture are deleted
+	virtual TextureView*				CreateImmutableTexture( const char* tag, const CookedTextureViewT& mips, Texture2D*& outTexture ) = 0;
+	virtual TextureView*				CreateUpdatableTexture( const char* tag, uint width, uint height, const uint32_t* texels, Texture2D*& outTexture ) = 0;
+	virtual void						UpdateTextureRegion( const char* tag, Texture2D* texture, const ImageRegionT& region, const uint32_t* texels ) = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Forwards to the engine's D3D11 RenderContext. Windows only, see RenderBackend_D3D11.cpp
+//------------------------------------------------------------------------------------------------------------------------------
+class EngineRenderBackend : public RenderBackend
+{
+public:
+	explicit EngineRenderBackend( RenderContext* renderContext );
+	virtual ~EngineRenderBackend();
+
+	virtual ColorTargetView*			GetFrameColorTarget() override;
+	virtual void						BeginCamera( Camera& camera ) override;
+	virtual void						EndCamera() override;
+	virtual void						UpdateCameraBuffer( Camera& camera ) override;
+	virtual void						ClearColorTargets( const Rgba& clearColor ) override;
+
+	virtual Shader*						CreateOrGetShader( const std::string& shaderPath ) override;
+	virtual void						BindShader( Shader* shader ) override;
+	virtual void						SetShaderDepth( Shader* shader, eCompareOp compareOp, bool writeDepth ) override;
+	virtual void						BindMaterial( Material* material ) override;
+	virtual void						BindTextureView( uint slot, TextureView* view ) override;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view ) override;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view, eSampleMode sampleMode ) override;
+	virtual void						SetModelMatrix( const Matrix44& model ) override;
+
+	using RenderBackend::DrawVertexArray;
+	virtual void						DrawVertexArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) override;
+	virtual void						DrawMesh( const char* tag, GPUMesh* mesh ) override;
+	virtual void						DrawSpriteInstances( const char* tag, const SpriteInstanceDataT* instances, uint instanceCount ) override;
+	virtual void						DrawLineArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) override;
+	virtual void						RenderDevConsole( Camera& camera, float lineHeight ) override;
+
+	virtual void						UploadLights( uint firstSlot, uint slotCount, const LightDescT* lights ) override;
+
+	virtual TextureView*				CreateImmutableTexture( const char* tag, const CookedTextureViewT& mips, Texture2D*& outTexture ) override;
+	virtual TextureView*				CreateUpdatableTexture( const char* tag, uint width, uint height, const uint32_t* texels, Texture2D*& outTexture ) override;
+	virtual void						UpdateTextureRegion( const char* tag, Texture2D* texture, const ImageRegionT& region, const uint32_t* texels ) override;
+
+private:
+	bool								CreateSpriteInstancing();
+	bool								CreateLineDrawing();
+
+private:
+	RenderContext*						m_renderContext = nullptr;
+	ShaderCache*						m_shaderCache = nullptr;
+
+	//Sprite instances stream through a dynamic vertex buffer used as a ring, see DrawSpriteInstances
+	ID3D11VertexShader*					m_spriteVertexShader = nullptr;
+	ID3D11PixelShader*					m_spritePixelShader = nullptr;
+	ID3D11InputLayout*					m_spriteInputLayout = nullptr;
+	ID3D11Buffer*						m_spriteRing = nullptr;
+	uint								m_spriteRingOffset = 0U;
+	bool								m_isSpriteInstancingBroken = false;
+
+	//Line verts stream through a ring of their own the same way, see DrawLineArray
+	ID3D11VertexShader*					m_lineVertexShader = nullptr;
+	ID3D11PixelShader*					m_linePixelShader = nullptr;
+	ID3D11InputLayout*					m_lineInputLayout = nullptr;
+	ID3D11Buffer*						m_lineRing = nullptr;
+	uint								m_lineRingOffset = 0U;
+	bool								m_isLineDrawingBroken = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// No device. Binds and state changes are dropped, draws are counted per tag and the clear and console count as draws with no
+// vertices. Draws bound to a null shader or texture still count, headless never loads either. Texture creation and updates
+// record the bytes they would send and hand back no texture, sprite instances record the quad once per instance and their bytes.
+// Line arrays are counted like vertex arrays
+//------------------------------------------------------------------------------------------------------------------------------
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	explicit RecordingRenderBackend( RenderRecorder* recorder );
+	virtual ~RecordingRenderBackend();
+
+	virtual ColorTargetView*			GetFrameColorTarget() override { return nullptr; }
+	virtual void						BeginCamera( Camera& camera ) override;
+	virtual void						EndCamera() override {}
+	virtual void						UpdateCameraBuffer( Camera& camera ) override;
+	virtual void						ClearColorTargets( const Rgba& clearColor ) override;
+
+	virtual Shader*						CreateOrGetShader( const std::string& shaderPath ) override { UNUSED(shaderPath); return nullptr; }
+	virtual void						BindShader( Shader* shader ) override { UNUSED(shader); }
+	virtual void						SetShaderDepth( Shader* shader, eCompareOp compareOp, bool writeDepth ) override;
+	virtual void						BindMaterial( Material* material ) override { UNUSED(material); }
+	virtual void						BindTextureView( uint slot, TextureView* view ) override;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view ) override;
+	virtual void						BindTextureViewWithSampler( uint slot, TextureView* view, eSampleMode sampleMode ) override;
+	virtual void						SetModelMatrix( const Matrix44& model ) override { UNUSED(model); }
+
+	using RenderBackend::DrawVertexArray;
+	virtual void						DrawVertexArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) override;
+	virtual void						DrawMesh( const char* tag, GPUMesh* mesh ) override;
+	virtual void						DrawSpriteInstances( const char* tag, const SpriteInstanceDataT* instances, uint instanceCount ) override;
+	virtual void						DrawLineArray( const char* tag, const Vertex_PCU* verts, uint vertCount ) override;
+	virtual void						RenderDevConsole( Camera& camera, float lineHeight ) override;
+
+	virtual void						UploadLights( uint firstSlot, uint slotCount, const LightDescT* lights ) override;
+
+	virtual TextureView*				CreateImmutableTexture( const char* tag, const CookedTextureViewT& mips, Texture2D*& outTexture ) override;
+	virtual TextureView*				CreateUpdatableTexture( const char* tag, uint width, uint height, const uint32_t* texels, Texture2D*& outTexture ) override;
+	virtual void						UpdateTextureRegion( const char* tag, Texture2D* texture, const ImageRegionT& region, const uint32_t* texels ) override;
+
+private:
+	RenderRecorder*						m_recorder = nullptr;
+	uint								m_clearTag = 0U;
+	uint								m_devConsoleTag = 0U;
+};
+
+extern RenderBackend* g_renderBackend;
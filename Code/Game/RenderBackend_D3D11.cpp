@@ -0,0 +1,570 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// The RenderBackend on the engine's D3D11 RenderContext. Windows only; headless builds use the RecordingRenderBackend, which has
+// no platform code
+//------------------------------------------------------------------------------------------------------------------------------
+#if defined(_WIN32)
+#include "Game/RenderBackend.hpp"
+//Engine Systems
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Renderer/TextureView.hpp"
+//Game Systems
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/DirtyRectTracker.hpp"
+#include "Game/LightManager.hpp"
+#include "Game/ShaderCache.hpp"
+#include "Game/SpriteBatch.hpp"
+//Third Party
+#include <d3d11.h>
+#include <stddef.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr const char* SPRITE_INSTANCED_SHADER_PATH = "Data/Shaders/sprite_instanced.hlsl";
+//A frame of 100k sprites fits, so the ring only wraps once a frame
+constexpr uint SPRITE_INSTANCE_RING_CAPACITY = 128U * 1024U;
+constexpr const char* DEBUG_LINE_SHADER_PATH = "Data/Shaders/debug_line.hlsl";
+//Even, so a wrap never splits a line
+constexpr uint LINE_VERTEX_RING_CAPACITY = 64U * 1024U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static void ReleaseD3DObject( T*& object )
+{
+	if (object != nullptr)
+	{
+		object->Release();
+		object = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What the sprite and line draws bind behind the RenderContext's back. It caches its own bindings, so they are put back as found
+//------------------------------------------------------------------------------------------------------------------------------
+struct SavedDrawStateT
+{
+	ID3D11InputLayout*					inputLayout = nullptr;
+	ID3D11Buffer*						vertexBuffer = nullptr;
+	UINT								vertexStride = 0U;
+	UINT								vertexOffset = 0U;
+	D3D11_PRIMITIVE_TOPOLOGY			topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	ID3D11VertexShader*					vertexShader = nullptr;
+	ID3D11PixelShader*					pixelShader = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void SaveDrawState( ID3D11DeviceContext* context, SavedDrawStateT& outState )
+{
+	context->IAGetInputLayout(&outState.inputLayout);
+	context->IAGetVertexBuffers(0U, 1U, &outState.vertexBuffer, &outState.vertexStride, &outState.vertexOffset);
+	context->IAGetPrimitiveTopology(&outState.topology);
+	context->VSGetShader(&outState.vertexShader, nullptr, nullptr);
+	context->PSGetShader(&outState.pixelShader, nullptr, nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void RestoreDrawState( ID3D11DeviceContext* context, SavedDrawStateT& state )
+{
+	context->IASetInputLayout(state.inputLayout);
+	context->IASetVertexBuffers(0U, 1U, &state.vertexBuffer, &state.vertexStride, &state.vertexOffset);
+	context->IASetPrimitiveTopology(state.topology);
+	context->VSSetShader(state.vertexShader, nullptr, 0U);
+	context->PSSetShader(state.pixelShader, nullptr, 0U);
+
+	//Each get added a reference
+	ReleaseD3DObject(state.pixelShader);
+	ReleaseD3DObject(state.vertexShader);
+	ReleaseD3DObject(state.vertexBuffer);
+	ReleaseD3DObject(state.inputLayout);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Matches the engine's own image textures, which are UNORM
+//------------------------------------------------------------------------------------------------------------------------------
+static DXGI_FORMAT GetCookedTextureDXGIFormat( eCookedTextureFormat format )
+{
+	switch (format)
+	{
+	case COOKED_TEXTURE_FORMAT_BC1:
+		return DXGI_FORMAT_BC1_UNORM;
+	case COOKED_TEXTURE_FORMAT_BC3:
+		return DXGI_FORMAT_BC3_UNORM;
+	default:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+EngineRenderBackend::EngineRenderBackend( RenderContext* renderContext )
+	: m_renderContext(renderContext)
+{
+	m_shaderCache = new ShaderCache(CompileShaderWithD3D, D3D_SHADER_COMPILER_TAG);
+
+	//The first map has to discard
+	m_spriteRingOffset = SPRITE_INSTANCE_RING_CAPACITY;
+	m_lineRingOffset = LINE_VERTEX_RING_CAPACITY;
+}
+
+EngineRenderBackend::~EngineRenderBackend()
+{
+	ReleaseD3DObject(m_spriteRing);
+	ReleaseD3DObject(m_spriteInputLayout);
+	ReleaseD3DObject(m_spritePixelShader);
+	ReleaseD3DObject(m_spriteVertexShader);
+	ReleaseD3DObject(m_lineRing);
+	ReleaseD3DObject(m_lineInputLayout);
+	ReleaseD3DObject(m_linePixelShader);
+	ReleaseD3DObject(m_lineVertexShader);
+
+	delete m_shaderCache;
+	m_shaderCache = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ColorTargetView* EngineRenderBackend::GetFrameColorTarget()
+{
+	return m_renderContext->GetFrameColorTarget();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BeginCamera( Camera& camera )
+{
+	m_renderContext->BeginCamera(camera);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::EndCamera()
+{
+	m_renderContext->EndCamera();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::UpdateCameraBuffer( Camera& camera )
+{
+	camera.UpdateUniformBuffer(m_renderContext);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::ClearColorTargets( const Rgba& clearColor )
+{
+	m_renderContext->ClearColorTargets(clearColor);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The RenderContext only takes source, so these shaders are compiled by the engine. Only the stages this backend creates itself,
+// sprites and lines, come from the ShaderCache's bytecode
+//------------------------------------------------------------------------------------------------------------------------------
+Shader* EngineRenderBackend::CreateOrGetShader( const std::string& shaderPath )
+{
+	return m_renderContext->CreateOrGetShaderFromFile(shaderPath);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BindShader( Shader* shader )
+{
+	m_renderContext->BindShader(shader);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::SetShaderDepth( Shader* shader, eCompareOp compareOp, bool writeDepth )
+{
+	shader->SetDepth(compareOp, writeDepth);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BindMaterial( Material* material )
+{
+	m_renderContext->BindMaterial(material);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BindTextureView( uint slot, TextureView* view )
+{
+	m_renderContext->BindTextureView(slot, view);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BindTextureViewWithSampler( uint slot, TextureView* view )
+{
+	m_renderContext->BindTextureViewWithSampler(slot, view);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::BindTextureViewWithSampler( uint slot, TextureView* view, eSampleMode sampleMode )
+{
+	m_renderContext->BindTextureViewWithSampler(slot, view, sampleMode);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::SetModelMatrix( const Matrix44& model )
+{
+	m_renderContext->SetModelMatrix(model);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::DrawVertexArray( const char* tag, const Vertex_PCU* verts, uint vertCount )
+{
+	UNUSED(tag);
+	m_renderContext->DrawVertexArray((int)vertCount, verts);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::DrawMesh( const char* tag, GPUMesh* mesh )
+{
+	UNUSED(tag);
+	m_renderContext->DrawMesh(mesh);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Instances are appended behind what earlier draws wrote with no-overwrite maps, so the GPU never has to finish with the buffer
+// first. When a draw no longer fits the ring is discarded, which hands back fresh memory while the GPU reads the old one.
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::DrawSpriteInstances( const char* tag, const SpriteInstanceDataT* instances, uint instanceCount )
+{
+	UNUSED(tag);
+	if (instanceCount == 0U || !CreateSpriteInstancing())
+	{
+		return;
+	}
+
+	ID3D11DeviceContext* context = m_renderContext->m_D3DContext;
+	SavedDrawStateT savedState;
+	SaveDrawState(context, savedState);
+
+	UINT stride = (UINT)sizeof(SpriteInstanceDataT);
+	UINT offset = 0U;
+	context->IASetInputLayout(m_spriteInputLayout);
+	context->IASetVertexBuffers(0U, 1U, &m_spriteRing, &stride, &offset);
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	context->VSSetShader(m_spriteVertexShader, nullptr, 0U);
+	context->PSSetShader(m_spritePixelShader, nullptr, 0U);
+
+	while (instanceCount > 0U)
+	{
+		uint chunkCount = (instanceCount < SPRITE_INSTANCE_RING_CAPACITY) ? instanceCount : SPRITE_INSTANCE_RING_CAPACITY;
+
+		D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+		if (m_spriteRingOffset + chunkCount > SPRITE_INSTANCE_RING_CAPACITY)
+		{
+			mapType = D3D11_MAP_WRITE_DISCARD;
+			m_spriteRingOffset = 0U;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		if (FAILED(context->Map(m_spriteRing, 0U, mapType, 0U, &mapped)))
+		{
+			break;
+		}
+		memcpy((SpriteInstanceDataT*)mapped.pData + m_spriteRingOffset, instances, chunkCount * sizeof(SpriteInstanceDataT));
+		context->Unmap(m_spriteRing, 0U);
+
+		context->DrawInstanced(SPRITE_QUAD_VERTEX_COUNT, chunkCount, 0U, m_spriteRingOffset);
+
+		m_spriteRingOffset += chunkCount;
+		instances += chunkCount;
+		instanceCount -= chunkCount;
+	}
+
+	RestoreDrawState(context, savedState);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Built on first use. A shader that does not compile is reported once and sprites are skipped from then on
+//------------------------------------------------------------------------------------------------------------------------------
+bool EngineRenderBackend::CreateSpriteInstancing()
+{
+	if (m_spriteRing != nullptr)
+	{
+		return true;
+	}
+	if (m_isSpriteInstancingBroken)
+	{
+		return false;
+	}
+	m_isSpriteInstancingBroken = true;
+
+	ShaderPassDescT pass;
+	std::vector<unsigned char> vertexCode;
+	std::vector<unsigned char> pixelCode;
+	if (!ReadShaderPassDesc(SPRITE_INSTANCED_SHADER_PATH, pass) || !m_shaderCache->GetOrCompilePass(pass, vertexCode, pixelCode))
+	{
+		return false;
+	}
+
+	//Every field steps once per instance, the corner comes from the vertex id
+	D3D11_INPUT_ELEMENT_DESC elements[] =
+	{
+		{ "CORNER",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, (UINT)offsetof(SpriteInstanceDataT, corner),	D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "RIGHT",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, (UINT)offsetof(SpriteInstanceDataT, right),	D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "UP",			0, DXGI_FORMAT_R32G32B32_FLOAT,		0, (UINT)offsetof(SpriteInstanceDataT, up),		D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "UVMINS",		0, DXGI_FORMAT_R32G32_FLOAT,		0, (UINT)offsetof(SpriteInstanceDataT, uvMins),	D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "UVMAXS",		0, DXGI_FORMAT_R32G32_FLOAT,		0, (UINT)offsetof(SpriteInstanceDataT, uvMaxs),	D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "TINT",		0, DXGI_FORMAT_R32G32B32A32_FLOAT,	0, (UINT)offsetof(SpriteInstanceDataT, tint),	D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+	};
+
+	D3D11_BUFFER_DESC ringDesc;
+	memset(&ringDesc, 0, sizeof(ringDesc));
+	ringDesc.ByteWidth = SPRITE_INSTANCE_RING_CAPACITY * (UINT)sizeof(SpriteInstanceDataT);
+	ringDesc.Usage = D3D11_USAGE_DYNAMIC;
+	ringDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	ringDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	ID3D11Device* device = m_renderContext->m_D3DDevice;
+	bool isCreated = SUCCEEDED(device->CreateVertexShader(vertexCode.data(), vertexCode.size(), nullptr, &m_spriteVertexShader))
+		&& SUCCEEDED(device->CreatePixelShader(pixelCode.data(), pixelCode.size(), nullptr, &m_spritePixelShader))
+		&& SUCCEEDED(device->CreateInputLayout(elements, (UINT)(sizeof(elements) / sizeof(elements[0])), vertexCode.data(), vertexCode.size(), &m_spriteInputLayout))
+		&& SUCCEEDED(device->CreateBuffer(&ringDesc, nullptr, &m_spriteRing));
+
+	if (!isCreated)
+	{
+		ReleaseD3DObject(m_spriteRing);
+		ReleaseD3DObject(m_spriteInputLayout);
+		ReleaseD3DObject(m_spritePixelShader);
+		ReleaseD3DObject(m_spriteVertexShader);
+		DebuggerPrintf("\n Could not create the sprite instancing resources");
+		return false;
+	}
+
+	m_isSpriteInstancingBroken = false;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Streamed like DrawSpriteInstances, one vertex per element instead of one instance
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::DrawLineArray( const char* tag, const Vertex_PCU* verts, uint vertCount )
+{
+	UNUSED(tag);
+	//A dangling vertex has no line to go with
+	vertCount &= ~1U;
+	if (vertCount == 0U || !CreateLineDrawing())
+	{
+		return;
+	}
+
+	ID3D11DeviceContext* context = m_renderContext->m_D3DContext;
+	SavedDrawStateT savedState;
+	SaveDrawState(context, savedState);
+
+	UINT stride = (UINT)sizeof(Vertex_PCU);
+	UINT offset = 0U;
+	context->IASetInputLayout(m_lineInputLayout);
+	context->IASetVertexBuffers(0U, 1U, &m_lineRing, &stride, &offset);
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+	context->VSSetShader(m_lineVertexShader, nullptr, 0U);
+	context->PSSetShader(m_linePixelShader, nullptr, 0U);
+
+	while (vertCount > 0U)
+	{
+		uint chunkCount = (vertCount < LINE_VERTEX_RING_CAPACITY) ? vertCount : LINE_VERTEX_RING_CAPACITY;
+
+		D3D11_MAP mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+		if (m_lineRingOffset + chunkCount > LINE_VERTEX_RING_CAPACITY)
+		{
+			mapType = D3D11_MAP_WRITE_DISCARD;
+			m_lineRingOffset = 0U;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		if (FAILED(context->Map(m_lineRing, 0U, mapType, 0U, &mapped)))
+		{
+			break;
+		}
+		memcpy((Vertex_PCU*)mapped.pData + m_lineRingOffset, verts, chunkCount * sizeof(Vertex_PCU));
+		context->Unmap(m_lineRing, 0U);
+
+		context->Draw(chunkCount, m_lineRingOffset);
+
+		m_lineRingOffset += chunkCount;
+		verts += chunkCount;
+		vertCount -= chunkCount;
+	}
+
+	RestoreDrawState(context, savedState);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Built on first use like the sprite instancing
+//------------------------------------------------------------------------------------------------------------------------------
+bool EngineRenderBackend::CreateLineDrawing()
+{
+	if (m_lineRing != nullptr)
+	{
+		return true;
+	}
+	if (m_isLineDrawingBroken)
+	{
+		return false;
+	}
+	m_isLineDrawingBroken = true;
+
+	ShaderPassDescT pass;
+	std::vector<unsigned char> vertexCode;
+	std::vector<unsigned char> pixelCode;
+	if (!ReadShaderPassDesc(DEBUG_LINE_SHADER_PATH, pass) || !m_shaderCache->GetOrCompilePass(pass, vertexCode, pixelCode))
+	{
+		return false;
+	}
+
+	D3D11_INPUT_ELEMENT_DESC elements[] =
+	{
+		{ "POSITION",	0, DXGI_FORMAT_R32G32B32_FLOAT,		0, (UINT)offsetof(Vertex_PCU, m_position),		D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "COLOR",		0, DXGI_FORMAT_R32G32B32A32_FLOAT,	0, (UINT)offsetof(Vertex_PCU, m_color),			D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD",	0, DXGI_FORMAT_R32G32_FLOAT,		0, (UINT)offsetof(Vertex_PCU, m_uvTexCoords),	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+
+	D3D11_BUFFER_DESC ringDesc;
+	memset(&ringDesc, 0, sizeof(ringDesc));
+	ringDesc.ByteWidth = LINE_VERTEX_RING_CAPACITY * (UINT)sizeof(Vertex_PCU);
+	ringDesc.Usage = D3D11_USAGE_DYNAMIC;
+	ringDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	ringDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	ID3D11Device* device = m_renderContext->m_D3DDevice;
+	bool isCreated = SUCCEEDED(device->CreateVertexShader(vertexCode.data(), vertexCode.size(), nullptr, &m_lineVertexShader))
+		&& SUCCEEDED(device->CreatePixelShader(pixelCode.data(), pixelCode.size(), nullptr, &m_linePixelShader))
+		&& SUCCEEDED(device->CreateInputLayout(elements, (UINT)(sizeof(elements) / sizeof(elements[0])), vertexCode.data(), vertexCode.size(), &m_lineInputLayout))
+		&& SUCCEEDED(device->CreateBuffer(&ringDesc, nullptr, &m_lineRing));
+
+	if (!isCreated)
+	{
+		ReleaseD3DObject(m_lineRing);
+		ReleaseD3DObject(m_lineInputLayout);
+		ReleaseD3DObject(m_linePixelShader);
+		ReleaseD3DObject(m_lineVertexShader);
+		DebuggerPrintf("\n Could not create the line drawing resources");
+		return false;
+	}
+
+	m_isLineDrawingBroken = false;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::RenderDevConsole( Camera& camera, float lineHeight )
+{
+	g_devConsole->Render(*m_renderContext, camera, lineHeight);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::UploadLights( uint firstSlot, uint slotCount, const LightDescT* lights )
+{
+	for (uint lightIndex = 0; lightIndex < slotCount; ++lightIndex)
+	{
+		const LightDescT& desc = lights[lightIndex];
+		LightT& light = m_renderContext->m_cpuLightBuffer.lights[firstSlot + lightIndex];
+
+		light.position = desc.position;
+		light.color = desc.color;
+		light.color.a = desc.intensity;
+		light.direction = desc.direction;
+		light.isDirection = desc.isDirectional ? 1.f : 0.f;
+		light.diffuseAttenuation = desc.diffuseAttenuation;
+		light.specularAttenuation = desc.specularAttenuation;
+	}
+
+	m_renderContext->m_lightBufferDirty = true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The engine's Texture2D only loads whole images into single mip dynamic textures, so the resource is created here and handed
+// to a Texture2D, which makes the view as it does for its own
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* EngineRenderBackend::CreateImmutableTexture( const char* tag, const CookedTextureViewT& mips, Texture2D*& outTexture )
+{
+	UNUSED(tag);
+	outTexture = nullptr;
+	if (mips.mipCount == 0U)
+	{
+		return nullptr;
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	memset(&desc, 0, sizeof(desc));
+	desc.Width = mips.mips[0].width;
+	desc.Height = mips.mips[0].height;
+	desc.MipLevels = mips.mipCount;
+	desc.ArraySize = 1U;
+	desc.Format = GetCookedTextureDXGIFormat(mips.format);
+	desc.SampleDesc.Count = 1U;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	//A row of BC blocks is the pitch of a block compressed mip
+	D3D11_SUBRESOURCE_DATA mipData[COOKED_TEXTURE_MAX_MIPS];
+	for (uint mipIndex = 0; mipIndex < mips.mipCount; ++mipIndex)
+	{
+		const CookedTextureMipDataT& mip = mips.mips[mipIndex];
+		mipData[mipIndex].pSysMem = mip.data;
+		mipData[mipIndex].SysMemPitch = (UINT)GetCookedMipByteCount(mips.format, mip.width, 1U);
+		mipData[mipIndex].SysMemSlicePitch = 0U;
+	}
+
+	ID3D11Texture2D* d3dTexture = nullptr;
+	if (FAILED(m_renderContext->m_D3DDevice->CreateTexture2D(&desc, mipData, &d3dTexture)))
+	{
+		return nullptr;
+	}
+
+	outTexture = new Texture2D(m_renderContext);
+	outTexture->m_handle = d3dTexture;
+	return outTexture->CreateTextureView2D();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* EngineRenderBackend::CreateUpdatableTexture( const char* tag, uint width, uint height, const uint32_t* texels, Texture2D*& outTexture )
+{
+	UNUSED(tag);
+	outTexture = nullptr;
+
+	//Default usage so regions can be updated in place; a dynamic texture can only be rewritten whole
+	D3D11_TEXTURE2D_DESC desc;
+	memset(&desc, 0, sizeof(desc));
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = 1U;
+	desc.ArraySize = 1U;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1U;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA texelData;
+	texelData.pSysMem = texels;
+	texelData.SysMemPitch = width * (UINT)sizeof(uint32_t);
+	texelData.SysMemSlicePitch = 0U;
+
+	ID3D11Texture2D* d3dTexture = nullptr;
+	if (FAILED(m_renderContext->m_D3DDevice->CreateTexture2D(&desc, &texelData, &d3dTexture)))
+	{
+		return nullptr;
+	}
+
+	outTexture = new Texture2D(m_renderContext);
+	outTexture->m_handle = d3dTexture;
+	return outTexture->CreateTextureView2D();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EngineRenderBackend::UpdateTextureRegion( const char* tag, Texture2D* texture, const ImageRegionT& region, const uint32_t* texels )
+{
+	UNUSED(tag);
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	D3D11_BOX box;
+	box.left = region.minX;
+	box.top = region.minY;
+	box.front = 0U;
+	box.right = region.maxX;
+	box.bottom = region.maxY;
+	box.back = 1U;
+
+	m_renderContext->m_D3DContext->UpdateSubresource(texture->m_handle, 0U, &box, texels, region.GetWidth() * (UINT)sizeof(uint32_t), 0U);
+}
+
+#endif
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/RenderRecorder.hpp"
+//Third Party
+#include <stdio.h>
+#include <string.h>
+
+RenderRecorder* g_renderRecorder = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderRecorder::RenderRecorder()
+{
+}
+
+RenderRecorder::~RenderRecorder()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::BeginFrame()
+{
+	for (RenderTagT& tag : m_tags)
+	{
+		tag.frameRecord = RenderRecordT();
+	}
+
+	m_frameTotals = RenderRecordT();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::EndFrame()
+{
+	m_frameCount++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int RenderRecorder::FindTag( const char* tag ) const
+{
+	for (size_t tagIndex = 0; tagIndex < m_tags.size(); ++tagIndex)
+	{
+		if (strcmp(m_tags[tagIndex].name.c_str(), tag) == 0)
+		{
+			return (int)tagIndex;
+		}
+	}
+
+	return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint RenderRecorder::InternTag( const char* tag )
+{
+	int tagIndex = FindTag(tag);
+	if (tagIndex >= 0)
+	{
+		return (uint)tagIndex;
+	}
+
+	m_tags.emplace_back();
+	m_tags.back().name = tag;
+	return (uint)m_tags.size() - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::RecordDraw( uint tagId, uint vertexCount, uint instanceCount /*= 1U*/ )
+{
+	RenderRecordT& frameRecord = m_tags[tagId].frameRecord;
+	frameRecord.drawCalls++;
+	frameRecord.vertexCount += vertexCount;
+	frameRecord.instanceCount += instanceCount;
+
+	RenderRecordT& runRecord = m_tags[tagId].runRecord;
+	runRecord.drawCalls++;
+	runRecord.vertexCount += vertexCount;
+	runRecord.instanceCount += instanceCount;
+
+	m_frameTotals.drawCalls++;
+	m_frameTotals.vertexCount += vertexCount;
+	m_frameTotals.instanceCount += instanceCount;
+
+	m_runTotals.drawCalls++;
+	m_runTotals.vertexCount += vertexCount;
+	m_runTotals.instanceCount += instanceCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::RecordUpload( uint tagId, size_t byteCount )
+{
+	RenderRecordT& frameRecord = m_tags[tagId].frameRecord;
+	frameRecord.uploadCount++;
+	frameRecord.uploadBytes += byteCount;
+
+	RenderRecordT& runRecord = m_tags[tagId].runRecord;
+	runRecord.uploadCount++;
+	runRecord.uploadBytes += byteCount;
+
+	m_frameTotals.uploadCount++;
+	m_frameTotals.uploadBytes += byteCount;
+
+	m_runTotals.uploadCount++;
+	m_runTotals.uploadBytes += byteCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderRecordT RenderRecorder::GetFrameRecord( const char* tag ) const
+{
+	int tagIndex = FindTag(tag);
+	return (tagIndex < 0) ? RenderRecordT() : m_tags[tagIndex].frameRecord;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+RenderRecordT RenderRecorder::GetRunRecord( const char* tag ) const
+{
+	int tagIndex = FindTag(tag);
+	return (tagIndex < 0) ? RenderRecordT() : m_tags[tagIndex].runRecord;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::ResetRunTotals()
+{
+	//Tag ids stay valid, only the counts go
+	for (RenderTagT& tag : m_tags)
+	{
+		tag.runRecord = RenderRecordT();
+	}
+
+	m_runTotals = RenderRecordT();
+	m_frameCount = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RenderRecorder::PrintSummary() const
+{
+	uint frames = (m_frameCount > 0U) ? m_frameCount : 1U;
+
+	printf("\n Render Recorder: %u frames", m_frameCount);
+	printf("\n %-24s %12s %14s %12s %16s", "Tag", "Draws/Frame", "Verts/Frame", "Uploads", "Bytes/Frame");
+
+	for (const RenderTagT& tag : m_tags)
+	{
+		const RenderRecordT& record = tag.runRecord;
+		if (record.drawCalls == 0U && record.uploadCount == 0U)
+		{
+			continue;
+		}
+
+		printf("\n %-24s %12.2f %14.2f %12u %16.2f",
+			tag.name.c_str(),
+			(double)record.drawCalls / frames,
+			(double)record.vertexCount / frames,
+			record.uploadCount,
+			(double)record.uploadBytes / frames);
+	}
+
+	printf("\n %-24s %12.2f %14.2f %12u %16.2f \n",
+		"Total",
+		(double)m_runTotals.drawCalls / frames,
+		(double)m_runTotals.vertexCount / frames,
+		m_runTotals.uploadCount,
+		(double)m_runTotals.uploadBytes / frames);
+}
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Records the draws and CPU->GPU uploads a frame submits so the frame loop can run (and be measured) without a window or a
+// GPU; the RecordingRenderBackend feeds it in headless builds. Also usable alongside the real RenderContext to count traffic.
+//------------------------------------------------------------------------------------------------------------------------------
+struct RenderRecordT
+{
+	uint								drawCalls = 0U;
+	uint								vertexCount = 0U;
+	uint								instanceCount = 0U;
+	uint								uploadCount = 0U;
+	size_t								uploadBytes = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Tags are interned: the first time a tag is seen its text is copied once and it gets an id. Recording by id is an index, by
+// text a compare against the few tags seen so far; neither builds a string or touches a map
+//------------------------------------------------------------------------------------------------------------------------------
+class RenderRecorder
+{
+public:
+	RenderRecorder();
+	~RenderRecorder();
+
+	void								BeginFrame();
+	void								EndFrame();
+
+	uint								InternTag( const char* tag );
+
+	void								RecordDraw( const char* tag, uint vertexCount, uint instanceCount = 1U ) { RecordDraw(InternTag(tag), vertexCount, instanceCount); }
+	void								RecordDraw( uint tagId, uint vertexCount, uint instanceCount = 1U );
+	void								RecordUpload( const char* tag, size_t byteCount ) { RecordUpload(InternTag(tag), byteCount); }
+	void								RecordUpload( uint tagId, size_t byteCount );
+
+	const RenderRecordT&				GetFrameTotals() const { return m_frameTotals; }
+	const RenderRecordT&				GetRunTotals() const { return m_runTotals; }
+	RenderRecordT						GetFrameRecord( const char* tag ) const;
+	RenderRecordT						GetRunRecord( const char* tag ) const;
+	uint								GetFrameCount() const { return m_frameCount; }
+	uint								GetTagCount() const { return (uint)m_tags.size(); }
+
+	void								ResetRunTotals();
+	void								PrintSummary() const;
+
+private:
+	struct RenderTagT
+	{
+		std::string						name;
+		RenderRecordT					frameRecord;
+		RenderRecordT					runRecord;
+	};
+
+	int									FindTag( const char* tag ) const;
+
+private:
+	std::vector<RenderTagT>				m_tags;
+	RenderRecordT						m_frameTotals;
+	RenderRecordT						m_runTotals;
+	uint								m_frameCount = 0U;
+};
+
+extern RenderRecorder* g_renderRecorder;
@@ -0,0 +1,392 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/ShaderCache.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+#include "Game/VirtualFileSystem.hpp"
+//Engine Systems
+#include "Engine/Core/XMLUtils/XMLUtils.hpp"
+//Third Party
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <d3dcompiler.h>
+#pragma comment(lib, "d3dcompiler.lib")
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Deeper than any real include chain, shallow enough to stop a cycle the stack check somehow misses
+constexpr uint SHADER_MAX_INCLUDE_DEPTH = 32U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashShaderBytes( uint64_t hash, const void* data, size_t size )
+{
+	//With a terminating zero so neighbouring fields can not run into each other
+	return HashFNV1a(data, size, hash) * FNV1A_64_PRIME;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadShaderSource( const std::string& filePath, std::string& outSource )
+{
+	if (g_virtualFileSystem != nullptr)
+	{
+		return g_virtualFileSystem->ReadTextFile(filePath, outSource);
+	}
+
+	FILE* file = fopen(filePath.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	outSource.resize((fileSize > 0) ? (size_t)fileSize : 0U);
+	bool isRead = outSource.empty() || fread(&outSource[0], 1, outSource.size(), file) == outSource.size();
+	fclose(file);
+	return isRead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadCompiledShader( const unsigned char* data, size_t byteCount, uint64_t key, std::vector<unsigned char>& outBytecode )
+{
+	if (byteCount < sizeof(CompiledShaderHeaderT))
+	{
+		return false;
+	}
+
+	CompiledShaderHeaderT header;
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != COMPILED_SHADER_MAGIC || header.version != COMPILED_SHADER_VERSION || header.headerSize != sizeof(CompiledShaderHeaderT)
+		|| header.key != key || (uint64_t)header.bytecodeSize + sizeof(CompiledShaderHeaderT) != (uint64_t)byteCount)
+	{
+		return false;
+	}
+
+	const unsigned char* bytecode = data + sizeof(CompiledShaderHeaderT);
+	outBytecode.assign(bytecode, bytecode + header.bytecodeSize);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool WriteCompiledShader( const std::string& filePath, uint64_t key, const std::vector<unsigned char>& bytecode )
+{
+	CompiledShaderHeaderT header;
+	header.key = key;
+	header.bytecodeSize = (uint32_t)bytecode.size();
+
+	return WriteFileAtomically(filePath, [&](FILE* file)
+	{
+		return fwrite(&header, sizeof(header), 1, file) == 1
+			&& (bytecode.empty() || fwrite(bytecode.data(), 1, bytecode.size(), file) == bytecode.size());
+	});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::vector<ShaderDefineT> ParseShaderDefines( const std::string& defines )
+{
+	std::vector<ShaderDefineT> defineList;
+
+	size_t entryStart = 0;
+	while (entryStart <= defines.size())
+	{
+		size_t entryEnd = defines.find(';', entryStart);
+		if (entryEnd == std::string::npos)
+		{
+			entryEnd = defines.size();
+		}
+
+		std::string entry = defines.substr(entryStart, entryEnd - entryStart);
+		entry.erase(0, entry.find_first_not_of(" \t\r\n"));
+		entry.erase(entry.find_last_not_of(" \t\r\n") + 1);
+
+		if (!entry.empty())
+		{
+			ShaderDefineT define;
+			size_t equalsIndex = entry.find('=');
+			define.name = entry.substr(0, equalsIndex);
+			define.value = (equalsIndex == std::string::npos) ? std::string() : entry.substr(equalsIndex + 1);
+			defineList.push_back(define);
+		}
+
+		entryStart = entryEnd + 1;
+	}
+
+	return defineList;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string GetShaderDataPath( const std::string& shaderPath )
+{
+	//The engine looks bare shader names up in Data/Shaders/
+	if (shaderPath.compare(0, 5, "Data/") == 0)
+	{
+		return shaderPath;
+	}
+	return "Data/Shaders/" + shaderPath;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ReadShaderPassDesc( const std::string& shaderPath, ShaderPassDescT& outPass )
+{
+	outPass = ShaderPassDescT();
+	std::string dataPath = GetShaderDataPath(shaderPath);
+
+	size_t extensionIndex = dataPath.find_last_of('.');
+	if (extensionIndex == std::string::npos || dataPath.compare(extensionIndex, std::string::npos, ".xml") != 0)
+	{
+		outPass.sourcePath = dataPath;
+		return true;
+	}
+
+	std::string xmlText;
+	if (!ReadShaderSource(dataPath, xmlText))
+	{
+		DebuggerPrintf("\n ShaderCache: could not read %s", dataPath.c_str());
+		return false;
+	}
+
+	tinyxml2::XMLDocument shaderDoc;
+	shaderDoc.Parse(xmlText.c_str(), xmlText.size());
+	const tinyxml2::XMLElement* passElement = (shaderDoc.RootElement() != nullptr) ? shaderDoc.RootElement()->FirstChildElement("pass") : nullptr;
+	const char* sourcePath = (passElement != nullptr) ? passElement->Attribute("src") : nullptr;
+	if (sourcePath == nullptr)
+	{
+		DebuggerPrintf("\n ShaderCache: %s has no pass with a src", dataPath.c_str());
+		return false;
+	}
+
+	outPass.sourcePath = GetShaderDataPath(sourcePath);
+	const char* defines = passElement->Attribute("defines");
+	if (defines != nullptr)
+	{
+		outPass.defines = defines;
+	}
+
+	const tinyxml2::XMLElement* vertElement = passElement->FirstChildElement("vert");
+	if (vertElement != nullptr && vertElement->Attribute("entry") != nullptr)
+	{
+		outPass.vertexEntry = vertElement->Attribute("entry");
+	}
+
+	const tinyxml2::XMLElement* fragElement = passElement->FirstChildElement("frag");
+	if (fragElement != nullptr && fragElement->Attribute("entry") != nullptr)
+	{
+		outPass.fragmentEntry = fragElement->Attribute("entry");
+	}
+
+	return true;
+}
+
+#if defined(_WIN32)
+//------------------------------------------------------------------------------------------------------------------------------
+bool CompileShaderWithD3D( const std::string& source, const std::string& sourceName, const std::vector<ShaderDefineT>& defines,
+	const std::string& entryPoint, const std::string& target, std::vector<unsigned char>& outBytecode, std::string& outErrors )
+{
+	std::vector<D3D_SHADER_MACRO> macros;
+	for (const ShaderDefineT& define : defines)
+	{
+		macros.push_back({ define.name.c_str(), define.value.c_str() });
+	}
+	macros.push_back({ nullptr, nullptr });
+
+	//Includes were already pasted in by the cache, so no include handler
+	ID3DBlob* code = nullptr;
+	ID3DBlob* errors = nullptr;
+	HRESULT result = D3DCompile(source.data(), source.size(), sourceName.c_str(), macros.data(), nullptr, entryPoint.c_str(), target.c_str(),
+		D3DCOMPILE_OPTIMIZATION_LEVEL3 | D3DCOMPILE_ENABLE_STRICTNESS, 0U, &code, &errors);
+
+	if (errors != nullptr)
+	{
+		outErrors.assign((const char*)errors->GetBufferPointer(), errors->GetBufferSize());
+		errors->Release();
+	}
+
+	if (FAILED(result) || code == nullptr)
+	{
+		if (code != nullptr)
+		{
+			code->Release();
+		}
+		return false;
+	}
+
+	const unsigned char* bytes = (const unsigned char*)code->GetBufferPointer();
+	outBytecode.assign(bytes, bytes + code->GetBufferSize());
+	code->Release();
+	return true;
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+ShaderCache::ShaderCache( const ShaderCompileFunction& compileFunction, const std::string& compilerTag, const std::string& cacheFolder )
+	: m_compileFunction(compileFunction),
+	m_compilerTag(compilerTag),
+	m_cacheFolder(cacheFolder)
+{
+}
+
+ShaderCache::~ShaderCache()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::GetOrCompile( const std::string& sourcePath, const std::string& defines, const std::string& entryPoint, const std::string& target,
+	std::vector<unsigned char>& outBytecode )
+{
+	//Sources are read and hashed every time; that is what makes an edited include a miss, and it costs far less than a compile
+	std::string source;
+	if (!ExpandIncludes(sourcePath, source))
+	{
+		m_failureCount++;
+		DebuggerPrintf("\n %s", m_lastErrors.c_str());
+		return false;
+	}
+
+	std::vector<ShaderDefineT> defineList = ParseShaderDefines(defines);
+	uint64_t key = ComputeKey(source, defineList, entryPoint, target);
+	std::string cachePath = GetCacheFilePath(key);
+
+	//Bytecode shipped in the pack first, then what an earlier run compiled here
+	FileSpanT packedSpan;
+	MappedFile looseFile;
+	if ((g_virtualFileSystem != nullptr && g_virtualFileSystem->ReadPackedFile(cachePath, packedSpan) && ReadCompiledShader(packedSpan.data, packedSpan.size, key, outBytecode))
+		|| (looseFile.Open(cachePath) && ReadCompiledShader(looseFile.GetData(), looseFile.GetSize(), key, outBytecode)))
+	{
+		m_hitCount++;
+		return true;
+	}
+	looseFile.Close();
+
+	outBytecode.clear();
+	m_lastErrors.clear();
+	if (!m_compileFunction || !m_compileFunction(source, sourcePath, defineList, entryPoint, target, outBytecode, m_lastErrors))
+	{
+		//Failures are not cached, the next attempt compiles again and reports the same messages
+		m_failureCount++;
+		DebuggerPrintf("\n ShaderCache: %s %s %s failed to compile\n%s", sourcePath.c_str(), entryPoint.c_str(), target.c_str(), m_lastErrors.c_str());
+		return false;
+	}
+
+	m_compileCount++;
+	if (!WriteCompiledShader(cachePath, key, outBytecode))
+	{
+		DebuggerPrintf("\n ShaderCache: could not write %s", cachePath.c_str());
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::GetOrCompilePass( const ShaderPassDescT& pass, std::vector<unsigned char>& outVertexBytecode,
+	std::vector<unsigned char>& outFragmentBytecode )
+{
+	return GetOrCompile(pass.sourcePath, pass.defines, pass.vertexEntry, SHADER_VERTEX_TARGET, outVertexBytecode)
+		&& GetOrCompile(pass.sourcePath, pass.defines, pass.fragmentEntry, SHADER_FRAGMENT_TARGET, outFragmentBytecode);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::ExpandIncludes( const std::string& sourcePath, std::string& outSource )
+{
+	outSource.clear();
+	std::vector<std::string> includeStack;
+	return ExpandIncludes(sourcePath, outSource, includeStack);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ShaderCache::ExpandIncludes( const std::string& sourcePath, std::string& outSource, std::vector<std::string>& includeStack )
+{
+	if (includeStack.size() >= SHADER_MAX_INCLUDE_DEPTH || std::find(includeStack.begin(), includeStack.end(), sourcePath) != includeStack.end())
+	{
+		m_lastErrors = "ShaderCache: include cycle through " + sourcePath;
+		return false;
+	}
+
+	std::string source;
+	if (!ReadShaderSource(sourcePath, source))
+	{
+		m_lastErrors = "ShaderCache: could not read " + sourcePath;
+		return false;
+	}
+
+	size_t folderEnd = sourcePath.find_last_of("/\\");
+	std::string folder = (folderEnd == std::string::npos) ? std::string() : sourcePath.substr(0, folderEnd + 1);
+	includeStack.push_back(sourcePath);
+	outSource += "#line 1 \"" + sourcePath + "\"\n";
+
+	uint lineNumber = 0U;
+	for (size_t lineStart = 0; lineStart < source.size();)
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+		{
+			lineEnd = source.size();
+		}
+
+		//Line endings are normalized so a checkout with CRLF hashes the same as one with LF
+		std::string line = source.substr(lineStart, lineEnd - lineStart);
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+		lineStart = lineEnd + 1;
+		lineNumber++;
+
+		size_t directiveStart = line.find_first_not_of(" \t");
+		size_t nameStart = std::string::npos;
+		size_t nameEnd = std::string::npos;
+		if (directiveStart != std::string::npos && line.compare(directiveStart, 8, "#include") == 0)
+		{
+			nameStart = line.find('"', directiveStart + 8);
+			nameEnd = (nameStart != std::string::npos) ? line.find('"', nameStart + 1) : std::string::npos;
+		}
+
+		//Only quoted includes are ours to resolve, anything else goes to the compiler untouched
+		if (nameEnd == std::string::npos)
+		{
+			outSource += line;
+			outSource += '\n';
+			continue;
+		}
+
+		if (!ExpandIncludes(folder + line.substr(nameStart + 1, nameEnd - nameStart - 1), outSource, includeStack))
+		{
+			return false;
+		}
+		outSource += "#line " + std::to_string(lineNumber + 1U) + " \"" + sourcePath + "\"\n";
+	}
+
+	includeStack.pop_back();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t ShaderCache::ComputeKey( const std::string& expandedSource, const std::vector<ShaderDefineT>& defines, const std::string& entryPoint,
+	const std::string& target ) const
+{
+	uint64_t key = FNV1A_64_OFFSET_BASIS;
+	key = HashShaderBytes(key, m_compilerTag.data(), m_compilerTag.size());
+	key = HashShaderBytes(key, target.data(), target.size());
+	key = HashShaderBytes(key, entryPoint.data(), entryPoint.size());
+
+	//Order is kept, a later define of the same name wins in the compiler too
+	for (const ShaderDefineT& define : defines)
+	{
+		key = HashShaderBytes(key, define.name.data(), define.name.size());
+		key = HashShaderBytes(key, define.value.data(), define.value.size());
+	}
+
+	key = HashShaderBytes(key, expandedSource.data(), expandedSource.size());
+	return key;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string ShaderCache::GetCacheFilePath( uint64_t key ) const
+{
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "%016llx.cso", (unsigned long long)key);
+	return m_cacheFolder + fileName;
+}
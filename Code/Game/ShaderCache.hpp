@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Third Party
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ShaderDefineT
+{
+	std::string							name;
+	std::string							value;
+};
+
+//"NAME=VALUE;FLAG" as written in a shader pass's defines attribute. A bare name is defined with an empty value
+std::vector<ShaderDefineT>	ParseShaderDefines( const std::string& defines );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a shader's pass compiles, read the way the engine reads it: an .xml names the source, defines and entry points in its
+// pass, anything else is the source itself with no defines and the engine's default entry points
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr const char* SHADER_VERTEX_TARGET = "vs_5_0";
+constexpr const char* SHADER_FRAGMENT_TARGET = "ps_5_0";
+
+struct ShaderPassDescT
+{
+	std::string							sourcePath;
+	std::string							defines;
+	std::string							vertexEntry = "VertexFunction";
+	std::string							fragmentEntry = "FragmentFunction";
+};
+
+//shaderPath is what the game asks the engine for; both it and an .xml's source are under Data/Shaders/ unless they say otherwise
+bool						ReadShaderPassDesc( const std::string& shaderPath, ShaderPassDescT& outPass );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Compiles one stage from fully expanded source. Returns false with the compiler's messages in outErrors on failure
+//------------------------------------------------------------------------------------------------------------------------------
+typedef std::function<bool( const std::string& source, const std::string& sourceName, const std::vector<ShaderDefineT>& defines,
+	const std::string& entryPoint, const std::string& target, std::vector<unsigned char>& outBytecode, std::string& outErrors )> ShaderCompileFunction;
+
+#if defined(_WIN32)
+//Flags are part of what the tag names; change the tag whenever they change so old bytecode is not reused
+constexpr const char* D3D_SHADER_COMPILER_TAG = "d3dcompiler_47 O3";
+bool						CompileShaderWithD3D( const std::string& source, const std::string& sourceName, const std::vector<ShaderDefineT>& defines,
+								const std::string& entryPoint, const std::string& target, std::vector<unsigned char>& outBytecode, std::string& outErrors );
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Compiled shader file layout
+//
+// File:	CompiledShaderHeaderT, then bytecodeSize bytes of bytecode. The file is named after the key; the key is stored again
+// so a renamed or truncated file is never mistaken for a hit.
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t COMPILED_SHADER_MAGIC = 0x42434853U;	// "SHCB"
+constexpr uint16_t COMPILED_SHADER_VERSION = 1U;
+
+#pragma pack(push, 1)
+struct CompiledShaderHeaderT
+{
+	uint32_t							magic = COMPILED_SHADER_MAGIC;
+	uint16_t							version = COMPILED_SHADER_VERSION;
+	uint16_t							headerSize = sizeof(CompiledShaderHeaderT);
+	uint64_t							key = 0U;
+	uint32_t							bytecodeSize = 0U;
+};
+#pragma pack(pop)
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Content addressed cache of compiled shader stages. The key hashes the source after every #include is pasted in, the defines
+// in order, the entry point, the target and the compiler tag, so editing an included file or a pass's defines is a miss while
+// touching a file without changing it is not. A hit reads the bytecode from disk and never calls the compiler.
+//
+// The compiler is passed in, which keeps the cache itself platform free and lets it run against a stub on Linux.
+//------------------------------------------------------------------------------------------------------------------------------
+class ShaderCache
+{
+public:
+	ShaderCache( const ShaderCompileFunction& compileFunction, const std::string& compilerTag, const std::string& cacheFolder = "Data/Cache/Shaders/" );
+	~ShaderCache();
+
+	bool								GetOrCompile( const std::string& sourcePath, const std::string& defines, const std::string& entryPoint, const std::string& target,
+											std::vector<unsigned char>& outBytecode );
+	bool								GetOrCompilePass( const ShaderPassDescT& pass, std::vector<unsigned char>& outVertexBytecode,
+											std::vector<unsigned char>& outFragmentBytecode );
+
+	//Quoted includes resolve next to the file including them; #line markers keep compiler messages pointing at the right file
+	bool								ExpandIncludes( const std::string& sourcePath, std::string& outSource );
+	uint64_t							ComputeKey( const std::string& expandedSource, const std::vector<ShaderDefineT>& defines, const std::string& entryPoint,
+											const std::string& target ) const;
+	std::string							GetCacheFilePath( uint64_t key ) const;
+
+	uint								GetHitCount() const { return m_hitCount; }
+	uint								GetCompileCount() const { return m_compileCount; }
+	uint								GetFailureCount() const { return m_failureCount; }
+	const std::string&					GetLastErrors() const { return m_lastErrors; }
+
+private:
+	bool								ExpandIncludes( const std::string& sourcePath, std::string& outSource, std::vector<std::string>& includeStack );
+
+private:
+	ShaderCompileFunction				m_compileFunction;
+	std::string							m_compilerTag;
+	std::string							m_cacheFolder;
+
+	uint								m_hitCount = 0U;
+	uint								m_compileCount = 0U;
+	uint								m_failureCount = 0U;
+	std::string							m_lastErrors;
+};
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/SpatialHashGrid.hpp"
+//Game Systems
+#include "Game/JobScheduler.hpp"
+//Third Party
+#include <algorithm>
+#include <math.h>
+
+//Row chunks per thread, so a few crowded rows don't leave the other workers idle
+constexpr uint ROW_CHUNKS_PER_THREAD = 4U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+SpatialHashGrid::SpatialHashGrid( const Vec2& worldMin, const Vec2& worldMax, float cellSize )
+	: m_worldMin(worldMin),
+	m_worldMax(worldMax)
+{
+	ResizeCells(cellSize);
+}
+
+SpatialHashGrid::~SpatialHashGrid()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::Rebuild( const float* positionsX, const float* positionsY, const float* radii, uint entityCount )
+{
+	float maxRadius = 0.f;
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		maxRadius = (radii[entityIndex] > maxRadius) ? radii[entityIndex] : maxRadius;
+	}
+
+	//Neighbour cells only cover everything while a disc fits in a cell
+	if (maxRadius * 2.f > m_cellSize)
+	{
+		ResizeCells(maxRadius * 2.f);
+	}
+
+	m_newEntityCells.resize(entityCount);
+	const int maxCellX = (int)m_cellsX - 1;
+	const int maxCellY = (int)m_cellsY - 1;
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		int cellX = (int)floorf((positionsX[entityIndex] - m_worldMin.x) * m_inverseCellSize);
+		int cellY = (int)floorf((positionsY[entityIndex] - m_worldMin.y) * m_inverseCellSize);
+		cellX = (cellX < 0) ? 0 : ((cellX > maxCellX) ? maxCellX : cellX);
+		cellY = (cellY < 0) ? 0 : ((cellY > maxCellY) ? maxCellY : cellY);
+		m_newEntityCells[entityIndex] = (uint)cellY * m_cellsX + (uint)cellX;
+	}
+
+	//Compare against last frame; a different entity count (spawns, swap removes) always re-sorts
+	m_movedCount = entityCount;
+	if (m_entityCells.size() == entityCount && m_sortedEntities.size() == entityCount)
+	{
+		m_movedCount = 0U;
+		for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+		{
+			m_movedCount += (m_newEntityCells[entityIndex] != m_entityCells[entityIndex]) ? 1U : 0U;
+		}
+	}
+	m_entityCells.swap(m_newEntityCells);
+
+	m_wasSorted = m_movedCount > 0U;
+	if (m_wasSorted)
+	{
+		SortIntoCells(entityCount);
+	}
+
+	//Positions change every frame even when the cell order does not
+	m_sortedX.resize(entityCount);
+	m_sortedY.resize(entityCount);
+	m_sortedRadii.resize(entityCount);
+	for (uint sortedIndex = 0; sortedIndex < entityCount; ++sortedIndex)
+	{
+		uint entityIndex = m_sortedEntities[sortedIndex];
+		m_sortedX[sortedIndex] = positionsX[entityIndex];
+		m_sortedY[sortedIndex] = positionsY[entityIndex];
+		m_sortedRadii[sortedIndex] = radii[entityIndex];
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::FindCandidatePairs( std::vector<CollisionPairT>& outPairs, JobScheduler* scheduler )
+{
+	uint threadCount = (scheduler != nullptr) ? scheduler->GetWorkerCount() + 1U : 1U;
+	if (threadCount <= 1U || m_cellsY < 2U)
+	{
+		FindPairsInRows(0U, m_cellsY, outPairs);
+		return;
+	}
+
+	uint chunkCount = std::min(threadCount * ROW_CHUNKS_PER_THREAD, m_cellsY);
+	uint rowsPerChunk = (m_cellsY + chunkCount - 1U) / chunkCount;
+	chunkCount = (m_cellsY + rowsPerChunk - 1U) / rowsPerChunk;
+
+	if (m_chunkPairs.size() < chunkCount)
+	{
+		m_chunkPairs.resize(chunkCount);
+	}
+
+	scheduler->ParallelFor(0U, chunkCount, 1U, [this, rowsPerChunk](uint beginChunk, uint endChunk)
+	{
+		for (uint chunkIndex = beginChunk; chunkIndex < endChunk; ++chunkIndex)
+		{
+			uint beginRow = chunkIndex * rowsPerChunk;
+			uint endRow = std::min(beginRow + rowsPerChunk, m_cellsY);
+
+			m_chunkPairs[chunkIndex].clear();
+			FindPairsInRows(beginRow, endRow, m_chunkPairs[chunkIndex]);
+		}
+	});
+
+	for (uint chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+	{
+		outPairs.insert(outPairs.end(), m_chunkPairs[chunkIndex].begin(), m_chunkPairs[chunkIndex].end());
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Disc vs disc over the whole buffer. Branch free compaction, the loop stays a straight stream over the pairs
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint SpatialHashGrid::FilterOverlappingPairs( const float* positionsX, const float* positionsY, const float* radii, std::vector<CollisionPairT>& inOutPairs )
+{
+	CollisionPairT* pairs = inOutPairs.data();
+	uint pairCount = (uint)inOutPairs.size();
+	uint keptCount = 0U;
+
+	for (uint pairIndex = 0; pairIndex < pairCount; ++pairIndex)
+	{
+		CollisionPairT pair = pairs[pairIndex];
+		float deltaX = positionsX[pair.entityB] - positionsX[pair.entityA];
+		float deltaY = positionsY[pair.entityB] - positionsY[pair.entityA];
+		float radiusSum = radii[pair.entityA] + radii[pair.entityB];
+
+		pairs[keptCount] = pair;
+		keptCount += (deltaX * deltaX + deltaY * deltaY < radiusSum * radiusSum) ? 1U : 0U;
+	}
+
+	inOutPairs.resize(keptCount);
+	return keptCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::ResizeCells( float cellSize )
+{
+	m_cellSize = (cellSize > 0.f) ? cellSize : 1.f;
+	m_inverseCellSize = 1.f / m_cellSize;
+
+	float worldWidth = m_worldMax.x - m_worldMin.x;
+	float worldHeight = m_worldMax.y - m_worldMin.y;
+	m_cellsX = std::max(1U, (uint)ceilf(worldWidth * m_inverseCellSize));
+	m_cellsY = std::max(1U, (uint)ceilf(worldHeight * m_inverseCellSize));
+	m_cellStarts.assign(m_cellsX * m_cellsY + 1U, 0U);
+
+	//Old cell indices mean nothing with the new layout
+	m_entityCells.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Counting sort by cell. Entities keep their index order inside a cell, so the pair order is deterministic
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::SortIntoCells( uint entityCount )
+{
+	uint cellCount = m_cellsX * m_cellsY;
+	std::fill(m_cellStarts.begin(), m_cellStarts.end(), 0U);
+
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		m_cellStarts[m_entityCells[entityIndex]]++;
+	}
+
+	uint runningTotal = 0U;
+	for (uint cellIndex = 0; cellIndex <= cellCount; ++cellIndex)
+	{
+		uint cellEntityCount = m_cellStarts[cellIndex];
+		m_cellStarts[cellIndex] = runningTotal;
+		runningTotal += cellEntityCount;
+	}
+
+	//Scatter, using the starts as write cursors; afterwards each holds the next cell's start
+	m_sortedEntities.resize(entityCount);
+	for (uint entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+	{
+		m_sortedEntities[m_cellStarts[m_entityCells[entityIndex]]++] = entityIndex;
+	}
+
+	for (uint cellIndex = cellCount; cellIndex > 0U; --cellIndex)
+	{
+		m_cellStarts[cellIndex] = m_cellStarts[cellIndex - 1U];
+	}
+	m_cellStarts[0] = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Cells of a row are contiguous in the sorted arrays, so a cell and its right neighbour are one range, and the three cells
+// above are another. Pairs are written unconditionally and only counted when they pass, which keeps the inner loop free of
+// hard to predict branches
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashGrid::FindPairsInRows( uint beginRow, uint endRow, std::vector<CollisionPairT>& outPairs ) const
+{
+	const float* sortedX = m_sortedX.data();
+	const float* sortedY = m_sortedY.data();
+	const float* sortedRadii = m_sortedRadii.data();
+	const uint* sortedEntities = m_sortedEntities.data();
+	const uint* cellStarts = m_cellStarts.data();
+
+	size_t pairCount = outPairs.size();
+
+	for (uint cellY = beginRow; cellY < endRow; ++cellY)
+	{
+		uint rowStart = cellY * m_cellsX;
+		uint rowAboveStart = rowStart + m_cellsX;
+		bool hasRowAbove = (cellY + 1U) < m_cellsY;
+
+		for (uint cellX = 0; cellX < m_cellsX; ++cellX)
+		{
+			uint cellBegin = cellStarts[rowStart + cellX];
+			uint cellEnd = cellStarts[rowStart + cellX + 1U];
+			if (cellBegin == cellEnd)
+			{
+				continue;
+			}
+
+			uint sameRowEnd = cellStarts[rowStart + std::min(cellX + 2U, m_cellsX)];
+			uint aboveBegin = 0U;
+			uint aboveEnd = 0U;
+			if (hasRowAbove)
+			{
+				aboveBegin = cellStarts[rowAboveStart + ((cellX > 0U) ? cellX - 1U : 0U)];
+				aboveEnd = cellStarts[rowAboveStart + std::min(cellX + 2U, m_cellsX)];
+			}
+
+			for (uint sortedA = cellBegin; sortedA < cellEnd; ++sortedA)
+			{
+				//Room for every candidate of this entity passing. Growth doubles, so a crowded cell costs what its pairs do
+				size_t maxNewPairs = (size_t)(sameRowEnd - sortedA - 1U) + (aboveEnd - aboveBegin);
+				if (pairCount + maxNewPairs > outPairs.size())
+				{
+					outPairs.resize(std::max(outPairs.size() * 2U, pairCount + maxNewPairs));
+				}
+				CollisionPairT* pairs = outPairs.data();
+
+				float ax = sortedX[sortedA];
+				float ay = sortedY[sortedA];
+				float ar = sortedRadii[sortedA];
+				uint entityA = sortedEntities[sortedA];
+
+				//Rest of this cell plus the right neighbour, then the row above
+				for (int rangeIndex = 0; rangeIndex < 2; ++rangeIndex)
+				{
+					uint rangeBegin = (rangeIndex == 0) ? sortedA + 1U : aboveBegin;
+					uint rangeEnd = (rangeIndex == 0) ? sameRowEnd : aboveEnd;
+
+					for (uint sortedB = rangeBegin; sortedB < rangeEnd; ++sortedB)
+					{
+						//Bounding square reject, the exact test is FilterOverlappingPairs
+						float reach = ar + sortedRadii[sortedB];
+						bool isNear = (fabsf(sortedX[sortedB] - ax) <= reach) & (fabsf(sortedY[sortedB] - ay) <= reach);
+
+						uint entityB = sortedEntities[sortedB];
+						pairs[pairCount].entityA = (entityA < entityB) ? entityA : entityB;
+						pairs[pairCount].entityB = (entityA < entityB) ? entityB : entityA;
+						pairCount += isNear ? 1U : 0U;
+					}
+				}
+			}
+		}
+	}
+
+	outPairs.resize(pairCount);
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+//Third Party
+#include <stdint.h>
+#include <vector>
+
+class JobScheduler;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct CollisionPairT
+{
+	uint								entityA = 0U;
+	uint								entityB = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Uniform grid broadphase for discs. Entities are bucketed by center with a counting sort into cell order, and positions and
+// radii are copied alongside so neighbour scans read contiguous memory. Cells are at least as wide as the largest diameter, so
+// each cell only needs testing against itself and 4 forward neighbours, and every pair comes out exactly once.
+//
+// Rebuild keeps its buffers and each entity's cell from the previous frame; when nobody changed cells the sort is skipped and
+// only the copied positions are refreshed. Entities outside the world are clamped into the border cells.
+//------------------------------------------------------------------------------------------------------------------------------
+class SpatialHashGrid
+{
+public:
+	explicit SpatialHashGrid( const Vec2& worldMin, const Vec2& worldMax, float cellSize );
+	~SpatialHashGrid();
+
+	void								Rebuild( const float* positionsX, const float* positionsY, const float* radii, uint entityCount );
+
+	//Appends every pair whose cells are neighbours. With a scheduler, cell rows are split into jobs and the per job results
+	//are appended in row order, so the output is the same either way
+	void								FindCandidatePairs( std::vector<CollisionPairT>& outPairs, JobScheduler* scheduler = nullptr );
+
+	//Keeps only the pairs whose discs overlap, in order. Returns the number kept
+	static uint							FilterOverlappingPairs( const float* positionsX, const float* positionsY, const float* radii, std::vector<CollisionPairT>& inOutPairs );
+
+	float								GetCellSize() const { return m_cellSize; }
+	uint								GetCellCount() const { return m_cellsX * m_cellsY; }
+	uint								GetMovedCount() const { return m_movedCount; }
+	bool								WasLastRebuildSorted() const { return m_wasSorted; }
+
+private:
+	void								ResizeCells( float cellSize );
+	void								SortIntoCells( uint entityCount );
+	void								FindPairsInRows( uint beginRow, uint endRow, std::vector<CollisionPairT>& outPairs ) const;
+
+private:
+	Vec2								m_worldMin;
+	Vec2								m_worldMax;
+	float								m_cellSize = 1.f;
+	float								m_inverseCellSize = 1.f;
+	uint								m_cellsX = 0U;
+	uint								m_cellsY = 0U;
+
+	//Per entity, indexed by entity
+	std::vector<uint>					m_entityCells;
+	std::vector<uint>					m_newEntityCells;
+
+	//m_cellStarts[cell] .. m_cellStarts[cell + 1] indexes the sorted arrays
+	std::vector<uint>					m_cellStarts;
+	std::vector<uint>					m_sortedEntities;
+	std::vector<float>					m_sortedX;
+	std::vector<float>					m_sortedY;
+	std::vector<float>					m_sortedRadii;
+
+	//One pair buffer per row chunk, kept between frames
+	std::vector<std::vector<CollisionPairT>>	m_chunkPairs;
+
+	uint								m_movedCount = 0U;
+	bool								m_wasSorted = false;
+};
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/SpriteBatch.hpp"
+//Engine Systems
+#include "Engine/Renderer/SpriteDefenition.hpp"
+//Game Systems
+#include "Game/JobScheduler.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint SPRITE_PLACE_GRAIN = 2048U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static float Dot( const Vec3& a, const Vec3& b )
+{
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SpriteFrameT::SpriteFrameT( const SpriteDefenition& spriteDef, const Vec2& spritePivot )
+	: pivot(spritePivot)
+{
+	spriteDef.GetUVs(uvMins, uvMaxs);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+IsoSpriteFramesT::IsoSpriteFramesT( const SpriteDefenition* spriteDefs, const Vec3* directions, uint count, const Vec2& spritePivot )
+{
+	frames.reserve(count);
+	this->directions.reserve(count);
+	for (uint frameIndex = 0; frameIndex < count; ++frameIndex)
+	{
+		frames.push_back(SpriteFrameT(spriteDefs[frameIndex], spritePivot));
+		this->directions.push_back(directions[frameIndex]);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const SpriteFrameT& IsoSpriteFramesT::GetFrameForDirection( const Vec3& viewDirection ) const
+{
+	uint bestIndex = 0U;
+	float bestDot = -2.f;
+	for (uint frameIndex = 0; frameIndex < (uint)directions.size(); ++frameIndex)
+	{
+		float dot = Dot(directions[frameIndex], viewDirection);
+		if (dot > bestDot)
+		{
+			bestDot = dot;
+			bestIndex = frameIndex;
+		}
+	}
+	return frames[bestIndex];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SpriteBatch::SpriteBatch()
+{
+}
+
+SpriteBatch::~SpriteBatch()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatch::Begin( const Vec3& right, const Vec3& up, const Vec3& forward )
+{
+	m_right = right;
+	m_up = up;
+	m_forward = forward;
+
+	m_textures.clear();
+	m_lastTextureSlot = 0U;
+	m_instances.clear();
+	m_draws.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatch::AddSprite( TextureView* texture, const SpriteFrameT& frame, const Vec3& position, const Vec2& size, const Rgba& tint )
+{
+	SpriteInstanceT instance;
+	instance.position = position;
+	instance.size = size;
+	instance.frame = frame;
+	instance.tint = tint;
+	instance.textureSlot = GetTextureSlot(texture);
+	m_instances.push_back(instance);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatch::AddIsoSprite( TextureView* texture, const IsoSpriteFramesT& isoFrames, const Vec3& position, const Vec3& facing, const Vec2& size,
+	const Rgba& tint )
+{
+	if (isoFrames.frames.empty())
+	{
+		return;
+	}
+
+	Vec3 viewDirection(Dot(facing, m_right), Dot(facing, m_up), Dot(facing, m_forward));
+	AddSprite(texture, isoFrames.GetFrameForDirection(viewDirection), position, size, tint);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatch::Finish( JobScheduler* scheduler )
+{
+	uint spriteCount = (uint)m_instances.size();
+	uint textureCount = (uint)m_textures.size();
+
+	//Counting sort by sheet: count, prefix sum, then hand out slots in add order
+	m_slotCounts.assign(textureCount, 0U);
+	for (const SpriteInstanceT& instance : m_instances)
+	{
+		m_slotCounts[instance.textureSlot]++;
+	}
+
+	m_draws.resize(textureCount);
+	uint firstSprite = 0U;
+	for (uint textureSlot = 0; textureSlot < textureCount; ++textureSlot)
+	{
+		m_draws[textureSlot].texture = m_textures[textureSlot];
+		m_draws[textureSlot].firstInstance = firstSprite;
+		m_draws[textureSlot].instanceCount = m_slotCounts[textureSlot];
+
+		uint slotCount = m_slotCounts[textureSlot];
+		m_slotCounts[textureSlot] = firstSprite;
+		firstSprite += slotCount;
+	}
+
+	m_destinations.resize(spriteCount);
+	for (uint spriteIndex = 0; spriteIndex < spriteCount; ++spriteIndex)
+	{
+		m_destinations[spriteIndex] = m_slotCounts[m_instances[spriteIndex].textureSlot]++;
+	}
+
+	m_instanceData.resize(spriteCount);
+
+	if (scheduler != nullptr && spriteCount > SPRITE_PLACE_GRAIN)
+	{
+		scheduler->ParallelFor(0U, spriteCount, SPRITE_PLACE_GRAIN, [this](uint beginSprite, uint endSprite)
+		{
+			PlaceSprites(beginSprite, endSprite);
+		});
+	}
+	else
+	{
+		PlaceSprites(0U, spriteCount);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sprites come and go in runs from the same sheet, so checking the last hit first skips the search almost every time
+//------------------------------------------------------------------------------------------------------------------------------
+uint SpriteBatch::GetTextureSlot( TextureView* texture )
+{
+	if (m_lastTextureSlot < (uint)m_textures.size() && m_textures[m_lastTextureSlot] == texture)
+	{
+		return m_lastTextureSlot;
+	}
+
+	for (uint textureSlot = 0; textureSlot < (uint)m_textures.size(); ++textureSlot)
+	{
+		if (m_textures[textureSlot] == texture)
+		{
+			m_lastTextureSlot = textureSlot;
+			return textureSlot;
+		}
+	}
+
+	m_textures.push_back(texture);
+	m_lastTextureSlot = (uint)m_textures.size() - 1U;
+	return m_lastTextureSlot;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpriteBatch::PlaceSprites( uint beginSprite, uint endSprite )
+{
+	//Copied out so the compiler knows the instance writes below can not change them
+	Vec3 batchRight = m_right;
+	Vec3 batchUp = m_up;
+	const SpriteInstanceT* instances = m_instances.data();
+	const uint* destinations = m_destinations.data();
+	SpriteInstanceDataT* allData = m_instanceData.data();
+
+	for (uint spriteIndex = beginSprite; spriteIndex < endSprite; ++spriteIndex)
+	{
+		const SpriteInstanceT& instance = instances[spriteIndex];
+		const SpriteFrameT& frame = instance.frame;
+
+		//The pivot lands on the sprite's position
+		SpriteInstanceDataT& data = allData[destinations[spriteIndex]];
+		data.right = batchRight * instance.size.x;
+		data.up = batchUp * instance.size.y;
+		data.corner = instance.position - data.right * frame.pivot.x - data.up * frame.pivot.y;
+		data.uvMins = frame.uvMins;
+		data.uvMaxs = frame.uvMaxs;
+		data.tint = instance.tint;
+	}
+}
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+//Third Party
+#include <vector>
+
+class JobScheduler;
+class SpriteDefenition;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a SpriteDefenition contributes to a sprite: its sheet cell and where the sprite's origin sits in that cell
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteFrameT
+{
+	SpriteFrameT() {}
+	SpriteFrameT( const SpriteDefenition& spriteDef, const Vec2& spritePivot );
+
+	Vec2								uvMins = Vec2(0.f, 0.f);
+	Vec2								uvMaxs = Vec2(1.f, 1.f);
+	Vec2								pivot = Vec2(0.5f, 0.5f);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The frames of a sprite seen from several sides, as an IsoSpriteDefenition is built: one frame per facing, each with the
+// direction it was drawn facing in. Directions are in view space, x right, y up and z away from the camera
+//------------------------------------------------------------------------------------------------------------------------------
+struct IsoSpriteFramesT
+{
+	IsoSpriteFramesT() {}
+	IsoSpriteFramesT( const SpriteDefenition* spriteDefs, const Vec3* directions, uint count, const Vec2& spritePivot );
+
+	//The frame drawn facing closest to viewDirection
+	const SpriteFrameT&					GetFrameForDirection( const Vec3& viewDirection ) const;
+
+	std::vector<SpriteFrameT>			frames;
+	std::vector<Vec3>					directions;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteInstanceT
+{
+	Vec3								position;
+	Vec2								size;
+	SpriteFrameT						frame;
+	Rgba								tint;
+	uint								textureSlot = 0U;
+};
+
+//Each instance is drawn as two triangles
+constexpr uint SPRITE_QUAD_VERTEX_COUNT = 6U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What the GPU reads for one sprite. The quad is already placed, corner is its bottom left and right and up its scaled edges, so
+// the vertex shader only has to pick a corner: 68 bytes a sprite against 144 for six Vertex_PCU. Matches sprite_instanced.hlsl
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteInstanceDataT
+{
+	Vec3								corner;
+	Vec3								right;
+	Vec3								up;
+	Vec2								uvMins;
+	Vec2								uvMaxs;
+	Rgba								tint;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One draw's worth of sprites: every sprite in it samples the same sheet
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpriteDrawT
+{
+	TextureView*						texture = nullptr;
+	uint								firstInstance = 0U;
+	uint								instanceCount = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collects camera facing sprites for a frame and places them into one instance array, grouped by sheet texture so the whole
+// batch costs one instanced draw per sheet. Add order is kept within a sheet. Finish places on the JobScheduler when given one,
+// each sprite writes only its own instance, and every buffer is kept between frames so a steady sprite count allocates nothing.
+//------------------------------------------------------------------------------------------------------------------------------
+class SpriteBatch
+{
+public:
+	SpriteBatch();
+	~SpriteBatch();
+
+	//Sprites are built in the plane of right and up, usually the camera's I and J basis; forward picks iso sprite facings
+	void								Begin( const Vec3& right, const Vec3& up, const Vec3& forward = Vec3(0.f, 0.f, 1.f) );
+	void								AddSprite( TextureView* texture, const SpriteFrameT& frame, const Vec3& position, const Vec2& size, const Rgba& tint = Rgba::WHITE );
+	//Facing is the world direction the sprite looks in, the frame drawn is the one for that direction as the camera sees it
+	void								AddIsoSprite( TextureView* texture, const IsoSpriteFramesT& isoFrames, const Vec3& position, const Vec3& facing, const Vec2& size,
+											const Rgba& tint = Rgba::WHITE );
+	void								Finish( JobScheduler* scheduler = nullptr );
+
+	uint								GetSpriteCount() const { return (uint)m_instances.size(); }
+	const std::vector<SpriteInstanceDataT>&	GetInstances() const { return m_instanceData; }
+	const std::vector<SpriteDrawT>&		GetDraws() const { return m_draws; }
+
+private:
+	uint								GetTextureSlot( TextureView* texture );
+	void								PlaceSprites( uint beginSprite, uint endSprite );
+
+private:
+	Vec3								m_right = Vec3(1.f, 0.f, 0.f);
+	Vec3								m_up = Vec3(0.f, 1.f, 0.f);
+	Vec3								m_forward = Vec3(0.f, 0.f, 1.f);
+
+	std::vector<TextureView*>			m_textures;
+	uint								m_lastTextureSlot = 0U;
+
+	std::vector<SpriteInstanceT>		m_instances;
+	//Where each sprite lands in the sorted instance data
+	std::vector<uint>					m_destinations;
+	std::vector<uint>					m_slotCounts;
+
+	std::vector<SpriteInstanceDataT>	m_instanceData;
+	std::vector<SpriteDrawT>			m_draws;
+};
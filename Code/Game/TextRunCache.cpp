@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/TextRunCache.hpp"
+//Engine Systems
+#include "Engine/Renderer/BitmapFont.hpp"
+//Game Systems
+#include "Game/FontAtlas.hpp"
+#include "Game/MappedFile.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextRunCache::TextRunCache( uint maxIdleFrames )
+	: m_maxIdleFrames(maxIdleFrames)
+{
+}
+
+TextRunCache::~TextRunCache()
+{
+	Clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const std::vector<Vertex_PCU>& TextRunCache::GetRun( BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color )
+{
+	uint64_t hash = HashRun(font, position, height, text, color);
+
+	typedef std::unordered_multimap<uint64_t, uint>::iterator RunIterator;
+	std::pair<RunIterator, RunIterator> range = m_runIndicesByHash.equal_range(hash);
+	for (RunIterator itr = range.first; itr != range.second; ++itr)
+	{
+		TextRunT& run = m_runs[itr->second];
+		if (IsSameRun(run, font, position, height, text, color))
+		{
+			run.lastUsedFrame = m_frame;
+			m_hitCount++;
+			return run.verts;
+		}
+	}
+
+	//Miss, reuse an evicted run so its vert capacity is kept
+	uint runIndex;
+	if (!m_freeRunIndices.empty())
+	{
+		runIndex = m_freeRunIndices.back();
+		m_freeRunIndices.pop_back();
+	}
+	else
+	{
+		runIndex = (uint)m_runs.size();
+		m_runs.emplace_back();
+	}
+
+	TextRunT& run = m_runs[runIndex];
+	run.font = font;
+	run.text = text;
+	run.position = position;
+	run.height = height;
+	run.color = color;
+	run.lastUsedFrame = m_frame;
+	run.verts.clear();
+
+	if (font != nullptr)
+	{
+		font->AddVertsForText2D(run.verts, position, height, text, color);
+
+		if (m_fontAtlas != nullptr)
+		{
+			m_fontAtlas->RemapVerts(font, run.verts);
+		}
+	}
+
+	m_runIndicesByHash.emplace(hash, runIndex);
+	m_missCount++;
+	return run.verts;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TextRunCache::EndFrame()
+{
+	std::unordered_multimap<uint64_t, uint>::iterator itr = m_runIndicesByHash.begin();
+	while (itr != m_runIndicesByHash.end())
+	{
+		TextRunT& run = m_runs[itr->second];
+		if (m_frame - run.lastUsedFrame >= m_maxIdleFrames)
+		{
+			run.font = nullptr;
+			run.text.clear();
+			m_freeRunIndices.push_back(itr->second);
+			itr = m_runIndicesByHash.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+
+	m_frame++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TextRunCache::Clear()
+{
+	m_runIndicesByHash.clear();
+	m_runs.clear();
+	m_freeRunIndices.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TextRunCache::SetFontAtlas( const FontAtlas* atlas )
+{
+	if (atlas != m_fontAtlas)
+	{
+		Clear();
+		m_fontAtlas = atlas;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC uint64_t TextRunCache::HashRun( const BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color )
+{
+	uint64_t hash = HashFNV1a(&font, sizeof(font));
+	hash = HashFNV1a(&position.x, sizeof(float), hash);
+	hash = HashFNV1a(&position.y, sizeof(float), hash);
+	hash = HashFNV1a(&height, sizeof(float), hash);
+	hash = HashFNV1a(&color.r, sizeof(float), hash);
+	hash = HashFNV1a(&color.g, sizeof(float), hash);
+	hash = HashFNV1a(&color.b, sizeof(float), hash);
+	hash = HashFNV1a(&color.a, sizeof(float), hash);
+	return HashFNV1a(text.data(), text.size(), hash);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool TextRunCache::IsSameRun( const TextRunT& run, const BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color )
+{
+	return run.font == font
+		&& run.position.x == position.x && run.position.y == position.y
+		&& run.height == height
+		&& run.color.r == color.r && run.color.g == color.g && run.color.b == color.b && run.color.a == color.a
+		&& run.text == text;
+}
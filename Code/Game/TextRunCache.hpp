@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vertex_PCU.hpp"
+//Third Party
+#include <deque>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BitmapFont;
+class FontAtlas;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct TextRunT
+{
+	BitmapFont*							font = nullptr;
+	std::string							text;
+	Vec2								position;
+	float								height = 0.f;
+	Rgba								color;
+
+	std::vector<Vertex_PCU>				verts;
+	uint								lastUsedFrame = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Retained glyph runs. GetRun only calls into BitmapFont when the (font, text, position, height, color) key was not seen
+// recently, so static text costs a hash and a compare per frame instead of a full glyph layout. A run that changes is simply
+// a new key; the stale one is evicted by EndFrame once it has gone unused for maxIdleFrames.
+//------------------------------------------------------------------------------------------------------------------------------
+class TextRunCache
+{
+public:
+	explicit TextRunCache( uint maxIdleFrames = 60U );
+	~TextRunCache();
+
+	//The returned verts stay put until EndFrame evicts the run. A null font caches an empty run
+	const std::vector<Vertex_PCU>&		GetRun( BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color );
+
+	void								EndFrame();
+	void								Clear();
+
+	//Runs of fonts packed in the atlas get atlas UVs. Changing the atlas drops every cached run
+	void								SetFontAtlas( const FontAtlas* atlas );
+	const FontAtlas*					GetFontAtlas() const { return m_fontAtlas; }
+
+	uint								GetRunCount() const { return (uint)m_runIndicesByHash.size(); }
+	uint								GetHitCount() const { return m_hitCount; }
+	uint								GetMissCount() const { return m_missCount; }
+
+private:
+	static uint64_t						HashRun( const BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color );
+	static bool							IsSameRun( const TextRunT& run, const BitmapFont* font, const Vec2& position, float height, const std::string& text, const Rgba& color );
+
+private:
+	//Several keys can share a hash, so every hit is confirmed against the full key
+	std::unordered_multimap<uint64_t, uint>	m_runIndicesByHash;
+	std::deque<TextRunT>				m_runs;
+	std::vector<uint>					m_freeRunIndices;
+	const FontAtlas*					m_fontAtlas = nullptr;
+
+	uint								m_frame = 0U;
+	uint								m_maxIdleFrames = 60U;
+	uint								m_hitCount = 0U;
+	uint								m_missCount = 0U;
+};
@@ -0,0 +1,297 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/TextureStreamer.hpp"
+//Engine Systems
+#include "Engine/Renderer/TextureView.hpp"
+//Game Systems
+#include "Game/ImageDecoder.hpp"
+#include "Game/MappedFile.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/VirtualFileSystem.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool OpenTextureFile( const std::string& filePath, MappedFile& looseFile, FileSpanT& outSpan )
+{
+	//A packed file is used in place; a loose one is mapped only as long as the caller's MappedFile lives, so the cooker can
+	//still replace it while the game runs
+	if (g_virtualFileSystem != nullptr && g_virtualFileSystem->ReadPackedFile(filePath, outSpan))
+	{
+		return true;
+	}
+
+	if (!looseFile.Open(filePath))
+	{
+		return false;
+	}
+
+	outSpan.data = looseFile.GetData();
+	outSpan.size = looseFile.GetSize();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+DecodedTextureT* CreateDecodedTexture( std::vector<std::vector<unsigned char>>& mipTexels, uint32_t width, uint32_t height )
+{
+	DecodedTextureT* decoded = new DecodedTextureT();
+	decoded->storage.swap(mipTexels);
+	decoded->mips.format = COOKED_TEXTURE_FORMAT_RGBA8;
+	decoded->mips.mipCount = (uint32_t)decoded->storage.size();
+
+	for (uint32_t mipIndex = 0; mipIndex < decoded->mips.mipCount; ++mipIndex)
+	{
+		CookedTextureMipDataT& mip = decoded->mips.mips[mipIndex];
+		mip.width = width;
+		mip.height = height;
+		mip.data = decoded->storage[mipIndex].data();
+		mip.byteCount = decoded->storage[mipIndex].size();
+
+		width = (width > 1U) ? width / 2U : 1U;
+		height = (height > 1U) ? height / 2U : 1U;
+	}
+
+	return decoded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static DecodedTextureT* LoadCookedTexture( const std::string& cookedPath, const std::string& sourcePath )
+{
+	DecodedTextureT* decoded = new DecodedTextureT();
+	FileSpanT cookedSpan;
+	uint64_t sourceHash = 0U;
+	if (!OpenTextureFile(cookedPath, decoded->cookedFile, cookedSpan) || !ReadCookedTexture(cookedSpan.data, cookedSpan.size, decoded->mips, &sourceHash))
+	{
+		delete decoded;
+		return nullptr;
+	}
+
+	//The mips go up as they are stored, so they have to be in the row order images load with
+	if ((decoded->mips.flags & COOKED_TEXTURE_FLAG_ROWS_FLIPPED) == 0U)
+	{
+		delete decoded;
+		return nullptr;
+	}
+
+	//Hashing the source costs a read, not a decode. Without a source the cook is all there is
+	MappedFile source;
+	FileSpanT sourceSpan;
+	if (OpenTextureFile(sourcePath, source, sourceSpan) && HashTextureSource(sourceSpan.data, sourceSpan.size) != sourceHash)
+	{
+		DebuggerPrintf("\n TextureStreamer: %s is older than %s, run TextureCooker", cookedPath.c_str(), sourcePath.c_str());
+		delete decoded;
+		return nullptr;
+	}
+
+	return decoded;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static DecodedTextureT* DecodeTextureFromFile( const std::string& filePath, bool isSRGB, const std::string& cookedFolder )
+{
+	size_t nameStart = filePath.find_last_of("/\\");
+	std::string cookedPath = cookedFolder + ((nameStart == std::string::npos) ? filePath : filePath.substr(nameStart + 1)) + ".ctex";
+	DecodedTextureT* cooked = LoadCookedTexture(cookedPath, filePath);
+	if (cooked != nullptr)
+	{
+		return cooked;
+	}
+
+	DecodedImageT image;
+	if (!DecodeImageFileRGBA8(filePath, image) || image.width == 0U || image.height == 0U)
+	{
+		return nullptr;
+	}
+
+	std::vector<std::vector<unsigned char>> mipTexels;
+	BuildTextureMipChain(image.texels.data(), image.width, image.height, isSRGB, mipTexels);
+	return CreateDecodedTexture(mipTexels, image.width, image.height);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static TextureView* UploadImmutableTexture( const std::string& fileName, const CookedTextureViewT& mips, Texture2D*& outTexture )
+{
+	return g_renderBackend->CreateImmutableTexture(fileName.c_str(), mips, outTexture);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void ReleaseTexture2D( TextureView* view, Texture2D* texture )
+{
+	delete view;
+	delete texture;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureStreamer::TextureStreamer( const std::string& imageFolder, size_t uploadBudgetBytes, const std::string& cookedFolder )
+	: m_imageFolder(imageFolder),
+	m_uploadBudgetBytes(uploadBudgetBytes),
+	m_decodeFunction([cookedFolder]( const std::string& filePath, bool isSRGB ) { return DecodeTextureFromFile(filePath, isSRGB, cookedFolder); }),
+	m_uploadFunction(UploadImmutableTexture),
+	m_releaseFunction(ReleaseTexture2D)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	//Decode jobs write into the handles, none may still be running when they are freed
+	WaitForDecodes();
+
+	for (StreamedTexture* texture : m_textures)
+	{
+		delete texture->m_decoded;
+		if (m_releaseFunction && (texture->m_view != nullptr || texture->m_texture != nullptr))
+		{
+			m_releaseFunction(texture->m_view, texture->m_texture);
+		}
+		delete texture;
+	}
+	m_textures.clear();
+
+	for (int placeholder = 0; placeholder < NUM_TEXTURE_PLACEHOLDERS; ++placeholder)
+	{
+		if (m_releaseFunction && (m_loadedPlaceholderViews[placeholder] != nullptr || m_loadedPlaceholderTextures[placeholder] != nullptr))
+		{
+			m_releaseFunction(m_loadedPlaceholderViews[placeholder], m_loadedPlaceholderTextures[placeholder]);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TextureStreamer::SetUploadFunctions( const TextureUploadFunction& uploadFunction, const TextureReleaseFunction& releaseFunction )
+{
+	m_uploadFunction = uploadFunction;
+	m_releaseFunction = releaseFunction;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TextureView* TextureStreamer::LoadPlaceholder( eTexturePlaceholder placeholder, const std::string& fileName )
+{
+	if (m_releaseFunction && (m_loadedPlaceholderViews[placeholder] != nullptr || m_loadedPlaceholderTextures[placeholder] != nullptr))
+	{
+		m_releaseFunction(m_loadedPlaceholderViews[placeholder], m_loadedPlaceholderTextures[placeholder]);
+		m_loadedPlaceholderViews[placeholder] = nullptr;
+		m_loadedPlaceholderTextures[placeholder] = nullptr;
+	}
+
+	//Placeholders are tiny, so on the main thread; everything streamed after this samples them
+	DecodedTextureT* decoded = m_decodeFunction ? m_decodeFunction(m_imageFolder + fileName, placeholder != TEXTURE_PLACEHOLDER_FLAT) : nullptr;
+	if (decoded != nullptr && decoded->mips.mipCount > 0U && m_uploadFunction)
+	{
+		m_loadedPlaceholderViews[placeholder] = m_uploadFunction(fileName, decoded->mips, m_loadedPlaceholderTextures[placeholder]);
+	}
+	delete decoded;
+
+	if (m_loadedPlaceholderViews[placeholder] == nullptr)
+	{
+		DebuggerPrintf("\n TextureStreamer: could not load the placeholder %s", fileName.c_str());
+	}
+
+	m_placeholderViews[placeholder] = m_loadedPlaceholderViews[placeholder];
+	return m_loadedPlaceholderViews[placeholder];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+StreamedTexture* TextureStreamer::RequestTexture( JobScheduler& scheduler, const std::string& fileName, eTexturePlaceholder placeholder )
+{
+	for (StreamedTexture* texture : m_textures)
+	{
+		if (texture->m_fileName == fileName)
+		{
+			return texture;
+		}
+	}
+
+	StreamedTexture* texture = new StreamedTexture();
+	texture->m_fileName = fileName;
+	texture->m_placeholderView = m_placeholderViews[placeholder];
+	texture->m_state.store(STREAMED_TEXTURE_DECODING, std::memory_order_relaxed);
+	m_textures.push_back(texture);
+	m_pendingCount++;
+
+	m_scheduler = &scheduler;
+	std::string filePath = m_imageFolder + fileName;
+	TextureDecodeFunction decodeFunction = m_decodeFunction;
+	//Normal maps are data, their mips are plain averages
+	bool isSRGB = (placeholder != TEXTURE_PLACEHOLDER_FLAT);
+
+	FunctionJob* decodeJob = new FunctionJob([texture, filePath, isSRGB, decodeFunction]()
+	{
+		DecodedTextureT* decoded = decodeFunction ? decodeFunction(filePath, isSRGB) : nullptr;
+		if (decoded == nullptr || decoded->mips.mipCount == 0U)
+		{
+			delete decoded;
+			DebuggerPrintf("\n TextureStreamer: could not decode %s", filePath.c_str());
+			texture->m_state.store(STREAMED_TEXTURE_FAILED, std::memory_order_release);
+			return;
+		}
+
+		texture->m_decoded = decoded;
+		texture->m_dimensions = IntVec2((int)decoded->mips.mips[0].width, (int)decoded->mips.mips[0].height);
+		texture->m_state.store(STREAMED_TEXTURE_DECODED, std::memory_order_release);
+	});
+	decodeJob->SetCounter(&m_decodeCounter);
+	scheduler.Dispatch(decodeJob);
+
+	return texture;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint TextureStreamer::Update()
+{
+	uint uploadedCount = 0U;
+	size_t uploadBytes = 0U;
+	uint pendingCount = 0U;
+	bool isBudgetSpent = false;
+
+	for (StreamedTexture* texture : m_textures)
+	{
+		eStreamedTextureState state = texture->GetState();
+		if (state == STREAMED_TEXTURE_RESIDENT || state == STREAMED_TEXTURE_FAILED)
+		{
+			continue;
+		}
+
+		//A texture still decoding does not hold up the ones behind it that are ready. Its decode is still writing the handle,
+		//so nothing past the state is read until it is
+		if (state == STREAMED_TEXTURE_DECODING)
+		{
+			pendingCount++;
+			continue;
+		}
+
+		size_t byteCount = GetCookedTextureByteCount(texture->m_decoded->mips);
+		isBudgetSpent = isBudgetSpent || (uploadedCount > 0U && uploadBytes + byteCount > m_uploadBudgetBytes);
+		if (isBudgetSpent)
+		{
+			pendingCount++;
+			continue;
+		}
+
+		texture->m_view = m_uploadFunction ? m_uploadFunction(texture->m_fileName, texture->m_decoded->mips, texture->m_texture) : nullptr;
+		delete texture->m_decoded;
+		texture->m_decoded = nullptr;
+
+		if (texture->m_view == nullptr)
+		{
+			DebuggerPrintf("\n TextureStreamer: could not upload %s", texture->m_fileName.c_str());
+			texture->m_state.store(STREAMED_TEXTURE_FAILED, std::memory_order_relaxed);
+			continue;
+		}
+
+		texture->m_state.store(STREAMED_TEXTURE_RESIDENT, std::memory_order_relaxed);
+
+		uploadedCount++;
+		uploadBytes += byteCount;
+	}
+
+	m_pendingCount = pendingCount;
+	m_lastUploadBytes = uploadBytes;
+	m_totalUploadBytes += uploadBytes;
+	return uploadedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TextureStreamer::WaitForDecodes()
+{
+	if (m_scheduler != nullptr)
+	{
+		m_scheduler->WaitForCounter(m_decodeCounter);
+	}
+}
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/IntVec2.hpp"
+//Game Systems
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/JobScheduler.hpp"
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Texture2D;
+class TextureView;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a texture samples while it streams in: WHITE.png for color maps, FLAT.png for normal maps
+//------------------------------------------------------------------------------------------------------------------------------
+enum eTexturePlaceholder
+{
+	TEXTURE_PLACEHOLDER_WHITE = 0,
+	TEXTURE_PLACEHOLDER_FLAT,
+
+	NUM_TEXTURE_PLACEHOLDERS
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a decode hands to the upload: the whole mip chain of an immutable texture. The mips point into storage, or for a cook
+// into the mounted pack or cookedFile, which stays mapped until the upload is done
+//------------------------------------------------------------------------------------------------------------------------------
+struct DecodedTextureT
+{
+	CookedTextureViewT					mips;
+	std::vector<std::vector<unsigned char>>	storage;
+	MappedFile							cookedFile;
+};
+
+//Takes the RGBA8 chain BuildTextureMipChain makes (level 0 of width x height first, halving down) and leaves mipTexels empty
+DecodedTextureT*	CreateDecodedTexture( std::vector<std::vector<unsigned char>>& mipTexels, uint32_t width, uint32_t height );
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eStreamedTextureState
+{
+	STREAMED_TEXTURE_DECODING = 0,
+	STREAMED_TEXTURE_DECODED,
+	STREAMED_TEXTURE_RESIDENT,
+	STREAMED_TEXTURE_FAILED
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Handle to a texture that may still be loading. Keep the handle and ask for the view every time it is bound; the view
+// changes from the placeholder to the real texture on the frame the upload happens
+//------------------------------------------------------------------------------------------------------------------------------
+class StreamedTexture
+{
+	friend class TextureStreamer;
+
+public:
+	TextureView*						GetView() const { return (m_view != nullptr) ? m_view : m_placeholderView; }
+	bool								IsResident() const { return m_view != nullptr; }
+	eStreamedTextureState				GetState() const { return (eStreamedTextureState)m_state.load(std::memory_order_acquire); }
+	const std::string&					GetFileName() const { return m_fileName; }
+	//Zero until the image is decoded
+	const IntVec2&						GetDimensions() const { return m_dimensions; }
+
+private:
+	std::string							m_fileName;
+	TextureView*						m_placeholderView = nullptr;
+
+	//Written by the decode job, read by the main thread only after it sees STREAMED_TEXTURE_DECODED
+	DecodedTextureT*					m_decoded = nullptr;
+	IntVec2								m_dimensions = IntVec2(0, 0);
+	std::atomic<int>					m_state;
+
+	Texture2D*							m_texture = nullptr;
+	TextureView*						m_view = nullptr;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Loads textures without stalling the frame. RequestTexture returns a handle at once and queues the decode on the
+// JobScheduler; Update, called once per frame on the main thread, uploads decoded textures in request order until the frame's
+// byte budget is spent. At least one texture goes up per frame, so one larger than the budget still arrives.
+//
+// Textures are created immutable with every mip in one call, so a slice of the budget is one texture rather than part of one.
+// The decode builds the mips on the worker; color maps are averaged in linear light, normal maps (the FLAT placeholder) as data.
+//
+// The default decode loads the TextureCooker output from cookedFolder when there is a cook of the same source bytes. Its mips,
+// BC blocks included, are uploaded straight out of the mapped file with no decode or copy. Anything else falls back to the
+// source file.
+//------------------------------------------------------------------------------------------------------------------------------
+class TextureStreamer
+{
+public:
+	//Runs on a worker. Returns nullptr if the file could not be decoded
+	typedef std::function<DecodedTextureT*( const std::string& filePath, bool isSRGB )> TextureDecodeFunction;
+	//Runs on the main thread. outTexture may stay null, whatever comes back is handed to the release function at shutdown
+	typedef std::function<TextureView*( const std::string& fileName, const CookedTextureViewT& mips, Texture2D*& outTexture )> TextureUploadFunction;
+	typedef std::function<void( TextureView* view, Texture2D* texture )> TextureReleaseFunction;
+
+public:
+	explicit TextureStreamer( const std::string& imageFolder = "Data/Images/", size_t uploadBudgetBytes = 8U * 1024U * 1024U,
+		const std::string& cookedFolder = "Data/Cache/Textures/" );
+	~TextureStreamer();
+
+	void								SetPlaceholder( eTexturePlaceholder placeholder, TextureView* view ) { m_placeholderViews[placeholder] = view; }
+	//Decodes and uploads the placeholder now with the streamer's own functions, so it is read from the pack like the rest.
+	//Returns its view, null if it could not be loaded; the streamer releases it
+	TextureView*						LoadPlaceholder( eTexturePlaceholder placeholder, const std::string& fileName );
+	//All default to the game's own: ImageDecoder for decoding, an immutable texture from the RenderBackend, delete for releasing
+	void								SetDecodeFunction( const TextureDecodeFunction& decodeFunction ) { m_decodeFunction = decodeFunction; }
+	void								SetUploadFunctions( const TextureUploadFunction& uploadFunction, const TextureReleaseFunction& releaseFunction );
+
+	//The same file name always returns the same handle
+	StreamedTexture*					RequestTexture( JobScheduler& scheduler, const std::string& fileName, eTexturePlaceholder placeholder = TEXTURE_PLACEHOLDER_WHITE );
+
+	//Returns how many textures were uploaded this frame
+	uint								Update();
+	//Blocks until every queued decode finished, for shutdown and tests; the uploads still wait for Update
+	void								WaitForDecodes();
+
+	uint								GetPendingCount() const { return m_pendingCount; }
+	size_t								GetLastUploadBytes() const { return m_lastUploadBytes; }
+	uint64_t							GetTotalUploadBytes() const { return m_totalUploadBytes; }
+
+private:
+	TextureStreamer( const TextureStreamer& ) = delete;
+	TextureStreamer& operator=( const TextureStreamer& ) = delete;
+
+private:
+	std::string							m_imageFolder;
+	size_t								m_uploadBudgetBytes = 0U;
+	TextureView*						m_placeholderViews[NUM_TEXTURE_PLACEHOLDERS] = {};
+	//Only the ones LoadPlaceholder made
+	TextureView*						m_loadedPlaceholderViews[NUM_TEXTURE_PLACEHOLDERS] = {};
+	Texture2D*							m_loadedPlaceholderTextures[NUM_TEXTURE_PLACEHOLDERS] = {};
+	TextureDecodeFunction				m_decodeFunction;
+	TextureUploadFunction				m_uploadFunction;
+	TextureReleaseFunction				m_releaseFunction;
+
+	//Request order, which is also upload order
+	std::vector<StreamedTexture*>		m_textures;
+	//The scheduler the decodes went to, kept so the destructor can wait for them
+	JobScheduler*						m_scheduler = nullptr;
+	JobCounter							m_decodeCounter;
+	uint								m_pendingCount = 0U;
+
+	size_t								m_lastUploadBytes = 0U;
+	uint64_t							m_totalUploadBytes = 0U;
+};
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/VirtualFileSystem.hpp"
+//Third Party
+#include <stdio.h>
+
+VirtualFileSystem* g_virtualFileSystem = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+VirtualFileSystem::VirtualFileSystem()
+	: m_packReadCount(0U),
+	m_looseReadCount(0U)
+{
+}
+
+VirtualFileSystem::~VirtualFileSystem()
+{
+	for (std::pair<const std::string, std::vector<unsigned char>*>& entry : m_decompressedEntries)
+	{
+		delete entry.second;
+	}
+	m_decompressedEntries.clear();
+	m_looseFiles.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::MountPack( const std::string& packPath )
+{
+	m_packIndex = PackIndexViewT();
+	if (!m_pack.Open(packPath))
+	{
+		return false;
+	}
+
+	if (!ReadPackIndex(m_pack.GetData(), m_pack.GetSize(), m_packIndex))
+	{
+		DebuggerPrintf("\n VirtualFileSystem: %s is not a valid pack", packPath.c_str());
+		m_pack.Close();
+		m_packIndex = PackIndexViewT();
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadFile( const std::string& path, FileSpanT& outSpan )
+{
+	outSpan = FileSpanT();
+	std::string normalizedPath = NormalizePackPath(path);
+
+	const PackEntryT* entry = m_pack.IsOpen() ? FindPackEntry(m_packIndex, normalizedPath) : nullptr;
+	if (entry != nullptr)
+	{
+		return ReadPackEntry(*entry, normalizedPath, outSpan);
+	}
+
+	return m_isLooseFallbackEnabled && ReadLooseFile(path, normalizedPath, outSpan);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadPackedFile( const std::string& path, FileSpanT& outSpan )
+{
+	outSpan = FileSpanT();
+	std::string normalizedPath = NormalizePackPath(path);
+
+	const PackEntryT* entry = m_pack.IsOpen() ? FindPackEntry(m_packIndex, normalizedPath) : nullptr;
+	return entry != nullptr && ReadPackEntry(*entry, normalizedPath, outSpan);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadTextFile( const std::string& path, std::string& outText )
+{
+	outText.clear();
+	std::string normalizedPath = NormalizePackPath(path);
+
+	const PackEntryT* entry = m_pack.IsOpen() ? FindPackEntry(m_packIndex, normalizedPath) : nullptr;
+	if (entry != nullptr)
+	{
+		m_packReadCount++;
+		if (entry->compression == PACK_COMPRESSION_NONE)
+		{
+			outText.assign((const char*)m_packIndex.data + entry->offset, entry->size);
+			return true;
+		}
+
+		outText.resize(entry->size);
+		//Straight into the string, a text file is parsed once so there is no point caching it
+		return outText.empty() || DecompressPackLZ(m_packIndex.data + entry->offset, entry->storedSize, (unsigned char*)&outText[0], outText.size());
+	}
+
+	if (!m_isLooseFallbackEnabled)
+	{
+		return false;
+	}
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	outText.resize((fileSize > 0) ? (size_t)fileSize : 0U);
+	bool isRead = outText.empty() || fread(&outText[0], 1, outText.size(), file) == outText.size();
+	fclose(file);
+
+	m_looseReadCount++;
+	return isRead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadPackEntry( const PackEntryT& entry, const std::string& normalizedPath, FileSpanT& outSpan )
+{
+	m_packReadCount++;
+
+	if (entry.compression == PACK_COMPRESSION_NONE)
+	{
+		outSpan.data = m_packIndex.data + entry.offset;
+		outSpan.size = entry.size;
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(m_cacheLock);
+	std::unordered_map<std::string, std::vector<unsigned char>*>::iterator cached = m_decompressedEntries.find(normalizedPath);
+	if (cached == m_decompressedEntries.end())
+	{
+		std::vector<unsigned char>* bytes = new std::vector<unsigned char>(entry.size);
+		if (!DecompressPackLZ(m_packIndex.data + entry.offset, entry.storedSize, bytes->data(), bytes->size()))
+		{
+			DebuggerPrintf("\n VirtualFileSystem: pack entry %s is corrupt", normalizedPath.c_str());
+			delete bytes;
+			return false;
+		}
+		cached = m_decompressedEntries.emplace(normalizedPath, bytes).first;
+	}
+
+	outSpan.data = cached->second->data();
+	outSpan.size = cached->second->size();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadLooseFile( const std::string& path, const std::string& normalizedPath, FileSpanT& outSpan )
+{
+	std::lock_guard<std::mutex> lock(m_cacheLock);
+	std::shared_ptr<MappedFile> file = m_looseFiles[normalizedPath].lock();
+	if (file == nullptr)
+	{
+		file = std::make_shared<MappedFile>();
+		if (!file->Open(path))
+		{
+			m_looseFiles.erase(normalizedPath);
+			return false;
+		}
+		m_looseFiles[normalizedPath] = file;
+	}
+
+	m_looseReadCount++;
+	outSpan.data = file->GetData();
+	outSpan.size = file->GetSize();
+	outSpan.looseFile = file;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint VirtualFileSystem::GetMappedLooseFileCount()
+{
+	std::lock_guard<std::mutex> lock(m_cacheLock);
+	uint mappedCount = 0U;
+	for (std::unordered_map<std::string, std::weak_ptr<MappedFile>>::iterator looseFile = m_looseFiles.begin(); looseFile != m_looseFiles.end();)
+	{
+		//Files whose last span went are dropped on the way past
+		if (looseFile->second.expired())
+		{
+			looseFile = m_looseFiles.erase(looseFile);
+			continue;
+		}
+
+		mappedCount++;
+		++looseFile;
+	}
+	return mappedCount;
+}
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+//Engine Systems
+#include "Engine/Commons/EngineCommon.hpp"
+//Game Systems
+#include "Game/MappedFile.hpp"
+#include "Game/PackFile.hpp"
+//Third Party
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Bytes of one file, valid until the VirtualFileSystem that returned them is destroyed. A loose file's span also shares its
+// mapping, which stays open only as long as some span of it does
+//------------------------------------------------------------------------------------------------------------------------------
+struct FileSpanT
+{
+	const unsigned char*				data = nullptr;
+	size_t								size = 0U;
+	std::shared_ptr<MappedFile>			looseFile;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Resolves the same "Data/..." paths the game always used, first against one mapped pack and then, when loose fallback is on,
+// against the file on disk. A stored pack entry is a span of the pack's mapping, so reading it costs page faults and no copy;
+// compressed entries are kept for the lifetime of the file system once read. A loose file is mapped once and shared by every
+// span read of it while one is held, then unmapped when the last span goes, so it can be edited or replaced again.
+//
+// Safe to read from job workers. Mounting is not, do it before anything reads.
+//------------------------------------------------------------------------------------------------------------------------------
+class VirtualFileSystem
+{
+public:
+	VirtualFileSystem();
+	~VirtualFileSystem();
+
+	//Replaces any pack mounted before. Returns false, leaving no pack mounted, if the file is missing or not a valid pack
+	bool								MountPack( const std::string& packPath );
+	bool								IsPackMounted() const { return m_pack.IsOpen(); }
+	//On by default, so a development tree without a pack runs off loose files
+	void								SetLooseFallback( bool isEnabled ) { m_isLooseFallbackEnabled = isEnabled; }
+
+	bool								ReadFile( const std::string& path, FileSpanT& outSpan );
+	//The pack alone, for callers that would rather map a loose file themselves and let it go when done
+	bool								ReadPackedFile( const std::string& path, FileSpanT& outSpan );
+	//A copy for the text parsers that want a string. Loose files are read and closed again rather than kept mapped, so
+	//shaders and configs can still be edited while the game runs
+	bool								ReadTextFile( const std::string& path, std::string& outText );
+
+	uint								GetPackReadCount() const { return m_packReadCount; }
+	uint								GetLooseReadCount() const { return m_looseReadCount; }
+	//Loose files some span still holds mapped
+	uint								GetMappedLooseFileCount();
+
+private:
+	VirtualFileSystem( const VirtualFileSystem& ) = delete;
+	VirtualFileSystem& operator=( const VirtualFileSystem& ) = delete;
+
+	bool								ReadPackEntry( const PackEntryT& entry, const std::string& normalizedPath, FileSpanT& outSpan );
+	bool								ReadLooseFile( const std::string& path, const std::string& normalizedPath, FileSpanT& outSpan );
+
+private:
+	MappedFile							m_pack;
+	PackIndexViewT						m_packIndex;
+	bool								m_isLooseFallbackEnabled = true;
+
+	//Both keyed by normalized path. Decompressed entries are never dropped, so their spans stay put; loose files belong to
+	//their spans and are only looked up here
+	std::mutex							m_cacheLock;
+	std::unordered_map<std::string, std::vector<unsigned char>*>	m_decompressedEntries;
+	std::unordered_map<std::string, std::weak_ptr<MappedFile>>		m_looseFiles;
+
+	std::atomic<uint>					m_packReadCount;
+	std::atomic<uint>					m_looseReadCount;
+};
+
+extern VirtualFileSystem* g_virtualFileSystem;
@@ -0,0 +1,360 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// LogDecoder: turns a binary log (Data/Logs/*.blog written by BinaryLog) back into the text ExecutionLog layout.
+//
+// Usage:	LogDecoder <input.blog> [output.txt] [-stats]
+// Build:	only needs the shared format code, e.g. from Code/
+//			c++ -std=c++14 -I. Tools/LogDecoder/Main_LogDecoder.cpp Game/BinaryLogFormat.cpp -o LogDecoder
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/BinaryLogFormat.hpp"
+//Third Party
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct DecodedFormatT
+{
+	std::string							text;
+	std::vector<eBinaryLogArg>			signature;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct DecodeStatsT
+{
+	uint64_t							messageCount = 0U;
+	uint64_t							callstackMessageCount = 0U;
+	uint64_t							uniqueCallstacks = 0U;
+	uint64_t							fileBytes = 0U;
+	uint64_t							textBytes = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+class BinaryLogReader
+{
+public:
+	explicit BinaryLogReader( const std::vector<unsigned char>& bytes )
+		: m_bytes(bytes)
+	{
+	}
+
+	template <typename T>
+	bool Read( T& outValue )
+	{
+		if (m_offset + sizeof(T) > m_bytes.size())
+		{
+			return false;
+		}
+
+		memcpy(&outValue, m_bytes.data() + m_offset, sizeof(T));
+		m_offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadString( std::string& outValue, size_t length )
+	{
+		if (m_offset + length > m_bytes.size())
+		{
+			return false;
+		}
+
+		outValue.assign((const char*)m_bytes.data() + m_offset, length);
+		m_offset += length;
+		return true;
+	}
+
+	const unsigned char* ReadBytes( size_t byteCount )
+	{
+		if (m_offset + byteCount > m_bytes.size())
+		{
+			return nullptr;
+		}
+
+		const unsigned char* bytes = m_bytes.data() + m_offset;
+		m_offset += byteCount;
+		return bytes;
+	}
+
+	bool IsAtEnd() const { return m_offset >= m_bytes.size(); }
+
+private:
+	const std::vector<unsigned char>&	m_bytes;
+	size_t								m_offset = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadWholeFile( const char* filePath, std::vector<unsigned char>& outBytes )
+{
+	FILE* file = fopen(filePath, "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	outBytes.resize((size_t)fileSize);
+	size_t readSize = fread(outBytes.data(), 1, outBytes.size(), file);
+	fclose(file);
+
+	return readSize == outBytes.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Symbol chunks are written after the messages that need them, so the file is walked twice: once with no output to collect
+// the symbols, then again to print.
+//------------------------------------------------------------------------------------------------------------------------------
+static bool DecodeLog( const std::vector<unsigned char>& bytes, FILE* output, std::unordered_map<uint64_t, std::string>& symbols, DecodeStatsT& stats )
+{
+	BinaryLogReader reader(bytes);
+	stats.fileBytes = bytes.size();
+
+	BinaryLogFileHeaderT header;
+	if (!reader.Read(header) || header.magic != BINARY_LOG_MAGIC)
+	{
+		printf("\n >> Not a binary log file");
+		return false;
+	}
+
+	//Version 1 files are the same minus symbol chunks
+	if (header.version == 0U || header.version > BINARY_LOG_VERSION)
+	{
+		printf("\n >> Unsupported binary log version %u (max %u)", header.version, BINARY_LOG_VERSION);
+		return false;
+	}
+
+	std::unordered_map<uint32_t, std::string> filters;
+	std::unordered_map<uint32_t, DecodedFormatT> formats;
+	std::unordered_map<uint32_t, std::vector<uint64_t>> callstacks;
+
+	while (!reader.IsAtEnd())
+	{
+		eBinaryLogChunk chunk;
+		if (!reader.Read(chunk))
+		{
+			break;
+		}
+
+		switch (chunk)
+		{
+		case BINARY_LOG_CHUNK_FILTER:
+		{
+			uint32_t id = 0U;
+			uint16_t length = 0U;
+			std::string name;
+			if (!reader.Read(id) || !reader.Read(length) || !reader.ReadString(name, length))
+			{
+				printf("\n >> Truncated filter chunk");
+				return true;
+			}
+			filters[id] = name;
+		}
+		break;
+		case BINARY_LOG_CHUNK_FORMAT:
+		{
+			uint32_t id = 0U;
+			uint16_t length = 0U;
+			uint8_t argCount = 0U;
+			DecodedFormatT format;
+			if (!reader.Read(id) || !reader.Read(length) || !reader.ReadString(format.text, length) || !reader.Read(argCount))
+			{
+				printf("\n >> Truncated format chunk");
+				return true;
+			}
+
+			const unsigned char* signature = reader.ReadBytes(argCount);
+			if (signature == nullptr)
+			{
+				printf("\n >> Truncated format chunk");
+				return true;
+			}
+			format.signature.assign((const eBinaryLogArg*)signature, (const eBinaryLogArg*)signature + argCount);
+			formats[id] = format;
+		}
+		break;
+		case BINARY_LOG_CHUNK_CALLSTACK:
+		{
+			uint32_t id = 0U;
+			uint16_t frameCount = 0U;
+			if (!reader.Read(id) || !reader.Read(frameCount))
+			{
+				printf("\n >> Truncated callstack chunk");
+				return true;
+			}
+
+			std::vector<uint64_t>& frames = callstacks[id];
+			frames.resize(frameCount);
+			for (uint16_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+			{
+				if (!reader.Read(frames[frameIndex]))
+				{
+					printf("\n >> Truncated callstack chunk");
+					return true;
+				}
+			}
+			stats.uniqueCallstacks++;
+		}
+		break;
+		case BINARY_LOG_CHUNK_SYMBOL:
+		{
+			uint64_t address = 0U;
+			uint16_t length = 0U;
+			std::string symbol;
+			if (!reader.Read(address) || !reader.Read(length) || !reader.ReadString(symbol, length))
+			{
+				printf("\n >> Truncated symbol chunk");
+				return true;
+			}
+			symbols[address] = symbol;
+		}
+		break;
+		case BINARY_LOG_CHUNK_MESSAGE:
+		{
+			BinaryLogMessageT message;
+			if (!reader.Read(message))
+			{
+				printf("\n >> Truncated message chunk");
+				return true;
+			}
+
+			const unsigned char* argBytes = reader.ReadBytes(message.argByteCount);
+			if (argBytes == nullptr)
+			{
+				printf("\n >> Truncated message chunk");
+				return true;
+			}
+
+			//Symbol collection pass
+			if (output == nullptr)
+			{
+				break;
+			}
+
+			std::string text = "<unknown format>";
+			std::unordered_map<uint32_t, DecodedFormatT>::const_iterator formatItr = formats.find(message.formatID);
+			if (formatItr != formats.end())
+			{
+				const DecodedFormatT& format = formatItr->second;
+				text = BinaryLogFormatArgs(format.text.c_str(), format.signature.data(), (uint8_t)format.signature.size(), argBytes, message.argByteCount);
+			}
+
+			const char* filterName = "<unknown filter>";
+			std::unordered_map<uint32_t, std::string>::const_iterator filterItr = filters.find(message.filterID);
+			if (filterItr != filters.end())
+			{
+				filterName = filterItr->second.c_str();
+			}
+
+			int written = fprintf(output, "Log Entry: Time: %.6f Filter: %s Thread: %u\n\t Message: %s\n",
+				(double)message.timestampNS * 1e-9, filterName, message.threadID, text.c_str());
+			stats.textBytes += (written > 0) ? (uint64_t)written : 0U;
+			stats.messageCount++;
+
+			if (message.callstackID != BINARY_LOG_INVALID_ID)
+			{
+				stats.callstackMessageCount++;
+
+				std::unordered_map<uint32_t, std::vector<uint64_t>>::const_iterator callstackItr = callstacks.find(message.callstackID);
+				if (callstackItr != callstacks.end())
+				{
+					for (uint64_t address : callstackItr->second)
+					{
+						std::unordered_map<uint64_t, std::string>::const_iterator symbolItr = symbols.find(address);
+						if (symbolItr != symbols.end())
+						{
+							written = fprintf(output, "\t\t %s\n", symbolItr->second.c_str());
+						}
+						else
+						{
+							written = fprintf(output, "\t\t 0x%016llx\n", (unsigned long long)address);
+						}
+						stats.textBytes += (written > 0) ? (uint64_t)written : 0U;
+					}
+				}
+			}
+		}
+		break;
+		default:
+		{
+			printf("\n >> Unknown chunk type %u, stopping", (uint32_t)chunk);
+			return true;
+		}
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	const char* inputPath = nullptr;
+	const char* outputPath = nullptr;
+	bool printStats = false;
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strcmp(argv[argIndex], "-stats") == 0)
+		{
+			printStats = true;
+		}
+		else if (inputPath == nullptr)
+		{
+			inputPath = argv[argIndex];
+		}
+		else
+		{
+			outputPath = argv[argIndex];
+		}
+	}
+
+	if (inputPath == nullptr)
+	{
+		printf("Usage: LogDecoder <input.blog> [output.txt] [-stats]\n");
+		return 1;
+	}
+
+	std::vector<unsigned char> bytes;
+	if (!ReadWholeFile(inputPath, bytes))
+	{
+		printf("\n >> Error reading %s \n", inputPath);
+		return 1;
+	}
+
+	std::unordered_map<uint64_t, std::string> symbols;
+	DecodeStatsT symbolStats;
+	if (!DecodeLog(bytes, nullptr, symbols, symbolStats))
+	{
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (outputPath != nullptr)
+	{
+		output = fopen(outputPath, "w");
+		if (output == nullptr)
+		{
+			printf("\n >> Error opening %s \n", outputPath);
+			return 1;
+		}
+	}
+
+	DecodeStatsT stats;
+	bool decoded = DecodeLog(bytes, output, symbols, stats);
+
+	if (output != stdout)
+	{
+		fclose(output);
+	}
+
+	if (printStats)
+	{
+		printf("\n Messages: %llu (%llu with callstacks, %llu unique callstacks)", (unsigned long long)stats.messageCount, (unsigned long long)stats.callstackMessageCount, (unsigned long long)stats.uniqueCallstacks);
+		printf("\n Binary bytes: %llu | Text bytes: %llu | Ratio: %.2fx \n", (unsigned long long)stats.fileBytes, (unsigned long long)stats.textBytes,
+			(stats.fileBytes > 0U) ? (double)stats.textBytes / (double)stats.fileBytes : 0.0);
+	}
+
+	return decoded ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// Packer: builds the single pack file the game mounts at start up (App DATA_PACK_PATH) from the loose Data folder. Entries
+// keep their "Data/..." paths, so nothing in the game changes how it names a file.
+//
+// Usage:	Packer <data folder> <output pack> [-store] [-stats]
+//			Run from Run/ as: Packer Data Data.pak
+//			Only the folders the game reads through the VirtualFileSystem go in; Audio and Materials are still opened loose
+//			by the engine, so they stay next to the pack. Cooked textures are always stored so they map in place
+//			-store	no compression at all
+//			-stats	per entry sizes, and the time to write the pack
+// Build:	Packer in the solution, which copies it to Run/. Elsewhere, from Code/
+//			c++ -std=c++14 -O2 -I. Tools/Packer/Main_Packer.cpp Game/PackFile.cpp Game/MappedFile.cpp -o Packer
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/MappedFile.hpp"
+#include "Game/PackFile.hpp"
+//Third Party
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+//Smallest saving, as a fraction of the file, worth a decompress on load
+constexpr float PACKER_MIN_COMPRESSION_SAVING = 0.125f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct PackOptionsT
+{
+	std::string							dataFolder;
+	std::string							outputPath;
+	bool								storeOnly = false;
+	bool								printStats = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What the game reads through the VirtualFileSystem, less what is written at run time or by tests. Matched against
+// normalized paths
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsPackedPath( const std::string& normalizedPath )
+{
+	static const char* EXCLUDED_FOLDERS[] = { "/logs/", "/screenshots/", "/cache/tests/" };
+	for (const char* folder : EXCLUDED_FOLDERS)
+	{
+		if (normalizedPath.find(folder) != std::string::npos)
+		{
+			return false;
+		}
+	}
+
+	static const char* PACKED_FOLDERS[] = { "/gameplay/", "/fonts/", "/images/", "/shaders/", "/cache/textures/", "/cache/meshes/", "/cache/shaders/" };
+	for (const char* folder : PACKED_FOLDERS)
+	{
+		if (normalizedPath.find(folder) != std::string::npos)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void CollectFiles( const std::string& folder, std::vector<std::string>& outPaths )
+{
+	std::vector<std::string> fileNames;
+	std::vector<std::string> folderNames;
+#if defined(_WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((folder + "*").c_str(), &findData);
+	if (findHandle != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0)
+			{
+				continue;
+			}
+
+			if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+			{
+				folderNames.push_back(findData.cFileName);
+			}
+			else
+			{
+				fileNames.push_back(findData.cFileName);
+			}
+		} while (FindNextFileA(findHandle, &findData));
+		FindClose(findHandle);
+	}
+#else
+	DIR* directory = opendir(folder.c_str());
+	if (directory != nullptr)
+	{
+		while (dirent* entry = readdir(directory))
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			{
+				continue;
+			}
+
+			struct stat entryStat;
+			std::string entryPath = folder + entry->d_name;
+			if (stat(entryPath.c_str(), &entryStat) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(entryStat.st_mode))
+			{
+				folderNames.push_back(entry->d_name);
+			}
+			else if (S_ISREG(entryStat.st_mode))
+			{
+				fileNames.push_back(entry->d_name);
+			}
+		}
+		closedir(directory);
+	}
+#endif
+
+	//Directory order is up to the OS, sorting keeps the pack the same run to run
+	std::sort(fileNames.begin(), fileNames.end());
+	std::sort(folderNames.begin(), folderNames.end());
+	for (const std::string& fileName : fileNames)
+	{
+		outPaths.push_back(folder + fileName);
+	}
+	for (const std::string& folderName : folderNames)
+	{
+		CollectFiles(folder + folderName + "/", outPaths);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadWholeFile( const std::string& filePath, std::vector<unsigned char>& outBytes )
+{
+	//Not mapped, MappedFile refuses empty files and an empty file is still a file the game may ask for
+	FILE* file = fopen(filePath.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	outBytes.resize((fileSize > 0) ? (size_t)fileSize : 0U);
+	bool isRead = outBytes.empty() || fread(outBytes.data(), 1, outBytes.size(), file) == outBytes.size();
+	fclose(file);
+	return isRead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static double GetElapsedMS( const std::chrono::steady_clock::time_point& start )
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	PackOptionsT options;
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strcmp(argv[argIndex], "-store") == 0)
+		{
+			options.storeOnly = true;
+		}
+		else if (strcmp(argv[argIndex], "-stats") == 0)
+		{
+			options.printStats = true;
+		}
+		else if (options.dataFolder.empty())
+		{
+			options.dataFolder = argv[argIndex];
+		}
+		else
+		{
+			options.outputPath = argv[argIndex];
+		}
+	}
+
+	if (options.dataFolder.empty() || options.outputPath.empty())
+	{
+		printf("Usage: Packer <data folder> <output pack> [-store] [-stats]\n");
+		return 1;
+	}
+
+	if (options.dataFolder.back() != '/' && options.dataFolder.back() != '\\')
+	{
+		options.dataFolder += '/';
+	}
+
+	std::vector<std::string> filePaths;
+	CollectFiles(options.dataFolder, filePaths);
+
+	std::string normalizedOutput = NormalizePackPath(options.outputPath);
+	std::vector<PackSourceT> sources;
+	uint64_t looseBytes = 0U;
+	for (const std::string& filePath : filePaths)
+	{
+		std::string normalizedPath = NormalizePackPath(filePath);
+		if (!IsPackedPath(normalizedPath) || normalizedPath == normalizedOutput)
+		{
+			continue;
+		}
+
+		PackSourceT source;
+		source.path = filePath;
+		if (!ReadWholeFile(filePath, source.bytes))
+		{
+			printf("\n >> Error reading %s\n", filePath.c_str());
+			return 1;
+		}
+		source.isCompressible = !options.storeOnly && normalizedPath.find("/cache/textures/") == std::string::npos;
+		looseBytes += source.bytes.size();
+		sources.push_back(std::move(source));
+	}
+
+	std::chrono::steady_clock::time_point writeStart = std::chrono::steady_clock::now();
+	std::string error;
+	if (!WritePackFile(options.outputPath, sources, PACKER_MIN_COMPRESSION_SAVING, error))
+	{
+		printf("\n >> Error writing %s: %s\n", options.outputPath.c_str(), error.c_str());
+		return 1;
+	}
+	double writeMS = GetElapsedMS(writeStart);
+
+	MappedFile pack;
+	PackIndexViewT index;
+	if (!pack.Open(options.outputPath) || !ReadPackIndex(pack.GetData(), pack.GetSize(), index))
+	{
+		printf("\n >> Error reading back %s\n", options.outputPath.c_str());
+		return 1;
+	}
+
+	uint32_t compressedCount = 0U;
+	for (uint32_t entryIndex = 0; entryIndex < index.entryCount; ++entryIndex)
+	{
+		const PackEntryT& entry = index.entries[entryIndex];
+		if (entry.compression != PACK_COMPRESSION_NONE)
+		{
+			compressedCount++;
+		}
+
+		if (options.printStats)
+		{
+			printf("\n %.*s: %u -> %u bytes%s", (int)entry.nameLength, index.names + entry.nameOffset, entry.size, entry.storedSize,
+				(entry.compression != PACK_COMPRESSION_NONE) ? ", compressed" : "");
+		}
+	}
+
+	printf("\n\n Packed %u files (%u compressed) into %s, %llu -> %zu bytes", index.entryCount, compressedCount, options.outputPath.c_str(),
+		(unsigned long long)looseBytes, pack.GetSize());
+	if (options.printStats)
+	{
+		printf(", written in %.2f ms", writeMS);
+	}
+	printf("\n");
+
+	return 0;
+}
@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------------------------------------------------------
+// TextureCooker: turns source images (Data/Images/*.png, *.jpg) into cooked textures the game maps and uploads without
+// decoding. Every mip is built here, and with -bc stored block compressed.
+//
+// Usage:	TextureCooker <image or folder>... [-out <folder>] [-bc] [-linear] [-force] [-stats]
+//			Run from Run/ so the default output lands where TextureStreamer looks: Data/Cache/Textures/<file name>.ctex
+//			-bc		BC1 for opaque images, BC3 when any texel has alpha
+//			-linear	average mips as plain data; files with "normal" in the name always are
+//			-force	cook even when the cooked file already matches the source
+//			-stats	time the source decode against loading the cooked file, and report the BC error
+// Build:	TextureCooker in the solution, which copies it to Run/. Elsewhere it needs stb_image from the engine's ThirdParty
+//			folder, e.g. from Code/
+//			c++ -std=c++14 -O2 -I. -ISubmodule/Engine/Code Tools/TextureCooker/Main_TextureCooker.cpp Game/CookedTextureFormat.cpp Game/MappedFile.cpp -o TextureCooker
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/CookedTextureFormat.hpp"
+#include "Game/MappedFile.hpp"
+//Third Party
+#include <algorithm>
+#include <chrono>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "ThirdParty/stb/stb_image.h"
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookOptionsT
+{
+	std::string							outputFolder = "Data/Cache/Textures/";
+	bool								useBC = false;
+	bool								forceLinear = false;
+	bool								forceCook = false;
+	bool								printStats = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct CookStatsT
+{
+	uint32_t							cookedCount = 0U;
+	uint32_t							skippedCount = 0U;
+	uint32_t							failedCount = 0U;
+	uint64_t							sourceBytes = 0U;
+	uint64_t							cookedBytes = 0U;
+	double								decodeMS = 0.0;
+	double								cookedLoadMS = 0.0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+static double GetElapsedMS( const std::chrono::steady_clock::time_point& start )
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool IsSourceImage( const std::string& fileName )
+{
+	size_t extensionStart = fileName.find_last_of('.');
+	if (extensionStart == std::string::npos)
+	{
+		return false;
+	}
+
+	std::string extension = fileName.substr(extensionStart + 1);
+	for (char& character : extension)
+	{
+		character = (char)tolower((unsigned char)character);
+	}
+	return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "tga" || extension == "bmp";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Adds the images directly inside path, or path itself if it is a file. Sub folders are not walked, the
+// ScreenShots folder next to the images is not game data
+//------------------------------------------------------------------------------------------------------------------------------
+static void CollectSourceImages( const std::string& path, std::vector<std::string>& outPaths )
+{
+#if defined(_WIN32)
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	bool isFolder = (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	struct stat fileStat;
+	bool isFolder = (stat(path.c_str(), &fileStat) == 0) && S_ISDIR(fileStat.st_mode);
+#endif
+
+	if (!isFolder)
+	{
+		outPaths.push_back(path);
+		return;
+	}
+
+	std::string folder = path;
+	if (folder.back() != '/' && folder.back() != '\\')
+	{
+		folder += '/';
+	}
+
+	std::vector<std::string> fileNames;
+#if defined(_WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((folder + "*").c_str(), &findData);
+	if (findHandle != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0 && IsSourceImage(findData.cFileName))
+			{
+				fileNames.push_back(findData.cFileName);
+			}
+		} while (FindNextFileA(findHandle, &findData));
+		FindClose(findHandle);
+	}
+#else
+	DIR* directory = opendir(folder.c_str());
+	if (directory != nullptr)
+	{
+		while (dirent* entry = readdir(directory))
+		{
+			struct stat entryStat;
+			std::string entryPath = folder + entry->d_name;
+			if (stat(entryPath.c_str(), &entryStat) == 0 && S_ISREG(entryStat.st_mode) && IsSourceImage(entry->d_name))
+			{
+				fileNames.push_back(entry->d_name);
+			}
+		}
+		closedir(directory);
+	}
+#endif
+
+	//Directory order is up to the OS, sorting keeps the output the same run to run
+	std::sort(fileNames.begin(), fileNames.end());
+	for (const std::string& fileName : fileNames)
+	{
+		outPaths.push_back(folder + fileName);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::string GetFileName( const std::string& filePath )
+{
+	size_t nameStart = filePath.find_last_of("/\\");
+	return (nameStart == std::string::npos) ? filePath : filePath.substr(nameStart + 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static double ComputeRMSE( const std::vector<unsigned char>& expected, const std::vector<unsigned char>& actual )
+{
+	double sumSquares = 0.0;
+	for (size_t byteIndex = 0; byteIndex < expected.size(); ++byteIndex)
+	{
+		double delta = (double)expected[byteIndex] - (double)actual[byteIndex];
+		sumSquares += delta * delta;
+	}
+	return expected.empty() ? 0.0 : sqrt(sumSquares / (double)expected.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool CookTexture( const std::string& sourcePath, const CookOptionsT& options, CookStatsT& stats )
+{
+	std::string fileName = GetFileName(sourcePath);
+	std::string cookedPath = options.outputFolder + fileName + ".ctex";
+
+	MappedFile source;
+	if (!source.Open(sourcePath))
+	{
+		printf("\n >> Error reading %s", sourcePath.c_str());
+		return false;
+	}
+	uint64_t sourceHash = HashTextureSource(source.GetData(), source.GetSize());
+
+	std::string lowerName = fileName;
+	for (char& character : lowerName)
+	{
+		character = (char)tolower((unsigned char)character);
+	}
+	bool isSRGB = !options.forceLinear && lowerName.find("normal") == std::string::npos;
+	uint16_t flags = (uint16_t)(COOKED_TEXTURE_FLAG_ROWS_FLIPPED | (isSRGB ? (uint16_t)COOKED_TEXTURE_FLAG_SRGB : (uint16_t)0U));
+
+	if (!options.forceCook)
+	{
+		MappedFile cooked;
+		CookedTextureViewT cookedView;
+		uint64_t cookedHash = 0U;
+		if (cooked.Open(cookedPath) && ReadCookedTexture(cooked.GetData(), cooked.GetSize(), cookedView, &cookedHash) && cookedHash == sourceHash
+			&& cookedView.flags == flags && (cookedView.format != COOKED_TEXTURE_FORMAT_RGBA8) == options.useBC)
+		{
+			stats.skippedCount++;
+			return true;
+		}
+	}
+
+	//Same row order the engine loads with, so the cooked rows can be copied as they are
+	std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* texels = stbi_load_from_memory(source.GetData(), (int)source.GetSize(), &width, &height, &channels, 4);
+	double decodeMS = GetElapsedMS(decodeStart);
+	if (texels == nullptr)
+	{
+		printf("\n >> Error decoding %s: %s", sourcePath.c_str(), stbi_failure_reason());
+		return false;
+	}
+
+	std::vector<std::vector<unsigned char>> mips;
+	BuildTextureMipChain(texels, (uint32_t)width, (uint32_t)height, isSRGB, mips);
+
+	bool hasAlpha = false;
+	for (size_t texelIndex = 0; texelIndex < (size_t)width * height && !hasAlpha; ++texelIndex)
+	{
+		hasAlpha = texels[texelIndex * 4U + 3U] != 255;
+	}
+	stbi_image_free(texels);
+
+	eCookedTextureFormat format = COOKED_TEXTURE_FORMAT_RGBA8;
+	double compressionRMSE = 0.0;
+	if (options.useBC)
+	{
+		format = hasAlpha ? COOKED_TEXTURE_FORMAT_BC3 : COOKED_TEXTURE_FORMAT_BC1;
+		for (size_t mipIndex = 0; mipIndex < mips.size(); ++mipIndex)
+		{
+			uint32_t mipWidth = ((uint32_t)width >> mipIndex) > 0U ? ((uint32_t)width >> mipIndex) : 1U;
+			uint32_t mipHeight = ((uint32_t)height >> mipIndex) > 0U ? ((uint32_t)height >> mipIndex) : 1U;
+			std::vector<unsigned char> blocks;
+			CompressTextureBC(format, mips[mipIndex].data(), mipWidth, mipHeight, blocks);
+
+			if (options.printStats && mipIndex == 0U)
+			{
+				std::vector<unsigned char> decoded;
+				DecompressTextureBC(format, blocks.data(), mipWidth, mipHeight, decoded);
+				compressionRMSE = ComputeRMSE(mips[mipIndex], decoded);
+			}
+			mips[mipIndex].swap(blocks);
+		}
+	}
+
+	if (!WriteCookedTexture(cookedPath, sourceHash, format, flags, mips, (uint32_t)width, (uint32_t)height))
+	{
+		printf("\n >> Error writing %s", cookedPath.c_str());
+		return false;
+	}
+
+	//What the game pays instead of the decode: map the file, validate it and touch the largest mip once
+	std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+	MappedFile cooked;
+	CookedTextureViewT cookedView;
+	if (!cooked.Open(cookedPath) || !ReadCookedTexture(cooked.GetData(), cooked.GetSize(), cookedView))
+	{
+		printf("\n >> Error reading back %s", cookedPath.c_str());
+		return false;
+	}
+	std::vector<unsigned char> uploadCopy(cookedView.mips[0].data, cookedView.mips[0].data + cookedView.mips[0].byteCount);
+	double cookedLoadMS = GetElapsedMS(loadStart);
+
+	stats.cookedCount++;
+	stats.sourceBytes += source.GetSize();
+	stats.cookedBytes += cooked.GetSize();
+	stats.decodeMS += decodeMS;
+	stats.cookedLoadMS += cookedLoadMS;
+
+	printf("\n %s -> %s: %dx%d, %u mips, %s", sourcePath.c_str(), cookedPath.c_str(), width, height, cookedView.mipCount,
+		(format == COOKED_TEXTURE_FORMAT_BC1) ? "BC1" : ((format == COOKED_TEXTURE_FORMAT_BC3) ? "BC3" : "RGBA8"));
+	if (options.printStats)
+	{
+		printf("\n\t decode %.2f ms, cooked load %.2f ms, %zu -> %zu bytes", decodeMS, cookedLoadMS, source.GetSize(), cooked.GetSize());
+		if (options.useBC)
+		{
+			printf(", BC RMSE %.2f", compressionRMSE);
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+	CookOptionsT options;
+	std::vector<std::string> inputPaths;
+
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		if (strcmp(argv[argIndex], "-out") == 0 && argIndex + 1 < argc)
+		{
+			options.outputFolder = argv[++argIndex];
+			if (options.outputFolder.back() != '/' && options.outputFolder.back() != '\\')
+			{
+				options.outputFolder += '/';
+			}
+		}
+		else if (strcmp(argv[argIndex], "-bc") == 0)
+		{
+			options.useBC = true;
+		}
+		else if (strcmp(argv[argIndex], "-linear") == 0)
+		{
+			options.forceLinear = true;
+		}
+		else if (strcmp(argv[argIndex], "-force") == 0)
+		{
+			options.forceCook = true;
+		}
+		else if (strcmp(argv[argIndex], "-stats") == 0)
+		{
+			options.printStats = true;
+		}
+		else
+		{
+			CollectSourceImages(argv[argIndex], inputPaths);
+		}
+	}
+
+	if (inputPaths.empty())
+	{
+		printf("Usage: TextureCooker <image or folder>... [-out <folder>] [-bc] [-linear] [-force] [-stats]\n");
+		return 1;
+	}
+
+	CookStatsT stats;
+	for (const std::string& inputPath : inputPaths)
+	{
+		if (!CookTexture(inputPath, options, stats))
+		{
+			stats.failedCount++;
+		}
+	}
+
+	printf("\n\n Cooked %u, up to date %u, failed %u", stats.cookedCount, stats.skippedCount, stats.failedCount);
+	if (options.printStats && stats.cookedCount > 0U)
+	{
+		printf("\n Decode %.2f ms, cooked load %.2f ms (%.1fx), %llu -> %llu bytes", stats.decodeMS, stats.cookedLoadMS,
+			(stats.cookedLoadMS > 0.0) ? stats.decodeMS / stats.cookedLoadMS : 0.0, (unsigned long long)stats.sourceBytes, (unsigned long long)stats.cookedBytes);
+	}
+	printf("\n");
+
+	return (stats.failedCount == 0U) ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------------
+// Debug lines
+// ------
+// Drawn as a line list of Vertex_PCU by RenderBackend::DrawLineArray. Lines are not
+// textured, the uv is only there so the vertex matches the engine's.
+//--------------------------------------------------------------------------------------
+struct vs_input_t
+{
+   float3 position      : POSITION;
+   float4 color         : COLOR;
+   float2 uv            : TEXCOORD;
+};
+
+//--------------------------------------------------------------------------------------
+cbuffer camera_constants : register(b2)
+{
+   float4x4 VIEW;
+   float4x4 PROJECTION;
+
+   float3 CAMERA_POSITION;
+   float cam_unused0;
+};
+
+//--------------------------------------------------------------------------------------
+cbuffer model_constants : register(b3)
+{
+   float4x4 MODEL;  // LOCAL_TO_WORLD
+}
+
+//--------------------------------------------------------------------------------------
+struct v2f_t
+{
+   float4 position : SV_POSITION;
+   float4 color : COLOR;
+};
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+v2f_t VertexFunction( vs_input_t input )
+{
+   v2f_t v2f = (v2f_t)0;
+
+   float4 world_pos = mul( MODEL, float4(input.position, 1.0f) );
+   float4 view_pos = mul( VIEW, world_pos );
+   v2f.position = mul( PROJECTION, view_pos );
+   v2f.color = input.color;
+
+   return v2f;
+}
+
+//--------------------------------------------------------------------------------------
+// Fragment Shader
+float4 FragmentFunction( v2f_t input ) : SV_Target0
+{
+   return input.color;
+}
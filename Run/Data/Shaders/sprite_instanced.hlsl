@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------------
+// Instanced sprites
+// ------
+// Drawn with DrawInstanced(6, spriteCount). There is no per vertex stream, every input
+// steps once per instance (SpriteInstanceDataT on the C++ side) and SV_VertexID picks
+// which corner of the sprite's quad this vertex is.
+//--------------------------------------------------------------------------------------
+struct vs_input_t
+{
+   float3 corner        : CORNER;      // bottom left of the quad, in world space
+   float3 right         : RIGHT;       // scaled edges of the quad
+   float3 up            : UP;
+   float2 uvMins        : UVMINS;
+   float2 uvMaxs        : UVMAXS;
+   float4 tint          : TINT;
+
+   uint vertexIndex     : SV_VERTEXID;
+};
+
+//--------------------------------------------------------------------------------------
+cbuffer camera_constants : register(b2)
+{
+   float4x4 VIEW;
+   float4x4 PROJECTION;
+
+   float3 CAMERA_POSITION;
+   float cam_unused0;
+};
+
+//--------------------------------------------------------------------------------------
+Texture2D<float4> tAlbedo : register(t0);
+SamplerState sAlbedo : register(s0);
+
+//--------------------------------------------------------------------------------------
+// Same two triangles the CPU sprite path used to build: BL BR TR, BL TR TL
+static float2 QUAD_CORNERS[6] = {
+   float2(0.0f, 0.0f),
+   float2(1.0f, 0.0f),
+   float2(1.0f, 1.0f),
+   float2(0.0f, 0.0f),
+   float2(1.0f, 1.0f),
+   float2(0.0f, 1.0f),
+};
+
+//--------------------------------------------------------------------------------------
+struct v2f_t
+{
+   float4 position : SV_POSITION;
+   float4 color : COLOR;
+   float2 uv : UV;
+};
+
+//--------------------------------------------------------------------------------------
+// Vertex Shader
+v2f_t VertexFunction( vs_input_t input )
+{
+   v2f_t v2f = (v2f_t)0;
+
+   float2 quadCorner = QUAD_CORNERS[input.vertexIndex];
+   float3 world_pos = input.corner + input.right * quadCorner.x + input.up * quadCorner.y;
+
+   float4 view_pos = mul( VIEW, float4(world_pos, 1.0f) );
+   v2f.position = mul( PROJECTION, view_pos );
+   v2f.color = input.tint;
+   v2f.uv = lerp( input.uvMins, input.uvMaxs, quadCorner );
+
+   return v2f;
+}
+
+//--------------------------------------------------------------------------------------
+// Fragment Shader
+float4 FragmentFunction( v2f_t input ) : SV_Target0
+{
+   float4 texColor = tAlbedo.Sample( sAlbedo, input.uv );
+   return texColor * input.color;
+}